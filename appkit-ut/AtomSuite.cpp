@@ -0,0 +1,178 @@
+#include "appkit/Atom.hpp"
+#include "appkit/U32.hpp"
+#include "appkit/String.hpp"
+#include "syskit/Thread.hpp"
+
+#include "appkit-ut-pch.h"
+#include "AtomSuite.hpp"
+
+using namespace appkit;
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+enum
+{
+    NumNames = 500,
+    NumThreads = 4
+};
+
+typedef struct
+{
+    unsigned int seed;
+    Atom atom[NumNames];
+} stress_t;
+
+END_NAMESPACE
+
+
+AtomSuite::AtomSuite()
+{
+}
+
+
+AtomSuite::~AtomSuite()
+{
+}
+
+
+//
+// Intern names in pseudo-random order. Identical names must yield identical
+// atoms regardless of which thread interns first.
+//
+void* AtomSuite::entry00(void* arg)
+{
+    stress_t& stress = *static_cast<stress_t*>(arg);
+    for (unsigned int i = 0, j = stress.seed; i < NumNames; ++i, j = (j + 7) % NumNames)
+    {
+        String name("AtomSuite::testStress00-");
+        name += U32(j).toString();
+        stress.atom[j] = Atom(name);
+    }
+
+    return arg;
+}
+
+
+//
+// Interfaces under test:
+// - Atom::Atom();
+// - Atom::Atom(const String& s);
+// - Atom::Atom(const char* s);
+// - Atom::Atom(const utf8_t* s, size_t numU8s, size_t numChars);
+// - bool Atom::operator !=(const Atom& atom) const;
+// - bool Atom::operator ==(const Atom& atom) const;
+// - unsigned int Atom::hash() const;
+// - unsigned int Atom::id() const;
+//
+void AtomSuite::testCtor00()
+{
+    Atom empty;
+    bool ok = (empty.id() == 0) && empty.asString().empty() && (empty == Atom(""));
+    CPPUNIT_ASSERT(ok);
+
+    String s("AtomSuite::testCtor00");
+    Atom a0(s);
+    Atom a1("AtomSuite::testCtor00");
+    Atom a2(reinterpret_cast<const utf8_t*>(s.ascii()), s.byteSize() - 1, s.length());
+    ok = (a0 == a1) && (a0 == a2) && (a0 != empty) && (a0.id() == a1.id()) && (a0.asString() == s);
+    CPPUNIT_ASSERT(ok);
+    ok = (a0.hash() == s.hash()) && (a0.asString().raw() == a1.asString().raw());
+    CPPUNIT_ASSERT(ok);
+
+    // Identifiers are unique.
+    Atom a3("AtomSuite::testCtor00 ");
+    ok = (a3 != a0) && (a3.id() != a0.id()) && (Atom::numAtoms() > a3.id());
+    CPPUNIT_ASSERT(ok);
+
+    // 8-bit ASCII characters are interned as UTF8.
+    Atom a4("AtomSuite::testCtor00\xe9");
+    String s4("AtomSuite::testCtor00\xe9");
+    ok = (a4 == Atom(s4)) && (a4.asString() == s4) && (a4.asString().byteSize() == s4.byteSize());
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - bool Atom::find(const String& s, Atom& atom);
+// - bool Atom::find(const utf8_t* s, size_t numU8s, Atom& atom);
+// - unsigned int Atom::numAtoms();
+//
+void AtomSuite::testFind00()
+{
+    String s("AtomSuite::testFind00");
+    Atom found;
+    unsigned int numAtoms = Atom::numAtoms();
+    bool ok = (!Atom::find(s, found)) && (found == Atom()) && (Atom::numAtoms() == numAtoms);
+    CPPUNIT_ASSERT(ok);
+
+    Atom a(s);
+    ok = Atom::find(s, found) && (found == a) && (Atom::numAtoms() == numAtoms + 1);
+    CPPUNIT_ASSERT(ok);
+    found = Atom();
+    ok = Atom::find(reinterpret_cast<const utf8_t*>(s.ascii()), s.byteSize() - 1, found) && (found == a);
+    CPPUNIT_ASSERT(ok);
+    ok = (!Atom::find(reinterpret_cast<const utf8_t*>(s.ascii()), s.byteSize() - 2, found)) && (found == a);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - String Atom::intern(const String& s);
+// - String Atom::intern(const utf8_t* s, size_t numU8s, size_t numChars);
+//
+void AtomSuite::testIntern00()
+{
+    String s("AtomSuite::testIntern00");
+    String s0(Atom::intern(s));
+    String s1(Atom::intern(reinterpret_cast<const utf8_t*>(s.ascii()), s.byteSize() - 1, s.length()));
+    bool ok = (s0 == s) && (s1 == s) && (s0.raw() == s1.raw()) && (s0.raw() == Atom(s).asString().raw());
+    CPPUNIT_ASSERT(ok);
+
+    // Interned strings are copy-on-write.
+    s1 += '!';
+    ok = (s1 == "AtomSuite::testIntern00!") && (Atom(s).asString() == s);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Concurrent interning of the same names must agree.
+//
+void AtomSuite::testStress00()
+{
+    stress_t stress[NumThreads];
+    Thread* thread[NumThreads];
+    for (unsigned int i = 0; i < NumThreads; ++i)
+    {
+        stress[i].seed = i * 101;
+        thread[i] = new Thread(entry00, &stress[i]);
+    }
+
+    bool ok = true;
+    for (unsigned int i = 0; i < NumThreads; ++i)
+    {
+        void* exitCode = 0;
+        thread[i]->waitTilDone(&exitCode);
+        if (exitCode != &stress[i])
+        {
+            ok = false;
+        }
+        delete thread[i];
+    }
+    CPPUNIT_ASSERT(ok);
+
+    for (unsigned int j = 0; j < NumNames; ++j)
+    {
+        for (unsigned int i = 1; i < NumThreads; ++i)
+        {
+            if (stress[i].atom[j] != stress[0].atom[j])
+            {
+                ok = false;
+            }
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+}
@@ -0,0 +1,36 @@
+#ifndef ATOM_SUITE_HPP
+#define ATOM_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "syskit/macros.h"
+
+
+class AtomSuite: public CppUnit::TestFixture
+{
+
+public:
+    AtomSuite();
+
+    virtual ~AtomSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(AtomSuite);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testFind00);
+    CPPUNIT_TEST(testIntern00);
+    CPPUNIT_TEST(testStress00);
+    CPPUNIT_TEST_SUITE_END();
+
+    AtomSuite(const AtomSuite&); //prohibit usage
+    const AtomSuite& operator =(const AtomSuite&); //prohibit usage
+
+    void testCtor00();
+    void testFind00();
+    void testIntern00();
+    void testStress00();
+
+    static void* entry00(void*);
+
+};
+
+#endif
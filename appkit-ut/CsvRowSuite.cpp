@@ -1,5 +1,6 @@
 #include "appkit/CsvRow.hpp"
 #include "appkit/Directory.hpp"
+#include "syskit/U64Vec.hpp"
 
 #include "appkit-ut-pch.h"
 #include "CsvRowSuite.hpp"
@@ -43,6 +44,42 @@ String CsvRowSuite::formExpectedCol(size_t i)
 }
 
 
+//
+// Split given row into columns one byte at a time. Save the column ends.
+//
+void CsvRowSuite::splitRow(U64Vec& colEnds, const char* row, size_t length, char delim)
+{
+    const char* p;
+    const char* p1;
+    const char* pEnd = row + length;
+    char quote = 0;
+    for (p = p1 = row; p < pEnd; ++p)
+    {
+        if (quote == 0)
+        {
+            if (p[0] == delim)
+            {
+                colEnds.add(reinterpret_cast<size_t>(p + 1));
+                p1 = p + 1;
+            }
+            else if ((p[0] == '"') || (p[0] == '\''))
+            {
+                quote = p[0];
+            }
+        }
+        else if ((p[0] == quote) && (p[-1] != '\\'))
+        {
+            quote = 0;
+        }
+    }
+
+    if (p1 < p)
+    {
+        colEnds.add(reinterpret_cast<size_t>(p));
+    }
+}
+
+
 bool CsvRowSuite::cb0(void* arg, const String& col)
 {
     String& s = *static_cast<String*>(arg);
@@ -107,6 +144,13 @@ void CsvRowSuite::cb4b(void* arg, const char* col, size_t length)
 }
 
 
+void CsvRowSuite::cb4c(void* arg, const char* col, size_t length)
+{
+    U64Vec& colEnds = *static_cast<U64Vec*>(arg);
+    colEnds.add(reinterpret_cast<size_t>(col + length));
+}
+
+
 //
 // Apply callback to each col. Use cb0_t.
 //
@@ -218,6 +262,53 @@ void CsvRowSuite::testApply04()
 }
 
 
+//
+// Compare the column splitting against the byte-at-a-time splitting
+// using random rows with quoted strings and escaped quotes.
+//
+void CsvRowSuite::testApply05()
+{
+    const char ALPHABET[] = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa,,,,,,,,,,\"\"\"\"\"\"\'\'\'\\\\\\  ";
+    const char DELIM[] = {',', '"', '|'};
+    const size_t ALPHABET_SIZE[] = {50 /*no quotes*/, 56 /*double quotes only*/, sizeof(ALPHABET) - 1};
+    char row[512];
+    unsigned int seed = 1;
+    bool ok = true;
+    for (unsigned int i = 0; ok && (i < 3000); ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        size_t startAt = (seed >> 4) % 8;
+        size_t length = startAt + (seed >> 8) % (sizeof(row) - startAt);
+        for (size_t j = startAt; j < length; ++j)
+        {
+            seed = seed * 1103515245U + 12345U;
+            row[j] = ALPHABET[(seed >> 16) % ALPHABET_SIZE[i % 3]];
+        }
+
+        for (size_t k = 0; k < sizeof(DELIM); ++k)
+        {
+            const char* s = row + startAt;
+            size_t n = length - startAt;
+            U64Vec expected(U64Vec::DefaultCap, -1 /*growBy*/);
+            splitRow(expected, s, n, DELIM[k]);
+
+            CsvRow csv(s, n, DELIM[k]);
+            U64Vec found(U64Vec::DefaultCap, -1 /*growBy*/);
+            csv.apply(cb4c, &found);
+            U64Vec nextFound(U64Vec::DefaultCap, -1 /*growBy*/);
+            const char* col;
+            for (size_t colLength; csv.next(col, colLength); nextFound.add(reinterpret_cast<size_t>(col + colLength)));
+            if ((found != expected) || (nextFound != expected) || (csv.countCols() != expected.numItems()))
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void CsvRowSuite::testCount00()
 {
     CsvRow row0(SAMPLE0, sizeof(SAMPLE0) - 1, COMMA);
@@ -5,6 +5,7 @@
 #include "syskit/macros.h"
 
 DECLARE_CLASS1(appkit, String)
+DECLARE_CLASS1(syskit, U64Vec)
 
 
 class CsvRowSuite: public CppUnit::TestFixture
@@ -21,6 +22,7 @@ private:
     CPPUNIT_TEST(testApply01);
     CPPUNIT_TEST(testApply03);
     CPPUNIT_TEST(testApply04);
+    CPPUNIT_TEST(testApply05);
     CPPUNIT_TEST(testCount00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
@@ -36,6 +38,7 @@ private:
     void testApply01();
     void testApply03();
     void testApply04();
+    void testApply05();
     void testCount00();
     void testCtor00();
     void testCtor01();
@@ -53,8 +56,10 @@ private:
     static void cb3(void*, const appkit::String&);
     static void cb4a(void*, const char*, size_t);
     static void cb4b(void*, const char*, size_t);
+    static void cb4c(void*, const char*, size_t);
 
     static appkit::String formExpectedCol(size_t);
+    static void splitRow(syskit::U64Vec&, const char*, size_t, char);
 
 };
 
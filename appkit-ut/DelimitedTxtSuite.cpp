@@ -1,10 +1,13 @@
 #include "appkit/DelimitedTxt.hpp"
 #include "appkit/StringVec.hpp"
+#include "syskit/Atomic32.hpp"
+#include "syskit/ThreadPool.hpp"
 
 #include "appkit-ut-pch.h"
 #include "DelimitedTxtSuite.hpp"
 
 using namespace appkit;
+using namespace syskit;
 
 const char NEW_LINE = '\n';
 
@@ -98,6 +101,33 @@ bool DelimitedTxtSuite::cb1d(void* arg, const char* line, size_t length)
 }
 
 
+//
+// Count lines and bytes. Can be invoked concurrently.
+// Abort at the line starting with a '!'.
+//
+bool DelimitedTxtSuite::cb1e(void* arg, const char* line, size_t length)
+{
+    Atomic32* count = static_cast<Atomic32*>(arg);
+    ++count[0];
+    count[1] += static_cast<Atomic32::item_t>(length);
+    return (*line != '!');
+}
+
+
+//
+// Expect lines in order. Abort at the line starting with a '!'.
+//
+bool DelimitedTxtSuite::cb1f(void* arg, const char* line, size_t length)
+{
+    const char*& expectedLine = *static_cast<const char**>(arg);
+    bool ok = (line == expectedLine);
+    CPPUNIT_ASSERT(ok);
+
+    expectedLine += length;
+    return (*line != '!');
+}
+
+
 String DelimitedTxtSuite::formExpectedLine(size_t i)
 {
     char c = static_cast<char>('0' + i);
@@ -111,6 +141,34 @@ String DelimitedTxtSuite::formExpectedLine(size_t i)
 }
 
 
+//
+// Form some text large enough to be iterated in parallel. Include some
+// lines longer than a parallel chunk, and some empty ones. The last line
+// does not have a line delimiter. Return the text. Also return its size in
+// txtSize and its number of lines in numLines.
+//
+char* DelimitedTxtSuite::formLongTxt(size_t& txtSize, size_t& numLines)
+{
+    const size_t maxSize = 8 * 1024 * 1024;
+    char* txt = new char[maxSize];
+    char* p = txt;
+    numLines = 0;
+    for (size_t i = 0; (p - txt) < static_cast<ptrdiff_t>(maxSize - 1024 * 1024); ++i, ++numLines)
+    {
+        size_t length = ((i % 4999) == 4998)? (256 * 1024): (i % 97);
+        memset(p, 'a' + static_cast<char>(i % 26), length);
+        p += length;
+        *p++ = NEW_LINE;
+    }
+    memset(p, 'z', 7);
+    p += 7;
+    ++numLines;
+
+    txtSize = p - txt;
+    return txt;
+}
+
+
 void DelimitedTxtSuite::cb3a(void* arg, const String& line)
 {
     String& s = *static_cast<String*>(arg);
@@ -147,6 +205,14 @@ void DelimitedTxtSuite::cb4b(void* arg, const char* line, size_t length)
 }
 
 
+void DelimitedTxtSuite::cb4c(void* arg, const char* /*line*/, size_t length)
+{
+    Atomic32* count = static_cast<Atomic32*>(arg);
+    ++count[0];
+    count[1] += static_cast<Atomic32::item_t>(length);
+}
+
+
 //
 // Apply callback to each line. Use cb0_t.
 //
@@ -278,6 +344,63 @@ void DelimitedTxtSuite::testApply04()
 }
 
 
+//
+// Apply callback to each line in parallel.
+//
+void DelimitedTxtSuite::testApply05()
+{
+    size_t txtSize;
+    size_t numLines;
+    char* s = formLongTxt(txtSize, numLines);
+    DelimitedTxt txt(s, txtSize, false /*makeCopy*/, NEW_LINE);
+    ThreadPool pool(4 /*numWorkers*/);
+
+    // Unordered.
+    Atomic32 count[2];
+    bool ok = txt.applyParallel(cb1e, count, false /*ordered*/, &pool) &&
+        (count[0] == numLines) &&
+        (count[1] == txtSize);
+    CPPUNIT_ASSERT(ok);
+
+    count[0] = 0;
+    count[1] = 0;
+    txt.applyParallel(cb4c, count, false /*ordered*/, &pool);
+    ok = (count[0] == numLines) && (count[1] == txtSize);
+    CPPUNIT_ASSERT(ok);
+
+    // Ordered.
+    const char* expectedLine = s;
+    ok = txt.applyParallel(cb1f, &expectedLine, true /*ordered*/, &pool) &&
+        (expectedLine == s + txtSize);
+    CPPUNIT_ASSERT(ok);
+
+    // Aborted.
+    size_t abortAt = txtSize / 2;
+    for (; (s[abortAt - 1] != NEW_LINE) || (s[abortAt] == NEW_LINE); ++abortAt);
+    s[abortAt] = '!';
+    const char* abortEnd = s + abortAt;
+    for (; *abortEnd++ != NEW_LINE;);
+    count[0] = 0;
+    count[1] = 0;
+    ok = (!txt.applyParallel(cb1e, count, false /*ordered*/, &pool)) &&
+        (count[0] <= numLines);
+    CPPUNIT_ASSERT(ok);
+    expectedLine = s;
+    ok = (!txt.applyParallel(cb1f, &expectedLine, true /*ordered*/, &pool)) &&
+        (expectedLine == abortEnd);
+    CPPUNIT_ASSERT(ok);
+
+    // Small text is iterated by the calling thread.
+    DelimitedTxt txt0(SAMPLE0, sizeof(SAMPLE0) - 1, false /*makeCopy*/, NEW_LINE);
+    expectedLine = SAMPLE0;
+    ok = txt0.applyParallel(cb1f, &expectedLine, false /*ordered*/, &pool) &&
+        (expectedLine == SAMPLE0 + sizeof(SAMPLE0) - 1);
+    CPPUNIT_ASSERT(ok);
+
+    delete[] s;
+}
+
+
 void DelimitedTxtSuite::testCount00()
 {
     DelimitedTxt txt0(SAMPLE0, sizeof(SAMPLE0) - 1, false /*makeCopy*/, NEW_LINE);
@@ -511,6 +634,54 @@ void DelimitedTxtSuite::testNext02()
 }
 
 
+//
+// Iterate some long text both ways.
+//
+void DelimitedTxtSuite::testNext03()
+{
+    size_t txtSize;
+    size_t numLines;
+    char* s = formLongTxt(txtSize, numLines);
+    DelimitedTxt txt(s, txtSize, false /*makeCopy*/, NEW_LINE);
+    bool ok = (txt.countLines() == numLines);
+    CPPUNIT_ASSERT(ok);
+
+    const char* expectedLine = s;
+    const char* line;
+    size_t length;
+    size_t n = 0;
+    for (; txt.next(line, length); ++n)
+    {
+        if ((line != expectedLine) || (line[length - 1] != ((n < numLines - 1)? NEW_LINE: 'z')))
+        {
+            break;
+        }
+        expectedLine += length;
+    }
+    ok = (n == numLines) && (expectedLine == s + txtSize);
+    CPPUNIT_ASSERT(ok);
+
+    txt.reset();
+    for (n = 0; txt.peekUp(line, length) && (line == expectedLine - length); ++n)
+    {
+        txt.prev(line, length);
+        expectedLine -= length;
+        if ((line != expectedLine) || ((line > s) && (line[-1] != NEW_LINE)))
+        {
+            break;
+        }
+    }
+    ok = (n == numLines) && (expectedLine == s);
+    CPPUNIT_ASSERT(ok);
+
+    expectedLine = s;
+    ok = txt.applyLoToHi(cb1f, &expectedLine) && (expectedLine == s + txtSize);
+    CPPUNIT_ASSERT(ok);
+
+    delete[] s;
+}
+
+
 void DelimitedTxtSuite::testOp00()
 {
     DelimitedTxt txt0(SAMPLE0, sizeof(SAMPLE0) - 1, false /*makeCopy*/, NEW_LINE);
@@ -21,6 +21,7 @@ private:
     CPPUNIT_TEST(testApply01);
     CPPUNIT_TEST(testApply03);
     CPPUNIT_TEST(testApply04);
+    CPPUNIT_TEST(testApply05);
     CPPUNIT_TEST(testCount00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
@@ -28,6 +29,7 @@ private:
     CPPUNIT_TEST(testNext00);
     CPPUNIT_TEST(testNext01);
     CPPUNIT_TEST(testNext02);
+    CPPUNIT_TEST(testNext03);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testPeek00);
     CPPUNIT_TEST(testPeek01);
@@ -48,6 +50,7 @@ private:
     void testApply01();
     void testApply03();
     void testApply04();
+    void testApply05();
     void testCount00();
     void testCtor00();
     void testCtor01();
@@ -55,6 +58,7 @@ private:
     void testNext00();
     void testNext01();
     void testNext02();
+    void testNext03();
     void testOp00();
     void testPeek00();
     void testPeek01();
@@ -76,12 +80,16 @@ private:
     static bool cb1b(void*, const char*, size_t);
     static bool cb1c(void*, const char*, size_t);
     static bool cb1d(void*, const char*, size_t);
+    static bool cb1e(void*, const char*, size_t);
+    static bool cb1f(void*, const char*, size_t);
     static void cb3a(void*, const appkit::String&);
     static void cb3b(void*, const appkit::String&);
     static void cb4a(void*, const char*, size_t);
     static void cb4b(void*, const char*, size_t);
+    static void cb4c(void*, const char*, size_t);
 
     static appkit::String formExpectedLine(size_t);
+    static char* formLongTxt(size_t&, size_t&);
 
 };
 
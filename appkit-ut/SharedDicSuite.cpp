@@ -0,0 +1,219 @@
+#include "appkit/SharedDic.hpp"
+#include "appkit/StringDic.hpp"
+#include "syskit/Epoch.hpp"
+#include "syskit/Thread.hpp"
+
+#include "appkit-ut-pch.h"
+#include "SharedDicSuite.hpp"
+
+using namespace appkit;
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    SharedDic* dic;
+    unsigned int numReads;
+    unsigned int numUpdates;
+} stress_t;
+
+END_NAMESPACE
+
+
+SharedDicSuite::SharedDicSuite()
+{
+}
+
+
+SharedDicSuite::~SharedDicSuite()
+{
+}
+
+
+//
+// Update callback. Bump both values. A consistent snapshot has equal values,
+// and the values equal the snapshot version.
+//
+bool SharedDicSuite::bumpKv(void* /*arg*/, StringDic& dic)
+{
+    unsigned int v = dic.getValueAsU32("a") + 1;
+    dic.associate("a", v);
+    dic.associate("b", v);
+    return true;
+}
+
+
+//
+// Update callback. Modify the private copy, then abandon the update.
+//
+bool SharedDicSuite::rejectKv(void* /*arg*/, StringDic& dic)
+{
+    dic.reset();
+    return false;
+}
+
+
+//
+// Reader. Take snapshots and validate them.
+//
+void* SharedDicSuite::entry00(void* arg)
+{
+    stress_t* stress = static_cast<stress_t*>(arg);
+    bool ok = true;
+    unsigned long long lastVersion = 0;
+    for (unsigned int i = 0; i < stress->numReads; ++i)
+    {
+        SharedDic::Snapshot snapshot(*stress->dic);
+        if ((i & 63) == 0)
+        {
+            Thread::yield(); //let the writer publish
+        }
+        unsigned int a = snapshot->getValueAsU32("a");
+        unsigned int b = snapshot->getValueAsU32("b");
+        if ((a != b) || (a != snapshot.version()) || (snapshot.version() < lastVersion))
+        {
+            ok = false;
+            break;
+        }
+        lastVersion = snapshot.version();
+    }
+
+    Epoch::instance().detach();
+    return ok? stress: 0;
+}
+
+
+//
+// Writer. Publish updates.
+//
+void* SharedDicSuite::entry01(void* arg)
+{
+    stress_t* stress = static_cast<stress_t*>(arg);
+    for (unsigned int i = 0; i < stress->numUpdates; ++i)
+    {
+        stress->dic->update(bumpKv);
+    }
+
+    Epoch::instance().detach();
+    return stress;
+}
+
+
+void SharedDicSuite::testCtor00()
+{
+    Epoch epoch;
+    SharedDic dic0(true /*ignoreCase*/, &epoch);
+    SharedDic::Snapshot snapshot0(dic0);
+    bool ok = (snapshot0->numKvPairs() == 0) && snapshot0->ignoreCase() && (snapshot0.version() == 0) && (dic0.version() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    StringDic dic;
+    dic.add("k0", "v0");
+    dic.add("k1", "v1");
+    SharedDic dic1(dic, &epoch);
+    SharedDic::Snapshot snapshot1(dic1);
+    ok = (*snapshot1 == dic) && (&snapshot1.dic() != &dic) && (!snapshot1->ignoreCase()) && (snapshot1.version() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Default reclamation domain.
+    SharedDic dic2(dic);
+    SharedDic::Snapshot snapshot2(dic2);
+    ok = (*snapshot2 == dic);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Published dictionaries must not disturb existing snapshots.
+//
+void SharedDicSuite::testPublish00()
+{
+    Epoch epoch;
+    StringDic dic;
+    dic.add("k0", "v0");
+    SharedDic* shared = new SharedDic(dic, &epoch);
+    SharedDic::Snapshot snapshot0(*shared);
+
+    StringDic newDic;
+    newDic.add("k1", "v1");
+    shared->publish(&newDic);
+    SharedDic::Snapshot snapshot1(*shared);
+    bool ok = (newDic.numKvPairs() == 0) && (shared->version() == 1) && (snapshot1.version() == 1) &&
+        (snapshot1->numKvPairs() == 1) && snapshot1->contains("k1", "v1");
+    CPPUNIT_ASSERT(ok);
+
+    // The replaced dictionary persists while snapshot0 holds it.
+    ok = (epoch.numReclaimed() == 1) && (snapshot0.version() == 0) && (*snapshot0 == dic);
+    CPPUNIT_ASSERT(ok);
+
+    dic.add("k2", "v2");
+    shared->publish(dic);
+    SharedDic::Snapshot snapshot2(snapshot1);
+    SharedDic::Snapshot snapshot3(*shared);
+    ok = (dic.numKvPairs() == 2) && (snapshot2.version() == 1) && (&*snapshot2 == &*snapshot1) &&
+        (snapshot3.version() == 2) && (*snapshot3 == dic);
+    CPPUNIT_ASSERT(ok);
+
+    // Snapshots outlive the shared dictionary.
+    delete shared;
+    ok = (epoch.numReclaimed() == 2) && snapshot3->contains("k2", "v2") && snapshot1->contains("k1", "v1");
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Lock-free readers must always see consistent snapshots while a writer updates.
+//
+void SharedDicSuite::testStress00()
+{
+    StringDic dic;
+    dic.associate("a", 0U);
+    dic.associate("b", 0U);
+    SharedDic shared(dic);
+    stress_t stress = {&shared, 20000, 2000};
+
+    enum
+    {
+        NumReaders = 4
+    };
+    Thread* thread[NumReaders + 1];
+    for (unsigned int i = 0; i <= NumReaders; ++i)
+    {
+        thread[i] = new Thread((i < NumReaders)? entry00: entry01, &stress);
+    }
+
+    bool ok = true;
+    for (unsigned int i = 0; i <= NumReaders; ++i)
+    {
+        void* exitCode = 0;
+        thread[i]->waitTilDone(&exitCode);
+        if (exitCode != &stress)
+        {
+            ok = false;
+        }
+        delete thread[i];
+    }
+    CPPUNIT_ASSERT(ok);
+
+    SharedDic::Snapshot snapshot(shared);
+    ok = (snapshot.version() == stress.numUpdates) && (snapshot->getValueAsU32("b") == stress.numUpdates);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void SharedDicSuite::testUpdate00()
+{
+    Epoch epoch;
+    SharedDic shared(false /*ignoreCase*/, &epoch);
+    bool ok = shared.update(bumpKv) && shared.update(bumpKv) && (shared.version() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    SharedDic::Snapshot snapshot0(shared);
+    ok = (!shared.update(rejectKv)) && (shared.version() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    SharedDic::Snapshot snapshot1(shared);
+    ok = (&*snapshot1 == &*snapshot0) && (snapshot1->getValueAsU32("a") == 2) && (snapshot1->getValueAsU32("b") == 2);
+    CPPUNIT_ASSERT(ok);
+}
@@ -0,0 +1,41 @@
+#ifndef SHARED_DIC_SUITE_HPP
+#define SHARED_DIC_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "syskit/macros.h"
+
+DECLARE_CLASS1(appkit, StringDic)
+
+
+class SharedDicSuite: public CppUnit::TestFixture
+{
+
+public:
+    SharedDicSuite();
+
+    virtual ~SharedDicSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(SharedDicSuite);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testPublish00);
+    CPPUNIT_TEST(testStress00);
+    CPPUNIT_TEST(testUpdate00);
+    CPPUNIT_TEST_SUITE_END();
+
+    SharedDicSuite(const SharedDicSuite&); //prohibit usage
+    const SharedDicSuite& operator =(const SharedDicSuite&); //prohibit usage
+
+    void testCtor00();
+    void testPublish00();
+    void testStress00();
+    void testUpdate00();
+
+    static bool bumpKv(void*, appkit::StringDic&);
+    static bool rejectKv(void*, appkit::StringDic&);
+    static void* entry00(void*);
+    static void* entry01(void*);
+
+};
+
+#endif
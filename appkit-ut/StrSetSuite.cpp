@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <string.h>
+#include "appkit/Str.hpp"
+#include "appkit/StrSet.hpp"
+#include "appkit/String.hpp"
+#include "appkit/StringVec.hpp"
+#include "appkit/TempDir.hpp"
+#include "appkit/TempFile.hpp"
+#include "syskit/Bst.hpp"
+#include "syskit/MappedFile.hpp"
+
+#include "appkit-ut-pch.h"
+#include "StrSetSuite.hpp"
+
+using namespace appkit;
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+const char* const HOSTS[] =
+{
+    "www.example.com",
+    "mail.example.com",
+    "www.example.org",
+    "ftp.example.com",
+    "www.example.com",
+    "www.example.co",
+    "www.example.com.au",
+    "example.com",
+    "",
+    "www.example.net"
+};
+
+const size_t NUM_HOSTS = sizeof(HOSTS) / sizeof(HOSTS[0]);
+
+// Same strings as HOSTS in ascending order without duplicates.
+const char* const SORTED_HOSTS[] =
+{
+    "",
+    "example.com",
+    "ftp.example.com",
+    "mail.example.com",
+    "www.example.co",
+    "www.example.com",
+    "www.example.com.au",
+    "www.example.net",
+    "www.example.org"
+};
+
+const size_t NUM_SORTED_HOSTS = sizeof(SORTED_HOSTS) / sizeof(SORTED_HOSTS[0]);
+
+END_NAMESPACE
+
+
+StrSetSuite::StrSetSuite()
+{
+}
+
+
+StrSetSuite::~StrSetSuite()
+{
+}
+
+
+bool StrSetSuite::collect(void* arg, const char* item, size_t length)
+{
+    StringVec& vec = *static_cast<StringVec*>(arg);
+    bool ok = (strlen(item) == length) && vec.add(item);
+    return ok;
+}
+
+
+bool StrSetSuite::stopAt2(void* arg, const char* /*item*/, size_t /*length*/)
+{
+    unsigned int& numCalls = *static_cast<unsigned int*>(arg);
+    return (++numCalls < 2);
+}
+
+
+//
+// Interfaces under test:
+// - bool StrSet::apply(cb0_t cb, void* arg=0) const;
+// - bool StrSet::applyPrefix(const char* prefix, cb0_t cb, void* arg=0) const;
+//
+void StrSetSuite::testApply00()
+{
+    StringVec vec;
+    for (size_t i = 0; i < NUM_HOSTS; ++i)
+    {
+        vec.add(HOSTS[i]);
+    }
+
+    StrSet set(vec, 2 /*bucketSize*/);
+    StringVec items;
+    bool ok = set.apply(collect, &items) && (items.numItems() == NUM_SORTED_HOSTS);
+    for (size_t i = 0; ok && (i < NUM_SORTED_HOSTS); ++i)
+    {
+        ok = (items[i] == SORTED_HOSTS[i]);
+    }
+    CPPUNIT_ASSERT(ok);
+
+    items.reset();
+    ok = set.applyPrefix("www.example.com", collect, &items) && (items.numItems() == 2) &&
+        (items[0] == "www.example.com") && (items[1] == "www.example.com.au");
+    CPPUNIT_ASSERT(ok);
+
+    items.reset();
+    ok = set.applyPrefix("www.example.c", collect, &items) && (items.numItems() == 3) && (items[0] == "www.example.co");
+    CPPUNIT_ASSERT(ok);
+
+    items.reset();
+    ok = set.applyPrefix("zzz", collect, &items) && items.empty();
+    CPPUNIT_ASSERT(ok);
+
+    unsigned int numCalls = 0;
+    ok = (!set.applyPrefix("", stopAt2, &numCalls)) && (numCalls == 2);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StrSet::StrSet(const StrSet& set);
+// - StrSet::StrSet(const StringVec& vec, unsigned int bucketSize=DefaultBucketSize);
+// - String StrSet::operator [](size_t index) const;
+// - bool StrSet::find(const String& item) const;
+// - bool StrSet::find(const char* item, size_t& foundIndex) const;
+// - unsigned int StrSet::bucketSize() const;
+// - unsigned int StrSet::numItems() const;
+//
+void StrSetSuite::testCtor00()
+{
+    StringVec vec;
+    for (size_t i = 0; i < NUM_HOSTS; ++i)
+    {
+        vec.add(HOSTS[i]);
+    }
+
+    for (unsigned int bucketSize = 0; bucketSize <= NUM_HOSTS; ++bucketSize)
+    {
+        StrSet set(vec, bucketSize);
+        bool ok = set.isOk() && (set.numItems() == NUM_SORTED_HOSTS) && (set.bucketSize() == ((bucketSize == 0)? static_cast<unsigned int>(StrSet::DefaultBucketSize): bucketSize));
+        CPPUNIT_ASSERT(ok);
+        for (size_t i = 0; i < NUM_SORTED_HOSTS; ++i)
+        {
+            size_t foundIndex = NUM_HOSTS;
+            ok = (set[i] == SORTED_HOSTS[i]) && set.find(SORTED_HOSTS[i], foundIndex) && (foundIndex == i) && set.find(String(SORTED_HOSTS[i]));
+            CPPUNIT_ASSERT(ok);
+        }
+
+        StrSet copy(set);
+        ok = copy.isOk() && (copy.imageSize() == set.imageSize()) && (memcmp(copy.image(), set.image(), set.imageSize()) == 0) && copy.find("example.com");
+        CPPUNIT_ASSERT(ok);
+    }
+
+    StringVec empty;
+    StrSet set(empty);
+    size_t foundIndex = 1;
+    bool ok = set.isOk() && (set.numItems() == 0) && (!set.find("", foundIndex)) && (foundIndex == 0);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StrSet::StrSet(const Bst& bst, unsigned int bucketSize=DefaultBucketSize);
+// - size_t StrSet::imageSize() const;
+//
+void StrSetSuite::testCtor01()
+{
+    Bst bst(Str::compareKI, 64 /*capacity*/, -1 /*growBy*/);
+    for (size_t i = 0; i < NUM_HOSTS; ++i)
+    {
+        bst.addIfNotFound(const_cast<char*>(HOSTS[i]));
+    }
+
+    StrSet set(bst);
+    bool ok = set.isOk() && (set.numItems() == NUM_SORTED_HOSTS);
+    for (size_t i = 0; ok && (i < NUM_SORTED_HOSTS); ++i)
+    {
+        ok = (set[i] == SORTED_HOSTS[i]);
+    }
+    CPPUNIT_ASSERT(ok);
+
+    // Front coding should beat storing the strings back to back.
+    size_t rawSize = 0;
+    for (size_t i = 0; i < NUM_SORTED_HOSTS; ++i)
+    {
+        rawSize += strlen(SORTED_HOSTS[i]) + 1;
+    }
+    StrSet set1(bst, 64 /*bucketSize*/);
+    ok = (set1.imageSize() < rawSize);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - bool StrSet::find(const char* item) const;
+// - bool StrSet::find(const char* item, size_t& foundIndex) const;
+//
+void StrSetSuite::testFind00()
+{
+
+    // Generate sorted paths with long common prefixes.
+    StringVec vec(4096 /*capacity*/, -1 /*growBy*/);
+    char item[64];
+    for (unsigned int i = 0; i < 400; ++i)
+    {
+        sprintf(item, "/usr/share/doc/pkg%03u/file%u", i / 7, i % 7);
+        vec.add(item);
+        sprintf(item, "/usr/share/doc/pkg%03u", i / 7);
+        vec.add(item);
+    }
+    StrSet set(vec, 5 /*bucketSize*/);
+    bool ok = (set.numItems() == 400 + (399 / 7 + 1));
+    CPPUNIT_ASSERT(ok);
+
+    // Every item is found at its rank, and near misses are not found but
+    // get the number of lesser items.
+    StringVec items(set.numItems(), 0 /*growBy*/);
+    for (size_t i = 0, numItems = set.numItems(); i < numItems; ++i)
+    {
+        items.add(set[i]);
+        ok = (i == 0) || (strcmp(items[i - 1].ascii(), items[i].ascii()) < 0);
+        CPPUNIT_ASSERT(ok);
+    }
+    for (size_t i = 0, numItems = set.numItems(); i < numItems; ++i)
+    {
+        const String& s = items.peek(i);
+        size_t foundIndex = numItems;
+        ok = set.find(s.ascii(), foundIndex) && (foundIndex == i);
+        CPPUNIT_ASSERT(ok);
+
+        String miss[3] = {s, s, s};
+        miss[0].truncate(s.length() - 1);
+        miss[1].setAscii(s.length() - 1, '0');
+        miss[2] += "0";
+        for (size_t j = 0; j < 3; ++j)
+        {
+            size_t numLesserItems = 0;
+            for (; (numLesserItems < numItems) && (strcmp(items[numLesserItems].ascii(), miss[j].ascii()) < 0); ++numLesserItems);
+            bool found = (numLesserItems < numItems) && (items[numLesserItems] == miss[j]);
+            ok = (set.find(miss[j].ascii(), foundIndex) == found) && (foundIndex == numLesserItems);
+            CPPUNIT_ASSERT(ok);
+        }
+    }
+
+    size_t foundIndex;
+    ok = (!set.find("", foundIndex)) && (foundIndex == 0) && (!set.find("~", foundIndex)) && (foundIndex == set.numItems());
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - bool StrSet::findPrefix(const char* prefix, size_t& startAt, size_t& itemCount) const;
+//
+void StrSetSuite::testFindPrefix00()
+{
+    Bst bst(Str::compareK, 64 /*capacity*/, -1 /*growBy*/);
+    for (size_t i = 0; i < NUM_HOSTS; ++i)
+    {
+        bst.addIfNotFound(const_cast<char*>(HOSTS[i]));
+    }
+    bst.add(const_cast<char*>("www.example.\xff"));
+    bst.add(const_cast<char*>("www.example.\xff\xff"));
+    bst.add(const_cast<char*>("www.examplf"));
+
+    StrSet set(bst, 3 /*bucketSize*/);
+    size_t startAt;
+    size_t itemCount;
+    bool ok = set.findPrefix("www.", startAt, itemCount) && (startAt == 4) && (itemCount == 8);
+    CPPUNIT_ASSERT(ok);
+    ok = set.findPrefix("www.example.com", startAt, itemCount) && (startAt == 5) && (itemCount == 2);
+    CPPUNIT_ASSERT(ok);
+    ok = set.findPrefix("www.example.\xff", startAt, itemCount) && (startAt == 9) && (itemCount == 2);
+    CPPUNIT_ASSERT(ok);
+    ok = set.findPrefix("", startAt, itemCount) && (startAt == 0) && (itemCount == set.numItems());
+    CPPUNIT_ASSERT(ok);
+    ok = (!set.findPrefix("www.example.a", startAt, itemCount)) && (startAt == 4) && (itemCount == 0);
+    CPPUNIT_ASSERT(ok);
+    ok = (!set.findPrefix("zzz", startAt, itemCount)) && (startAt == set.numItems()) && (itemCount == 0);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StrSet::StrSet(const unsigned char* image, size_t imageSize, bool makeCopy=false);
+// - bool StrSet::isOk() const;
+// - bool StrSet::saveIn(const wchar_t* path) const;
+// - const unsigned char* StrSet::image(size_t& imageSize) const;
+//
+void StrSetSuite::testSaveIn00()
+{
+    StringVec vec;
+    for (size_t i = 0; i < NUM_HOSTS; ++i)
+    {
+        vec.add(HOSTS[i]);
+    }
+
+    StrSet set(vec, 4 /*bucketSize*/);
+    TempDir tempDir;
+    TempFile tempFile(tempDir, "hosts.fcs");
+    bool ok = set.saveIn(tempFile.path().widen());
+    CPPUNIT_ASSERT(ok);
+
+    MappedFile file(tempFile.path().widen());
+    size_t imageSize = 0;
+    const unsigned char* image = set.image(imageSize);
+    ok = file.isOk() && (file.size() == imageSize) && (memcmp(file.map(), image, imageSize) == 0);
+    CPPUNIT_ASSERT(ok);
+
+    StrSet saved(file.map(), static_cast<size_t>(file.size()));
+    ok = saved.isOk() && (saved.image() == file.map()) && (saved.numItems() == NUM_SORTED_HOSTS) && (saved.bucketSize() == 4);
+    CPPUNIT_ASSERT(ok);
+    for (size_t i = 0; i < NUM_SORTED_HOSTS; ++i)
+    {
+        size_t foundIndex;
+        ok = saved.find(SORTED_HOSTS[i], foundIndex) && (foundIndex == i);
+        CPPUNIT_ASSERT(ok);
+    }
+
+    bool makeCopy = true;
+    StrSet copy(image, imageSize, makeCopy);
+    ok = copy.isOk() && (copy.image() != image) && copy.find("www.example.net");
+    CPPUNIT_ASSERT(ok);
+
+    // Invalid images.
+    StrSet bad0(image, imageSize - 1);
+    StrSet bad1(image, 3);
+    ok = (!bad0.isOk()) && (bad0.numItems() == 0) && (!bad0.find("example.com")) && (!bad1.isOk()) && (!bad1.saveIn(tempFile.path().widen()));
+    CPPUNIT_ASSERT(ok);
+}
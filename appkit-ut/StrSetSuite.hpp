@@ -0,0 +1,41 @@
+#ifndef STR_SET_SUITE_HPP
+#define STR_SET_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "syskit/macros.h"
+
+
+class StrSetSuite: public CppUnit::TestFixture
+{
+
+public:
+    StrSetSuite();
+
+    virtual ~StrSetSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(StrSetSuite);
+    CPPUNIT_TEST(testApply00);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testCtor01);
+    CPPUNIT_TEST(testFind00);
+    CPPUNIT_TEST(testFindPrefix00);
+    CPPUNIT_TEST(testSaveIn00);
+    CPPUNIT_TEST_SUITE_END();
+
+    StrSetSuite(const StrSetSuite&); //prohibit usage
+    const StrSetSuite& operator =(const StrSetSuite&); //prohibit usage
+
+    void testApply00();
+    void testCtor00();
+    void testCtor01();
+    void testFind00();
+    void testFindPrefix00();
+    void testSaveIn00();
+
+    static bool collect(void*, const char*, size_t);
+    static bool stopAt2(void*, const char*, size_t);
+
+};
+
+#endif
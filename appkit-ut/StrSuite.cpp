@@ -1,3 +1,4 @@
+#include <string.h>
 #include "appkit/Str.hpp"
 #include "appkit/String.hpp"
 
@@ -137,6 +138,120 @@ void StrSuite::testCompare02()
 }
 
 
+//
+// Interfaces under test:
+// - int Str::compareKI(const void* item0, const void* item1);
+// - int Str::compareKIN(const char* item0, const char* item1, size_t n);
+//
+void StrSuite::testCompare03()
+{
+
+    // Long keys differing at various offsets. Characters just outside the
+    // capital and small letter ranges must not be folded.
+    char item0[80];
+    char item1[80];
+    const char* s0 = "The Quick Brown Fox @[`{ Jumps Over The Lazy Dog \xc0\xdf\xe0 0123456789";
+    const char* s1 = "tHE qUICK bROWN fOX @[`{ jUMPS oVER tHE lAZY dOG \xc0\xdf\xe0 0123456789";
+    strcpy(item0, s0);
+    strcpy(item1, s1);
+    size_t length = strlen(item0);
+    bool ok = (Str::compareKI(item0, item1) == 0) && (Str::compareKIN(item0, item1, length + 9) == 0);
+    CPPUNIT_ASSERT(ok);
+    char folded0[80];
+    char folded1[80];
+    for (size_t i = 0; i < length; ++i)
+    {
+        const char c[] = "@[`{";
+        for (size_t j = 0; c[j] != 0; ++j)
+        {
+            strcpy(item1, s1);
+            item1[i] = c[j];
+            for (size_t k = 0; k <= length; ++k)
+            {
+                folded0[k] = ((item0[k] >= 'A') && (item0[k] <= 'Z'))? (item0[k] - 'A' + 'a'): item0[k];
+                folded1[k] = ((item1[k] >= 'A') && (item1[k] <= 'Z'))? (item1[k] - 'A' + 'a'): item1[k];
+            }
+            int rc = strcmp(folded0, folded1);
+            int rc0 = Str::compareKI(item0, item1);
+            int rc1 = Str::compareKIN(item0, item1, length);
+            if (((rc0 < 0) != (rc < 0)) || ((rc0 > 0) != (rc > 0)) || ((rc1 < 0) != (rc < 0)) || ((rc1 > 0) != (rc > 0)))
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    // Keys ending right before a page boundary.
+    char* buf = new char[8192 + 4096];
+    char* page = reinterpret_cast<char*>((reinterpret_cast<size_t>(buf) + 4095U) & ~static_cast<size_t>(4095U));
+    char* k0 = page + 4096 - 20;
+    char* k1 = page + 8192 - 20;
+    strcpy(k0, "0123456789ABCDEFXYZ");
+    strcpy(k1, "0123456789abcdefxyz");
+    ok = (Str::compareKI(k0, k1) == 0) && (Str::compareKI(k0 + 5, k1 + 5) == 0) && (Str::compareKIN(k0, k1, 99) == 0);
+    CPPUNIT_ASSERT(ok);
+    delete[] buf;
+}
+
+
+//
+// Interfaces under test:
+// - const char* Str::find(const char* s, size_t length, const char* k, size_t kLength);
+// - const char* Str::findI(const char* s, size_t length, const char* k, size_t kLength);
+// - const char* Str::rfind(const char* s, size_t length, const char* k, size_t kLength);
+//
+void StrSuite::testFind00()
+{
+
+    // Place the key at every offset of a haystack long enough to
+    // exercise both the vectorized and the scalar code paths.
+    char s[64 + 1];
+    const char key[] = "xYz";
+    const char keyI[] = "XyZ";
+    bool ok = true;
+    for (size_t i = 0, length = sizeof(s) - 1; i + sizeof(key) - 1 <= length; ++i)
+    {
+        memset(s, 'x', length);
+        s[length] = 0;
+        memcpy(s + i, key, sizeof(key) - 1);
+        if ((Str::find(s, length, key, sizeof(key) - 1) != s + i) ||
+            (Str::findI(s, length, keyI, sizeof(keyI) - 1) != s + i) ||
+            (Str::rfind(s, length, key, sizeof(key) - 1) != s + i) ||
+            (Str::find(s, length, keyI, sizeof(keyI) - 1) != 0))
+        {
+            ok = false;
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    // Multiple hits. Partial hits must not hide later ones.
+    const char* s1 = "aaabaaabaaabaaabaaabaaabaaabaaab";
+    size_t length1 = strlen(s1);
+    ok = (Str::find(s1, length1, "aab", 3) == s1 + 1) &&
+        (Str::rfind(s1, length1, "aab", 3) == s1 + length1 - 3) &&
+        (Str::findI(s1, length1, "AAB", 3) == s1 + 1) &&
+        (Str::rfind(s1, length1, "aaa", 3) == s1 + length1 - 4);
+    CPPUNIT_ASSERT(ok);
+
+    // Empty keys and keys longer than the haystack.
+    ok = (Str::find(s1, length1, "", 0) == s1) &&
+        (Str::findI(s1, length1, "", 0) == s1) &&
+        (Str::rfind(s1, length1, "", 0) == s1 + length1) &&
+        (Str::find(s1, 3, "aab", 3) == 0) &&
+        (Str::rfind(s1, 2, "aa", 3) == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Embedded nulls are ordinary bytes.
+    const char s2[] = "ab\0cd\0ab\0cd";
+    ok = (Str::find(s2, sizeof(s2) - 1, "\0cd", 3) == s2 + 2) &&
+        (Str::rfind(s2, sizeof(s2) - 1, "\0cd", 3) == s2 + 8);
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void StrSuite::testStrcasestr00()
 {
     const char* haystack = "HaystackHaystackNeedleHaystack";
@@ -159,6 +274,17 @@ void StrSuite::testStrcasestr00()
     found = appkit::strcasestr(haystack, "haystackhaystackneedle");
     ok = (found == haystack);
     CPPUNIT_ASSERT(ok);
+
+    found = appkit::strcasestr("aaAB", "aab");
+    ok = (found != 0) && (strcmp(found, "aAB") == 0);
+    CPPUNIT_ASSERT(ok);
+    found = appkit::strcasestr("xaAB", "aB");
+    ok = (found != 0) && (strcmp(found, "AB") == 0);
+    CPPUNIT_ASSERT(ok);
+
+    found = appkit::strcasestr(haystack, "");
+    ok = (found == haystack);
+    CPPUNIT_ASSERT(ok);
 }
 
 
@@ -17,6 +17,8 @@ private:
     CPPUNIT_TEST(testCompare00);
     CPPUNIT_TEST(testCompare01);
     CPPUNIT_TEST(testCompare02);
+    CPPUNIT_TEST(testCompare03);
+    CPPUNIT_TEST(testFind00);
     CPPUNIT_TEST(testStrcasestr00);
     CPPUNIT_TEST(testStripSpace00);
     CPPUNIT_TEST(testStripSpace01);
@@ -31,6 +33,8 @@ private:
     void testCompare00();
     void testCompare01();
     void testCompare02();
+    void testCompare03();
+    void testFind00();
     void testStrcasestr00();
     void testStripSpace00();
     void testStripSpace01();
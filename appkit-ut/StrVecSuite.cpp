@@ -0,0 +1,270 @@
+#include <string.h>
+#include "appkit/DelimitedTxt.hpp"
+#include "appkit/Str.hpp"
+#include "appkit/StrVec.hpp"
+#include "appkit/String.hpp"
+#include "appkit/StringVec.hpp"
+#include "appkit/Tokenizer.hpp"
+
+#include "appkit-ut-pch.h"
+#include "StrVecSuite.hpp"
+
+using namespace appkit;
+using namespace syskit;
+
+
+StrVecSuite::StrVecSuite()
+{
+}
+
+
+StrVecSuite::~StrVecSuite()
+{
+}
+
+
+//
+// Interfaces under test:
+// - String StrVec::operator [](size_t index) const;
+// - bool StrVec::add(const String& item);
+// - bool StrVec::add(const char* item);
+// - bool StrVec::add(const char* item, size_t length);
+// - const char* StrVec::peek(size_t index) const;
+// - const char* StrVec::peek(size_t index, size_t& length) const;
+// - size_t StrVec::byteSize() const;
+//
+void StrVecSuite::testAdd00()
+{
+    StrVec vec;
+    bool ok = vec.empty() && (vec.numItems() == 0) && (vec.byteSize() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    String vn;
+    vn.reset8(reinterpret_cast<const utf8_t*>("\xe1\xba\xa0"), 3); //3-byte character
+    ok = vec.add("abc") && vec.add("defxyz", 3) && vec.add(vn) && vec.add("", 0);
+    CPPUNIT_ASSERT(ok);
+    ok = (!vec.empty()) && (vec.numItems() == 4) && (vec.byteSize() == (4 + 3 + 1) * 3 + (4 + 0 + 1));
+    CPPUNIT_ASSERT(ok);
+
+    size_t length;
+    ok = (strcmp(vec.peek(0, length), "abc") == 0) && (length == 3) &&
+        (strcmp(vec.peek(1, length), "def") == 0) && (length == 3) &&
+        (strcmp(vec.peek(2, length), "\xe1\xba\xa0") == 0) && (length == 3) &&
+        (strcmp(vec.peek(3, length), "") == 0) && (length == 0);
+    CPPUNIT_ASSERT(ok);
+
+    ok = (vec[0] == "abc") && (vec[1] == "def") && (vec[2] == vn) && (vec[2].length() == 1) && (vec[3].empty());
+    CPPUNIT_ASSERT(ok);
+
+    // Adding an item residing in the vector itself must survive growth.
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        if (!vec.add(vec.peek(0)))
+        {
+            ok = false;
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+    ok = (vec.numItems() == 1004) && (strcmp(vec.peek(1003), "abc") == 0);
+    CPPUNIT_ASSERT(ok);
+
+    vec.reset();
+    ok = vec.empty() && (vec.byteSize() == 0) && vec.add("x") && (strcmp(vec.peek(0), "x") == 0);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - bool StrVec::add(const char* item, size_t length);
+// - bool StrVec::resize(unsigned int newCap);
+// - unsigned int StrVec::add(const StringVec& vec);
+//
+void StrVecSuite::testAdd01()
+{
+
+    // Non-growable vector.
+    StrVec vec(2 /*capacity*/, 0 /*growBy*/);
+    bool ok = vec.add("a") && vec.add("b") && (!vec.add("c")) && (vec.numItems() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    // The packed buffer does not grow either.
+    char item[2 * StrVec::AvgItemSize + 1];
+    memset(item, 'z', sizeof(item));
+    StrVec vec1(2 /*capacity*/, 0 /*growBy*/);
+    ok = (!vec1.add(item, sizeof(item))) && vec1.empty();
+    CPPUNIT_ASSERT(ok);
+
+    ok = vec.resize(3) && (vec.capacity() == 3) && vec.add("c") && (!vec.resize(2));
+    CPPUNIT_ASSERT(ok);
+
+    StringVec classic;
+    classic.add("0");
+    classic.add("1");
+    classic.add("2");
+    StrVec vec2(1 /*capacity*/, 0 /*growBy*/);
+    ok = (vec2.add(classic) == 1) && (vec2[0] == "0");
+    CPPUNIT_ASSERT(ok);
+    vec2.setGrowth(-1);
+    ok = (vec2.add(classic) == 3) && (vec2.numItems() == 4) && (vec2[3] == "2");
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StrVec::StrVec(const StrVec& vec);
+// - StrVec::StrVec(const StringVec& vec, bool ignoreCase=false);
+// - StrVec::StrVec(unsigned int capacity=DefaultCap, int growBy=-1, bool ignoreCase=false);
+// - bool StrVec::operator !=(const StrVec& vec) const;
+// - bool StrVec::operator ==(const StrVec& vec) const;
+// - const StrVec& StrVec::operator =(const StrVec& vec);
+// - bool StrVec::find(const String& item, size_t& foundIndex) const;
+// - bool StrVec::find(const char* item) const;
+//
+void StrVecSuite::testCtor00()
+{
+    StrVec vec0(1 /*capacity*/, -1 /*growBy*/);
+    vec0.add("one");
+    vec0.add("two");
+    vec0.add("three");
+
+    StrVec vec1(vec0);
+    bool ok = (vec1 == vec0) && (vec1.numItems() == 3) && (vec1.capacity() == vec0.capacity()) && (vec1.byteSize() == vec0.byteSize());
+    CPPUNIT_ASSERT(ok);
+
+    vec1.add("four");
+    ok = (vec1 != vec0);
+    CPPUNIT_ASSERT(ok);
+    vec1 = vec0;
+    ok = (vec1 == vec0) && (!vec1.find("four"));
+    CPPUNIT_ASSERT(ok);
+
+    size_t foundIndex = 0;
+    ok = vec1.find(String("three"), foundIndex) && (foundIndex == 2) && (!vec1.find("Three"));
+    CPPUNIT_ASSERT(ok);
+
+    StringVec classic;
+    classic.add("one");
+    classic.add("two");
+    classic.add("three");
+    StrVec vec2(classic, true /*ignoreCase*/);
+    ok = (vec2 == vec0) && (vec2.byteSize() == vec0.byteSize()) && vec2.find("Three", foundIndex) && (foundIndex == 2);
+    CPPUNIT_ASSERT(ok);
+
+    StrVec vec3;
+    vec3.add("one");
+    vec3.add("two");
+    vec3.add("3");
+    ok = (vec3 != vec0);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StrVec::StrVec(DelimitedTxt& txt, bool trimLines=true, unsigned int capacity=DefaultCap, int growBy=-1, bool ignoreCase=false);
+// - bool StrVec::reset(DelimitedTxt& txt, bool trimLines=true);
+// - bool StrVec::vectorize(StringVec& vec) const;
+//
+void StrVecSuite::testCtor01()
+{
+    const char* s = "1\r\n" "22\r\n" "\r\n" "4444";
+    DelimitedTxt txt(s, strlen(s), false /*makeCopy*/);
+    StrVec vec(txt);
+    bool ok = (vec.numItems() == 4) && (vec[0] == "1") && (vec[1] == "22") && (vec[2].empty()) && (vec[3] == "4444");
+    CPPUNIT_ASSERT(ok);
+    ok = (vec.byteSize() <= txt.txtSize() + txt.countLines() * 5);
+    CPPUNIT_ASSERT(ok);
+
+    bool trimLines = false;
+    ok = vec.reset(txt, trimLines) && (vec.numItems() == 4) && (vec[0] == "1\r\n") && (vec[3] == "4444");
+    CPPUNIT_ASSERT(ok);
+
+    StringVec classic(txt, trimLines);
+    StringVec converted(1 /*capacity*/, 0 /*growBy*/);
+    ok = (!vec.vectorize(converted)) && (converted.numItems() == 1);
+    CPPUNIT_ASSERT(ok);
+    converted.setGrowth(-1);
+    ok = vec.vectorize(converted) && (converted == classic);
+    CPPUNIT_ASSERT(ok);
+
+    StrVec vec1(txt, true /*trimLines*/, 2 /*capacity*/, 0 /*growBy*/);
+    ok = (vec1.numItems() == 2) && (!vec1.reset(txt)) && (vec1.numItems() == 2);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - bool StrVec::search(compare_t compare, const char* item, size_t& foundIndex) const;
+// - bool StrVec::search(const String& item) const;
+// - bool StrVec::search(const char* item, size_t& foundIndex) const;
+// - void StrVec::sort(bool reverseOrder=false);
+// - void StrVec::sort(compare_t compare, bool reverseOrder=false);
+//
+void StrVecSuite::testSort00()
+{
+    const char* s = "pear\n" "Apple\n" "fig\n" "apple\n" "Banana\n";
+    DelimitedTxt txt(s, strlen(s), false /*makeCopy*/);
+    StrVec vec(txt);
+    StrVec copy(vec);
+    vec.sort();
+    bool ok = (vec[0] == "Apple") && (vec[1] == "Banana") && (vec[2] == "apple") && (vec[3] == "fig") && (vec[4] == "pear");
+    CPPUNIT_ASSERT(ok);
+
+    // Sorting permutes the offsets only.
+    ok = (vec.byteSize() == copy.byteSize()) && (vec != copy) && (copy[0] == "pear");
+    CPPUNIT_ASSERT(ok);
+
+    size_t foundIndex = 9;
+    ok = vec.search("apple", foundIndex) && (foundIndex == 2) && vec.search(String("pear")) && (!vec.search("grape"));
+    CPPUNIT_ASSERT(ok);
+
+    bool reverseOrder = true;
+    vec.sort(reverseOrder);
+    ok = (vec[0] == "pear") && (vec[4] == "Apple");
+    CPPUNIT_ASSERT(ok);
+
+    vec.sort(Str::compareKI);
+    size_t length;
+    ok = (strcasecmp(vec.peek(0, length), "apple") == 0) && (length == 5) && (vec[2] == "Banana") && (vec[4] == "pear");
+    ok = ok && vec.search(Str::compareKI, "BANANA", foundIndex) && (foundIndex == 2);
+    CPPUNIT_ASSERT(ok);
+
+    StrVec vec1(txt, true /*trimLines*/, StrVec::DefaultCap, -1 /*growBy*/, true /*ignoreCase*/);
+    vec1.sort();
+    ok = (vec1[2] == "Banana") && vec1.search("FIG", foundIndex) && (foundIndex == 3);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - bool DelimitedTxt::vectorize(StrVec& vec, bool doTrimLine=false, bool reverseOrder=false) const;
+// - bool Tokenizer::vectorize(StrVec& vec) const;
+//
+void StrVecSuite::testVectorize00()
+{
+    const char* s = "1\n" "22\n" "333";
+    DelimitedTxt txt(s, strlen(s), false /*makeCopy*/);
+    StrVec vec;
+    bool ok = txt.vectorize(vec) && (vec.numItems() == 3) && (vec[0] == "1\n") && (vec[2] == "333");
+    CPPUNIT_ASSERT(ok);
+
+    bool doTrimLine = true;
+    bool reverseOrder = true;
+    ok = txt.vectorize(vec, doTrimLine, reverseOrder) && (vec.numItems() == 3) && (vec[0] == "333") && (vec[2] == "1");
+    CPPUNIT_ASSERT(ok);
+
+    StrVec vec1(2 /*capacity*/, 0 /*growBy*/);
+    ok = (!txt.vectorize(vec1, doTrimLine)) && (vec1.numItems() == 2) && (vec1[1] == "22");
+    CPPUNIT_ASSERT(ok);
+
+    Tokenizer tokenizer(" a bb  ccc ");
+    ok = tokenizer.vectorize(vec) && (vec.numItems() == 3) && (vec[0] == "a") && (vec[1] == "bb") && (vec[2] == "ccc");
+    CPPUNIT_ASSERT(ok);
+    ok = (!tokenizer.vectorize(vec1)) && (vec1.numItems() == 2);
+    CPPUNIT_ASSERT(ok);
+}
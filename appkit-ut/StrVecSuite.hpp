@@ -0,0 +1,38 @@
+#ifndef STR_VEC_SUITE_HPP
+#define STR_VEC_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "syskit/macros.h"
+
+
+class StrVecSuite: public CppUnit::TestFixture
+{
+
+public:
+    StrVecSuite();
+
+    virtual ~StrVecSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(StrVecSuite);
+    CPPUNIT_TEST(testAdd00);
+    CPPUNIT_TEST(testAdd01);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testCtor01);
+    CPPUNIT_TEST(testSort00);
+    CPPUNIT_TEST(testVectorize00);
+    CPPUNIT_TEST_SUITE_END();
+
+    StrVecSuite(const StrVecSuite&); //prohibit usage
+    const StrVecSuite& operator =(const StrVecSuite&); //prohibit usage
+
+    void testAdd00();
+    void testAdd01();
+    void testCtor00();
+    void testCtor01();
+    void testSort00();
+    void testVectorize00();
+
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "appkit/String.hpp"
+#include "appkit/StringBuilder.hpp"
+
+#include "appkit-ut-pch.h"
+#include "StringBuilderSuite.hpp"
+
+using namespace appkit;
+using namespace syskit;
+
+
+StringBuilderSuite::StringBuilderSuite()
+{
+}
+
+
+StringBuilderSuite::~StringBuilderSuite()
+{
+}
+
+
+//
+// Interfaces under test:
+// - const StringBuilder& StringBuilder::operator +=(char c);
+// - const StringBuilder& StringBuilder::operator +=(const String& str);
+// - const StringBuilder& StringBuilder::operator +=(const char* s);
+// - String StringBuilder::toString() const;
+// - void StringBuilder::append(const char* s, size_t length);
+// - void StringBuilder::append(const utf8_t* s, size_t numU8s, size_t numChars);
+// - void StringBuilder::append(size_t count, char c);
+//
+void StringBuilderSuite::testAppend00()
+{
+    String vn;
+    vn.reset8(reinterpret_cast<const utf8_t*>("\xe1\xba\xa0"), 3); //3-byte character
+    StringBuilder sb;
+    sb += 'a';
+    sb += "bc";
+    sb += vn;
+    sb.append("\xe9xyz", 2); //8-bit ASCII character
+    sb.append(3, '-');
+    const utf8_t u8[] = {0xf0U, 0x9fU, 0x98U, 0x80U}; //4-byte character
+    sb.append(u8, sizeof(u8), 1);
+    String s(sb.toString());
+    bool ok = (s.length() == 10) && (sb.length() == 10) && (sb.byteSize() == s.byteSize() - 1);
+    CPPUNIT_ASSERT(ok);
+
+    String expected("abc");
+    expected += vn;
+    expected.append("\xe9x", 2);
+    expected.append(3, '-');
+    expected.append(u8, sizeof(u8), 1);
+    ok = (s == expected) && (s.byteSize() == expected.byteSize());
+    CPPUNIT_ASSERT(ok);
+
+    // The builder is not modified.
+    ok = (sb.toString() == s);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Data spanning the inline buffer and multiple chunks must be gathered
+// correctly, including characters split across buffers.
+//
+void StringBuilderSuite::testAppend01()
+{
+    StringBuilder sb;
+    String expected;
+    String piece;
+    piece.reset8(reinterpret_cast<const utf8_t*>("0123456789\xe1\xba\xa0\xc3\xa9"), 15);
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+        sb += piece;
+        expected += piece;
+        if ((i % 1000) == 0)
+        {
+            sb.append(5000, (i & 1000)? 'x': '\xe9');
+            expected.append(5000, (i & 1000)? 'x': '\xe9');
+        }
+    }
+
+    String s(sb.toString());
+    bool ok = (s == expected) && (s.length() == expected.length()) && (sb.length() == expected.length());
+    CPPUNIT_ASSERT(ok);
+
+    // Big single pieces.
+    String big(100000, 'b');
+    sb.reset();
+    sb += 'a';
+    sb += big;
+    sb += 'c';
+    ok = (sb.toString() == (String("a") + big + "c"));
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StringBuilder::StringBuilder();
+// - bool StringBuilder::empty() const;
+// - unsigned int StringBuilder::byteSize() const;
+// - unsigned int StringBuilder::length() const;
+//
+void StringBuilderSuite::testCtor00()
+{
+    StringBuilder sb;
+    bool ok = sb.empty() && (sb.byteSize() == 0) && (sb.length() == 0) && sb.toString().empty();
+    CPPUNIT_ASSERT(ok);
+
+    sb += "";
+    sb.append(0, 'c');
+    ok = sb.empty() && (sb.toString() == "");
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - void StringBuilder::reset();
+//
+void StringBuilderSuite::testReset00()
+{
+    StringBuilder sb;
+    sb.append(StringBuilder::InlineCap * 3, 'x');
+    sb.reset();
+    bool ok = sb.empty() && (sb.byteSize() == 0) && sb.toString().empty();
+    CPPUNIT_ASSERT(ok);
+
+    sb += "abc";
+    ok = (sb.toString() == "abc");
+    CPPUNIT_ASSERT(ok);
+}
@@ -0,0 +1,34 @@
+#ifndef STRING_BUILDER_SUITE_HPP
+#define STRING_BUILDER_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "syskit/macros.h"
+
+
+class StringBuilderSuite: public CppUnit::TestFixture
+{
+
+public:
+    StringBuilderSuite();
+
+    virtual ~StringBuilderSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(StringBuilderSuite);
+    CPPUNIT_TEST(testAppend00);
+    CPPUNIT_TEST(testAppend01);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testReset00);
+    CPPUNIT_TEST_SUITE_END();
+
+    StringBuilderSuite(const StringBuilderSuite&); //prohibit usage
+    const StringBuilderSuite& operator =(const StringBuilderSuite&); //prohibit usage
+
+    void testAppend00();
+    void testAppend01();
+    void testCtor00();
+    void testReset00();
+
+};
+
+#endif
@@ -1,11 +1,17 @@
+#include <stdio.h>
+#include <utility>
+#include "appkit/Atom.hpp"
 #include "appkit/DelimitedTxt.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/StringDic.hpp"
 #include "appkit/StringVec.hpp"
+#include "syskit/TickTime.hpp"
 
 #include "appkit-ut-pch.h"
 #include "StringDicSuite.hpp"
 
 using namespace appkit;
+using namespace syskit;
 
 const char COLON = ':';
 const char COMMA = ',';
@@ -345,6 +351,135 @@ void StringDicSuite::testCtor02()
 }
 
 
+//
+// Interfaces under test:
+// - StringDic::StringDic(bool ignoreCase, bool internKeys);
+// - bool StringDic::internKeys() const;
+//
+void StringDicSuite::testCtor03()
+{
+    bool ignoreCase = false;
+    bool internKeys = true;
+    StringDic dic0(ignoreCase, internKeys);
+    StringDic dic1(ignoreCase, internKeys);
+    String k("StringDicSuite::testCtor03");
+    dic0.associate(k, "v0");
+    dic1.associate(String("StringDicSuite::testCtor03"), "v1");
+    String k0;
+    String k1;
+    String v;
+    dic0.any(k0, v);
+    dic1.any(k1, v);
+    bool ok = dic0.internKeys() && (k0 == k) && (k0.raw() == k1.raw()) && (k0.raw() == Atom(k).asString().raw());
+    CPPUNIT_ASSERT(ok);
+
+    // Copies keep the key mode.
+    StringDic dic2(dic0);
+    ok = dic2.internKeys() && (dic2 == dic0) && (!StringDic().internKeys());
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StringDic::StringDic(bool ignoreCase, bool internKeys, bool hashKeys);
+// - bool StringDic::hashKeys() const;
+//
+void StringDicSuite::testCtor04()
+{
+    bool ignoreCase = true;
+    bool internKeys = false;
+    bool hashKeys = true;
+    StringDic dic0(ignoreCase, internKeys, hashKeys);
+    dic0.add("k2", "v2");
+    dic0.add("K0", "v0");
+    dic0.associate("k1", "v1");
+    bool ok = dic0.hashKeys() && (!dic0.add("K2", "v2")) && (dic0["k0"] == "v0") && (dic0[String("K1")] == "v1");
+    CPPUNIT_ASSERT(ok);
+    ok = (dic0.stringify() == "K0=v0\nk1=v1\nk2=v2\n");
+    CPPUNIT_ASSERT(ok);
+
+    // Removals and resets keep the index in sync.
+    ok = dic0.rm("K1") && (!dic0.contains("k1")) && dic0.add("k1", "v1") && (dic0.getValue("K1") == "v1");
+    CPPUNIT_ASSERT(ok);
+    StringDic dic1(dic0);
+    dic1.reset();
+    ok = dic1.hashKeys() && (!dic1.contains("k0")) && dic1.add("k0", "v0") && dic1.contains("K0");
+    CPPUNIT_ASSERT(ok);
+
+    // Hashed and unhashed dictionaries interoperate.
+    StringDic dic2(ignoreCase);
+    dic2 = dic0;
+    ok = (!dic2.hashKeys()) && (dic2 == dic0) && (dic0 == dic2) && dic0.contains(dic2);
+    CPPUNIT_ASSERT(ok);
+    dic1 = &dic2;
+    ok = (dic1 == dic0) && dic1.contains("K2") && (dic2.numKvPairs() == 0);
+    CPPUNIT_ASSERT(ok);
+    dic0.mergeInto(dic2);
+    ok = (dic0.numKvPairs() == 0) && (!dic0.contains("k0")) && (dic2 == dic1);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - StringDic::StringDic(bool ignoreCase, bool internKeys, bool hashKeys);
+// - bool StringDic::ignoreCase() const;
+//
+void StringDicSuite::testCtor05()
+{
+    String longK("A-Rather-Long-Key-With-Mixed-Case-Characters-");
+    for (int hashKeys = 0; hashKeys <= 1; ++hashKeys)
+    {
+        bool ignoreCase = true;
+        bool internKeys = false;
+        StringDic dic0(ignoreCase, internKeys, hashKeys != 0);
+        dic0.add("bb", "v1");
+        dic0.add("Aa", "v0");
+        dic0.add("cC", "v2");
+        dic0.add(longK, "v3");
+        String k("a-rather-long-key-with-mixed-case-characters-");
+        bool ok = dic0.ignoreCase() && (dic0.stringify() == "A-Rather-Long-Key-With-Mixed-Case-Characters-=v3\nAa=v0\nbb=v1\ncC=v2\n") &&
+            (dic0[k] == "v3") && (dic0["AA"] == "v0") && dic0.contains("BB") && (!dic0.add("cc", "v2"));
+        CPPUNIT_ASSERT(ok);
+
+        // Move contents from a case-sensitive dictionary.
+        StringDic dic1;
+        dic1.add("Dd", "v4");
+        dic1.add(longK + "D", "v5");
+        dic0 = &dic1;
+        ok = (dic0.numKvPairs() == 2) && (dic0["dD"] == "v4") && dic0.rm(k + "d") && (!dic0.contains(longK + "D"));
+        CPPUNIT_ASSERT(ok);
+    }
+}
+
+
+//
+// Interfaces under test:
+// - StringDic::StringDic(StringDic&& that);
+// - const StringDic& StringDic::operator =(StringDic&& that);
+//
+void StringDicSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+    StringDic dic0;
+    dic0.add("k0", "v0");
+    dic0.add("k1", "v1");
+    StringDic dic1(dic0);
+
+    StringDic dic(std::move(dic1));
+    bool ok = (dic == dic0) && (dic1.numKvPairs() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    StringDic dic2;
+    dic2.add("k2", "v2");
+    dic2 = std::move(dic);
+    ok = (dic2 == dic0) && (dic.numKvPairs() == 0) && (!dic2.contains("k2"));
+    CPPUNIT_ASSERT(ok);
+#endif
+}
+
+
 void StringDicSuite::testOp00()
 {
     Sample0 dic0;
@@ -390,6 +525,48 @@ void StringDicSuite::testOp01()
 }
 
 
+#if 0
+//
+// Load 1M distinct keys from DelimitedTxt, then look up 2M keys, with and
+// without the hash index. A hashed load costs more because each add also
+// updates the hash table.
+//
+void StringDicSuite::testPerf00()
+{
+    const unsigned int NUM_KEYS = 1000000;
+    char line[64];
+    StringBuilder sb;
+    for (unsigned int i = 0; i < NUM_KEYS; ++i)
+    {
+        sprintf_s(line, sizeof(line), "key%07u=value%u\n", static_cast<unsigned int>((i * 7919ULL) % NUM_KEYS), i);
+        sb += line;
+    }
+    String s(sb.toString());
+
+    for (int hashKeys = 0; hashKeys <= 1; ++hashKeys)
+    {
+        unsigned long long t0 = TickTime::curTime();
+        DelimitedTxt txt(s, false /*makeCopy*/);
+        StringDic dic(txt, '=', true /*trimLines*/, false /*ignoreCase*/, false /*internKeys*/, (hashKeys != 0));
+        unsigned long long t1 = TickTime::curTime();
+        unsigned int numHits = 0;
+        for (unsigned int i = 0; i < NUM_KEYS * 2; ++i)
+        {
+            sprintf_s(line, sizeof(line), "key%07u", static_cast<unsigned int>((i * 104729ULL) % NUM_KEYS));
+            numHits += dic.contains(line)? 1: 0;
+        }
+        unsigned long long t2 = TickTime::curTime();
+        double loadSecs = (t1 - t0) * TickTime::secsPerTick();
+        double lookupSecs = (t2 - t1) * TickTime::secsPerTick();
+        printf("%s: keys=%u loadSecs=%.3f hits=%u lookupSecs=%.3f\n", hashKeys? "hashed": "tree", dic.numKvPairs(), loadSecs, numHits, lookupSecs);
+    }
+
+    bool ok = true;
+    CPPUNIT_ASSERT(ok);
+}
+#endif
+
+
 void StringDicSuite::testRm00()
 {
     Sample0 dic0;
@@ -25,8 +25,13 @@ private:
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
     CPPUNIT_TEST(testCtor02);
+    CPPUNIT_TEST(testCtor03);
+    CPPUNIT_TEST(testCtor04);
+    CPPUNIT_TEST(testCtor05);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
+    //CPPUNIT_TEST(testPerf00);
     CPPUNIT_TEST(testRm00);
     CPPUNIT_TEST(testRm01);
     CPPUNIT_TEST_SUITE_END();
@@ -39,8 +44,13 @@ private:
     void testCtor00();
     void testCtor01();
     void testCtor02();
+    void testCtor03();
+    void testCtor04();
+    void testCtor05();
+    void testMove00();
     void testOp00();
     void testOp01();
+    //void testPerf00();
     void testRm00();
     void testRm01();
 
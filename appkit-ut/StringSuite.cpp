@@ -1,4 +1,6 @@
+#include <utility>
 #include "appkit/String.hpp"
+#include "appkit/StringDic.hpp"
 #include "appkit/StringPair.hpp"
 #include "appkit/StringVec.hpp"
 #include "appkit/U16.hpp"
@@ -581,6 +583,38 @@ void StringSuite::testCtor08()
 }
 
 
+//
+// Short strings are kept inline with the shared representation.
+// Growth moves them into the heap.
+//
+void StringSuite::testCtor09()
+{
+    String str0("abc");
+    bool ok = (str0 == "abc") && (str0.length() == 3) && (str0.capacity() == String::S::InlineCap);
+    CPPUNIT_ASSERT(ok);
+
+    String str1(str0);
+    str1 += "defghijklmnopqrstuvwxyz0123456789";
+    ok = (str0 == "abc") && (str1.length() == 36) && (str1.capacity() > String::S::InlineCap) &&
+        (strcmp(str1.ascii(), "abcdefghijklmnopqrstuvwxyz0123456789") == 0);
+    CPPUNIT_ASSERT(ok);
+
+    String str2(str1.substr(3, 5));
+    ok = (str2 == "defgh") && (str2.capacity() == String::S::InlineCap);
+    CPPUNIT_ASSERT(ok);
+
+    str2 += static_cast<wchar_t>(0x20acU);
+    ok = (str2.length() == 6) && (str2[5] == 0x20acU) && (!str2.isAscii()) && (str2.byteSize() == 6 + 3);
+    CPPUNIT_ASSERT(ok);
+
+    unsigned int byteSize = 0;
+    utf8_t* raw = str2.detachRaw(byteSize);
+    ok = (byteSize == 6 + 3) && (memcmp(raw, "defgh\xe2\x82\xac", byteSize) == 0);
+    CPPUNIT_ASSERT(ok);
+    delete[] raw;
+}
+
+
 //
 // String::find(utf32_t, size_t);
 //
@@ -659,6 +693,49 @@ void StringSuite::testFind02()
 }
 
 
+//
+// Interfaces under test:
+// - size_t String::find(const String&, size_t) const;
+// - size_t String::find(utf32_t, size_t) const;
+// - size_t String::rfind(const String&, size_t) const;
+// - size_t String::rfind(utf32_t, size_t) const;
+//
+void StringSuite::testFind03()
+{
+
+    // Non-ASCII string long enough to exercise the vectorized searches.
+    // Compare against character-by-character scans.
+    Sample1 sample1;
+    String str("caf\xe9 na\xefve r\xe9sum\xe9 caf\xe9 ");
+    str += sample1;
+    str += " r\xe9sum\xe9";
+    bool ok = true;
+    for (size_t i = 0, n = str.length(); i < n; ++i)
+    {
+        utf32_t c = str[i];
+        size_t first = 0;
+        for (; str[first] != c; ++first);
+        size_t last = n - 1;
+        for (; str[last] != c; --last);
+        String key(str, i, 3);
+        if ((str.find(c) != first) || (str.rfind(c) != last) ||
+            (str.find(c, i) != i) || (str.rfind(c, i) != i) ||
+            (str.find(key, i) != i) || (str.rfind(key, i) != i))
+        {
+            ok = false;
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    ok = (str.find(String("r\xe9sum\xe9")) == 11) &&
+        (str.rfind(String("r\xe9sum\xe9")) == str.length() - 6) &&
+        (str.find(0xe8U) == String::INVALID_INDEX) &&
+        (str.rfind(0xe8U) == String::INVALID_INDEX);
+    CPPUNIT_ASSERT(ok);
+}
+
+
 //
 // Interfaces under test:
 // - String::Ascii8 String::formAscii8(char, size_t);
@@ -859,6 +936,33 @@ void StringSuite::testHash00()
 }
 
 
+//
+// Interfaces under test:
+// - String::String(String&& str);
+// - const String& String::operator =(String&& str);
+//
+void StringSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+    String s0("abcdefghijklmnopqrstuvwxyz");
+    String s1(s0);
+    String s(std::move(s1));
+    bool ok = (s == s0) && s1.empty() && (s.s_ == s0.s_) && (s0.s_->refCount() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    String s2("0123456789");
+    s2 = std::move(s);
+    ok = (s2 == s0) && s.empty() && (s0.s_->refCount() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    s1 = s2.substr(3, 3);
+    s = "xyz";
+    ok = (s1 == "def") && (s == "xyz");
+    CPPUNIT_ASSERT(ok);
+#endif
+}
+
+
 void StringSuite::testNew00()
 {
     String* s = new String;
@@ -1060,6 +1164,42 @@ void StringSuite::testPerf02()
     t1.waitTilDone();
     t2.waitTilDone();
 }
+
+
+//
+// String-heavy workload: copy a vector of short strings, sort the copy, build
+// a dictionary from it, and churn through unique strings. Copies and releases
+// exercise the String reference counts.
+//
+void StringSuite::testPerf03()
+{
+    StringVec vec0;
+    char buf[32];
+    for (unsigned int i = 0; i < 100000; ++i)
+    {
+        sprintf_s(buf, sizeof(buf), "key%u", (i * 7919U) % 100003U);
+        vec0.add(buf);
+    }
+
+    for (int i = 99; i > 0; --i)
+    {
+        StringVec vec1(vec0);
+        vec1.sort();
+        StringDic dic;
+        for (size_t k = 0, numItems = vec1.numItems(); k < numItems; ++k)
+        {
+            dic.add(vec1.peek(k), vec0.peek(k));
+        }
+        StringVec vec2;
+        for (size_t k = 0, numItems = vec0.numItems(); k < numItems; ++k)
+        {
+            vec2.add(String(vec0.peek(k).ascii()));
+        }
+    }
+
+    bool ok = true;
+    CPPUNIT_ASSERT(ok);
+}
 #endif
 
 
@@ -1245,7 +1385,7 @@ void StringSuite::testRfind01()
 void StringSuite::testSize00()
 {
     bool ok = (sizeof(String) == sizeof(void*)) && //Win32:4 x64:8
-        (sizeof(String::S) == sizeof(void*) * 5 + 16) && //Win32:36 x64:56
+        (sizeof(String::S) == sizeof(void*) * 6 + 24 + String::S::InlineCap) && //Win32:72 x64:96
         (sizeof(StringPair) == sizeof(void*) * 2); //Win32:8 x64:16
     CPPUNIT_ASSERT(ok);
 }
@@ -33,9 +33,11 @@ private:
     CPPUNIT_TEST(testCtor06);
     CPPUNIT_TEST(testCtor07);
     CPPUNIT_TEST(testCtor08);
+    CPPUNIT_TEST(testCtor09);
     CPPUNIT_TEST(testFind00);
     CPPUNIT_TEST(testFind01);
     CPPUNIT_TEST(testFind02);
+    CPPUNIT_TEST(testFind03);
     CPPUNIT_TEST(testFormAscii8a);
     CPPUNIT_TEST(testFormBox00);
     CPPUNIT_TEST(testFormUtfX00);
@@ -44,6 +46,7 @@ private:
     CPPUNIT_TEST(testFormUtfX03);
     CPPUNIT_TEST(testFormUtfX04);
     CPPUNIT_TEST(testHash00);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testNew00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
@@ -52,6 +55,7 @@ private:
     //CPPUNIT_TEST(testPerf00);
     //CPPUNIT_TEST(testPerf01);
     //CPPUNIT_TEST(testPerf02);
+    //CPPUNIT_TEST(testPerf03);
     CPPUNIT_TEST(testReset00);
     CPPUNIT_TEST(testResize00);
     CPPUNIT_TEST(testRfind00);
@@ -86,9 +90,11 @@ private:
     void testCtor06();
     void testCtor07();
     void testCtor08();
+    void testCtor09();
     void testFind00();
     void testFind01();
     void testFind02();
+    void testFind03();
     void testFormAscii8a();
     void testFormBox00();
     void testFormUtfX00();
@@ -97,6 +103,7 @@ private:
     void testFormUtfX03();
     void testFormUtfX04();
     void testHash00();
+    void testMove00();
     void testNew00();
     void testOp00();
     void testOp01();
@@ -105,6 +112,7 @@ private:
     //void testPerf00();
     //void testPerf01();
     //void testPerf02();
+    //void testPerf03();
     void testReset00();
     void testResize00();
     void testRfind00();
@@ -24,10 +24,12 @@ private:
     CPPUNIT_TEST(testFind00);
     CPPUNIT_TEST(testFindMaxLength00);
     CPPUNIT_TEST(testFindMinLength00);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
     CPPUNIT_TEST(testOp02);
     CPPUNIT_TEST(testOp03);
+    //CPPUNIT_TEST(testPerf00);
     CPPUNIT_TEST(testResize00);
     CPPUNIT_TEST(testRm00);
     CPPUNIT_TEST(testRm01);
@@ -48,10 +50,12 @@ private:
     void testFind00();
     void testFindMaxLength00();
     void testFindMinLength00();
+    void testMove00();
     void testOp00();
     void testOp01();
     void testOp02();
     void testOp03();
+    //void testPerf00();
     void testResize00();
     void testRm00();
     void testRm01();
@@ -775,7 +775,7 @@ void U16SetSuite::testRm02()
 void U16SetSuite::testSize00()
 {
     size_t size = sizeof(U16Set);
-    bool ok = (size == (sizeof(Set) + sizeof(void*) + 12)); //Win32:36 x64:48
+    bool ok = (size == (sizeof(Set) + sizeof(void*) + 12)); //Win32:40 x64:52
     CPPUNIT_ASSERT(ok);
 }
 
@@ -775,7 +775,7 @@ void U32SetSuite::testRm02()
 void U32SetSuite::testSize00()
 {
     size_t size = sizeof(U32Set);
-    bool ok = (size == (sizeof(Set) + sizeof(void*) + 20)); //Win32:44 x64:56
+    bool ok = (size == (sizeof(Set) + sizeof(void*) + 20)); //Win32:48 x64:60
     CPPUNIT_ASSERT(ok);
 }
 
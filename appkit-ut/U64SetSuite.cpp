@@ -775,7 +775,7 @@ void U64SetSuite::testRm02()
 void U64SetSuite::testSize00()
 {
     size_t size = sizeof(U64Set);
-    bool ok = (size == (sizeof(Set) + sizeof(void*) + 28)); //Win32:52 x64:64
+    bool ok = (size == (sizeof(Set) + sizeof(void*) + 28)); //Win32:56 x64:68
     CPPUNIT_ASSERT(ok);
 }
 
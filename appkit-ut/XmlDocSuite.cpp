@@ -4,6 +4,7 @@
 #include "appkit/XmlProlog.hpp"
 #include "appkit/std.hpp"
 #include "syskit/MappedTxtFile.hpp"
+#include "syskit/Region.hpp"
 
 #include "appkit-ut-pch.h"
 #include "XmlDocSuite.hpp"
@@ -55,7 +56,7 @@ bool XmlDocSuite::loadXmlFile(void* arg, const Directory& parent, const String&
 // Interfaces under test:
 // - XmlDoc::Cdata::Cdata(const String&);
 // - XmlDoc::Cdata::~Cdata();
-// - String XmlDoc::Cdata::toXml(size_t) const;
+// - void XmlDoc::Cdata::appendXml(StringBuilder&, size_t) const;
 // - bool XmlDoc::Cdata::giveBirth(XmlElement*);
 // - const String& XmlDoc::Cdata::body() const;
 // - void XmlDoc::Cdata::reset(const String&);
@@ -89,7 +90,7 @@ void XmlDocSuite::testCdata00()
 // Interfaces under test:
 // - XmlDoc::Comment::Comment(const String&);
 // - XmlDoc::Comment::~Comment();
-// - String XmlDoc::Comment::toXml(size_t) const;
+// - void XmlDoc::Comment::appendXml(StringBuilder&, size_t) const;
 // - bool XmlDoc::Comment::giveBirth(XmlElement*);
 // - const String& XmlDoc::Comment::body() const;
 // - void XmlDoc::Comment::reset(const String&);
@@ -123,7 +124,7 @@ void XmlDocSuite::testComment00()
 // Interfaces under test:
 // - XmlDoc::Content::Content(const String&);
 // - XmlDoc::Content::~Content();
-// - String XmlDoc::Content::toXml(size_t) const;
+// - void XmlDoc::Content::appendXml(StringBuilder&, size_t) const;
 // - bool XmlDoc::Content::giveBirth(XmlElement*);
 // - const String& XmlDoc::Content::body() const;
 // - void XmlDoc::Content::reset(const String&);
@@ -386,6 +387,50 @@ void XmlDocSuite::testLoadFrom03()
 }
 
 
+//
+// Interfaces under test:
+// - bool XmlDoc::loadFromXml(const String&, Region&);
+//
+void XmlDocSuite::testLoadFrom04()
+{
+    String xmlIn("<?xml version=\"1.0\"?>\n"
+        "<root a=\"1\" b=\"2\">\n"
+        "  <!--comment-->\n"
+        "  <kid>content &amp; more</kid>\n"
+        "  <![CDATA[cdata]]>\n"
+        "  <empty c=\"3\"/>\n"
+        "</root>\n");
+    XmlDoc heapDoc;
+    bool ok = heapDoc.loadFromXml(xmlIn);
+    CPPUNIT_ASSERT(ok);
+
+    Region region(1024 /*chunkSize*/);
+    XmlDoc* doc = new XmlDoc;
+    ok = (doc->loadFromXml(xmlIn, region) && (doc->toXml() == heapDoc.toXml()));
+    CPPUNIT_ASSERT(ok);
+    ok = doc->root().isInRegion() && doc->root().kid(0).isInRegion() && (region.numBytes() > 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Heap-allocated and region-allocated elements can be mixed.
+    ok = doc->root().giveBirth(new XmlElement("heap"));
+    CPPUNIT_ASSERT(ok);
+    ok = doc->root().setKid(0, new XmlDoc::Comment("replaced"));
+    CPPUNIT_ASSERT(ok);
+    XmlElement* kid = doc->root().findKid("kid");
+    ok = (kid != 0) && (kid->body() == "content & more") && (kid->detach(*doc) == kid);
+    CPPUNIT_ASSERT(ok);
+    kid->destroy();
+    ok = (doc->find("/root/empty") != 0) && (doc->find("/root/heap") != 0) && (doc->find("/root/kid") == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Document must be destructed before the region is reset.
+    delete doc;
+    region.reset();
+    ok = (region.numBytes() == 0) && (region.numChunks() <= 1);
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void XmlDocSuite::testProlog00()
 {
     XmlProlog prolog0;
@@ -452,7 +497,7 @@ void XmlDocSuite::testProlog01()
 // Interfaces under test:
 // - XmlDoc::UnknownElement::UnknownElement(const String&);
 // - XmlDoc::UnknownElement::~UnknownElement();
-// - String XmlDoc::UnknownElement::toXml(size_t) const;
+// - void XmlDoc::UnknownElement::appendXml(StringBuilder&, size_t) const;
 // - bool XmlDoc::UnknownElement::giveBirth(XmlElement*);
 // - const String& XmlDoc::UnknownElement::body() const;
 // - void XmlDoc::UnknownElement::reset(const String&);
@@ -30,6 +30,7 @@ private:
     CPPUNIT_TEST(testLoadFrom01);
     CPPUNIT_TEST(testLoadFrom02);
     CPPUNIT_TEST(testLoadFrom03);
+    CPPUNIT_TEST(testLoadFrom04);
     CPPUNIT_TEST(testProlog00);
     CPPUNIT_TEST(testProlog01);
     CPPUNIT_TEST(testUnknownElement00);
@@ -50,6 +51,7 @@ private:
     void testLoadFrom01();
     void testLoadFrom02();
     void testLoadFrom03();
+    void testLoadFrom04();
     void testProlog00();
     void testProlog01();
     void testUnknownElement00();
@@ -368,12 +368,12 @@ void XmlElementSuite::testSetBody00()
 
 void XmlElementSuite::testSize00()
 {
-    bool ok = (sizeof(XmlDoc::Cdata) == sizeof(void*) * 7) &&
-        (sizeof(XmlDoc::Comment) == sizeof(void*) * 7) &&
-        (sizeof(XmlDoc::Content) == sizeof(void*) * 7) &&
-        (sizeof(XmlDoc::EmptyElement) == sizeof(void*) * 6) &&
-        (sizeof(XmlDoc::UnknownElement) == sizeof(void*) * 7) &&
-        (sizeof(XmlElement) == sizeof(void*) * 6); //Win32:24 x64:48
+    bool ok = (sizeof(XmlDoc::Cdata) == sizeof(void*) * 8) &&
+        (sizeof(XmlDoc::Comment) == sizeof(void*) * 8) &&
+        (sizeof(XmlDoc::Content) == sizeof(void*) * 8) &&
+        (sizeof(XmlDoc::EmptyElement) == sizeof(void*) * 7) &&
+        (sizeof(XmlDoc::UnknownElement) == sizeof(void*) * 8) &&
+        (sizeof(XmlElement) == sizeof(void*) * 7); //Win32:28 x64:56
     CPPUNIT_ASSERT(ok);
 }
 
@@ -8,6 +8,7 @@
 #include "syskit/sys.hpp"
 
 #include "appkit-ut-pch.h"
+#include "AtomSuite.hpp"
 #include "CmdLineSuite.hpp"
 #include "CmdSuite.hpp"
 #include "CrtSuite.hpp"
@@ -22,8 +23,12 @@
 #include "PathSuite.hpp"
 #include "QuotedStringSuite.hpp"
 #include "S32Suite.hpp"
+#include "SharedDicSuite.hpp"
 #include "StdSuite.hpp"
+#include "StrSetSuite.hpp"
 #include "StrSuite.hpp"
+#include "StrVecSuite.hpp"
+#include "StringBuilderSuite.hpp"
 #include "StringDicSuite.hpp"
 #include "StringSuite.hpp"
 #include "StringVecSuite.hpp"
@@ -43,6 +48,7 @@
 using namespace appkit;
 using namespace syskit;
 
+CPPUNIT_TEST_SUITE_REGISTRATION(AtomSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(CmdLineSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(CmdSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(CrtSuite);
@@ -57,8 +63,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION(ObserverSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(PathSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(QuotedStringSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(S32Suite);
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedDicSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(StdSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(StrSetSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(StrSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(StrVecSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(StringBuilderSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(StringDicSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(StringSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(StringVecSuite);
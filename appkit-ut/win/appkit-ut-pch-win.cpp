@@ -18,6 +18,7 @@
 #include "appkit/DicFile.hpp"
 #include "appkit/Directory.hpp"
 #include "appkit/F32.hpp"
+#include "appkit/LockCmd.hpp"
 #include "appkit/Messenger.hpp"
 #include "appkit/MiscDbugCmd.hpp"
 #include "appkit/NewsAnchor.hpp"
@@ -0,0 +1,358 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <string.h>
+#include "syskit/HashTable.hpp"
+#include "syskit/RwSection.hpp"
+#include "syskit/Singleton.hpp"
+#include "syskit/Thread.hpp"
+#include "syskit/macros.h"
+
+#include "appkit-pch.h"
+#include "appkit/Atom.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//
+// Per-process table of atoms. Searches are done as a reader, and additions
+// are done as a writer. Atoms are never removed from the table.
+//
+class Atom::Table: public Singleton
+{
+public:
+    const atom_t* empty() const;
+    const atom_t* find(const key_t&) const;
+    const atom_t* intern(const key_t&, const String*, bool);
+    unsigned int numAtoms() const;
+    static Table* instance();
+protected:
+    Table(const char*, unsigned int);
+    virtual ~Table();
+private:
+    static const char ID1[];
+    HashTable table_;
+    RwSection mutable rws_;
+    const atom_t* empty_;
+    Table(const Table&); //prohibit usage
+    const Table& operator =(const Table&); //prohibit usage
+    static Singleton* create(const char*, unsigned int, void*);
+    static int diff(const void*, const void*);
+    static unsigned int hash(const void*, size_t);
+    static void deleteAtom(void*, void*);
+};
+
+const char Atom::Table::ID1[] = "appkit::Atom::Table"; //singleton ID
+
+
+Atom::Table::Table(const char* id, unsigned int initialRefCount):
+RefCounted(initialRefCount),
+Singleton(id, initialRefCount),
+table_(diff, hash, 1024 /*capacity*/),
+rws_()
+{
+    key_t k;
+    mkKey(k, 0, 0, 0);
+    empty_ = intern(k, 0, false /*capped*/);
+}
+
+
+Atom::Table::~Table()
+{
+    table_.apply(deleteAtom);
+}
+
+
+const Atom::atom_t* Atom::Table::empty() const
+{
+    return empty_;
+}
+
+
+//
+// Locate atom with given key. Return zero if not found.
+//
+const Atom::atom_t* Atom::Table::find(const key_t& k) const
+{
+    void* foundItem;
+    RwSection::ReadLock lock(rws_);
+    return table_.find(&k, foundItem)? static_cast<const atom_t*>(foundItem): 0;
+}
+
+
+//
+// Locate atom with given key. Add it if not found. Reuse given string if
+// non-zero, and form one from the key otherwise. When capped, do not add
+// beyond SoftCap atoms. Return zero if the atom was neither found nor added.
+//
+const Atom::atom_t* Atom::Table::intern(const key_t& k, const String* s, bool capped)
+{
+    const atom_t* found = find(k);
+    if (found != 0)
+    {
+        return found;
+    }
+
+    RwSection::WriteLock lock(rws_);
+    void* foundItem;
+    if (table_.find(&k, foundItem))
+    {
+        found = static_cast<const atom_t*>(foundItem);
+    }
+    else if ((!capped) || (table_.numItems() < SoftCap))
+    {
+        atom_t* a = new atom_t;
+        if (s != 0)
+        {
+            a->str = *s;
+        }
+        else if (k.numU8s > 0)
+        {
+            a->str.reset(k.s, k.numU8s, k.numChars);
+        }
+        a->key = k;
+        a->key.s = a->str.raw();
+        a->id = table_.numItems();
+        table_.add(a);
+        found = a;
+    }
+
+    return found;
+}
+
+
+unsigned int Atom::Table::numAtoms() const
+{
+    RwSection::ReadLock lock(rws_);
+    return table_.numItems();
+}
+
+
+//
+// Return per-process singleton. Construct on first use. Destruct at exit.
+//
+Atom::Table* Atom::Table::instance()
+{
+    static Table* s_table = dynamic_cast<Table*>(getSingleton(ID1, create, 1U /*initialRefCount*/, 0 /*createArg*/));
+    for (; s_table == 0; Thread::yield());
+    return s_table;
+}
+
+
+//
+// This method should be invoked just once per process via Singleton::getSingleton().
+//
+Singleton* Atom::Table::create(const char* id, unsigned int initialRefCount, void* /*arg*/)
+{
+    Table* table = new Table(id, initialRefCount);
+    static Table::Count s_lock(*table, true /*skipAddRef*/); //destruct at unload or exit
+    return table;
+}
+
+
+//
+// Compare opaques as key_t pointers.
+// Return non-zero if they differ.
+//
+int Atom::Table::diff(const void* item0, const void* item1)
+{
+    const key_t* k0 = static_cast<const key_t*>(item0);
+    const key_t* k1 = static_cast<const key_t*>(item1);
+    int rc = (k0->hash != k1->hash) || (k0->numU8s != k1->numU8s) || (memcmp(k0->s, k1->s, k0->numU8s) != 0);
+    return rc;
+}
+
+
+//
+// Hash opaque as a key_t pointer.
+//
+unsigned int Atom::Table::hash(const void* item, size_t numBuckets)
+{
+    const key_t* k = static_cast<const key_t*>(item);
+    unsigned int i = (k->hash % static_cast<unsigned int>(numBuckets));
+    return i;
+}
+
+
+void Atom::Table::deleteAtom(void* /*arg*/, void* item)
+{
+    delete static_cast<atom_t*>(item);
+}
+
+
+//!
+//! Construct the empty-string atom.
+//!
+Atom::Atom()
+{
+    a_ = Table::instance()->empty();
+}
+
+
+//!
+//! Construct atom for given string. Intern the string if necessary.
+//!
+Atom::Atom(const String& s)
+{
+    key_t k;
+    mkKey(k, s);
+    a_ = Table::instance()->intern(k, &s, false /*capped*/);
+}
+
+
+//!
+//! Construct atom for given null-terminated 8-bit ASCII string.
+//! Intern the string if necessary.
+//!
+Atom::Atom(const char* s)
+{
+    size_t length = strlen(s);
+    const utf8_t* p = reinterpret_cast<const utf8_t*>(s);
+    const utf8_t* pEnd = p + length;
+    for (; (p < pEnd) && (*p < 0x80U); ++p);
+    if (p == pEnd)
+    {
+        key_t k;
+        mkKey(k, reinterpret_cast<const utf8_t*>(s), length, length);
+        a_ = Table::instance()->intern(k, 0, false /*capped*/);
+    }
+    else
+    {
+        String str(s, length);
+        key_t k;
+        mkKey(k, str);
+        a_ = Table::instance()->intern(k, &str, false /*capped*/);
+    }
+}
+
+
+//!
+//! Construct atom for given valid UTF8 sequence (numU8s bytes holding numChars
+//! characters starting at s). Intern the sequence if necessary.
+//!
+Atom::Atom(const utf8_t* s, size_t numU8s, size_t numChars)
+{
+    key_t k;
+    mkKey(k, s, numU8s, numChars);
+    a_ = Table::instance()->intern(k, 0, false /*capped*/);
+}
+
+
+//!
+//! Return the interned form of given string. The returned string shares its
+//! representation with the atom if given string has been interned or if the
+//! table holds less than SoftCap atoms. Otherwise, return given string as is.
+//!
+String Atom::intern(const String& s)
+{
+    key_t k;
+    mkKey(k, s);
+    const atom_t* a = Table::instance()->intern(k, &s, true /*capped*/);
+    return (a == 0)? s: a->str;
+}
+
+
+//!
+//! Return the interned form of given valid UTF8 sequence (numU8s bytes holding
+//! numChars characters starting at s). The returned string shares its
+//! representation with the atom if the sequence has been interned or if the
+//! table holds less than SoftCap atoms. Otherwise, return a plain copy.
+//!
+String Atom::intern(const utf8_t* s, size_t numU8s, size_t numChars)
+{
+    key_t k;
+    mkKey(k, s, numU8s, numChars);
+    const atom_t* a = Table::instance()->intern(k, 0, true /*capped*/);
+    if (a != 0)
+    {
+        return a->str;
+    }
+
+    String str(static_cast<unsigned int>(numU8s + 1));
+    str.append(s, numU8s, numChars);
+    return str;
+}
+
+
+//!
+//! Locate the atom for given string without interning. Return true if
+//! found (also return the found atom in atom). Return false otherwise.
+//!
+bool Atom::find(const String& s, Atom& atom)
+{
+    key_t k;
+    mkKey(k, s);
+    const atom_t* a = Table::instance()->find(k);
+    bool found = (a != 0);
+    if (found)
+    {
+        atom.a_ = a;
+    }
+
+    return found;
+}
+
+
+//!
+//! Locate the atom for given valid UTF8 sequence (numU8s bytes starting at s)
+//! without interning. Return true if found (also return the found atom in atom).
+//! Return false otherwise.
+//!
+bool Atom::find(const utf8_t* s, size_t numU8s, Atom& atom)
+{
+    key_t k;
+    mkKey(k, s, numU8s, 0 /*numChars*/);
+    const atom_t* a = Table::instance()->find(k);
+    bool found = (a != 0);
+    if (found)
+    {
+        atom.a_ = a;
+    }
+
+    return found;
+}
+
+
+//!
+//! Return the number of atoms in the per-process table.
+//!
+unsigned int Atom::numAtoms()
+{
+    unsigned int n = Table::instance()->numAtoms();
+    return n;
+}
+
+
+//
+// Form search key for given string.
+//
+void Atom::mkKey(key_t& k, const String& s)
+{
+    unsigned int byteSize;
+    const utf8_t* raw = s.raw(byteSize);
+    mkKey(k, raw, byteSize - 1, s.length());
+}
+
+
+//
+// Form search key for given UTF8 sequence. The hash code
+// is computed the same way String::hash() does it.
+//
+void Atom::mkKey(key_t& k, const utf8_t* s, size_t numU8s, size_t numChars)
+{
+    unsigned int code = 5381;
+    for (const utf8_t* p = s, * pEnd = s + numU8s; (p < pEnd) && (*p != 0); ++p)
+    {
+        code += (code << 5) + *p;
+    }
+
+    k.hash = code;
+    k.numChars = static_cast<unsigned int>(numChars);
+    k.numU8s = static_cast<unsigned int>(numU8s);
+    k.s = s;
+}
+
+END_NAMESPACE1
@@ -0,0 +1,164 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef APPKIT_ATOM_HPP
+#define APPKIT_ATOM_HPP
+
+#include "appkit/String.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//! interned string
+class Atom
+    //!
+    //! A class representing an interned string aka atom. Equal strings map to
+    //! the same atom, so atoms compare and hash in constant time. Each atom has
+    //! a stable identifier, and its hash code equals String::hash() of its
+    //! string. Atoms reside in a thread-safe per-process table and live until
+    //! the table goes away at exit, so atoms suit bounded vocabularies such as
+    //! command names and well-known keys. Strings from less trusted sources
+    //! should use intern() instead. It shares the representation of an existing
+    //! atom if any, but stops adding new atoms once the table holds SoftCap of
+    //! them. An interned string shares its representation with the atom, and
+    //! String equality short-circuits on shared representations. Example:
+    //!\code
+    //! static const Atom s_help("help");
+    //! Atom cmd(cmdName);
+    //! if (cmd == s_help)
+    //! {
+    //!   showHelp();
+    //! }
+    //!\endcode
+    //!
+{
+
+public:
+    enum
+    {
+        SoftCap = 65536
+    };
+
+    // Constructors and destructor.
+    Atom();
+    Atom(const Atom& atom);
+    Atom(const String& s);
+    Atom(const char* s);
+    Atom(const syskit::utf8_t* s, size_t numU8s, size_t numChars);
+    ~Atom();
+
+    // Operators.
+    operator const String&() const;
+    bool operator !=(const Atom& atom) const;
+    bool operator ==(const Atom& atom) const;
+    const Atom& operator =(const Atom& atom);
+
+    // Getters.
+    const String& asString() const;
+    const char* ascii() const;
+    unsigned int hash() const;
+    unsigned int id() const;
+
+    static String intern(const String& s);
+    static String intern(const syskit::utf8_t* s, size_t numU8s, size_t numChars);
+    static bool find(const String& s, Atom& atom);
+    static bool find(const syskit::utf8_t* s, size_t numU8s, Atom& atom);
+    static unsigned int numAtoms();
+
+private:
+    class Table;
+
+    typedef struct
+    {
+        unsigned int hash;
+        unsigned int numChars;
+        unsigned int numU8s; //excluding the terminating null
+        const syskit::utf8_t* s;
+    } key_t;
+
+    typedef struct atom_s
+    {
+        key_t key; //must be first
+        unsigned int id;
+        String str;
+    } atom_t;
+
+    const atom_t* a_;
+
+    Atom(const atom_t*);
+
+    static void mkKey(key_t&, const String&);
+    static void mkKey(key_t&, const syskit::utf8_t*, size_t, size_t);
+
+    friend class Table;
+
+};
+
+inline Atom::Atom(const atom_t* a)
+{
+    a_ = a;
+}
+
+inline Atom::Atom(const Atom& atom)
+{
+    a_ = atom.a_;
+}
+
+inline Atom::~Atom()
+{
+}
+
+//! Return the atom as a string. The returned string lives as long as the atom table.
+inline Atom::operator const String&() const
+{
+    return a_->str;
+}
+
+//! Return true if this atom differs from given atom.
+inline bool Atom::operator !=(const Atom& atom) const
+{
+    return (a_ != atom.a_);
+}
+
+//! Return true if this atom equals given atom.
+inline bool Atom::operator ==(const Atom& atom) const
+{
+    return (a_ == atom.a_);
+}
+
+inline const Atom& Atom::operator =(const Atom& atom)
+{
+    a_ = atom.a_;
+    return *this;
+}
+
+//! Return the atom as a string. The returned string lives as long as the atom table.
+inline const String& Atom::asString() const
+{
+    return a_->str;
+}
+
+//! Return the atom as if it were a null-terminated ASCII string.
+inline const char* Atom::ascii() const
+{
+    return a_->str.ascii();
+}
+
+//! Return the atom's hash code. It equals String::hash() of the atom's string.
+inline unsigned int Atom::hash() const
+{
+    return a_->key.hash;
+}
+
+//! Return the atom's identifier. Identifiers are assigned in interning order,
+//! and the empty string has identifier zero.
+inline unsigned int Atom::id() const
+{
+    return a_->id;
+}
+
+END_NAMESPACE1
+
+#endif
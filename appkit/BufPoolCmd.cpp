@@ -3,9 +3,11 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include "syskit/BufPool.hpp"
+#include "syskit/BufProfile.hpp"
 #include "syskit/macros.h"
 
 #include "appkit-pch.h"
+#include "appkit/Bool.hpp"
 #include "appkit/BufPoolCmd.hpp"
 #include "appkit/U32.hpp"
 #include "appkit/crt.hpp"
@@ -14,17 +16,64 @@ using namespace syskit;
 
 // Supported command set.
 const char CMD_SET[] =
+" bufpool-profile"
 " bufpool-resetstat"
 " bufpool-show"
 " bufpool-shrink"
 ;
 
+// Usage texts. One per command. Must match supported command set.
+const char USAGE_0[] =
+"Usage:\n"
+"  bufpool-profile [--dump=xxx ]\n"
+"                  [--rate=xxx ]\n"
+"                  [--sites=xxx]\n"
+"                  [--start    ]\n"
+"                  [--stop     ]\n\n"
+"Examples:\n"
+"  bufpool-profile --start --rate=256\n"
+"  bufpool-profile --sites=30\n"
+"  bufpool-profile --stop --dump=/tmp/bufpool-profile.txt\n"
+;
+
+const char* const USAGE[] =
+{
+    USAGE_0, //bufpool-profile
+    "",      //bufpool-resetstat
+    "",      //bufpool-show
+    ""       //bufpool-shrink
+};
+
 // Extended names. One per command. Must match supported command set.
 const char* const X_NAME[] =
 {
-    "reset BufPool stats", //bufpool-resetstat
-    "show buffer arenas",  //bufpool-show
-    "shrink buffer arenas" //bufpool-shrink
+    "profile BufPool allocations", //bufpool-profile
+    "reset BufPool stats",         //bufpool-resetstat
+    "show buffer arenas",          //bufpool-show
+    "shrink buffer arenas"         //bufpool-shrink
+};
+
+// Extended usage texts. One per command. Must match supported command set.
+const char X_USAGE_0[] =
+"\n"
+"Options:\n"
+"--dump=xxx\n"
+"  Save the profile report in given file instead of responding with it.\n"
+"--rate=xxx\n"
+"  Sample one in xxx allocations when starting. Default is 1024.\n"
+"--sites=xxx\n"
+"  Show at most xxx call sites per report section. Default is 16.\n"
+"--start\n"
+"--stop\n"
+"  Start or stop profiling. Starting discards the existing profile.\n"
+;
+
+const char* const X_USAGE[] =
+{
+    X_USAGE_0, //bufpool-profile
+    "",        //bufpool-resetstat
+    "",        //bufpool-show
+    ""         //bufpool-shrink
 };
 
 BEGIN_NAMESPACE1(appkit)
@@ -33,6 +82,7 @@ BEGIN_NAMESPACE1(appkit)
 // Command doers. One per command. Must match supported command set.
 BufPoolCmd::doer_t BufPoolCmd::doer_[] =
 {
+    &BufPoolCmd::doProfile,   //bufpool-profile
     &BufPoolCmd::doResetStat, //bufpool-resetstat
     &BufPoolCmd::doShow,      //bufpool-show
     &BufPoolCmd::doShrink     //bufpool-shrink
@@ -50,6 +100,66 @@ BufPoolCmd::~BufPoolCmd()
 }
 
 
+//
+// bufpool-profile [--dump=xxx ]
+//                 [--rate=xxx ]
+//                 [--sites=xxx]
+//                 [--start    ]
+//                 [--stop     ]
+//
+bool BufPoolCmd::doProfile(const CmdLine& req)
+{
+    BufPool& pool = BufPool::instance();
+    String optK("start");
+    if (Bool(req.opt(optK), false /*defaultV*/))
+    {
+        optK = "rate";
+        U32 rate(req.opt(optK), BufProfile::DefaultSampleRate);
+        if (!pool.startProfiling(rate))
+        {
+            respond(req, "Unavailable for a disabled BufPool.");
+            bool cmdIsValid = true;
+            return cmdIsValid;
+        }
+    }
+    else
+    {
+        optK = "stop";
+        if (Bool(req.opt(optK), false /*defaultV*/))
+        {
+            pool.stopProfiling();
+        }
+    }
+
+    const BufProfile* profile = pool.profile();
+    if (profile == 0)
+    {
+        respond(req, "None.");
+        bool cmdIsValid = true;
+        return cmdIsValid;
+    }
+
+    optK = "sites";
+    U32 maxSites(req.opt(optK), BufProfile::DefaultMaxSites);
+    optK = "dump";
+    const String* path = req.opt(optK);
+    if ((path != 0) && (!path->empty()))
+    {
+        bool ok = profile->dump(path->ascii(), maxSites);
+        formRsp(req, "%s %s.%c", ok? "Saved in": "Cannot save in", path->ascii(), 0);
+    }
+    else
+    {
+        char* rsp = profile->describe(maxSites);
+        respond(req, rsp);
+        delete[] rsp;
+    }
+
+    bool cmdIsValid = true;
+    return cmdIsValid;
+}
+
+
 //
 // bufpool-resetstat
 //
@@ -143,9 +253,21 @@ bool BufPoolCmd::onRun(const CmdLine& req)
 }
 
 
+const char* BufPoolCmd::usage(unsigned char cmdIndex) const
+{
+    return USAGE[cmdIndex];
+}
+
+
 const char* BufPoolCmd::xName(unsigned char cmdIndex) const
 {
     return X_NAME[cmdIndex];
 }
 
+
+const char* BufPoolCmd::xUsage(unsigned char cmdIndex) const
+{
+    return X_USAGE[cmdIndex];
+}
+
 END_NAMESPACE1
@@ -20,7 +20,9 @@ public:
 
     virtual ~BufPoolCmd();
     virtual bool onRun(const CmdLine& req);
+    virtual const char* usage(unsigned char cmdIndex) const;
     virtual const char* xName(unsigned char cmdIndex) const;
+    virtual const char* xUsage(unsigned char cmdIndex) const;
 
 private:
     typedef bool (BufPoolCmd::*doer_t)(const CmdLine& req);
@@ -30,6 +32,7 @@ private:
     BufPoolCmd(const BufPoolCmd&); //prohibit usage
     const BufPoolCmd& operator =(const BufPoolCmd&); //prohibit usage
 
+    bool doProfile(const CmdLine&);
     bool doResetStat(const CmdLine&);
     bool doShow(const CmdLine&);
     bool doShrink(const CmdLine&);
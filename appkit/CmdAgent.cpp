@@ -18,6 +18,7 @@
 #include "appkit/DelimitedTxt.hpp"
 #include "appkit/S32.hpp"
 #include "appkit/String.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/StringDic.hpp"
 #include "appkit/StringVec.hpp"
 #include "appkit/SysIo.hpp"
@@ -34,7 +35,7 @@ const int OBUF_SIZE = 196608; //bytes (192k)
 BEGIN_NAMESPACE
 
 // No-op if rspCopy is zero. Append given response to the copy otherwise.
-static void saveRsp(String* rspCopy, const utf8_t* rsp, size_t rspSize)
+static void saveRsp(StringBuilder* rspCopy, const utf8_t* rsp, size_t rspSize)
 {
     if (rspCopy != 0)
     {
@@ -375,11 +376,8 @@ bool CmdAgent::runCmds(const CmdLine& cmdLine, StringVec* rspCopies)
 //
 bool CmdAgent::showRsp(String* rspCopy)
 {
-    if (rspCopy != 0)
-    {
-        rspCopy->reset();
-    }
-
+    StringBuilder sb;
+    StringBuilder* rspBuilder = (rspCopy == 0)? (0): (&sb);
     bool ok = true;
     utf8_t rsp[Cmd::MaxRspLength + 1];
     for (unsigned int timeoutInMsecs = timeout0_;; timeoutInMsecs = timeout_)
@@ -394,7 +392,7 @@ bool CmdAgent::showRsp(String* rspCopy)
             {
                 bool more = true;
                 onRsp(reinterpret_cast<const char*>(rsp), rspSize, more);
-                saveRsp(rspCopy, rsp, rspSize);
+                saveRsp(rspBuilder, rsp, rspSize);
                 continue;
             }
 
@@ -403,7 +401,7 @@ bool CmdAgent::showRsp(String* rspCopy)
             {
                 bool more = false;
                 onRsp(reinterpret_cast<const char*>(rsp), rspSize - 1, more);
-                saveRsp(rspCopy, rsp, rspSize - 1);
+                saveRsp(rspBuilder, rsp, rspSize - 1);
             }
         }
         else
@@ -414,6 +412,11 @@ bool CmdAgent::showRsp(String* rspCopy)
         break;
     }
 
+    if (rspCopy != 0)
+    {
+        *rspCopy = sb.toString();
+    }
+
     return ok;
 }
 
@@ -13,6 +13,7 @@
 #include "appkit/Tokenizer.hpp"
 
 const bool IGNORE_CASE = true;
+const bool INTERN_KEYS = true;
 const char EQUALS_SIGN = '=';
 const char HYPHEN = '-';
 const char TOKEN_DELIM[] = "\001";
@@ -41,7 +42,7 @@ argVec_(cmdLine.argVec_)
 //!
 CmdLine::CmdLine(const String& cmd):
 cmd_(cmd),
-optDic_(IGNORE_CASE),
+optDic_(IGNORE_CASE, INTERN_KEYS),
 argVec_(ARG_CAP, ARG_GROWTH)
 {
 
@@ -56,7 +57,7 @@ argVec_(ARG_CAP, ARG_GROWTH)
 //!
 CmdLine::CmdLine(const char* cmd):
 cmd_(cmd),
-optDic_(IGNORE_CASE),
+optDic_(IGNORE_CASE, INTERN_KEYS),
 argVec_(ARG_CAP, ARG_GROWTH)
 {
 
@@ -71,7 +72,7 @@ argVec_(ARG_CAP, ARG_GROWTH)
 //!
 CmdLine::CmdLine(const char* cmd, size_t length):
 cmd_(cmd, length),
-optDic_(IGNORE_CASE),
+optDic_(IGNORE_CASE, INTERN_KEYS),
 argVec_(ARG_CAP, ARG_GROWTH)
 {
 
@@ -2,7 +2,6 @@
  * Software by Thanh Phung -- thanhtphung@yahoo.com.
  * No copyrights. No warranties. No restrictions in reuse.
  */
-#include <stddef.h>
 #include "syskit/Thread.hpp"
 #include "syskit/macros.h"
 
@@ -35,7 +34,7 @@ cs_(CriSection::DefaultSpinCount)
 
 CmdMap::~CmdMap()
 {
-    for (size_t i = map_.numItems(); i > 0; delete[] static_cast<const unsigned char*>(map_.peek(--i)));
+    for (size_t i = map_.numItems(); i > 0; delete static_cast<const kvPair_t*>(map_.peek(--i)));
 }
 
 
@@ -114,7 +113,7 @@ bool CmdMap::apply(cb0_t cb, void* arg) const
         for (size_t i = 0; i < map_.numItems(); ++i)
         {
             const kvPair_t* kv = static_cast<const kvPair_t*>(map_.peek(i));
-            if (!cb(arg, kv->name, kv->cmd, kv->cmdIndex))
+            if (!cb(arg, kv->name.ascii(), kv->cmd, kv->cmdIndex))
             {
                 ok = false;
                 break;
@@ -132,8 +131,8 @@ bool CmdMap::apply(cb0_t cb, void* arg) const
 //
 int CmdMap::compare(const void* item0, const void* item1)
 {
-    const char* k0 = static_cast<const kvPair_t*>(item0)->name;
-    const char* k1 = static_cast<const kvPair_t*>(item1)->name;
+    const char* k0 = static_cast<const kvPair_t*>(item0)->name.ascii();
+    const char* k1 = static_cast<const kvPair_t*>(item1)->name.ascii();
     return Str::compareKI(k0, k1);
 }
 
@@ -141,7 +140,7 @@ int CmdMap::compare(const void* item0, const void* item1)
 int CmdMap::compareName(const void* item0, const void* item1)
 {
     const char* k0 = static_cast<const char*>(item0);
-    const char* k1 = static_cast<const kvPair_t*>(item1)->name;
+    const char* k1 = static_cast<const kvPair_t*>(item1)->name.ascii();
     return Str::compareKI(k0, k1);
 }
 
@@ -164,20 +163,18 @@ unsigned int CmdMap::add(Cmd* cmd, unsigned int& numErrs)
         unsigned int numItems = map_.numItems();
         while (tokenizer.next(cmdName))
         {
-            size_t kvSize = offsetof(kvPair_t, name) + cmdName.length() + 1;
-            unsigned char* p = new unsigned char[kvSize];
-            kvPair_t* kv = reinterpret_cast<kvPair_t*>(p);
+            kvPair_t* kv = new kvPair_t;
             kv->cmd = cmd;
             kv->cmdIndex = cmdIndex++;
-            memcpy(kv->name, cmdName.raw(), cmdName.byteSize());
+            kv->name = Atom(cmdName);
             if (!map_.addIfNotFound(kv))
             {
                 ok = false;
-                delete[] p;
+                delete kv;
             }
             else
             {
-                added.add(cmdName);
+                added.add(kv->name);
                 if (cmdName.length() > maxNameLength_)
                 {
                     maxNameLength_ = cmdName.length();
@@ -228,12 +225,13 @@ unsigned int CmdMap::rm(const Cmd* cmd)
             void* removedItem;
             if (map_.rm(cmdName.ascii(), compareName, removedItem))
             {
-                removed.add(cmdName);
+                const kvPair_t* kv = static_cast<const kvPair_t*>(removedItem);
+                removed.add(kv->name);
                 if (cmdName.length() == maxNameLength_)
                 {
                     findMaxNameLength = true;
                 }
-                delete[] static_cast<const unsigned char*>(removedItem);
+                delete kv;
             }
         }
         numCmds = numItems - map_.numItems();
@@ -248,7 +246,7 @@ unsigned int CmdMap::rm(const Cmd* cmd)
         for (size_t i = 0; i < map_.numItems(); ++i)
         {
             const kvPair_t* kv = static_cast<const kvPair_t*>(map_.peek(i));
-            size_t nameLength = strlen(kv->name);
+            size_t nameLength = kv->name.asString().length();
             if (nameLength == maxNameLength_)
             {
                 maxNameLength = maxNameLength_;
@@ -285,7 +283,7 @@ void CmdMap::apply(cb1_t cb, void* arg) const
     for (size_t i = 0; i < map_.numItems(); ++i)
     {
         const kvPair_t* kv = static_cast<const kvPair_t*>(map_.peek(i));
-        cb(arg, kv->name, kv->cmd, kv->cmdIndex);
+        cb(arg, kv->name.ascii(), kv->cmd, kv->cmdIndex);
     }
 }
 
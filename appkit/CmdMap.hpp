@@ -6,6 +6,7 @@
 #define APPKIT_CMD_MAP_HPP
 
 #include <string.h>
+#include "appkit/Atom.hpp"
 #include "syskit/Bst.hpp"
 #include "syskit/CriSection.hpp"
 #include "syskit/Singleton.hpp"
@@ -14,7 +15,6 @@
 BEGIN_NAMESPACE1(appkit)
 
 class Cmd;
-class String;
 
 
 //! command map aka command registry
@@ -54,7 +54,7 @@ private:
     {
         Cmd* cmd;
         unsigned char cmdIndex;
-        char name[1]; //variable length
+        Atom name;
     } kvPair_t;
 
     static const char ID1[];
@@ -15,6 +15,263 @@ const char BACKSLASH = '\\';
 const char DOUBLE_QUOTE = '"';
 const char SINGLE_QUOTE = '\'';
 
+BEGIN_NAMESPACE
+
+
+//
+// Scanner locating the column delimiters which are not in quoted strings. The
+// row is scanned 64 bytes at a time. For each block, bitmasks of delimiters,
+// quotes, and backslashes are formed. Quoted regions are then located via a
+// prefix-XOR of the quote bitmask. Blocks which cannot be handled that way
+// (e.g., blocks with both kinds of quotes or with escaped quotes) are scanned
+// byte by byte.
+//
+class DelimScanner
+{
+public:
+    DelimScanner(const utf8_t* p, const utf8_t* pEnd, char delim);
+    const utf8_t* next();
+private:
+    enum
+    {
+        BlockSize = 64
+    };
+    typedef unsigned long long mask_t;
+    const utf8_t* base_;
+    const utf8_t* p_;
+    const utf8_t* pEnd_;
+    mask_t hits_;
+    bool escaped_;
+    bool useSse2_;
+    char delim_;
+    char quote_;
+    void scan();
+    void scanBytes(size_t);
+    static mask_t prefixXor(mask_t);
+#if HAS_SSE2_INTRINSICS
+    bool scanMasks(size_t);
+    static bool canRead64(const void*);
+#endif
+};
+
+
+DelimScanner::DelimScanner(const utf8_t* p, const utf8_t* pEnd, char delim)
+{
+    base_ = p;
+    p_ = p;
+    pEnd_ = pEnd;
+    hits_ = 0;
+    escaped_ = false;
+    delim_ = delim;
+    quote_ = 0;
+
+    // The bitmasks cannot tell apart a delimiter also used for quoting or escaping.
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    useSse2_ = s_useSse2 && (delim != DOUBLE_QUOTE) && (delim != SINGLE_QUOTE) && (delim != BACKSLASH);
+#else
+    useSse2_ = false;
+#endif
+}
+
+
+//
+// Return the next column delimiter which is not in a quoted string.
+// Return zero if there's none.
+//
+const utf8_t* DelimScanner::next()
+{
+    while (hits_ == 0)
+    {
+        if (p_ >= pEnd_)
+        {
+            return 0;
+        }
+        scan();
+    }
+
+    ulong32_t bit = 0;
+    unsigned int lo = static_cast<unsigned int>(hits_);
+    if (!_BitScanForward(&bit, lo))
+    {
+        _BitScanForward(&bit, static_cast<unsigned int>(hits_ >> 32));
+        bit += 32;
+    }
+    hits_ &= hits_ - 1;
+    return base_ + bit;
+}
+
+
+//
+// Return the bitmask with each bit set if an odd number of bits
+// are set at or below it in given bitmask.
+//
+DelimScanner::mask_t DelimScanner::prefixXor(mask_t mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+
+//
+// Scan the next block. Locate its column delimiters which are not in quoted strings.
+//
+void DelimScanner::scan()
+{
+    size_t n = pEnd_ - p_;
+    if (n > BlockSize)
+    {
+        n = BlockSize;
+    }
+
+#if HAS_SSE2_INTRINSICS
+    if ((!useSse2_) || (!scanMasks(n)))
+    {
+        scanBytes(n);
+    }
+#else
+    scanBytes(n);
+#endif
+
+    base_ = p_;
+    p_ += n;
+}
+
+
+//
+// Scan the next n bytes one at a time.
+//
+void DelimScanner::scanBytes(size_t n)
+{
+    const utf8_t* p = p_;
+    const utf8_t delim = delim_;
+    char quote = quote_;
+    mask_t hits = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (quote == 0)
+        {
+            if (p[i] == delim) hits |= 1ULL << i;
+            else if ((p[i] == DOUBLE_QUOTE) || (p[i] == SINGLE_QUOTE)) quote = p[i];
+        }
+        else if ((p[i] == quote) && (p[i - 1] != BACKSLASH))
+        {
+            quote = 0;
+        }
+    }
+
+    escaped_ = (p[n - 1] == BACKSLASH);
+    hits_ = hits;
+    quote_ = quote;
+}
+
+
+#if HAS_SSE2_INTRINSICS
+//
+// Return true if 64 bytes can be read starting at p without crossing into
+// the next 4KB page. Such reads are safe even if they go past the row.
+//
+bool DelimScanner::canRead64(const void* p)
+{
+    return ((reinterpret_cast<size_t>(p) & 4095U) <= (4096U - 64U));
+}
+
+
+//
+// Scan the next n bytes using bitmasks. Return false if the block
+// cannot be handled that way and must be scanned byte by byte.
+//
+bool DelimScanner::scanMasks(size_t n)
+{
+    if ((n < BlockSize) && (!canRead64(p_)))
+    {
+        return false;
+    }
+
+    // Form the bitmasks. Ignore bytes beyond the row.
+    const __m128i delim = _mm_set1_epi8(delim_);
+    const __m128i dquote = _mm_set1_epi8(DOUBLE_QUOTE);
+    const __m128i squote = _mm_set1_epi8(SINGLE_QUOTE);
+    const __m128i backslash = _mm_set1_epi8(BACKSLASH);
+    mask_t d = 0;
+    mask_t dq = 0;
+    mask_t sq = 0;
+    mask_t bs = 0;
+    for (unsigned int i = 0; i < BlockSize; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_ + i));
+        d |= static_cast<mask_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, delim))) << i;
+        dq |= static_cast<mask_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, dquote))) << i;
+        sq |= static_cast<mask_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, squote))) << i;
+        bs |= static_cast<mask_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash))) << i;
+    }
+    if (n < BlockSize)
+    {
+        mask_t valid = (1ULL << n) - 1;
+        d &= valid;
+        dq &= valid;
+        sq &= valid;
+        bs &= valid;
+    }
+
+    // Identify the quotes which can open or close a quoted string. The other
+    // kind of quotes must be absent, or the block is entirely in a quoted string.
+    char quote = quote_;
+    mask_t q;
+    if (quote == 0)
+    {
+        if (sq == 0)
+        {
+            quote = DOUBLE_QUOTE;
+            q = dq;
+        }
+        else if (dq == 0)
+        {
+            quote = SINGLE_QUOTE;
+            q = sq;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else
+    {
+        q = (quote == DOUBLE_QUOTE)? dq: sq;
+        mask_t other = (quote == DOUBLE_QUOTE)? sq: dq;
+        if ((q != 0) && (other != 0))
+        {
+            return false;
+        }
+    }
+
+    // Escaped quotes do not close quoted strings.
+    mask_t escaped = (bs << 1) | (escaped_? 1ULL: 0ULL);
+    if ((q & escaped) != 0)
+    {
+        return false;
+    }
+
+    // Quoted regions lie between odd and even quotes.
+    mask_t inQuotes = prefixXor(q);
+    if (quote_ != 0)
+    {
+        inQuotes = ~inQuotes;
+    }
+    hits_ = d & (~inQuotes);
+    quote_ = (inQuotes >> (BlockSize - 1))? quote: 0;
+    escaped_ = ((bs >> (n - 1)) & 1ULL) != 0;
+    return true;
+}
+#endif
+
+END_NAMESPACE
+
 BEGIN_NAMESPACE1(appkit)
 
 
@@ -70,37 +327,21 @@ bool CsvRow::apply(cb1_t cb, void* arg) const
 
     // Iterate from left to right. Invoke callback at each column.
     // Return immediately if aborting.
-    const char delim = delim_;
+    DelimScanner scanner(row_, pEnd_, delim_);
     const utf8_t* p;
     const utf8_t* p1;
-    char quote = 0;
-    for (p = p1 = row_; p < pEnd_; ++p)
+    for (p1 = row_; (p = scanner.next()) != 0; p1 = p + 1)
     {
-        if (quote == 0)
-        {
-            if (p[0] == delim)
-            {
-                if (!cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1))
-                {
-                    return false;
-                }
-                p1 = p + 1;
-            }
-            else if ((p[0] == DOUBLE_QUOTE) || (p[0] == SINGLE_QUOTE))
-            {
-                quote = p[0];
-            }
-        }
-        else if ((p[0] == quote) && (p[-1] != BACKSLASH))
+        if (!cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1))
         {
-            quote = 0;
+            return false;
         }
     }
 
     // Still need to take care of the last column w/o a column delimiter.
-    if (p1 < p)
+    if (p1 < pEnd_)
     {
-        return cb(arg, reinterpret_cast<const char*>(p1), p - p1);
+        return cb(arg, reinterpret_cast<const char*>(p1), pEnd_ - p1);
     }
 
     // Return true to indicate the iterating was not aborted.
@@ -232,21 +473,12 @@ bool CsvRow::next(const char*& col, size_t& length)
     // If a column delimiter is in a quoted string, consider it part of the string.
     if (ok)
     {
-        const utf8_t* p;
-        const utf8_t* pLast;
-        const char delim = delim_;
-        char quote = 0;
-        for (p = p1_, pLast = pEnd_ - 1; p < pLast; ++p)
+        const utf8_t* pLast = pEnd_ - 1;
+        DelimScanner scanner(p1_, pLast, delim_);
+        const utf8_t* p = scanner.next();
+        if (p == 0)
         {
-            if (quote == 0)
-            {
-                if (p[0] == delim) break;
-                else if ((p[0] == DOUBLE_QUOTE) || (p[0] == SINGLE_QUOTE)) quote = p[0];
-            }
-            else if ((p[0] == quote) && (p[-1] != BACKSLASH))
-            {
-                quote = 0;
-            }
+            p = pLast;
         }
         p2_ = p;
         col = reinterpret_cast<const char*>(p1_);
@@ -290,24 +522,17 @@ size_t CsvRow::countCols() const
 {
 
     // Iterate from left to right. Count each column.
-    const char delim = delim_;
+    DelimScanner scanner(row_, pEnd_, delim_);
+    const utf8_t* p;
+    const utf8_t* p1;
     size_t numCols = 0;
-    char quote = 0;
-    for (const utf8_t* p = row_; p < pEnd_; ++p)
+    for (p1 = row_; (p = scanner.next()) != 0; p1 = p + 1)
     {
-        if (quote == 0)
-        {
-            if (p[0] == delim) ++numCols;
-            else if ((p[0] == DOUBLE_QUOTE) || (p[0] == SINGLE_QUOTE)) quote = p[0];
-        }
-        else if ((p[0] == quote) && (p[-1] != BACKSLASH))
-        {
-            quote = 0;
-        }
+        ++numCols;
     }
 
     // Still need to take care of the last column w/o a column delimiter.
-    if ((row_ != pEnd_) && (*(pEnd_ - 1) != delim))
+    if (p1 < pEnd_)
     {
         ++numCols;
     }
@@ -336,34 +561,18 @@ void CsvRow::apply(cb4_t cb, void* arg) const
 {
 
     // Iterate from left to right. Invoke callback at each column.
-    const char delim = delim_;
+    DelimScanner scanner(row_, pEnd_, delim_);
     const utf8_t* p;
     const utf8_t* p1;
-    char quote = 0;
-    for (p = p1 = row_; p < pEnd_; ++p)
+    for (p1 = row_; (p = scanner.next()) != 0; p1 = p + 1)
     {
-        if (quote == 0)
-        {
-            if (p[0] == delim)
-            {
-                cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1);
-                p1 = p + 1;
-            }
-            else if ((p[0] == DOUBLE_QUOTE) || (p[0] == SINGLE_QUOTE))
-            {
-                quote = p[0];
-            }
-        }
-        else if ((p[0] == quote) && (p[-1] != BACKSLASH))
-        {
-            quote = 0;
-        }
+        cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1);
     }
 
     // Still need to take care of the last column w/o a column delimiter.
-    if (p1 < p)
+    if (p1 < pEnd_)
     {
-        cb(arg, reinterpret_cast<const char*>(p1), p - p1);
+        cb(arg, reinterpret_cast<const char*>(p1), pEnd_ - p1);
     }
 }
 
@@ -2,10 +2,14 @@
  * Software by Thanh Phung -- thanhtphung@yahoo.com.
  * No copyrights. No warranties. No restrictions in reuse.
  */
+#include "syskit/MappedTxtFile.hpp"
+#include "syskit/ThreadPool.hpp"
+#include "syskit/U32Vec.hpp"
 #include "syskit/macros.h"
 
 #include "appkit-pch.h"
 #include "appkit/DelimitedTxt.hpp"
+#include "appkit/StrVec.hpp"
 #include "appkit/StringVec.hpp"
 
 using namespace syskit;
@@ -14,6 +18,180 @@ const char CARRIAGE_RETURN = '\r';
 const char LINE_FEED = '\n';
 const utf32_t CARRIAGE_RETURN32 = '\r';
 
+BEGIN_NAMESPACE
+
+// Delimiter-aligned chunk of text. When delivering lines in order,
+// the chunk is first split into lines, and the line ends relative to
+// the chunk start are saved in ends.
+typedef struct
+{
+    const utf8_t* lo;
+    const utf8_t* hi;
+    U32Vec* ends;
+    char delim;
+} chunk_t;
+
+typedef struct
+{
+    appkit::DelimitedTxt::cb1_t cb;
+    void* arg;
+    const chunk_t* chunk;
+    bool volatile aborted;
+} parallelArg_t;
+
+// Return the number of delimiters in the [p, pEnd) range.
+size_t countDelims(const utf8_t* p, const utf8_t* pEnd, char delim)
+{
+    size_t numDelims = 0;
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    if (s_useSse2)
+    {
+
+        // Accumulate per-byte hit counts for up to 255 blocks at a time,
+        // then sum them up horizontally.
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i d = _mm_set1_epi8(delim);
+        while ((pEnd - p) >= 16)
+        {
+            __m128i acc = zero;
+            for (unsigned int i = 0; (i < 255) && ((pEnd - p) >= 16); ++i, p += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(v, d));
+            }
+            __m128i sum = _mm_sad_epu8(acc, zero);
+            numDelims += _mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4);
+        }
+    }
+#endif
+
+    for (const utf8_t d8 = delim; p < pEnd; ++p)
+    {
+        if (*p == d8)
+        {
+            ++numDelims;
+        }
+    }
+
+    return numDelims;
+}
+
+// Locate the first delimiter in the [p, pEnd) range.
+// Return pEnd if not found.
+const utf8_t* findDelim(const utf8_t* p, const utf8_t* pEnd, char delim)
+{
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i d = _mm_set1_epi8(delim);
+        for (; (pEnd - p) >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, d));
+            ulong32_t bit;
+            if (_BitScanForward(&bit, mask))
+            {
+                return p + bit;
+            }
+        }
+    }
+#endif
+
+    const utf8_t d8 = delim;
+    for (; (p < pEnd) && (*p != d8); ++p);
+    return p;
+}
+
+// Locate the last delimiter in the [pLo, p) range.
+// Return zero if not found.
+const utf8_t* rfindDelim(const utf8_t* pLo, const utf8_t* p, char delim)
+{
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i d = _mm_set1_epi8(delim);
+        for (; (p - pLo) >= 16;)
+        {
+            p -= 16;
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, d));
+            ulong32_t bit;
+            if (_BitScanReverse(&bit, mask))
+            {
+                return p + bit;
+            }
+        }
+    }
+#endif
+
+    for (const utf8_t d8 = delim; p > pLo;)
+    {
+        if (*--p == d8)
+        {
+            return p;
+        }
+    }
+
+    return 0;
+}
+
+// Apply callback to each line in the [loIndex, hiIndex) chunk range.
+// Stop if the callback aborts the iterating here or elsewhere.
+void applyChunks(void* arg, size_t loIndex, size_t hiIndex)
+{
+    parallelArg_t* r = static_cast<parallelArg_t*>(arg);
+    for (size_t i = loIndex; (i < hiIndex) && (!r->aborted); ++i)
+    {
+        const chunk_t& chunk = r->chunk[i];
+        for (const utf8_t* p1 = chunk.lo, * p2; p1 < chunk.hi; p1 = p2)
+        {
+            p2 = findDelim(p1, chunk.hi, chunk.delim);
+            p2 = (p2 < chunk.hi)? (p2 + 1): chunk.hi;
+            if (r->aborted || (!r->cb(r->arg, reinterpret_cast<const char*>(p1), p2 - p1)))
+            {
+                r->aborted = true;
+                break;
+            }
+        }
+    }
+}
+
+// Apply callback to each line in given chunk using the saved line ends.
+// Return false if the callback aborted the iterating.
+bool deliverChunk(const parallelArg_t* r, const chunk_t& chunk)
+{
+    const utf8_t* p1 = chunk.lo;
+    for (size_t i = 0, numLines = chunk.ends->numItems(); i < numLines; ++i)
+    {
+        const utf8_t* p2 = chunk.lo + (*chunk.ends)[i];
+        if (!r->cb(r->arg, reinterpret_cast<const char*>(p1), p2 - p1))
+        {
+            return false;
+        }
+        p1 = p2;
+    }
+
+    return true;
+}
+
+// Split given chunk into lines. Save the line ends.
+void scanChunk(void* arg)
+{
+    chunk_t& chunk = *static_cast<chunk_t*>(arg);
+    chunk.ends->reset();
+    for (const utf8_t* p1 = chunk.lo, * p2; p1 < chunk.hi; p1 = p2)
+    {
+        p2 = findDelim(p1, chunk.hi, chunk.delim);
+        p2 = (p2 < chunk.hi)? (p2 + 1): chunk.hi;
+        chunk.ends->add(static_cast<U32Vec::item_t>(p2 - chunk.lo));
+    }
+}
+
+END_NAMESPACE
+
 BEGIN_NAMESPACE1(appkit)
 
 
@@ -60,6 +238,21 @@ DelimitedTxt::DelimitedTxt(const DelimitedTxt& delimitedTxt, bool makeCopy)
 }
 
 
+//!
+//! Construct an instance attached to the image of given memory-mapped text file.
+//! The image is not copied and must outlive the instance. Use given delimiter
+//! when parsing for lines.
+//!
+DelimitedTxt::DelimitedTxt(const MappedTxtFile& file, char delim)
+{
+    delim_ = delim;
+    txt_ = 0;
+    txtIsMine_ = true;
+    bool makeCopy = false;
+    setTxt(reinterpret_cast<const char*>(file.image()), static_cast<size_t>(file.imageSize()), makeCopy);
+}
+
+
 //!
 //! Construct instance using given text. A deep copy of the given text is made if
 //! makeCopy is true.
@@ -116,20 +309,16 @@ bool DelimitedTxt::applyHiToLo(cb1_t cb, void* arg) const
     const char delim = delim_;
     const utf8_t* p;
     const utf8_t* p2;
-    for (p = p2 = pEnd_ - 1; p > txt_;)
+    for (p2 = pEnd_ - 1; (p = rfindDelim(txt_, p2, delim)) != 0; p2 = p)
     {
-        if (*--p == delim)
+        if (!cb(arg, reinterpret_cast<const char*>(p + 1), p2 - p))
         {
-            if (!cb(arg, reinterpret_cast<const char*>(p + 1), p2 - p))
-            {
-                return false;
-            }
-            p2 = p;
+            return false;
         }
     }
 
     // Still need to take care of the top line.
-    return cb(arg, reinterpret_cast<const char*>(p), p2 - p + 1);
+    return cb(arg, reinterpret_cast<const char*>(txt_), p2 - txt_ + 1);
 }
 
 
@@ -161,22 +350,18 @@ bool DelimitedTxt::applyLoToHi(cb1_t cb, void* arg) const
     const char delim = delim_;
     const utf8_t* p;
     const utf8_t* p1;
-    for (p = p1 = txt_; p < pEnd_; ++p)
+    for (p1 = txt_; (p = findDelim(p1, pEnd_, delim)) < pEnd_; p1 = p + 1)
     {
-        if (*p == delim)
+        if (!cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1))
         {
-            if (!cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1))
-            {
-                return false;
-            }
-            p1 = p + 1;
+            return false;
         }
     }
 
     // Still need to take care of the bottom line w/o a line delimiter.
-    if (p1 < p)
+    if (p1 < pEnd_)
     {
-        return cb(arg, reinterpret_cast<const char*>(p1), p - p1);
+        return cb(arg, reinterpret_cast<const char*>(p1), pEnd_ - p1);
     }
 
     // Return true to indicate the iterating was not aborted.
@@ -184,6 +369,104 @@ bool DelimitedTxt::applyLoToHi(cb1_t cb, void* arg) const
 }
 
 
+//!
+//! Apply callback to each line in parallel using given thread pool (the process-wide
+//! pool if zero). The text is split into delimiter-aligned chunks, and the lines in
+//! each chunk are iterated from top to bottom. The callback should return true to
+//! continue iterating and should return false to abort iterating. Return false if
+//! the callback aborted the iterating. Return true otherwise. If ordered is false,
+//! chunks are iterated by several threads concurrently, and the callback must be
+//! thread-safe with respect to arg. If ordered is true, lines are delivered from
+//! top to bottom by one thread at a time while the chunks ahead are being split
+//! into lines by other threads. Small text is iterated by the calling thread.
+//!
+bool DelimitedTxt::applyParallel(cb1_t cb, void* arg, bool ordered, ThreadPool* pool) const
+{
+
+    // Use a few chunks per worker. Iterate small text by the calling thread.
+    ThreadPool& threadPool = (pool != 0)? *pool: ThreadPool::instance();
+    size_t numWorkers = threadPool.numWorkers();
+    size_t txtSize = pEnd_ - txt_;
+    if ((txtSize <= MinChunkSize) || (numWorkers == 0) || (!threadPool.isOk()))
+    {
+        return applyLoToHi(cb, arg);
+    }
+    size_t chunkSize = txtSize / (numWorkers * ChunksPerWorker);
+    if (chunkSize < MinChunkSize) chunkSize = MinChunkSize;
+    else if (chunkSize > MaxChunkSize) chunkSize = MaxChunkSize;
+
+    // Split text into delimiter-aligned chunks. Each chunk but the
+    // last one holds at least chunkSize bytes.
+    chunk_t* chunk = new chunk_t[txtSize / chunkSize + 1];
+    size_t numChunks = 0;
+    for (const utf8_t* p1 = txt_, * p2; p1 < pEnd_; p1 = p2, ++numChunks)
+    {
+        p2 = (static_cast<size_t>(pEnd_ - p1) > chunkSize)? findDelim(p1 + chunkSize - 1, pEnd_, delim_): pEnd_;
+        p2 = (p2 < pEnd_)? (p2 + 1): pEnd_;
+        chunk_t& c = chunk[numChunks];
+        c.lo = p1;
+        c.hi = p2;
+        c.ends = 0;
+        c.delim = delim_;
+    }
+
+    // Iterate the chunks concurrently.
+    parallelArg_t r = {cb, arg, chunk, false /*aborted*/};
+    if (!ordered)
+    {
+        threadPool.apply(numChunks, applyChunks, &r, 1 /*grainSize*/);
+    }
+
+    // Deliver lines in order. Process chunks in windows of one chunk per
+    // worker. Split the chunks in the next window into lines while
+    // delivering the lines in the current window.
+    else
+    {
+        size_t window = numWorkers;
+        size_t numBufs = window * 2;
+        U32Vec** ends = new U32Vec*[numBufs];
+        for (size_t i = 0; i < numBufs; ++i)
+        {
+            ends[i] = new U32Vec(U32Vec::DefaultCap, -1 /*growBy*/);
+        }
+
+        ThreadPool::Group group(threadPool);
+        for (size_t i = 0, hi = (window < numChunks)? window: numChunks; i < hi; ++i)
+        {
+            chunk[i].ends = ends[i % numBufs];
+            group.run(scanChunk, chunk + i);
+        }
+        group.wait();
+
+        for (size_t lo = 0; (lo < numChunks) && (!r.aborted); lo += window)
+        {
+            size_t hi = ((lo + window) < numChunks)? (lo + window): numChunks;
+            size_t nextHi = ((hi + window) < numChunks)? (hi + window): numChunks;
+            for (size_t i = hi; i < nextHi; ++i)
+            {
+                chunk[i].ends = ends[i % numBufs];
+                group.run(scanChunk, chunk + i);
+            }
+            for (size_t i = lo; (i < hi) && (!r.aborted); ++i)
+            {
+                r.aborted = !deliverChunk(&r, chunk[i]);
+            }
+            group.wait();
+        }
+
+        for (size_t i = 0; i < numBufs; ++i)
+        {
+            delete ends[i];
+        }
+        delete[] ends;
+    }
+
+    delete[] chunk;
+    bool ok = (!r.aborted);
+    return ok;
+}
+
+
 //
 // Retrieve the next line (i.e., the next line iterating from top to
 // bottom). Return true if there's one. Otherwise, return false and
@@ -252,10 +535,7 @@ bool DelimitedTxt::next(const char*& line, size_t& length)
     // Retrieve the next line.
     if (ok)
     {
-        const char delim = delim_;
-        const utf8_t* p;
-        const utf8_t* pLast;
-        for (p = p1_, pLast = pEnd_ - 1; p < pLast && *p != delim; ++p);
+        const utf8_t* p = findDelim(p1_, pEnd_ - 1, delim_);
         p2_ = p;
         line = reinterpret_cast<const char*>(p1_);
         length = p - p1_ + 1;
@@ -300,10 +580,7 @@ bool DelimitedTxt::peekDown(const char*& line, size_t& length) const
     bool ok;
     if (p1 != 0)
     {
-        const char delim = delim_;
-        const utf8_t* p;
-        const utf8_t* pLast;
-        for (p = p1, pLast = pEnd_ - 1; p < pLast && *p != delim; ++p);
+        const utf8_t* p = findDelim(p1, pEnd_ - 1, delim_);
         line = reinterpret_cast<const char*>(p1);
         length = p - p1 + 1;
         ok = true;
@@ -349,11 +626,10 @@ bool DelimitedTxt::peekUp(const char*& line, size_t& length) const
     bool ok;
     if (p2 != 0)
     {
-        const char delim = delim_;
-        const utf8_t* p;
-        for (p = p2 - 1; p >= txt_ && *p != delim; --p);
-        line = reinterpret_cast<const char*>(p)+1;
-        length = p2 - p;
+        const utf8_t* p = rfindDelim(txt_, p2, delim_);
+        const utf8_t* p1 = (p != 0)? (p + 1): txt_;
+        line = reinterpret_cast<const char*>(p1);
+        length = p2 - p1 + 1;
         ok = true;
     }
     else
@@ -400,12 +676,10 @@ bool DelimitedTxt::prev(const char*& line, size_t& length)
     // Retrieve the previous line.
     if (ok)
     {
-        const char delim = delim_;
-        const utf8_t* p;
-        for (p = p2_ - 1; p >= txt_ && *p != delim; --p);
-        p1_ = p + 1;
+        const utf8_t* p = rfindDelim(txt_, p2_, delim_);
+        p1_ = (p != 0)? (p + 1): txt_;
         line = reinterpret_cast<const char*>(p1_);
-        length = p2_ - p;
+        length = p2_ - p1_ + 1;
     }
     else
     {
@@ -426,6 +700,14 @@ bool DelimitedTxt::proxy0(void* arg, const char* line, size_t length)
 }
 
 
+bool DelimitedTxt::proxy4(void* arg, const char* line, size_t length)
+{
+    const arg4_t& arg4 = *static_cast<const arg4_t*>(arg);
+    arg4.cb(arg4.arg, line, length);
+    return true;
+}
+
+
 //
 // Retrieve the next line (i.e., the next line iterating from top to
 // bottom). Return true if there's one. Otherwise, return false and
@@ -464,6 +746,22 @@ bool DelimitedTxt::trimPrev(String& line)
 }
 
 
+//!
+//! Look at text as a vector of packed lines. Return true if successful.
+//! Return false otherwise (result is partial due to insufficient capacity
+//! in provided vector). If doTrimLine is true, the returned lines are also
+//! trimmed. Unlike the StringVec form, no per-line allocations are made.
+//!
+bool DelimitedTxt::vectorize(StrVec& vec, bool doTrimLine, bool reverseOrder) const
+{
+    vec.reset();
+    packArg_t arg = {true /*ok*/, this, &vec};
+    cb4_t cb = doTrimLine? trimAndPack: pack;
+    reverseOrder? applyHiToLo(cb, &arg): applyLoToHi(cb, &arg);
+    return arg.ok;
+}
+
+
 //!
 //! Look at text as a vector of lines. Return true if successful. Return
 //! false otherwise (result is partial due to insufficient capacity in
@@ -509,19 +807,12 @@ const String& DelimitedTxt::trimLine(String& line) const
 size_t DelimitedTxt::countLines() const
 {
 
-    // Iterate from top to bottom. Count each line.
+    // Count the delimited lines.
     const char delim = delim_;
-    size_t numLines = 0;
-    for (const utf8_t* p = txt_; p < pEnd_; ++p)
-    {
-        if (*p == delim)
-        {
-            ++numLines;
-        }
-    }
+    size_t numLines = countDelims(txt_, pEnd_, delim);
 
     // Still need to take care of the bottom line w/o a line delimiter.
-    if ((txt_ != pEnd_) && (*(pEnd_ - 1) != delim))
+    if ((txt_ != pEnd_) && (*(pEnd_ - 1) != static_cast<utf8_t>(delim)))
     {
         ++numLines;
     }
@@ -572,17 +863,13 @@ void DelimitedTxt::applyHiToLo(cb4_t cb, void* arg) const
     const char delim = delim_;
     const utf8_t* p;
     const utf8_t* p2;
-    for (p = p2 = pEnd_ - 1; p > txt_;)
+    for (p2 = pEnd_ - 1; (p = rfindDelim(txt_, p2, delim)) != 0; p2 = p)
     {
-        if (*--p == delim)
-        {
-            cb(arg, reinterpret_cast<const char*>(p + 1), p2 - p);
-            p2 = p;
-        }
+        cb(arg, reinterpret_cast<const char*>(p + 1), p2 - p);
     }
 
     // Still need to take care of the top line.
-    cb(arg, reinterpret_cast<const char*>(p), p2 - p + 1);
+    cb(arg, reinterpret_cast<const char*>(txt_), p2 - txt_ + 1);
 }
 
 
@@ -607,19 +894,15 @@ void DelimitedTxt::applyLoToHi(cb4_t cb, void* arg) const
     const char delim = delim_;
     const utf8_t* p;
     const utf8_t* p1;
-    for (p = p1 = txt_; p < pEnd_; ++p)
+    for (p1 = txt_; (p = findDelim(p1, pEnd_, delim)) < pEnd_; p1 = p + 1)
     {
-        if (*p == delim)
-        {
-            cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1);
-            p1 = p + 1;
-        }
+        cb(arg, reinterpret_cast<const char*>(p1), p - p1 + 1);
     }
 
     // Still need to take care of the bottom line w/o a line delimiter.
-    if (p1 < p)
+    if (p1 < pEnd_)
     {
-        cb(arg, reinterpret_cast<const char*>(p1), p - p1);
+        cb(arg, reinterpret_cast<const char*>(p1), pEnd_ - p1);
     }
 }
 
@@ -638,6 +921,16 @@ void DelimitedTxt::copyFrom(const DelimitedTxt& delimitedTxt)
 }
 
 
+void DelimitedTxt::pack(void* arg, const char* line, size_t length)
+{
+    packArg_t& r = *static_cast<packArg_t*>(arg);
+    if (r.ok && (!r.vec->add(line, length)))
+    {
+        r.ok = false;
+    }
+}
+
+
 void DelimitedTxt::proxy3(void* arg, const char* line, size_t length)
 {
     const arg3_t& arg3 = *static_cast<const arg3_t*>(arg);
@@ -690,6 +983,17 @@ void DelimitedTxt::save(void* arg, const char* line, size_t length)
 }
 
 
+void DelimitedTxt::trimAndPack(void* arg, const char* line, size_t length)
+{
+    packArg_t& r = *static_cast<packArg_t*>(arg);
+    length = r.txt->trimLine(line, length);
+    if (r.ok && (!r.vec->add(line, length)))
+    {
+        r.ok = false;
+    }
+}
+
+
 void DelimitedTxt::trimAndSave(void* arg, const char* line, size_t length)
 {
     saveArg_t& r = *static_cast<saveArg_t*>(arg);
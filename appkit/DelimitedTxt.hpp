@@ -8,8 +8,12 @@
 #include "appkit/String.hpp"
 #include "syskit/sys.hpp"
 
+DECLARE_CLASS1(syskit, MappedTxtFile)
+DECLARE_CLASS1(syskit, ThreadPool)
+
 BEGIN_NAMESPACE1(appkit)
 
+class StrVec;
 class StringVec;
 
 
@@ -23,7 +27,10 @@ class DelimitedTxt
     //! be specified at construction or afterwards using setDelim(). To
     //! iterate downward, use the next() and/or applyLoToHi() methods. To
     //! iterate upward, use the prev() and/or applyHiToLo() methods. Peeking
-    //! is supported via the peekDown() and peekUp() methods. Example:
+    //! is supported via the peekDown() and peekUp() methods. Large text such
+    //! as a memory-mapped log file can be split into delimiter-aligned chunks
+    //! whose lines are processed by several threads using applyParallel().
+    //! Example:
     //!\code
     //! const char* s = "1" "\n" "22" "\n" "333" "\n";
     //! DelimitedTxt txt(s, strlen(s));
@@ -49,6 +56,7 @@ public:
     DelimitedTxt(char delim = '\n');
     DelimitedTxt(const DelimitedTxt& delimitedTxt);
     DelimitedTxt(const DelimitedTxt& delimitedTxt, bool makeCopy);
+    DelimitedTxt(const syskit::MappedTxtFile& file, char delim = '\n');
     DelimitedTxt(const String& txt, bool makeCopy = false, char delim = '\n');
     DelimitedTxt(const char* txt, size_t length, bool makeCopy = false, char delim = '\n');
     ~DelimitedTxt();
@@ -61,6 +69,7 @@ public:
     bool applyHiToLo(cb1_t cb, void* arg = 0) const;
     bool applyLoToHi(cb0_t cb, void* arg = 0) const;
     bool applyLoToHi(cb1_t cb, void* arg = 0) const;
+    bool applyParallel(cb1_t cb, void* arg = 0, bool ordered = false, syskit::ThreadPool* pool = 0) const;
     bool next(String& line, bool doTrimLine = false);
     bool next(const char*& line, size_t& length);
     bool peekDown() const;
@@ -71,11 +80,13 @@ public:
     bool peekUp(const char*& line, size_t& length) const;
     bool prev(String& line, bool doTrimLine = false);
     bool prev(const char*& line, size_t& length);
+    bool vectorize(StrVec& vec, bool doTrimLine = false, bool reverseOrder = false) const;
     bool vectorize(StringVec& vec, bool doTrimLine = false, bool reverseOrder = false) const;
     void applyHiToLo(cb3_t cb, void* arg = 0) const;
     void applyHiToLo(cb4_t cb, void* arg = 0) const;
     void applyLoToHi(cb3_t cb, void* arg = 0) const;
     void applyLoToHi(cb4_t cb, void* arg = 0) const;
+    void applyParallel(cb4_t cb, void* arg = 0, bool ordered = false, syskit::ThreadPool* pool = 0) const;
     void reset();
 
     // Utilities.
@@ -91,6 +102,13 @@ public:
     void setTxt(const char* txt, size_t length, bool makeCopy = false);
 
 private:
+    enum
+    {
+        ChunksPerWorker = 4,
+        MaxChunkSize = 4 * 1024 * 1024,
+        MinChunkSize = 64 * 1024
+    };
+
     typedef struct
     {
         cb0_t cb;
@@ -105,6 +123,12 @@ private:
         String* line;
     } arg3_t;
 
+    typedef struct
+    {
+        cb4_t cb;
+        void* arg;
+    } arg4_t;
+
     typedef struct
     {
         bool ok;
@@ -113,6 +137,13 @@ private:
         StringVec* vec;
     } saveArg_t;
 
+    typedef struct
+    {
+        bool ok;
+        const DelimitedTxt* txt;
+        StrVec* vec;
+    } packArg_t;
+
     bool txtIsMine_;
     char delim_;
     const syskit::utf8_t* p1_;
@@ -128,9 +159,12 @@ private:
 
     static bool proxy0(void*, const char*, size_t);
     static bool proxy2(void*, const char*, size_t);
+    static bool proxy4(void*, const char*, size_t);
+    static void pack(void*, const char*, size_t);
     static void proxy3(void*, const char*, size_t);
     static void proxy5(void*, const char*, size_t);
     static void save(void*, const char*, size_t);
+    static void trimAndPack(void*, const char*, size_t);
     static void trimAndSave(void*, const char*, size_t);
 
 };
@@ -240,6 +274,18 @@ inline size_t DelimitedTxt::txtSize() const
     return pEnd_ - txt_;
 }
 
+//! Apply callback to each line in parallel using given thread pool (the
+//! process-wide pool if zero). Lines are not delivered in any particular
+//! order unless ordered is true. Ordered lines are delivered top to bottom
+//! by one thread at a time while subsequent chunks are being split into
+//! lines by other threads. Unordered lines are delivered by several threads
+//! concurrently, and the callback must be thread-safe with respect to arg.
+inline void DelimitedTxt::applyParallel(cb4_t cb, void* arg, bool ordered, syskit::ThreadPool* pool) const
+{
+    arg4_t arg4 = {cb, arg};
+    applyParallel(proxy4, &arg4, ordered, pool);
+}
+
 //! Reset the iterator to its initial state. That is, next() will
 //! return the top line, and prev() will return bottom line.
 inline void DelimitedTxt::reset()
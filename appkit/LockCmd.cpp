@@ -0,0 +1,169 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit/BufPool.hpp"
+#include "syskit/LockStat.hpp"
+#include "syskit/macros.h"
+
+#include "appkit-pch.h"
+#include "appkit/Bool.hpp"
+#include "appkit/LockCmd.hpp"
+#include "appkit/U32.hpp"
+#include "appkit/crt.hpp"
+
+using namespace syskit;
+
+// Supported command set.
+const char CMD_SET[] =
+" lock-profile"
+;
+
+// Usage texts. One per command. Must match supported command set.
+const char USAGE_0[] =
+"Usage:\n"
+"  lock-profile [--dump=xxx]\n"
+"               [--reset   ]\n"
+"               [--start   ]\n"
+"               [--stop    ]\n"
+"               [--top=xxx ]\n\n"
+"Examples:\n"
+"  lock-profile --start --reset\n"
+"  lock-profile --top=30\n"
+"  lock-profile --stop --dump=/tmp/lock-profile.txt\n"
+;
+
+const char* const USAGE[] =
+{
+    USAGE_0 //lock-profile
+};
+
+// Extended names. One per command. Must match supported command set.
+const char* const X_NAME[] =
+{
+    "profile lock contention" //lock-profile
+};
+
+// Extended usage texts. One per command. Must match supported command set.
+const char X_USAGE_0[] =
+"\n"
+"Options:\n"
+"--dump=xxx\n"
+"  Save the profile report in given file instead of responding with it.\n"
+"--reset\n"
+"  Reset the statistics of all profiled locks.\n"
+"--start\n"
+"--stop\n"
+"  Start or stop profiling. Starting also profiles the BufPool locks.\n"
+"--top=xxx\n"
+"  Show at most xxx locks, most contended first. Default is 16.\n"
+;
+
+const char* const X_USAGE[] =
+{
+    X_USAGE_0 //lock-profile
+};
+
+BEGIN_NAMESPACE1(appkit)
+
+
+// Command doers. One per command. Must match supported command set.
+LockCmd::doer_t LockCmd::doer_[] =
+{
+    &LockCmd::doProfile //lock-profile
+};
+
+
+LockCmd::LockCmd():
+Cmd(CMD_SET)
+{
+}
+
+
+LockCmd::~LockCmd()
+{
+}
+
+
+//
+// lock-profile [--dump=xxx]
+//              [--reset   ]
+//              [--start   ]
+//              [--stop    ]
+//              [--top=xxx ]
+//
+bool LockCmd::doProfile(const CmdLine& req)
+{
+    String optK("start");
+    if (Bool(req.opt(optK), false /*defaultV*/))
+    {
+        BufPool::instance().profileLocks();
+        LockStat::enable(true);
+    }
+    else
+    {
+        optK = "stop";
+        if (Bool(req.opt(optK), false /*defaultV*/))
+        {
+            LockStat::enable(false);
+        }
+    }
+
+    optK = "reset";
+    if (Bool(req.opt(optK), false /*defaultV*/))
+    {
+        LockStat::resetAll();
+    }
+
+    optK = "top";
+    U32 maxLocks(req.opt(optK), LockStat::DefaultMaxLocks);
+    optK = "dump";
+    const String* path = req.opt(optK);
+    if ((path != 0) && (!path->empty()))
+    {
+        bool ok = LockStat::dump(path->ascii(), maxLocks);
+        formRsp(req, "%s %s.%c", ok? "Saved in": "Cannot save in", path->ascii(), 0);
+    }
+    else
+    {
+        char* rsp = LockStat::describe(maxLocks);
+        respond(req, rsp);
+        delete[] rsp;
+    }
+
+    bool cmdIsValid = true;
+    return cmdIsValid;
+}
+
+
+//!
+//! Run command using dedicated agent threads provided by the Cmd framework. Return
+//! true if command is valid. A false return results in some command usage hints as
+//! response to the request.
+//!
+bool LockCmd::onRun(const CmdLine& req)
+{
+    doer_t doer = doer_[cmdIndex(req)];
+    bool cmdIsValid = (this->*doer)(req);
+    return cmdIsValid;
+}
+
+
+const char* LockCmd::usage(unsigned char cmdIndex) const
+{
+    return USAGE[cmdIndex];
+}
+
+
+const char* LockCmd::xName(unsigned char cmdIndex) const
+{
+    return X_NAME[cmdIndex];
+}
+
+
+const char* LockCmd::xUsage(unsigned char cmdIndex) const
+{
+    return X_USAGE[cmdIndex];
+}
+
+END_NAMESPACE1
@@ -0,0 +1,41 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef APPKIT_LOCK_CMD_HPP
+#define APPKIT_LOCK_CMD_HPP
+
+#include "appkit/Cmd.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//! dbug commands to troubleshoot lock contention
+class LockCmd: public Cmd
+{
+
+public:
+    LockCmd();
+
+    virtual ~LockCmd();
+    virtual bool onRun(const CmdLine& req);
+    virtual const char* usage(unsigned char cmdIndex) const;
+    virtual const char* xName(unsigned char cmdIndex) const;
+    virtual const char* xUsage(unsigned char cmdIndex) const;
+
+private:
+    typedef bool (LockCmd::*doer_t)(const CmdLine& req);
+
+    static doer_t doer_[];
+
+    LockCmd(const LockCmd&); //prohibit usage
+    const LockCmd& operator =(const LockCmd&); //prohibit usage
+
+    bool doProfile(const CmdLine&);
+
+};
+
+END_NAMESPACE1
+
+#endif
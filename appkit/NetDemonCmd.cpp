@@ -18,6 +18,7 @@
 #include "appkit/CmdCmd.hpp"
 #include "appkit/CmdMap.hpp"
 #include "appkit/Directory.hpp"
+#include "appkit/LockCmd.hpp"
 #include "appkit/MiscDbugCmd.hpp"
 #include "appkit/NetDemon.hpp"
 #include "appkit/NetDemonCmd.hpp"
@@ -92,6 +93,7 @@ Cmd(CMD_SET)
 
     new BufPoolCmd;
     new CmdCmd(sysIo_);
+    new LockCmd;
     new MiscDbugCmd(sysIo_);
 }
 
@@ -100,6 +102,7 @@ NetDemonCmd::~NetDemonCmd()
 {
     const CmdMap* map = Cmd::map();
     delete map->find("version-show"); //MiscDbugCmd
+    delete map->find("lock-profile"); //LockCmd
     delete map->find("help");         //CmdCmd
     delete map->find("bufpool-show"); //BufPoolCmd
 }
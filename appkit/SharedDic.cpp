@@ -0,0 +1,218 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit/Epoch.hpp"
+#include "syskit/RefCounted.hpp"
+#include "syskit/macros.h"
+
+#include "appkit-pch.h"
+#include "appkit/SharedDic.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE1(appkit)
+
+
+// Published dictionary. The shared dictionary holds one reference
+// to the current dictionary, and each snapshot holds one reference.
+class SharedDic::Rep: public StringDic, public RefCounted
+{
+public:
+    Rep(StringDic* dic);
+    Rep(bool ignoreCase);
+    Rep(const StringDic& dic);
+    unsigned long long version() const;
+    void setVersion(unsigned long long version);
+private:
+    unsigned long long version_;
+    Rep(const Rep&); //prohibit usage
+    const Rep& operator =(const Rep&); //prohibit usage
+};
+
+SharedDic::Rep::Rep(StringDic* dic):
+StringDic(dic),
+RefCounted(1U)
+{
+    version_ = 0;
+}
+
+SharedDic::Rep::Rep(bool ignoreCase):
+StringDic(ignoreCase),
+RefCounted(1U)
+{
+    version_ = 0;
+}
+
+SharedDic::Rep::Rep(const StringDic& dic):
+StringDic(dic),
+RefCounted(1U)
+{
+    version_ = 0;
+}
+
+inline unsigned long long SharedDic::Rep::version() const
+{
+    return version_;
+}
+
+inline void SharedDic::Rep::setVersion(unsigned long long version)
+{
+    version_ = version;
+}
+
+
+//!
+//! Construct an empty shared dictionary. Snapshots are protected by given
+//! reclamation domain. Use the process-wide domain if epoch is zero.
+//!
+SharedDic::SharedDic(bool ignoreCase, Epoch* epoch):
+rep_(reinterpret_cast<AtomicWord::item_t>(new Rep(ignoreCase))),
+cs_(),
+epoch_((epoch == 0)? Epoch::instance(): *epoch)
+{
+}
+
+
+//!
+//! Construct a shared dictionary initially publishing a copy of given
+//! dictionary. Snapshots are protected by given reclamation domain. Use
+//! the process-wide domain if epoch is zero.
+//!
+SharedDic::SharedDic(const StringDic& dic, Epoch* epoch):
+rep_(reinterpret_cast<AtomicWord::item_t>(new Rep(dic))),
+cs_(),
+epoch_((epoch == 0)? Epoch::instance(): *epoch)
+{
+}
+
+
+//!
+//! Destruct the shared dictionary. The current dictionary persists until its
+//! last snapshot is destructed.
+//!
+SharedDic::~SharedDic()
+{
+    const Rep* rep = reinterpret_cast<const Rep*>(rep_.asWord());
+    rep->rmRef();
+}
+
+
+//!
+//! Update the shared dictionary. Invoke the callback with a private copy of the
+//! current dictionary. The callback should modify the copy and return true to
+//! publish it, or return false to abandon the update. Return true if the copy
+//! was published. Writers are serialized, so no update is lost.
+//!
+bool SharedDic::update(cb0_t cb, void* arg)
+{
+    CriSection::Lock lock(cs_);
+    const Rep* cur = reinterpret_cast<const Rep*>(rep_.asWord());
+    const StringDic& dic = *cur;
+    Rep* rep = new Rep(dic);
+    bool ok = cb(arg, *rep);
+    if (ok)
+    {
+        install(rep);
+    }
+    else
+    {
+        rep->rmRef();
+    }
+
+    return ok;
+}
+
+
+//
+// Take a snapshot. The epoch critical section keeps the current dictionary
+// from being destroyed between loading it and referencing it.
+//
+const StringDic* SharedDic::acquire(unsigned long long& version) const
+{
+    Epoch::Guard guard(epoch_);
+    const Rep* rep = reinterpret_cast<const Rep*>(rep_.asWord());
+    rep->addRef();
+    version = rep->version();
+    return rep;
+}
+
+
+//!
+//! Return the version of the current dictionary. The initial dictionary
+//! is version zero, and each publication increments the version.
+//!
+unsigned long long SharedDic::version() const
+{
+    Epoch::Guard guard(epoch_);
+    const Rep* rep = reinterpret_cast<const Rep*>(rep_.asWord());
+    return rep->version();
+}
+
+
+void SharedDic::addRef(const StringDic* dic)
+{
+    const Rep* rep = static_cast<const Rep*>(dic);
+    rep->addRef();
+}
+
+
+//
+// Reclaim callback. Drop the shared dictionary's reference to a
+// replaced dictionary once no reader can be about to reference it.
+//
+void SharedDic::dropRep(void* /*arg*/, void* item)
+{
+    const Rep* rep = static_cast<const Rep*>(item);
+    rep->rmRef();
+}
+
+
+//
+// Publish given dictionary as the next version. Must be invoked while holding
+// the writer lock. The replaced dictionary is released via the reclamation domain.
+// Writes are rare, so wait for in-flight snapshot acquisitions right here. The
+// replaced dictionary then lives exactly as long as its last snapshot, even if
+// this thread never writes again or exits without detaching.
+//
+void SharedDic::install(Rep* rep)
+{
+    const Rep* cur = reinterpret_cast<const Rep*>(rep_.asWord());
+    rep->setVersion(cur->version() + 1);
+    AtomicWord::item_t old;
+    rep_.set(reinterpret_cast<AtomicWord::item_t>(rep), old);
+    epoch_.retire(reinterpret_cast<Rep*>(old), dropRep);
+    epoch_.synchronize();
+}
+
+
+//!
+//! Publish given dictionary. Move the dictionary contents from dic. That is,
+//! dic is empty on return.
+//!
+void SharedDic::publish(StringDic* dic)
+{
+    Rep* rep = new Rep(dic);
+    CriSection::Lock lock(cs_);
+    install(rep);
+}
+
+
+//!
+//! Publish a copy of given dictionary.
+//!
+void SharedDic::publish(const StringDic& dic)
+{
+    Rep* rep = new Rep(dic);
+    CriSection::Lock lock(cs_);
+    install(rep);
+}
+
+
+void SharedDic::release(const StringDic* dic)
+{
+    const Rep* rep = static_cast<const Rep*>(dic);
+    rep->rmRef();
+}
+
+END_NAMESPACE1
@@ -0,0 +1,152 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef APPKIT_SHARED_DIC_HPP
+#define APPKIT_SHARED_DIC_HPP
+
+#include "appkit/StringDic.hpp"
+#include "syskit/AtomicWord.hpp"
+#include "syskit/CriSection.hpp"
+#include "syskit/macros.h"
+
+DECLARE_CLASS1(syskit, Epoch)
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//! copy-on-write dictionary of key-value strings
+class SharedDic
+    //!
+    //! A class representing a read-mostly dictionary of key-value strings shared
+    //! by many threads (e.g., configuration values). Readers get an immutable,
+    //! reference-counted snapshot without taking any lock. Writers never modify a
+    //! published dictionary. Instead, a writer builds a modified copy and publishes
+    //! it atomically. Readers holding an older snapshot keep using it undisturbed,
+    //! and the older dictionary is destroyed when its last snapshot is destructed.
+    //! Writers are serialized among themselves, and a writer briefly waits for
+    //! in-flight snapshot acquisitions before returning. Snapshot acquisition is
+    //! protected by an epoch-based reclamation domain, so a reader thread which
+    //! exits should detach from that domain. Example:
+    //!\code
+    //! SharedDic config;
+    //! :
+    //! { //reader
+    //!   SharedDic::Snapshot snapshot(config);
+    //!   unsigned int timeout = snapshot->getValueAsU32("timeout");
+    //! }
+    //! :
+    //! config.publish(&reloadedDic); //writer
+    //!\endcode
+    //!
+{
+
+public:
+    typedef bool(*cb0_t)(void* arg, StringDic& dic);
+
+
+    //! immutable dictionary snapshot
+    class Snapshot
+        //!
+        //! A class representing an immutable snapshot of a shared dictionary.
+        //! Construct an instance to take a snapshot, and destruct it to release
+        //! the snapshot. The snapshot remains valid and unchanged even if newer
+        //! dictionaries are published or if the shared dictionary is destructed.
+        //! Example:
+        //!\code
+        //! SharedDic::Snapshot snapshot(config);
+        //! const String* v = snapshot->find(k);
+        //!\endcode
+        //!
+    {
+    public:
+        Snapshot(const SharedDic& dic);
+        Snapshot(const Snapshot& snapshot);
+        ~Snapshot();
+        const StringDic& operator *() const;
+        const StringDic* operator ->() const;
+        const StringDic& dic() const;
+        unsigned long long version() const;
+    private:
+        const StringDic* dic_;
+        unsigned long long version_;
+        const Snapshot& operator =(const Snapshot&); //prohibit usage
+    };
+
+    SharedDic(bool ignoreCase = false, syskit::Epoch* epoch = 0);
+    SharedDic(const StringDic& dic, syskit::Epoch* epoch = 0);
+    ~SharedDic();
+
+    bool update(cb0_t cb, void* arg = 0);
+    unsigned long long version() const;
+    void publish(StringDic* dic);
+    void publish(const StringDic& dic);
+
+private:
+    class Rep;
+
+    syskit::AtomicWord rep_;
+    syskit::CriSection cs_;
+    syskit::Epoch& epoch_;
+
+    SharedDic(const SharedDic&); //prohibit usage
+    const SharedDic& operator =(const SharedDic&); //prohibit usage
+
+    const StringDic* acquire(unsigned long long&) const;
+    void install(Rep*);
+
+    static void addRef(const StringDic*);
+    static void dropRep(void*, void*);
+    static void release(const StringDic*);
+
+};
+
+//! Take a snapshot of given shared dictionary.
+inline SharedDic::Snapshot::Snapshot(const SharedDic& dic)
+{
+    dic_ = dic.acquire(version_);
+}
+
+//! Construct a duplicate snapshot of the same dictionary.
+inline SharedDic::Snapshot::Snapshot(const Snapshot& snapshot)
+{
+    addRef(snapshot.dic_);
+    dic_ = snapshot.dic_;
+    version_ = snapshot.version_;
+}
+
+//! Release the snapshot. Destroy its dictionary if it is no longer
+//! published and this is its last snapshot.
+inline SharedDic::Snapshot::~Snapshot()
+{
+    release(dic_);
+}
+
+//! Return the snapshot dictionary.
+inline const StringDic& SharedDic::Snapshot::operator *() const
+{
+    return *dic_;
+}
+
+//! Return the snapshot dictionary.
+inline const StringDic* SharedDic::Snapshot::operator ->() const
+{
+    return dic_;
+}
+
+//! Return the snapshot dictionary.
+inline const StringDic& SharedDic::Snapshot::dic() const
+{
+    return *dic_;
+}
+
+//! Return the snapshot version. The initial dictionary is version zero,
+//! and each publication increments the version.
+inline unsigned long long SharedDic::Snapshot::version() const
+{
+    return version_;
+}
+
+END_NAMESPACE1
+
+#endif
@@ -5,11 +5,15 @@
 #include "syskit/macros.h"
 #include <string.h>
 
+#include "syskit/sys.hpp"
+
 #include "appkit-pch.h"
 #include "appkit/S32.hpp"
 #include "appkit/Str.hpp"
 #include "appkit/String.hpp"
 
+using namespace syskit;
+
 // Ignore-case character map (0x41U=='A', 0x5aU=='Z', 0x61U=='a', 0x7aU=='z').
 // Indexed by byte value. If i is not a capital letter, s_icCharMap[i]==i.
 // Otherwise, s_icCharMap[i]==lowercase(i).
@@ -49,36 +53,213 @@ static const unsigned char s_icCharMap[] =
     0xf8U, 0xf9U, 0xfaU, 0xfbU, 0xfcU, 0xfdU, 0xfeU, 0xffU  //0xf8-0xff
 };
 
+#if HAS_SSE2_INTRINSICS
+BEGIN_NAMESPACE
+
+// Return true if 16 bytes can be read starting at p without crossing into the
+// next 4KB page. Such reads are safe even if they go past a terminating null.
+inline bool canRead16(const void* p)
+{
+    return ((reinterpret_cast<size_t>(p) & 4095U) <= (4096U - 16U));
+}
+
+// Fold given 16 bytes to lowercase the same way s_icCharMap does.
+inline __m128i foldCase(__m128i v)
+{
+    __m128i isCap = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(isCap, _mm_set1_epi8(0x20)));
+}
+
+END_NAMESPACE
+#endif
+
 BEGIN_NAMESPACE1(appkit)
 
 
 //!
-//! Quick implementation for the case-insensitive strstr().
+//! Quick implementation for the case-insensitive strstr(). Case is ignored for
+//! ASCII letters only. Return the first occurrence of needle in haystack. Return
+//! haystack if needle is empty. Return zero if not found.
 //!
 const char* strcasestr(const char* haystack, const char* needle)
 {
-    const unsigned char* hp = 0;
-    const unsigned char* np = 0;
-    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(haystack); *p != 0; ++p)
+    return Str::findI(haystack, strlen(haystack), needle, strlen(needle));
+}
+
+
+//!
+//! Locate the first occurrence of given key (kLength bytes starting at k) in
+//! given string (length bytes starting at s). Both are viewed as bytes, so
+//! a hit in valid UTF8 sequences is also a hit at a character boundary.
+//! Return the located occurrence. Return s if the key is empty. Return zero
+//! if not found.
+//!
+const char* Str::find(const char* s, size_t length, const char* k, size_t kLength)
+{
+    if (kLength == 0)
+    {
+        return s;
+    }
+    if (kLength > length)
+    {
+        return 0;
+    }
+
+    // Candidates start in [s, pEnd). Filter 16 candidates at a time using
+    // their first and last bytes. Verify the survivors in full.
+    const char* p = s;
+    const char* pEnd = s + length - kLength + 1;
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = syskit::sse2IsSupported();
+    if (s_useSse2)
     {
-        if (np != 0)
+        const __m128i first = _mm_set1_epi8(k[0]);
+        const __m128i last = _mm_set1_epi8(k[kLength - 1]);
+        for (; pEnd - p >= 16; p += 16)
         {
-            if (s_icCharMap[*p] == s_icCharMap[*np])
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + kLength - 1));
+            __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(v0, first), _mm_cmpeq_epi8(v1, last));
+            unsigned int mask = _mm_movemask_epi8(eq);
+            for (ulong32_t bit; _BitScanForward(&bit, mask); mask &= mask - 1)
             {
-                if (*++np == 0)
+                if (memcmp(p + bit, k, kLength) == 0)
                 {
-                    return reinterpret_cast<const char*>(hp);
+                    return p + bit;
                 }
             }
-            else
+        }
+    }
+#endif
+
+    for (; p < pEnd; ++p)
+    {
+        if ((*p == *k) && (memcmp(p, k, kLength) == 0))
+        {
+            return p;
+        }
+    }
+
+    return 0;
+}
+
+
+//!
+//! Locate the first occurrence of given key (kLength bytes starting at k) in
+//! given string (length bytes starting at s). Ignore case for ASCII letters.
+//! Return the located occurrence. Return s if the key is empty. Return zero
+//! if not found.
+//!
+const char* Str::findI(const char* s, size_t length, const char* k, size_t kLength)
+{
+    if (kLength == 0)
+    {
+        return s;
+    }
+    if (kLength > length)
+    {
+        return 0;
+    }
+
+    // Candidates start in [s, pEnd). Filter 16 candidates at a time using
+    // their folded first and last bytes. Verify the survivors in full.
+    const unsigned char* k8 = reinterpret_cast<const unsigned char*>(k);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    const unsigned char* pEnd = p + length - kLength + 1;
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = syskit::sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i first = _mm_set1_epi8(s_icCharMap[k8[0]]);
+        const __m128i last = _mm_set1_epi8(s_icCharMap[k8[kLength - 1]]);
+        for (; pEnd - p >= 16; p += 16)
+        {
+            __m128i v0 = foldCase(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            __m128i v1 = foldCase(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + kLength - 1)));
+            __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(v0, first), _mm_cmpeq_epi8(v1, last));
+            unsigned int mask = _mm_movemask_epi8(eq);
+            for (ulong32_t bit; _BitScanForward(&bit, mask); mask &= mask - 1)
+            {
+                const unsigned char* p1 = p + bit;
+                size_t i = 0;
+                for (; (i < kLength) && (s_icCharMap[p1[i]] == s_icCharMap[k8[i]]); ++i);
+                if (i == kLength)
+                {
+                    return reinterpret_cast<const char*>(p1);
+                }
+            }
+        }
+    }
+#endif
+
+    for (unsigned char c0 = s_icCharMap[k8[0]]; p < pEnd; ++p)
+    {
+        if (s_icCharMap[*p] == c0)
+        {
+            size_t i = 1;
+            for (; (i < kLength) && (s_icCharMap[p[i]] == s_icCharMap[k8[i]]); ++i);
+            if (i == kLength)
+            {
+                return reinterpret_cast<const char*>(p);
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+//!
+//! Locate the last occurrence of given key (kLength bytes starting at k) in
+//! given string (length bytes starting at s). Both are viewed as bytes, so
+//! a hit in valid UTF8 sequences is also a hit at a character boundary.
+//! Return the located occurrence. Return s+length if the key is empty.
+//! Return zero if not found.
+//!
+const char* Str::rfind(const char* s, size_t length, const char* k, size_t kLength)
+{
+    if (kLength == 0)
+    {
+        return s + length;
+    }
+    if (kLength > length)
+    {
+        return 0;
+    }
+
+    // Candidates start in [s, s+numCandidates). Filter 16 candidates at a
+    // time, right to left, using their first and last bytes. Verify the
+    // survivors in full.
+    size_t numCandidates = length - kLength + 1;
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = syskit::sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i first = _mm_set1_epi8(k[0]);
+        const __m128i last = _mm_set1_epi8(k[kLength - 1]);
+        for (; numCandidates >= 16; numCandidates -= 16)
+        {
+            const char* p = s + numCandidates - 16;
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + kLength - 1));
+            __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(v0, first), _mm_cmpeq_epi8(v1, last));
+            unsigned int mask = _mm_movemask_epi8(eq);
+            for (ulong32_t bit; _BitScanReverse(&bit, mask); mask &= ~(1U << bit))
             {
-                np = 0;
+                if (memcmp(p + bit, k, kLength) == 0)
+                {
+                    return p + bit;
+                }
             }
         }
-        else if (s_icCharMap[*p] == s_icCharMap[*reinterpret_cast<const unsigned char*>(needle)])
+    }
+#endif
+
+    for (const char* p = s + numCandidates; p > s;)
+    {
+        if ((*--p == *k) && (memcmp(p, k, kLength) == 0))
         {
-            np = reinterpret_cast<const unsigned char*>(needle)+1;
-            hp = p;
+            return p;
         }
     }
 
@@ -367,6 +548,27 @@ int Str::compareKI(const void* item0, const void* item1)
 
     const unsigned char* p0 = reinterpret_cast<const unsigned char*>(item0);
     const unsigned char* p1 = reinterpret_cast<const unsigned char*>(item1);
+
+    // Skip equal 16-byte chunks. Leave the chunk with the first difference
+    // or the terminating null to the character loop.
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = syskit::sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i ZERO = _mm_setzero_si128();
+        for (; canRead16(p0) && canRead16(p1); p0 += 16, p1 += 16)
+        {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1));
+            __m128i eq = _mm_cmpeq_epi8(foldCase(v0), foldCase(v1));
+            if ((_mm_movemask_epi8(eq) != 0xffff) || (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, ZERO)) != 0))
+            {
+                break;
+            }
+        }
+    }
+#endif
+
     for (;; ++p0, ++p1)
     {
         int c0 = s_icCharMap[*p0];
@@ -398,6 +600,27 @@ int Str::compareKIN(const char* item0, const char* item1, size_t n)
 
     const unsigned char* p0 = reinterpret_cast<const unsigned char*>(item0);
     const unsigned char* p1 = reinterpret_cast<const unsigned char*>(item1);
+
+    // Skip equal 16-byte chunks. Leave the chunk with the first difference
+    // or the terminating null to the character loop.
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = syskit::sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i ZERO = _mm_setzero_si128();
+        for (; (n >= 16) && canRead16(p0) && canRead16(p1); n -= 16, p0 += 16, p1 += 16)
+        {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1));
+            __m128i eq = _mm_cmpeq_epi8(foldCase(v0), foldCase(v1));
+            if ((_mm_movemask_epi8(eq) != 0xffff) || (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, ZERO)) != 0))
+            {
+                break;
+            }
+        }
+    }
+#endif
+
     for (size_t i = 0; i < n; ++i, ++p0, ++p1)
     {
         int c0 = s_icCharMap[*p0];
@@ -493,4 +716,39 @@ int Str::comparePR(const void* item0, const void* item1)
     return strcmp(*p1, *p0);
 }
 
+
+//!
+//! Modular hash function for a null-terminated string. Hash the same way
+//! String::hash() does. Return a non-negative number less than numBuckets.
+//!
+unsigned int Str::hashK(const void* item, size_t numBuckets)
+{
+    unsigned int code = 5381;
+    for (const unsigned char* p = static_cast<const unsigned char*>(item); *p != 0; ++p)
+    {
+        code += (code << 5) + *p;
+    }
+
+    unsigned int i = (code % static_cast<unsigned int>(numBuckets));
+    return i;
+}
+
+
+//!
+//! Modular hash function for a null-terminated string. Ignore case. Strings
+//! equal per compareKI() hash alike. Return a non-negative number less than
+//! numBuckets.
+//!
+unsigned int Str::hashKI(const void* item, size_t numBuckets)
+{
+    unsigned int code = 5381;
+    for (const unsigned char* p = static_cast<const unsigned char*>(item); *p != 0; ++p)
+    {
+        code += (code << 5) + s_icCharMap[*p];
+    }
+
+    unsigned int i = (code % static_cast<unsigned int>(numBuckets));
+    return i;
+}
+
 END_NAMESPACE1
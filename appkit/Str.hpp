@@ -35,6 +35,10 @@ class Str
 public:
     static bool isAscii(const char* s, size_t length);
 
+    static const char* find(const char* s, size_t length, const char* k, size_t kLength);
+    static const char* findI(const char* s, size_t length, const char* k, size_t kLength);
+    static const char* rfind(const char* s, size_t length, const char* k, size_t kLength);
+
     static String& stripSpace(String& result, const char* s, char delim = ',');
     static String& stripSpace(String& result, const char* s, size_t length, char delim = ',');
     static char* stripSpace(char* s, char delim = ',');
@@ -54,6 +58,9 @@ public:
 
     static int compareKIN(const char* item0, const char* item1, size_t n);
 
+    static unsigned int hashK(const void* item, size_t numBuckets);
+    static unsigned int hashKI(const void* item, size_t numBuckets);
+
 };
 
 const char* strcasestr(const char* haystack, const char* needle);
@@ -0,0 +1,526 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <string.h>
+#include "syskit/Bst.hpp"
+#include "syskit/MappedFile.hpp"
+#include "syskit/Vec.hpp"
+#include "syskit/macros.h"
+
+#include "appkit-pch.h"
+#include "appkit/Str.hpp"
+#include "appkit/StrSet.hpp"
+#include "appkit/String.hpp"
+#include "appkit/StringVec.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE1(appkit)
+
+const unsigned int StrSet::MAGIC = 0x31534346U; //"FCS1" in little-endian byte order
+
+
+//!
+//! Construct a duplicate instance of the given set.
+//!
+StrSet::StrSet(const StrSet& set)
+{
+    bool makeCopy = true;
+    attach(set.image_, set.imageSize_, makeCopy);
+}
+
+
+//!
+//! Construct instance with the distinct strings from given vector. Use
+//! front-coded buckets of up to bucketSize strings. A zero bucketSize
+//! means DefaultBucketSize.
+//!
+StrSet::StrSet(const StringVec& vec, unsigned int bucketSize)
+{
+    size_t numItems = vec.numItems();
+    const char** item = new const char*[numItems];
+    for (size_t i = 0; i < numItems; ++i)
+    {
+        item[i] = vec.peek(i).ascii();
+    }
+
+    build(item, numItems, bucketSize);
+    delete[] item;
+}
+
+
+//!
+//! Construct instance with the distinct strings from given table. The table
+//! items must be null-terminated strings. Their order in the table does not
+//! matter. Use front-coded buckets of up to bucketSize strings. A zero
+//! bucketSize means DefaultBucketSize.
+//!
+StrSet::StrSet(const Bst& bst, unsigned int bucketSize)
+{
+    size_t numItems = bst.numItems();
+    const char** item = new const char*[numItems];
+    for (size_t i = 0; i < numItems; ++i)
+    {
+        item[i] = static_cast<const char*>(bst.peek(i));
+    }
+
+    build(item, numItems, bucketSize);
+    delete[] item;
+}
+
+
+//!
+//! Construct instance from given image (imageSize bytes starting at image)
+//! formed by another instance, e.g., one saved using saveIn() and mapped
+//! into memory. The image is used in place and must outlive this instance
+//! unless makeCopy is true. Use isOk() to determine if the image is valid.
+//!
+StrSet::StrSet(const unsigned char* image, size_t imageSize, bool makeCopy)
+{
+    attach(image, imageSize, makeCopy);
+}
+
+
+StrSet::~StrSet()
+{
+    if (imageIsMine_)
+    {
+        delete[] image_;
+    }
+}
+
+
+//!
+//! Return the string residing at given rank. Don't do any error checking.
+//! Behavior is unpredictable if given index is invalid.
+//!
+String StrSet::operator [](size_t index) const
+{
+    size_t bucket = index / header_.bucketSize;
+    const char* p = head(bucket);
+    char* buf = new char[header_.maxLength + 1];
+    size_t length = strlen(p);
+    memcpy(buf, p, length);
+    p += length + 1;
+    for (size_t i = bucket * header_.bucketSize; i < index; ++i)
+    {
+        size_t sharedLength;
+        p = decode(p, sharedLength);
+        size_t suffixLength = strlen(p);
+        memcpy(buf + sharedLength, p, suffixLength);
+        length = sharedLength + suffixLength;
+        p += suffixLength + 1;
+    }
+
+    String item;
+    item.reset8(reinterpret_cast<const utf8_t*>(buf), length);
+    delete[] buf;
+    return item;
+}
+
+
+//!
+//! Iterate the strings in ascending order. Invoke callback at each string.
+//! The callback should return true to continue iterating and false to abort
+//! iterating. Return false if the callback aborted the iterating. Return
+//! true otherwise.
+//!
+bool StrSet::apply(cb0_t cb, void* arg) const
+{
+    const char* prefix = 0;
+    return scan(0, cb, arg, prefix);
+}
+
+
+//!
+//! Iterate the strings starting with given prefix in ascending order. Invoke
+//! callback at each string. The callback should return true to continue
+//! iterating and false to abort iterating. Return false if the callback
+//! aborted the iterating. Return true otherwise.
+//!
+bool StrSet::applyPrefix(const char* prefix, cb0_t cb, void* arg) const
+{
+    size_t startAt;
+    locate(prefix, startAt);
+    return scan(startAt, cb, arg, prefix);
+}
+
+
+//!
+//! Return true if given string is in the set.
+//!
+bool StrSet::find(const String& item) const
+{
+    size_t foundIndex;
+    return locate(item.ascii(), foundIndex);
+}
+
+
+//!
+//! Locate the strings starting with given prefix. Return true if found (also
+//! return the rank of the first one in startAt and their count in itemCount).
+//! Return false otherwise (also return zero in itemCount). The search takes
+//! two lookups regardless of the number of matching strings.
+//!
+bool StrSet::findPrefix(const char* prefix, size_t& startAt, size_t& itemCount) const
+{
+    locate(prefix, startAt);
+
+    // Locate the least string greater than all strings with given prefix.
+    size_t length = strlen(prefix);
+    for (; (length > 0) && (static_cast<unsigned char>(prefix[length - 1]) == 0xffU); --length);
+    size_t endAt;
+    if (length == 0)
+    {
+        endAt = header_.numItems;
+    }
+    else
+    {
+        char* next = new char[length + 1];
+        memcpy(next, prefix, length);
+        ++next[length - 1];
+        next[length] = 0;
+        locate(next, endAt);
+        delete[] next;
+    }
+
+    itemCount = endAt - startAt;
+    bool found = (itemCount > 0);
+    return found;
+}
+
+
+//
+// Locate given item using binary search over the bucket heads and a scan of
+// the bucket which might contain given item. Return true if found. Return
+// the number of strings less than given item in index. The scan tracks how
+// many leading bytes the current string shares with given item, so decoded
+// strings never need to be reconstructed.
+//
+bool StrSet::locate(const char* item, size_t& index) const
+{
+
+    // Locate the last bucket whose head is not greater than given item.
+    size_t loI = 0;
+    size_t hiI = numBuckets_;
+    while (loI < hiI)
+    {
+        size_t midI = (loI + hiI) >> 1;
+        if (strcmp(head(midI), item) <= 0)
+        {
+            loI = midI + 1;
+        }
+        else
+        {
+            hiI = midI;
+        }
+    }
+
+    if (loI == 0)
+    {
+        index = 0;
+        return false;
+    }
+
+    // Compare given item against the bucket head.
+    size_t bucket = loI - 1;
+    const unsigned char* k = reinterpret_cast<const unsigned char*>(item);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(head(bucket));
+    size_t matched = 0;
+    for (; (p[matched] != 0) && (p[matched] == k[matched]); ++matched);
+    index = bucket * header_.bucketSize;
+    if (p[matched] == k[matched])
+    {
+        return true;
+    }
+
+    // Scan the remaining strings in the bucket.
+    bool found = false;
+    p += matched;
+    p += strlen(reinterpret_cast<const char*>(p)) + 1;
+    for (++index; (index < header_.numItems) && ((index % header_.bucketSize) != 0); ++index)
+    {
+        size_t sharedLength;
+        p = reinterpret_cast<const unsigned char*>(decode(reinterpret_cast<const char*>(p), sharedLength));
+
+        // This string diverges from the previous one before given item does,
+        // so it is greater than given item.
+        if (sharedLength < matched)
+        {
+            break;
+        }
+
+        // This string is still less than given item.
+        if (sharedLength > matched)
+        {
+            p += strlen(reinterpret_cast<const char*>(p)) + 1;
+            continue;
+        }
+
+        // Compare the suffix against the unmatched part of given item.
+        const unsigned char* k1 = k + matched;
+        size_t n = 0;
+        for (; (p[n] != 0) && (p[n] == k1[n]); ++n);
+        if (p[n] == k1[n])
+        {
+            found = true;
+            break;
+        }
+        if (p[n] > k1[n])
+        {
+            break;
+        }
+        matched += n;
+        p += n + strlen(reinterpret_cast<const char*>(p + n)) + 1;
+    }
+
+    return found;
+}
+
+
+//!
+//! Save the image in given file. The file is created if it does not exist
+//! and overwritten otherwise. Return true if successful. An instance which
+//! is not ok cannot be saved.
+//!
+bool StrSet::saveIn(const wchar_t* path) const
+{
+    bool ok = ok_;
+    if (ok)
+    {
+        bool failIfExists = false;
+        MappedFile file(path, imageSize_, failIfExists);
+        ok = file.isOk();
+        if (ok)
+        {
+            file.setBytes(0, imageSize_, image_);
+        }
+    }
+
+    return ok;
+}
+
+
+//
+// Iterate the strings starting at given rank in ascending order. Stop at the
+// first string not starting with given prefix if prefix is non-zero. Return
+// false if the callback aborted the iterating.
+//
+bool StrSet::scan(size_t startAt, cb0_t cb, void* arg, const char* prefix) const
+{
+    if (startAt >= header_.numItems)
+    {
+        return true;
+    }
+
+    size_t prefixLength = (prefix == 0)? 0: strlen(prefix);
+    size_t bucket = startAt / header_.bucketSize;
+    const char* p = head(bucket);
+    char* buf = new char[header_.maxLength + 1];
+    bool ok = true;
+    size_t length = 0;
+    for (size_t i = bucket * header_.bucketSize; i < header_.numItems; ++i)
+    {
+        size_t sharedLength = 0;
+        if ((i % header_.bucketSize) != 0)
+        {
+            p = decode(p, sharedLength);
+        }
+        size_t suffixLength = strlen(p);
+        memcpy(buf + sharedLength, p, suffixLength + 1);
+        length = sharedLength + suffixLength;
+        p += suffixLength + 1;
+
+        if (i < startAt)
+        {
+            continue;
+        }
+        if ((prefix != 0) && ((length < prefixLength) || (memcmp(buf, prefix, prefixLength) != 0)))
+        {
+            break;
+        }
+        if (!cb(arg, buf, length))
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    delete[] buf;
+    return ok;
+}
+
+
+//
+// Decode the variable-length number at p. Return the number in value.
+// Return the location following the decoded number.
+//
+const char* StrSet::decode(const char* p, size_t& value)
+{
+    const unsigned char* p8 = reinterpret_cast<const unsigned char*>(p);
+    size_t v = 0;
+    int shift = 0;
+    for (; *p8 >= 0x80U; ++p8, shift += 7)
+    {
+        v |= static_cast<size_t>(*p8 & 0x7fU) << shift;
+    }
+
+    value = v | (static_cast<size_t>(*p8) << shift);
+    return reinterpret_cast<const char*>(p8 + 1);
+}
+
+
+//
+// Encode given value as a variable-length number at p, seven bits per byte,
+// least significant bits first. Return the location following the encoded
+// number.
+//
+unsigned char* StrSet::encode(unsigned char* p, size_t value)
+{
+    for (; value >= 0x80U; value >>= 7)
+    {
+        *p++ = static_cast<unsigned char>(value | 0x80U);
+    }
+
+    *p++ = static_cast<unsigned char>(value);
+    return p;
+}
+
+
+//
+// Attach to given image. Make a copy if necessary. Validate the image.
+// Become an empty and not-ok set if the image is invalid.
+//
+void StrSet::attach(const unsigned char* image, size_t imageSize, bool makeCopy)
+{
+    bool ok = (imageSize >= sizeof(header_));
+    if (ok)
+    {
+        memcpy(&header_, image, sizeof(header_));
+        ok = (header_.magic == MAGIC) && (header_.bucketSize > 0);
+    }
+
+    size_t numBuckets = 0;
+    if (ok)
+    {
+        numBuckets = (static_cast<size_t>(header_.numItems) + header_.bucketSize - 1) / header_.bucketSize;
+        size_t expectedSize = sizeof(header_) + numBuckets * sizeof(unsigned int) + header_.dataSize;
+        ok = (imageSize == expectedSize) && ((header_.dataSize == 0) || (image[imageSize - 1] == 0));
+    }
+
+    if (ok)
+    {
+        if (makeCopy)
+        {
+            unsigned char* p = new unsigned char[imageSize];
+            memcpy(p, image, imageSize);
+            image = p;
+        }
+        imageIsMine_ = makeCopy;
+        image_ = image;
+        imageSize_ = imageSize;
+        numBuckets_ = static_cast<unsigned int>(numBuckets);
+    }
+    else
+    {
+        memset(&header_, 0, sizeof(header_));
+        header_.magic = MAGIC;
+        header_.bucketSize = DefaultBucketSize;
+        imageIsMine_ = false;
+        image_ = 0;
+        imageSize_ = 0;
+        numBuckets_ = 0;
+    }
+
+    ok_ = ok;
+    offset_ = image_ + sizeof(header_);
+    data_ = reinterpret_cast<const char*>(offset_ + numBuckets_ * sizeof(unsigned int));
+}
+
+
+//
+// Form the image from given strings. The array is sorted in place, and
+// duplicates are dropped.
+//
+void StrSet::build(const char** item, size_t numItems, unsigned int bucketSize)
+{
+    if (bucketSize == 0)
+    {
+        bucketSize = DefaultBucketSize;
+    }
+
+    // Sort and drop duplicates.
+    Vec::sort(const_cast<void**>(reinterpret_cast<const void**>(item)), numItems, Str::compareK);
+    size_t numDistinctItems = 0;
+    for (size_t i = 0; i < numItems; ++i)
+    {
+        if ((numDistinctItems == 0) || (strcmp(item[numDistinctItems - 1], item[i]) != 0))
+        {
+            item[numDistinctItems++] = item[i];
+        }
+    }
+
+    // Size the image.
+    header_t header;
+    header.magic = MAGIC;
+    header.bucketSize = bucketSize;
+    header.maxLength = 0;
+    header.numItems = static_cast<unsigned int>(numDistinctItems);
+    unsigned char encoded[MaxEncodedSize];
+    size_t dataSize = 0;
+    for (size_t i = 0; i < numDistinctItems; ++i)
+    {
+        size_t length = strlen(item[i]);
+        if (length > header.maxLength)
+        {
+            header.maxLength = static_cast<unsigned int>(length);
+        }
+        if ((i % bucketSize) == 0)
+        {
+            dataSize += length + 1;
+        }
+        else
+        {
+            size_t sharedLength = 0;
+            for (const char* prev = item[i - 1]; (prev[sharedLength] != 0) && (prev[sharedLength] == item[i][sharedLength]); ++sharedLength);
+            dataSize += (encode(encoded, sharedLength) - encoded) + (length - sharedLength) + 1;
+        }
+    }
+    header.dataSize = static_cast<unsigned int>(dataSize);
+    size_t numBuckets = (numDistinctItems + bucketSize - 1) / bucketSize;
+    size_t imageSize = sizeof(header) + numBuckets * sizeof(unsigned int) + dataSize;
+
+    // Form the image.
+    unsigned char* image = new unsigned char[imageSize];
+    memcpy(image, &header, sizeof(header));
+    unsigned char* offset = image + sizeof(header);
+    unsigned char* data = offset + numBuckets * sizeof(unsigned int);
+    unsigned char* p = data;
+    for (size_t i = 0; i < numDistinctItems; ++i)
+    {
+        const char* s = item[i];
+        if ((i % bucketSize) == 0)
+        {
+            unsigned int headAt = static_cast<unsigned int>(p - data);
+            memcpy(offset, &headAt, sizeof(headAt));
+            offset += sizeof(headAt);
+        }
+        else
+        {
+            size_t sharedLength = 0;
+            for (const char* prev = item[i - 1]; (prev[sharedLength] != 0) && (prev[sharedLength] == s[sharedLength]); ++sharedLength);
+            p = encode(p, sharedLength);
+            s += sharedLength;
+        }
+        size_t n = strlen(s) + 1;
+        memcpy(p, s, n);
+        p += n;
+    }
+
+    bool makeCopy = false;
+    attach(image, imageSize, makeCopy);
+    imageIsMine_ = true;
+}
+
+END_NAMESPACE1
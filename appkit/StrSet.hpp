@@ -0,0 +1,191 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef APPKIT_STR_SET_HPP
+#define APPKIT_STR_SET_HPP
+
+#include <string.h>
+#include "syskit/macros.h"
+
+DECLARE_CLASS1(syskit, Bst)
+
+BEGIN_NAMESPACE1(appkit)
+
+class String;
+class StringVec;
+
+
+//! front-coded sorted set of strings
+class StrSet
+    //!
+    //! A class representing an immutable sorted set of null-terminated strings.
+    //! The strings are kept in byte order and front-coded in buckets of up to
+    //! bucketSize() strings. Each bucket starts with a head string in full, and
+    //! each remaining string is stored as the length of the prefix it shares
+    //! with its predecessor plus the differing suffix. Lookups binary-search the
+    //! bucket heads and then scan one bucket, so they stay logarithmic. Sorted
+    //! sets of hostnames or paths with long common prefixes typically shrink
+    //! several-fold compared to StringVec or Bst forms. The whole set lives in
+    //! one position-independent image which can be saved using saveIn() and
+    //! viewed in place later, e.g., from a memory-mapped file. Example:
+    //!\code
+    //! StrSet set(hostnames);
+    //! set.saveIn(path);
+    //! :
+    //! MappedFile file(path);
+    //! StrSet saved(file.map(), static_cast<size_t>(file.size()));
+    //! bool found = saved.find("www.example.com");
+    //!\endcode
+    //!
+{
+
+public:
+    enum
+    {
+        DefaultBucketSize = 16
+    };
+
+    //! Iterator callback. Return true to continue iterating.
+    typedef bool(*cb0_t)(void* arg, const char* item, size_t length);
+
+    // Constructors and destructor.
+    StrSet(const StrSet& set);
+    StrSet(const StringVec& vec, unsigned int bucketSize = DefaultBucketSize);
+    StrSet(const syskit::Bst& bst, unsigned int bucketSize = DefaultBucketSize);
+    StrSet(const unsigned char* image, size_t imageSize, bool makeCopy = false);
+    ~StrSet();
+
+    // Operators.
+    String operator [](size_t index) const;
+    bool operator !=(const StrSet& set) const;
+    bool operator ==(const StrSet& set) const;
+
+    // Set operations.
+    bool apply(cb0_t cb, void* arg = 0) const;
+    bool applyPrefix(const char* prefix, cb0_t cb, void* arg = 0) const;
+    bool find(const String& item) const;
+    bool find(const char* item) const;
+    bool find(const char* item, size_t& foundIndex) const;
+    bool findPrefix(const char* prefix, size_t& startAt, size_t& itemCount) const;
+    bool saveIn(const wchar_t* path) const;
+
+    // Getters.
+    bool isOk() const;
+    const unsigned char* image() const;
+    const unsigned char* image(size_t& imageSize) const;
+    size_t imageSize() const;
+    unsigned int bucketSize() const;
+    unsigned int numItems() const;
+
+private:
+    typedef struct
+    {
+        unsigned int magic;
+        unsigned int bucketSize;
+        unsigned int maxLength; //longest string excluding the terminating null
+        unsigned int numItems;
+        unsigned int dataSize;
+    } header_t;
+
+    enum
+    {
+        MaxEncodedSize = (sizeof(size_t) * 8 + 6) / 7
+    };
+
+    static const unsigned int MAGIC;
+
+    bool imageIsMine_;
+    bool ok_;
+    const char* data_;
+    const unsigned char* image_;
+    const unsigned char* offset_;
+    header_t header_;
+    size_t imageSize_;
+    unsigned int numBuckets_;
+
+    const StrSet& operator =(const StrSet&); //prohibit usage
+
+    bool locate(const char*, size_t&) const;
+    bool scan(size_t, cb0_t, void*, const char*) const;
+    const char* head(size_t) const;
+    void attach(const unsigned char*, size_t, bool);
+    void build(const char**, size_t, unsigned int);
+
+    static const char* decode(const char*, size_t&);
+    static unsigned char* encode(unsigned char*, size_t);
+
+};
+
+//! Return true if this set differs from given set.
+inline bool StrSet::operator !=(const StrSet& set) const
+{
+    return !(*this == set);
+}
+
+//! Return true if given null-terminated string is in the set.
+inline bool StrSet::find(const char* item) const
+{
+    size_t foundIndex;
+    return locate(item, foundIndex);
+}
+
+//! Return true if given null-terminated string is in the set (also return
+//! its rank in foundIndex). Return false otherwise (also return in foundIndex
+//! the rank given string would have, i.e., the number of smaller strings).
+inline bool StrSet::find(const char* item, size_t& foundIndex) const
+{
+    return locate(item, foundIndex);
+}
+
+//! Return true if instance was successfully constructed. An instance
+//! constructed from an invalid image is empty and not ok.
+inline bool StrSet::isOk() const
+{
+    return ok_;
+}
+
+//! Return the image. It holds the whole set and is position-independent.
+inline const unsigned char* StrSet::image() const
+{
+    return image_;
+}
+
+//! Return the image. Also return its size in bytes in imageSize.
+inline const unsigned char* StrSet::image(size_t& imageSize) const
+{
+    imageSize = imageSize_;
+    return image_;
+}
+
+//! Return the image size in bytes.
+inline size_t StrSet::imageSize() const
+{
+    return imageSize_;
+}
+
+//! Return the maximum number of strings per front-coded bucket.
+inline unsigned int StrSet::bucketSize() const
+{
+    return header_.bucketSize;
+}
+
+//! Return the number of strings in the set.
+inline unsigned int StrSet::numItems() const
+{
+    return header_.numItems;
+}
+
+//
+// Return the head string of given bucket.
+//
+inline const char* StrSet::head(size_t bucket) const
+{
+    unsigned int offset;
+    memcpy(&offset, offset_ + bucket * sizeof(offset), sizeof(offset));
+    return data_ + offset;
+}
+
+END_NAMESPACE1
+
+#endif
@@ -0,0 +1,420 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <string.h>
+#include "syskit/Vec.hpp"
+#include "syskit/macros.h"
+
+#include "appkit-pch.h"
+#include "appkit/DelimitedTxt.hpp"
+#include "appkit/Str.hpp"
+#include "appkit/StrVec.hpp"
+#include "appkit/String.hpp"
+#include "appkit/StringVec.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//!
+//! Construct instance with lines from given delimited text. Lines become
+//! vector items. By default, lines are trimmed. Use trimLines to specify
+//! otherwise. The vector does not grow if growBy is zero, exponentially
+//! grows by doubling if growBy is negative, and grows by growBy items
+//! otherwise. The packed buffer grows by doubling whenever the vector can
+//! grow. Construction is partial if vector cannot grow to accomodate all
+//! lines. Ignore case when sorting and searching if ignoreCase is true.
+//!
+StrVec::StrVec(DelimitedTxt& txt, bool trimLines, unsigned int capacity, int growBy, bool ignoreCase):
+Growable(capacity, growBy)
+{
+    compare_ = ignoreCase? Str::compareKI: Str::compareK;
+    offset_ = allocateItems<unsigned int>(StrVec::capacity());
+    size_t bufCap = txt.txtSize() + txt.countLines() * (LengthSize + 1);
+    bufCap_ = (bufCap > MaxBufCap)? static_cast<unsigned int>(MaxBufCap): static_cast<unsigned int>(bufCap);
+    buf_ = allocateItems<char>(bufCap_, BufArray);
+    bufSize_ = 0;
+    numItems_ = 0;
+    doReset(txt, trimLines);
+}
+
+
+//!
+//! Construct a duplicate instance of the given vector.
+//!
+StrVec::StrVec(const StrVec& vec):
+Growable(vec)
+{
+    copyFrom(vec);
+}
+
+
+//!
+//! Construct instance with items from given vector. The instance has the
+//! same capacity and growth factor as given vector, and its packed buffer
+//! is sized to fit all items. Ignore case when sorting and searching if
+//! ignoreCase is true.
+//!
+StrVec::StrVec(const StringVec& vec, bool ignoreCase):
+Growable(vec.capacity(), vec.growthFactor())
+{
+    size_t bufCap = 0;
+    for (size_t i = 0, numItems = vec.numItems(); i < numItems; ++i)
+    {
+        bufCap += LengthSize + vec.peek(i).byteSize();
+    }
+
+    compare_ = ignoreCase? Str::compareKI: Str::compareK;
+    offset_ = allocateItems<unsigned int>(capacity());
+    bufCap_ = static_cast<unsigned int>(bufCap);
+    buf_ = allocateItems<char>(bufCap_, BufArray);
+    bufSize_ = 0;
+    numItems_ = 0;
+    add(vec);
+}
+
+
+//!
+//! Construct an empty vector with initial capacity of capacity items. The
+//! vector does not grow if growBy is zero, exponentially grows by doubling
+//! if growBy is negative, and grows by growBy items otherwise. The packed
+//! buffer starts with room for capacity items of AvgItemSize bytes and
+//! grows by doubling whenever the vector can grow. Ignore case when sorting
+//! and searching if ignoreCase is true.
+//!
+StrVec::StrVec(unsigned int capacity, int growBy, bool ignoreCase):
+Growable(capacity, growBy)
+{
+    compare_ = ignoreCase? Str::compareKI: Str::compareK;
+    offset_ = allocateItems<unsigned int>(StrVec::capacity());
+    bufCap_ = StrVec::capacity() * AvgItemSize;
+    buf_ = allocateItems<char>(bufCap_, BufArray);
+    bufSize_ = 0;
+    numItems_ = 0;
+}
+
+
+StrVec::~StrVec()
+{
+    freeItems(buf_, BufArray);
+    freeItems(offset_);
+}
+
+
+//!
+//! Return true if this vector equals given vector.
+//!
+bool StrVec::operator ==(const StrVec& vec) const
+{
+    bool eq;
+    if (numItems_ != vec.numItems_)
+    {
+        eq = false;
+    }
+    else
+    {
+        eq = true;
+        for (size_t i = 0; i < numItems_; ++i)
+        {
+            size_t length0;
+            size_t length1;
+            const char* item0 = peek(i, length0);
+            const char* item1 = vec.peek(i, length1);
+            if ((length0 != length1) || (memcmp(item0, item1, length0) != 0))
+            {
+                eq = false;
+                break;
+            }
+        }
+    }
+
+    return eq;
+}
+
+
+const StrVec& StrVec::operator =(const StrVec& vec)
+{
+
+    // Prevent self assignment.
+    if (this != &vec)
+    {
+        freeItems(buf_, BufArray);
+        freeItems(offset_);
+        Growable::operator =(vec);
+        copyFrom(vec);
+    }
+
+    // Return reference to self.
+    return *this;
+}
+
+
+//!
+//! Add given item (length bytes starting at item) to the tail end. Return
+//! true if successful. Return false otherwise (vector is full and cannot
+//! grow).
+//!
+bool StrVec::add(const char* item, size_t length)
+{
+
+    // Given item might reside in the packed buffer which might move.
+    size_t itemSize = LengthSize + length + 1;
+    bool isMine = (item >= buf_) && (item < buf_ + bufSize_);
+    size_t itemAt = isMine? (item - buf_): 0;
+
+    // Vector is not full.
+    bool ok;
+    if (((numItems_ < capacity()) || grow()) && reserve(itemSize))
+    {
+        if (isMine)
+        {
+            item = buf_ + itemAt;
+        }
+        char* p = buf_ + bufSize_;
+        unsigned int n = static_cast<unsigned int>(length);
+        memcpy(p, &n, LengthSize);
+        p += LengthSize;
+        memmove(p, item, length);
+        p[length] = 0;
+        offset_[numItems_++] = bufSize_ + LengthSize;
+        bufSize_ += static_cast<unsigned int>(itemSize);
+        ok = true;
+    }
+
+    // Vector is full.
+    else
+    {
+        ok = false;
+    }
+
+    // Return true if successful.
+    return ok;
+}
+
+
+bool StrVec::doReset(DelimitedTxt& txt, bool trimLines)
+{
+    const char* line;
+    size_t length;
+    bool ok = true;
+    for (txt.reset(); txt.next(line, length);)
+    {
+        if (trimLines)
+        {
+            length = txt.trimLine(line, length);
+        }
+        if (!add(line, length))
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    return ok;
+}
+
+
+//!
+//! Locate given item using linear search. Return true if found (also return
+//! the located index in foundIndex). Return false otherwise.
+//!
+bool StrVec::find(const char* item, size_t& foundIndex) const
+{
+    bool found = false;
+    for (size_t i = 0; i < numItems_; ++i)
+    {
+        if (compare_(item, buf_ + offset_[i]) == 0)
+        {
+            foundIndex = i;
+            found = true;
+            break;
+        }
+    }
+
+    return found;
+}
+
+
+//
+// Make room for given number of additional bytes in the packed buffer.
+// Grow the buffer by doubling if necessary and allowed. Return true if
+// successful.
+//
+bool StrVec::reserve(size_t numBytes)
+{
+    bool ok;
+    size_t minCap = bufSize_ + numBytes;
+    if (minCap <= bufCap_)
+    {
+        ok = true;
+    }
+
+    else if ((!canGrow()) || (minCap > MaxBufCap))
+    {
+        ok = false;
+    }
+
+    else
+    {
+        size_t newCap = (bufCap_ > 0)? bufCap_: static_cast<size_t>(AvgItemSize);
+        for (; newCap < minCap; newCap <<= 1);
+        bufCap_ = (newCap > MaxBufCap)? static_cast<unsigned int>(MaxBufCap): static_cast<unsigned int>(newCap);
+        buf_ = resizeItems(buf_, bufCap_, bufSize_, BufArray);
+        ok = true;
+    }
+
+    return ok;
+}
+
+
+//!
+//! Resize vector. Given new capacity must not be less than the current
+//! number of items. Return true if successful. The packed buffer is not
+//! affected.
+//!
+bool StrVec::resize(unsigned int newCap)
+{
+    bool ok;
+    if (numItems_ > newCap)
+    {
+        ok = false;
+    }
+
+    else
+    {
+        ok = true;
+        if (newCap != capacity())
+        {
+            offset_ = resizeItems(offset_, newCap, numItems_);
+            setCapacity(newCap);
+        }
+    }
+
+    return ok;
+}
+
+
+//!
+//! Assume vector is sorted using given comparison function, locate given
+//! item using binary search. Return true if found (also return the located
+//! index in foundIndex). Return false otherwise (also return the nearest item
+//! in foundIndex). Behavior is unpredictable if vector is unsorted.
+//!
+bool StrVec::search(compare_t compare, const char* item, size_t& foundIndex) const
+{
+    bool found = false;
+    int loI = 0;
+    int hiI = static_cast<int>(numItems_) - 1;
+    unsigned int midI = 0;
+    while (loI <= hiI)
+    {
+        midI = (loI + hiI) >> 1;
+        int rc = compare(item, buf_ + offset_[midI]);
+        if (rc > 0)
+        {
+            loI = midI + 1;
+        }
+        else if (rc < 0)
+        {
+            hiI = midI - 1;
+        }
+        else
+        {
+            found = true;
+            break;
+        }
+    }
+
+    foundIndex = midI;
+    return found;
+}
+
+
+//!
+//! Convert to the classic form. That is, reset given vector and copy all
+//! items into it. Return true if successful. Return false otherwise (result
+//! is partial due to insufficient capacity in provided vector).
+//!
+bool StrVec::vectorize(StringVec& vec) const
+{
+    vec.reset();
+    bool ok = true;
+    for (size_t i = 0; i < numItems_; ++i)
+    {
+        size_t length;
+        const char* item = peek(i, length);
+        String s;
+        s.reset8(reinterpret_cast<const utf8_t*>(item), length);
+        if (!vec.add(s))
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    return ok;
+}
+
+
+//!
+//! Add items from given vector to the tail end. Return number of items
+//! successfully added. This number can be less than the number of items
+//! in given vector if growth is required but this vector cannot grow.
+//!
+unsigned int StrVec::add(const StringVec& vec)
+{
+    unsigned int numAdds = 0;
+    for (size_t i = 0, numItems = vec.numItems(); i < numItems; ++i, ++numAdds)
+    {
+        if (!add(vec.peek(i)))
+        {
+            break;
+        }
+    }
+
+    return numAdds;
+}
+
+
+//
+// Copy items from given vector. Assume the Growable portion has been copied.
+//
+void StrVec::copyFrom(const StrVec& vec)
+{
+    compare_ = vec.compare_;
+    offset_ = allocateItems<unsigned int>(capacity());
+    memcpy(offset_, vec.offset_, vec.numItems_ * sizeof(*offset_));
+    bufCap_ = vec.bufSize_;
+    buf_ = allocateItems<char>(bufCap_, BufArray);
+    memcpy(buf_, vec.buf_, vec.bufSize_);
+    bufSize_ = vec.bufSize_;
+    numItems_ = vec.numItems_;
+}
+
+
+//!
+//! Sort vector using given comparison function. If reverseOrder is true,
+//! sort vector in descending order. Only the offsets are permuted.
+//!
+void StrVec::sort(compare_t compare, bool reverseOrder)
+{
+
+    // Sort the item addresses, then map them back to offsets.
+    void** item = new void*[numItems_];
+    for (size_t i = 0; i < numItems_; ++i)
+    {
+        item[i] = buf_ + offset_[i];
+    }
+
+    Vec::sort(item, numItems_, compare, reverseOrder);
+    for (size_t i = 0; i < numItems_; ++i)
+    {
+        offset_[i] = static_cast<unsigned int>(static_cast<char*>(item[i]) - buf_);
+    }
+
+    delete[] item;
+}
+
+END_NAMESPACE1
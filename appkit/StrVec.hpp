@@ -0,0 +1,286 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef APPKIT_STR_VEC_HPP
+#define APPKIT_STR_VEC_HPP
+
+#include <string.h>
+#include "appkit/String.hpp"
+#include "syskit/Growable.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(appkit)
+
+class DelimitedTxt;
+class StringVec;
+
+
+//! vector of packed strings
+class StrVec: public syskit::Growable
+    //!
+    //! A class representing an unsorted vector of strings packed back to back
+    //! in one contiguous byte buffer. Each item is a null-terminated byte
+    //! sequence prefixed with its length, and the vector itself is an array
+    //! of 32-bit offsets into the buffer. Compared to StringVec, which holds
+    //! one separately allocated String per item, adding an item here costs
+    //! no allocations beyond the occasional buffer growth, and iterating the
+    //! items touches memory sequentially. Items can be viewed as null-terminated
+    //! strings using peek() or as String copies using the subscript operator.
+    //! Sorting permutes the offsets and leaves the packed bytes as is. Items
+    //! are append-only, and the buffer holds at most 4GB. Use vectorize() to
+    //! convert to the classic StringVec form. Example:
+    //!\code
+    //! StrVec vec(txt); //one item per line
+    //! vec.sort();
+    //! for (size_t i = 0, numItems = vec.numItems(); i < numItems; ++i)
+    //! {
+    //!   size_t length;
+    //!   const char* item = vec.peek(i, length);
+    //!   //do something with each item
+    //! }
+    //!\endcode
+    //!
+{
+
+public:
+    enum
+    {
+        AvgItemSize = 16,
+        DefaultCap = 64
+    };
+
+    //! Return a negative value if item0<item1, a positive value if item 0>item 1, and zero otherwise.
+    typedef int(*compare_t)(const void* item0, const void* item1);
+
+    // Constructors.
+    StrVec(DelimitedTxt& txt, bool trimLines = true, unsigned int capacity = DefaultCap, int growBy = -1, bool ignoreCase = false);
+    StrVec(const StrVec& vec);
+    StrVec(const StringVec& vec, bool ignoreCase = false);
+    StrVec(unsigned int capacity = DefaultCap, int growBy = -1, bool ignoreCase = false);
+
+    // Operators.
+    String operator [](size_t index) const;
+    bool operator !=(const StrVec& vec) const;
+    bool operator ==(const StrVec& vec) const;
+    const StrVec& operator =(const StrVec& vec);
+
+    // Vector operations.
+    bool add(const String& item);
+    bool add(const char* item);
+    bool add(const char* item, size_t length);
+    bool find(const String& item) const;
+    bool find(const String& item, size_t& foundIndex) const;
+    bool find(const char* item) const;
+    bool find(const char* item, size_t& foundIndex) const;
+    bool reset(DelimitedTxt& txt, bool trimLines = true);
+    bool vectorize(StringVec& vec) const;
+    unsigned int add(const StringVec& vec);
+    void reset();
+
+    // Getters.
+    bool empty() const;
+    const char* peek(size_t index) const;
+    const char* peek(size_t index, size_t& length) const;
+    size_t byteSize() const;
+    unsigned int numItems() const;
+
+    // Sort and search.
+    bool search(compare_t compare, const char* item) const;
+    bool search(compare_t compare, const char* item, size_t& foundIndex) const;
+    bool search(const String& item) const;
+    bool search(const String& item, size_t& foundIndex) const;
+    bool search(const char* item) const;
+    bool search(const char* item, size_t& foundIndex) const;
+    void sort(bool reverseOrder = false);
+    void sort(compare_t compare, bool reverseOrder = false);
+
+    // Override Growable.
+    virtual ~StrVec();
+    virtual bool resize(unsigned int newCap);
+
+private:
+    enum
+    {
+        BufArray = 1, //item array index of the packed buffer (see Growable)
+        LengthSize = sizeof(unsigned int),
+        MaxBufCap = 0xffffffffU
+    };
+
+    char* buf_;
+    compare_t compare_;
+    unsigned int* offset_;
+    unsigned int bufCap_;
+    unsigned int bufSize_;
+    unsigned int numItems_;
+
+    bool doReset(DelimitedTxt&, bool);
+    bool reserve(size_t);
+    void copyFrom(const StrVec&);
+
+};
+
+//! Peek at given index and return a copy of the residing item. Don't do any
+//! error checking. Behavior is unpredictable if given index is invalid.
+inline String StrVec::operator [](size_t index) const
+{
+    size_t length;
+    const char* item = peek(index, length);
+    String s;
+    s.reset8(reinterpret_cast<const syskit::utf8_t*>(item), length);
+    return s;
+}
+
+//! Return true if this vector does not equal given vector.
+inline bool StrVec::operator !=(const StrVec& vec) const
+{
+    return !(*this == vec);
+}
+
+//! Add given item to the tail end. Return true if successful. Return false
+//! otherwise (vector is full and cannot grow).
+inline bool StrVec::add(const String& item)
+{
+    unsigned int byteSize;
+    const syskit::utf8_t* raw = item.raw(byteSize);
+    return add(reinterpret_cast<const char*>(raw), byteSize - 1);
+}
+
+//! Add given null-terminated item to the tail end. Return true if successful.
+//! Return false otherwise (vector is full and cannot grow).
+inline bool StrVec::add(const char* item)
+{
+    return add(item, strlen(item));
+}
+
+//! Locate given item using linear search. Return true if found.
+inline bool StrVec::find(const String& item) const
+{
+    size_t foundIndex;
+    return find(item.ascii(), foundIndex);
+}
+
+//! Locate given item using linear search. Return true if found
+//! (also return the located index in foundIndex). Return false
+//! otherwise.
+inline bool StrVec::find(const String& item, size_t& foundIndex) const
+{
+    return find(item.ascii(), foundIndex);
+}
+
+//! Locate given item using linear search. Return true if found.
+inline bool StrVec::find(const char* item) const
+{
+    size_t foundIndex;
+    return find(item, foundIndex);
+}
+
+//! Reset and use lines from given delimited text as vector items. By default,
+//! lines are trimmed. Use trimLines to specify otherwise. Return true if
+//! successful. Return false otherwise (reset is partial because vector cannot
+//! grow to accomodate all lines).
+inline bool StrVec::reset(DelimitedTxt& txt, bool trimLines)
+{
+    reset();
+    return doReset(txt, trimLines);
+}
+
+//! Remove all items. The packed buffer is kept for reuse.
+inline void StrVec::reset()
+{
+    bufSize_ = 0;
+    numItems_ = 0;
+}
+
+//! Return true if vector is empty.
+inline bool StrVec::empty() const
+{
+    return (numItems_ == 0);
+}
+
+//! Peek at given index and return the residing null-terminated item. The
+//! returned item is valid until the vector grows or is reset. Don't do any
+//! error checking. Behavior is unpredictable if given index is invalid.
+inline const char* StrVec::peek(size_t index) const
+{
+    return buf_ + offset_[index];
+}
+
+//! Peek at given index and return the residing null-terminated item. Also
+//! return its length in bytes excluding the terminating null. The returned
+//! item is valid until the vector grows or is reset. Don't do any error
+//! checking. Behavior is unpredictable if given index is invalid.
+inline const char* StrVec::peek(size_t index, size_t& length) const
+{
+    const char* item = buf_ + offset_[index];
+    unsigned int n;
+    memcpy(&n, item - LengthSize, LengthSize);
+    length = n;
+    return item;
+}
+
+//! Return the number of bytes used in the packed buffer.
+inline size_t StrVec::byteSize() const
+{
+    return bufSize_;
+}
+
+//! Return the current number of items.
+inline unsigned int StrVec::numItems() const
+{
+    return numItems_;
+}
+
+//! Assume vector is sorted using given comparison function, locate given
+//! item using binary search. Return true if found. Behavior is unpredictable
+//! if vector is unsorted.
+inline bool StrVec::search(compare_t compare, const char* item) const
+{
+    size_t foundIndex;
+    return search(compare, item, foundIndex);
+}
+
+//! Assume vector is sorted, locate given item using binary search.
+//! Return true if found. Behavior is unpredictable if vector is unsorted.
+inline bool StrVec::search(const String& item) const
+{
+    size_t foundIndex;
+    return search(compare_, item.ascii(), foundIndex);
+}
+
+//! Assume vector is sorted, locate given item using binary search.
+//! Return true if found (also return the located index in foundIndex).
+//! Return false otherwise (also return the nearest item in foundIndex).
+//! Behavior is unpredictable if vector is unsorted.
+inline bool StrVec::search(const String& item, size_t& foundIndex) const
+{
+    return search(compare_, item.ascii(), foundIndex);
+}
+
+//! Assume vector is sorted, locate given item using binary search.
+//! Return true if found. Behavior is unpredictable if vector is unsorted.
+inline bool StrVec::search(const char* item) const
+{
+    size_t foundIndex;
+    return search(compare_, item, foundIndex);
+}
+
+//! Assume vector is sorted, locate given item using binary search.
+//! Return true if found (also return the located index in foundIndex).
+//! Return false otherwise (also return the nearest item in foundIndex).
+//! Behavior is unpredictable if vector is unsorted.
+inline bool StrVec::search(const char* item, size_t& foundIndex) const
+{
+    return search(compare_, item, foundIndex);
+}
+
+//! Sort vector in ascending order. If reverseOrder is true, sort vector in
+//! descending order. Only the offsets are permuted.
+inline void StrVec::sort(bool reverseOrder)
+{
+    sort(compare_, reverseOrder);
+}
+
+END_NAMESPACE1
+
+#endif
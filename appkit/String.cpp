@@ -67,12 +67,20 @@ inline const utf8_t* findFirst(const utf8_t* s, utf32_t c)
     return reinterpret_cast<const utf8_t*>(strchr(reinterpret_cast<const char*>(s), static_cast<char>(c)));
 }
 
-inline const utf8_t* strstr(const utf8_t* s, const String& k)
+// Locate the first occurrence of given key (kLength bytes starting at k)
+// in the bytes starting at s and ending before pEnd.
+inline const utf8_t* findBytes(const utf8_t* s, const utf8_t* pEnd, const utf8_t* k, size_t kLength)
 {
-    const char* str = reinterpret_cast<const char*>(s);
-    const char* key = k.ascii();
-    const utf8_t* p = reinterpret_cast<const utf8_t*>(::strstr(str, key));
-    return p;
+    const char* p = Str::find(reinterpret_cast<const char*>(s), pEnd - s, reinterpret_cast<const char*>(k), kLength);
+    return reinterpret_cast<const utf8_t*>(p);
+}
+
+// Locate the last occurrence of given key (kLength bytes starting at k)
+// in the bytes starting at s and ending before pEnd.
+inline const utf8_t* rfindBytes(const utf8_t* s, const utf8_t* pEnd, const utf8_t* k, size_t kLength)
+{
+    const char* p = Str::rfind(reinterpret_cast<const char*>(s), pEnd - s, reinterpret_cast<const char*>(k), kLength);
+    return reinterpret_cast<const utf8_t*>(p);
 }
 
 const String::formUtfX_t String::formX_[][2] =
@@ -840,7 +848,7 @@ int String::compareP(const void* item0, const void* item1)
 {
     const char* k0 = static_cast<const String*>(item0)->ascii();
     const char* k1 = static_cast<const String*>(item1)->ascii();
-    int rc = strcmp(k0, k1);
+    int rc = (k0 == k1)? 0: strcmp(k0, k1);
     return rc;
 }
 
@@ -854,7 +862,7 @@ int String::comparePI(const void* item0, const void* item1)
 {
     const char* k0 = static_cast<const String*>(item0)->ascii();
     const char* k1 = static_cast<const String*>(item1)->ascii();
-    int rc = Str::compareKI(k0, k1);
+    int rc = (k0 == k1)? 0: Str::compareKI(k0, k1);
     return rc;
 }
 
@@ -869,7 +877,7 @@ int String::comparePIR(const void* item0, const void* item1)
 {
     const char* k0 = static_cast<const String*>(item0)->ascii();
     const char* k1 = static_cast<const String*>(item1)->ascii();
-    int rc = Str::compareKI(k1, k0);
+    int rc = (k0 == k1)? 0: Str::compareKI(k1, k0);
     return rc;
 }
 
@@ -883,7 +891,7 @@ int String::comparePR(const void* item0, const void* item1)
 {
     const char* k0 = static_cast<const String*>(item0)->ascii();
     const char* k1 = static_cast<const String*>(item1)->ascii();
-    int rc = strcmp(k1, k0);
+    int rc = (k0 == k1)? 0: strcmp(k1, k0);
     return rc;
 }
 
@@ -1038,16 +1046,20 @@ unsigned int String::find(const String& str, size_t startAt) const
     if ((pLo <= pHi) && (startAt < s_->numChars()))
     {
 
+        // Search the UTF8 bytes. Map the hit back to a character index.
+        unsigned int keySize;
+        const utf8_t* key = str.raw(keySize);
+        const utf8_t* pEnd = pLo + byteSize() - 1;
         if (s_->isAscii())
         {
-            const utf8_t* p = strstr(pLo + startAt, str);
+            const utf8_t* p = findBytes(pLo + startAt, pEnd, key, keySize - 1);
             if (p != 0) foundAt = p - pLo;
         }
 
         else
         {
             pLo = s_->seek(startAt);
-            const utf8_t* p = strstr(pLo, str);
+            const utf8_t* p = findBytes(pLo, pEnd, key, keySize - 1);
             if (p != 0)
             {
                 unsigned int numChars;
@@ -1082,18 +1094,19 @@ unsigned int String::find(utf32_t c, size_t startAt) const
             }
         }
 
+        // Valid UTF8 is self-synchronizing, so a hit of the encoded character
+        // in the UTF8 bytes is a hit at a character boundary.
         else if (Utf8::isValid(c))
         {
-            Utf8 c8;
-            const utf8_t* p = s_->seek(startAt);
-            for (size_t i = startAt; *p; ++i)
+            utf8_t seq[Utf8::MaxSeqLength];
+            unsigned int seqLength = Utf8(c).encode(seq);
+            const utf8_t* pLo = s_->seek(startAt);
+            const utf8_t* p = findBytes(pLo, s_->raw() + byteSize() - 1, seq, seqLength);
+            if (p != 0)
             {
-                p += c8.decode(p);
-                if (c8 == c)
-                {
-                    foundAt = i;
-                    break;
-                }
+                unsigned int numChars;
+                Utf8Seq::countChars(pLo, p - pLo, numChars);
+                foundAt = startAt + numChars;
             }
         }
     }
@@ -1131,6 +1144,19 @@ unsigned int String::hashP(const void* item, size_t numBuckets)
 }
 
 
+//!
+//! Modular hash function for a string given its address. Ignore case. Strings
+//! equal per comparePI() hash alike. Return a non-negative number less than
+//! numBuckets.
+//!
+unsigned int String::hashPI(const void* item, size_t numBuckets)
+{
+    const String& s = *static_cast<const String*>(item);
+    unsigned int i = Str::hashKI(s.ascii(), numBuckets);
+    return i;
+}
+
+
 //!
 //! Reset instance with given UTFx string. Given BOM guides how it's decoded.
 //! With a BOM of None, it's assumed to be UTF8. Return the number of invalid
@@ -1229,15 +1255,14 @@ unsigned int String::rfind(const String& str, size_t startAt) const
             if (p > pHi) p = pHi;
         }
 
-        size_t n = str.byteSize() - 1;
-        for (const utf8_t* key = str.raw(); p >= pLo; --p)
+        // Search the UTF8 bytes. Map the hit back to a character index.
+        unsigned int keySize;
+        const utf8_t* key = str.raw(keySize);
+        p = rfindBytes(pLo, p + keySize - 1, key, keySize - 1);
+        if (p != 0)
         {
-            if (memcmp(p, key, n) == 0)
-            {
-                if (s_->isAscii()) foundAt = static_cast<unsigned int>(p - pLo);
-                else Utf8Seq::countChars(pLo, p - pLo, foundAt);
-                break;
-            }
+            if (s_->isAscii()) foundAt = static_cast<unsigned int>(p - pLo);
+            else Utf8Seq::countChars(pLo, p - pLo, foundAt);
         }
     }
 
@@ -1259,37 +1284,31 @@ unsigned int String::rfind(utf32_t c, size_t startAt) const
     }
 
     size_t foundAt = INVALID_INDEX;
+    const utf8_t* p0 = s_->raw();
     if (s_->isAscii())
     {
         if (c <= Utf8::MaxAscii)
         {
-            const utf8_t* p0 = s_->raw();
-            const utf8_t* p = p0 + startAt;
-            do
-            {
-                if (*p == c)
-                {
-                    foundAt = p - p0;
-                    break;
-                }
-            } while (--p >= p0);
+            utf8_t c8 = static_cast<utf8_t>(c);
+            const utf8_t* p = rfindBytes(p0, p0 + startAt + 1, &c8, 1);
+            if (p != 0) foundAt = p - p0;
         }
     }
 
+    // Valid UTF8 is self-synchronizing, so a hit of the encoded character
+    // in the UTF8 bytes is a hit at a character boundary.
     else if (Utf8::isValid(c))
     {
-        Utf8 c8;
-        const utf8_t* p = s_->seek(startAt);
-        for (size_t i = startAt;; --i)
+        utf8_t seq[Utf8::MaxSeqLength];
+        unsigned int seqLength = Utf8(c).encode(seq);
+        const utf8_t* pEnd = s_->seek(startAt) + seqLength;
+        const utf8_t* pMax = p0 + byteSize() - 1;
+        const utf8_t* p = rfindBytes(p0, (pEnd > pMax)? pMax: pEnd, seq, seqLength);
+        if (p != 0)
         {
-            c8.decode(p);
-            if (c8 == c)
-            {
-                foundAt = i;
-                break;
-            }
-            if (i == 0) break;
-            while (Utf8::getSeqLength(*--p) == Utf8::InvalidByte0);
+            unsigned int numChars;
+            Utf8Seq::countChars(p0, p - p0, numChars);
+            foundAt = numChars;
         }
     }
 
@@ -1498,15 +1517,14 @@ void String::reset(size_t count, wchar_t c)
 
 //
 // Reset-on-write. If guts are shared, make private copy of empty string using
-// current capacity. Otherwise, no-op.
+// inline storage. The subsequent reset grows it as needed. Otherwise, no-op.
 //
 void String::row()
 {
     if (s_->refCount() > 1U)
     {
-        unsigned int capacity = s_->capacity();
         s_->rmRef();
-        s_ = new S(capacity);
+        s_ = new S;
     }
 }
 
@@ -1581,31 +1599,42 @@ String::Ascii8::~Ascii8()
 }
 
 
+//
+// Short sequences use the inline buffer. Longer ones
+// grow into the heap as needed.
+//
 String::S::S(const S& s):
 RefCounted(1U),
-Utf8Seq(s)
+Utf8Seq(buf_, InlineCap)
 {
+    Utf8Seq::operator =(s);
 }
 
 
 String::S::S(const Utf8Seq& seq):
 RefCounted(1U),
-Utf8Seq(seq)
+Utf8Seq(buf_, InlineCap)
 {
+    Utf8Seq::operator =(seq);
 }
 
 
 String::S::S(const Utf8Seq& seq, size_t startAt, size_t charCount):
 RefCounted(1U),
-Utf8Seq(seq, startAt, charCount)
+Utf8Seq(buf_, InlineCap)
 {
+    reset(seq, startAt, charCount);
 }
 
 
 String::S::S(unsigned int capacity):
 RefCounted(1U),
-Utf8Seq(capacity)
+Utf8Seq(buf_, InlineCap)
 {
+    if (capacity > InlineCap)
+    {
+        resize(capacity);
+    }
 }
 
 
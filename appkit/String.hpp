@@ -22,7 +22,9 @@ class QuotedString;
 //! UTF-capable copy-on-write string
 class String
     //!
-    //! Yet another UTF-capable COW string class. Example:
+    //! Yet another UTF-capable COW string class. A short string keeps its bytes
+    //! inline with its shared representation, so constructing one costs a single
+    //! allocation. Example:
     //!\code
     //! String path("./");
     //! path += childName;
@@ -53,6 +55,9 @@ public:
     String(size_t count, char c);
     String(size_t count, wchar_t c);
     String(unsigned int capacity);
+#if HAS_RVALUE_REFS
+    String(String&& str);
+#endif
     ~String();
 
     // Operators.
@@ -79,6 +84,9 @@ public:
     const String& operator =(const syskit::Utf8Seq& seq);
     const String& operator =(const char* s);
     const String& operator =(const wchar_t* s);
+#if HAS_RVALUE_REFS
+    const String& operator =(String&& str);
+#endif
     syskit::utf32_t operator [](size_t index) const;
     static void operator delete(void* p, size_t size);
     static void operator delete(void* p, void* buf);
@@ -152,6 +160,7 @@ public:
     static int comparePIR(const void* item0, const void* item1);
     static int comparePR(const void* item0, const void* item1);
     static unsigned int hashP(const void* item, size_t numBuckets);
+    static unsigned int hashPI(const void* item, size_t numBuckets);
 
 
     //! array of null-terminated 8-bit ASCII characters
@@ -201,10 +210,14 @@ private:
     class S: public syskit::RefCounted, public syskit::Utf8Seq
     {
     public:
+        enum
+        {
+            InlineCap = 24 //including the terminating null
+        };
         S(const S& s);
         S(const syskit::Utf8Seq& seq);
         S(const syskit::Utf8Seq& seq, size_t startAt, size_t charCount);
-        S(unsigned int capacity = syskit::Utf8Seq::DefaultCap);
+        S(unsigned int capacity = InlineCap);
         S(syskit::utf8_t* s, size_t numU8s, size_t numChars);
         using syskit::Utf8Seq::addNull;
         using syskit::Utf8Seq::addNullIfNone;
@@ -216,6 +229,7 @@ private:
     protected:
         virtual ~S();
     private:
+        syskit::utf8_t buf_[InlineCap];
         const S& operator =(const S&); //prohibit usage
     };
 
@@ -271,10 +285,19 @@ inline String::String(S* s)
     s_ = s;
 }
 
+#if HAS_RVALUE_REFS
+//! Construct instance using guts from given string. Given string is left empty.
+inline String::String(String&& str)
+{
+    s_ = str.s_;
+    str.s_ = emptyStringRef();
+}
+#endif
+
 //! Return true if this string does not equal given string.
 inline bool String::operator !=(const String& str) const
 {
-    return (*s_ != *str.s_);
+    return (s_ != str.s_) && (*s_ != *str.s_);
 }
 
 //! Return true if this string does not equal given string.
@@ -321,7 +344,7 @@ inline bool String::operator >=(const String& str) const
 //! Return true if this string equals given string.
 inline bool String::operator ==(const String& str) const
 {
-    return (*s_ == *str.s_);
+    return (s_ == str.s_) || (*s_ == *str.s_);
 }
 
 //! Return true if this string equals given string.
@@ -337,6 +360,21 @@ inline bool String::operator ==(const wchar_t* s) const
     return isEq;
 }
 
+#if HAS_RVALUE_REFS
+//! Move given string into this. Given string is left empty. Return reference to self.
+inline const String& String::operator =(String&& str)
+{
+    if (this != &str)
+    {
+        s_->rmRef();
+        s_ = str.s_;
+        str.s_ = emptyStringRef();
+    }
+
+    return *this;
+}
+#endif
+
 //! Reset instance with given UTF16 sequence.
 inline const String& String::operator =(const syskit::Utf16Seq& seq)
 {
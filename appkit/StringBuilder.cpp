@@ -0,0 +1,235 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <cstring>
+#include "syskit/macros.h"
+
+#include "appkit-pch.h"
+#include "appkit/StringBuilder.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//!
+//! Construct an empty string builder.
+//!
+StringBuilder::StringBuilder()
+{
+    head_ = 0;
+    tail_ = 0;
+    byteSize_ = 0;
+    numChars_ = 0;
+    p_ = buf0_;
+    pEnd_ = buf0_ + InlineCap;
+}
+
+
+StringBuilder::~StringBuilder()
+{
+    deleteChunks(head_);
+}
+
+
+//!
+//! Append given null-terminated 8-bit ASCII string to this string.
+//!
+const StringBuilder& StringBuilder::operator +=(const char* s)
+{
+    append(s, strlen(s));
+    return *this;
+}
+
+
+//!
+//! Form and return the string built so far. The builder is not modified.
+//! The resulting string is formed using one allocation.
+//!
+String StringBuilder::toString() const
+{
+    if (head_ == 0)
+    {
+        String s(static_cast<unsigned int>(byteSize_ + 1));
+        s.append(buf0_, byteSize_, numChars_);
+        return s;
+    }
+
+    // Gather the inline buffer and the chunks into one buffer.
+    // All chunks but the last one are full.
+    utf8_t* buf = new utf8_t[byteSize_ + 1];
+    memcpy(buf, buf0_, InlineCap);
+    utf8_t* p = buf + InlineCap;
+    for (chunk_t* chunk = head_; chunk != tail_; chunk = chunk->next)
+    {
+        memcpy(p, chunkData(chunk), chunk->capacity);
+        p += chunk->capacity;
+    }
+    size_t n = p_ - chunkData(tail_);
+    memcpy(p, chunkData(tail_), n);
+    p[n] = 0;
+
+    String s;
+    s.attachRaw(buf, byteSize_ + 1, numChars_ + 1);
+    return s;
+}
+
+
+//!
+//! Append given 8-bit ASCII string (length characters starting at s) to this string.
+//!
+void StringBuilder::append(const char* s, size_t length)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    const unsigned char* pEnd = p + length;
+    for (; (p < pEnd) && (*p <= Utf8::MaxAscii); ++p);
+
+    // Copy the 7-bit ASCII part in bulk.
+    size_t n = p - reinterpret_cast<const unsigned char*>(s);
+    appendBytes(reinterpret_cast<const utf8_t*>(s), n);
+    numChars_ += n;
+    if (p < pEnd)
+    {
+        appendAscii8(p, pEnd - p);
+    }
+}
+
+
+//!
+//! Append count characters (c) to this string.
+//! For example, (sb.append(5,'c'), sb.toString()) == "ccccc".
+//!
+void StringBuilder::append(size_t count, char c)
+{
+    unsigned char u8 = static_cast<unsigned char>(c);
+    if (u8 > Utf8::MaxAscii)
+    {
+        for (; count > 0; --count, appendAscii8(&u8, 1));
+        return;
+    }
+
+    for (size_t n = count; n > 0;)
+    {
+        size_t room = pEnd_ - p_;
+        if (room == 0)
+        {
+            grow(n);
+            room = pEnd_ - p_;
+        }
+        size_t fill = (n < room)? n: room;
+        memset(p_, u8, fill);
+        p_ += fill;
+        n -= fill;
+    }
+
+    byteSize_ += count;
+    numChars_ += count;
+}
+
+
+//
+// Append given 8-bit ASCII string (length bytes starting at s). Each
+// 8-bit ASCII character takes two bytes in UTF8.
+//
+void StringBuilder::appendAscii8(const unsigned char* s, size_t length)
+{
+    utf8_t seq[2];
+    for (const unsigned char* pEnd = s + length; s < pEnd; ++s)
+    {
+        if (*s <= Utf8::MaxAscii)
+        {
+            appendBytes(s, 1);
+        }
+        else
+        {
+            seq[0] = static_cast<utf8_t>(0xc0U | (*s >> 6));
+            seq[1] = static_cast<utf8_t>(0x80U | (*s & 0x3fU));
+            appendBytes(seq, 2);
+        }
+    }
+
+    numChars_ += length;
+}
+
+
+//
+// Append given UTF8 bytes (numU8s bytes starting at s). Fill up the current
+// buffer, then continue in a new chunk if necessary. Character count is not
+// updated.
+//
+void StringBuilder::appendBytes(const utf8_t* s, size_t numU8s)
+{
+    size_t room = pEnd_ - p_;
+    if (numU8s > room)
+    {
+        memcpy(p_, s, room);
+        p_ += room;
+        byteSize_ += room;
+        s += room;
+        numU8s -= room;
+        grow(numU8s);
+    }
+
+    memcpy(p_, s, numU8s);
+    p_ += numU8s;
+    byteSize_ += numU8s;
+}
+
+
+//
+// Current buffer is full. Add a chunk with room for at least minCap bytes.
+// Chunks double in size up to MaxChunkSize bytes unless a larger one is
+// required.
+//
+void StringBuilder::grow(size_t minCap)
+{
+    size_t capacity = (tail_ == 0)? static_cast<size_t>(MinChunkSize): (tail_->capacity << 1);
+    if (capacity > MaxChunkSize)
+    {
+        capacity = MaxChunkSize;
+    }
+    if (capacity < minCap)
+    {
+        capacity = minCap;
+    }
+
+    chunk_t* chunk = reinterpret_cast<chunk_t*>(new unsigned char[sizeof(*chunk) + capacity]);
+    chunk->next = 0;
+    chunk->capacity = capacity;
+    (tail_ != 0)? (tail_->next = chunk): (head_ = chunk);
+    tail_ = chunk;
+    p_ = chunkData(chunk);
+    pEnd_ = p_ + capacity;
+}
+
+
+//!
+//! Reset instance to its initial state. Release all chunks.
+//!
+void StringBuilder::reset()
+{
+    deleteChunks(head_);
+    head_ = 0;
+    tail_ = 0;
+    byteSize_ = 0;
+    numChars_ = 0;
+    p_ = buf0_;
+    pEnd_ = buf0_ + InlineCap;
+}
+
+
+//
+// Delete given chunk and all chunks after it.
+//
+void StringBuilder::deleteChunks(chunk_t* chunk)
+{
+    while (chunk != 0)
+    {
+        chunk_t* next = chunk->next;
+        delete[] reinterpret_cast<unsigned char*>(chunk);
+        chunk = next;
+    }
+}
+
+END_NAMESPACE1
@@ -0,0 +1,149 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef APPKIT_STRING_BUILDER_HPP
+#define APPKIT_STRING_BUILDER_HPP
+
+#include "appkit/String.hpp"
+#include "syskit/Utf8.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(appkit)
+
+
+//! string builder
+class StringBuilder
+    //!
+    //! A class representing a string under construction. Appended data lands in
+    //! a small inline buffer, then in a chain of heap chunks which grow up to
+    //! MaxChunkSize bytes each. Existing chunks are never copied or reallocated,
+    //! and the character count is tracked as data is appended. The resulting
+    //! string is formed by toString() using one allocation. Use a builder instead
+    //! of repeated String appends when assembling a potentially long string from
+    //! many pieces. Example:
+    //!\code
+    //! StringBuilder sb;
+    //! for (size_t i = 0; i < numItems; ++i)
+    //! {
+    //!   sb += item[i].name();
+    //!   sb += '\n';
+    //! }
+    //! String s(sb.toString());
+    //!\endcode
+    //!
+{
+
+public:
+    enum
+    {
+        InlineCap = 256,
+        MaxChunkSize = 65536,
+        MinChunkSize = 1024
+    };
+
+    StringBuilder();
+    ~StringBuilder();
+
+    const StringBuilder& operator +=(char c);
+    const StringBuilder& operator +=(const String& str);
+    const StringBuilder& operator +=(const char* s);
+
+    String toString() const;
+    bool empty() const;
+    unsigned int byteSize() const;
+    unsigned int length() const;
+    void append(const char* s, size_t length);
+    void append(const syskit::utf8_t* s, size_t numU8s, size_t numChars);
+    void append(size_t count, char c);
+    void reset();
+
+private:
+    typedef struct chunk_s
+    {
+        struct chunk_s* next;
+        size_t capacity;
+    } chunk_t;
+
+    chunk_t* head_;
+    chunk_t* tail_;
+    size_t byteSize_;
+    size_t numChars_;
+    syskit::utf8_t* p_;
+    syskit::utf8_t* pEnd_;
+    syskit::utf8_t buf0_[InlineCap];
+
+    StringBuilder(const StringBuilder&); //prohibit usage
+    const StringBuilder& operator =(const StringBuilder&); //prohibit usage
+
+    void appendAscii8(const unsigned char*, size_t);
+    void appendBytes(const syskit::utf8_t*, size_t);
+    void grow(size_t);
+
+    static syskit::utf8_t* chunkData(chunk_t*);
+    static void deleteChunks(chunk_t*);
+
+};
+
+//! Append given character to this string. An 8-bit ASCII character
+//! takes two bytes in UTF8.
+inline const StringBuilder& StringBuilder::operator +=(char c)
+{
+    unsigned char u8 = static_cast<unsigned char>(c);
+    if ((u8 <= syskit::Utf8::MaxAscii) && (p_ < pEnd_))
+    {
+        *p_++ = u8;
+        ++byteSize_;
+        ++numChars_;
+    }
+    else
+    {
+        appendAscii8(&u8, 1);
+    }
+
+    return *this;
+}
+
+//! Append given string to this string.
+inline const StringBuilder& StringBuilder::operator +=(const String& str)
+{
+    unsigned int byteSize;
+    const syskit::utf8_t* s = str.raw(byteSize);
+    append(s, byteSize - 1, str.length());
+    return *this;
+}
+
+//! Return true if nothing has been appended since construction or the last reset.
+inline bool StringBuilder::empty() const
+{
+    return (numChars_ == 0);
+}
+
+//! Return the number of UTF8 bytes appended so far. There's no terminating null.
+inline unsigned int StringBuilder::byteSize() const
+{
+    return static_cast<unsigned int>(byteSize_);
+}
+
+//! Return the number of characters appended so far.
+inline unsigned int StringBuilder::length() const
+{
+    return static_cast<unsigned int>(numChars_);
+}
+
+//! Append given UTF8 string (numU8s bytes holding numChars characters
+//! starting at s) to this string.
+inline void StringBuilder::append(const syskit::utf8_t* s, size_t numU8s, size_t numChars)
+{
+    appendBytes(s, numU8s);
+    numChars_ += numChars;
+}
+
+inline syskit::utf8_t* StringBuilder::chunkData(chunk_t* chunk)
+{
+    return reinterpret_cast<syskit::utf8_t*>(chunk + 1);
+}
+
+END_NAMESPACE1
+
+#endif
@@ -5,7 +5,10 @@
 #include "syskit/macros.h"
 
 #include "appkit-pch.h"
+#include "appkit/Atom.hpp"
 #include "appkit/DelimitedTxt.hpp"
+#include "appkit/Str.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/StringDic.hpp"
 #include "appkit/StringVec.hpp"
 
@@ -17,7 +20,7 @@ using namespace appkit;
 
 typedef struct
 {
-    String* dicAsString;
+    StringBuilder* dicAsString;
     String* lineDelim;
     char kvDelim;
 } stringifyArg_t;
@@ -31,12 +34,16 @@ BEGIN_NAMESPACE1(appkit)
 //! Construct a dictionary with given key-value pairs. Each line in txt contains
 //! a key-value pair delimited by kvDelim. Use trimLines to indicate if lines
 //! need to be trimmed (i.e., if a line delimiter is or is not included in the
-//! value part). In case of duplicates, the newer key-value pair is used.
+//! value part). In case of duplicates, the newer key-value pair is used. Use
+//! internKeys to indicate if keys are to be interned. Use hashKeys to indicate
+//! if keys are to be hashed for constant-time lookups.
 //!
-StringDic::StringDic(DelimitedTxt& txt, char kvDelim, bool trimLines, bool ignoreCase):
+StringDic::StringDic(DelimitedTxt& txt, char kvDelim, bool trimLines, bool ignoreCase, bool internKeys, bool hashKeys):
 tree_(ignoreCase? String::comparePI: String::compareP)
 {
     compareK_ = ignoreCase? String::compareKPI: String::compareKP;
+    index_ = hashKeys? mkIndex(ignoreCase): 0;
+    internKeys_ = internKeys;
     doReset(txt, kvDelim, trimLines);
 }
 
@@ -49,16 +56,40 @@ StringDic::StringDic(StringDic* that):
 tree_(&that->tree_)
 {
     compareK_ = that->compareK_;
+    index_ = that->index_;
+    internKeys_ = that->internKeys_;
+    that->index_ = 0;
 }
 
 
+#if HAS_RVALUE_REFS
 //!
-//! Construct an empty dictionary.
+//! Construct instance using guts from that. That is, move dictionary contents from
+//! that into this.
 //!
-StringDic::StringDic(bool ignoreCase):
+StringDic::StringDic(StringDic&& that):
+tree_(static_cast<Tree&&>(that.tree_))
+{
+    compareK_ = that.compareK_;
+    index_ = that.index_;
+    internKeys_ = that.internKeys_;
+    that.index_ = 0;
+}
+#endif
+
+
+//!
+//! Construct an empty dictionary. Use internKeys to indicate if keys are to be
+//! interned. Interned keys are shared among dictionaries with recurring keys.
+//! Use hashKeys to indicate if keys are to be hashed. Hashed keys are located
+//! in constant time, but each key-value pair costs an additional table node.
+//!
+StringDic::StringDic(bool ignoreCase, bool internKeys, bool hashKeys):
 tree_(ignoreCase? String::comparePI: String::compareP)
 {
     compareK_ = ignoreCase? String::compareKPI: String::compareKP;
+    index_ = hashKeys? mkIndex(ignoreCase): 0;
+    internKeys_ = internKeys;
 }
 
 
@@ -69,7 +100,9 @@ StringDic::StringDic(const StringDic& dic):
 tree_(dic.tree_.cmpFunc())
 {
     compareK_ = dic.ignoreCase()? String::compareKPI: String::compareKP;
-    dic.tree_.applyParentFirst(cloneKv, &tree_);
+    index_ = (dic.index_ != 0)? mkIndex(dic.ignoreCase()): 0;
+    internKeys_ = dic.internKeys_;
+    dic.tree_.applyParentFirst(cloneKv, this);
 }
 
 
@@ -77,6 +110,23 @@ StringDic::~StringDic()
 {
     void* arg = 0;
     tree_.applyChildFirst(deleteKv, arg);
+    delete index_;
+}
+
+
+//!
+//! Reset and move the dictionary contents from that into this. Assume the dictionaries
+//! are compatible. That is, items unique in that are also unique in this.
+//!
+const StringDic& StringDic::operator =(StringDic* that)
+{
+    if (this != that)
+    {
+        reset();
+        takeGuts(that);
+    }
+
+    return *this;
 }
 
 
@@ -93,7 +143,7 @@ const StringDic& StringDic::operator =(const StringDic& dic)
     {
         reset();
         Tree::cb1_t cb = (compareK_ == dic.compareK_)? cloneKv: addKv;
-        dic.tree_.applyParentFirst(cb, &tree_);
+        dic.tree_.applyParentFirst(cb, this);
     }
 
     // Return reference to self.
@@ -101,6 +151,95 @@ const StringDic& StringDic::operator =(const StringDic& dic)
 }
 
 
+//
+// Return given key in the form to be stored. That is, interned if keys are to be interned.
+//
+String StringDic::mkKey(const String& k) const
+{
+    return internKeys_? Atom::intern(k): k;
+}
+
+
+//
+// Return a new index for hashed keys.
+//
+HashTable* StringDic::mkIndex(bool ignoreCase)
+{
+    HashTable* index = ignoreCase?
+        new HashTable(String::comparePI, String::hashPI):
+        new HashTable(String::compareP, String::hashP);
+    return index;
+}
+
+
+//
+// Remove key-value pair with given key from the tree and, if keys are hashed,
+// from the index. Return the removed key-value pair. Return zero if not found.
+//
+StringPair* StringDic::extractKv(const String& k)
+{
+    void* removedItem;
+    StringPair* kv = tree_.rm(&k, removedItem)? static_cast<StringPair*>(removedItem): 0;
+    if ((kv != 0) && (index_ != 0))
+    {
+        index_->rm(kv);
+    }
+
+    return kv;
+}
+
+
+//
+// Remove key-value pair with given key from the tree and, if keys are hashed,
+// from the index. Return the removed key-value pair. Return zero if not found.
+//
+StringPair* StringDic::extractKv(const char* k)
+{
+    void* removedItem;
+    StringPair* kv = tree_.rm(k, compareK_, removedItem)? static_cast<StringPair*>(removedItem): 0;
+    if ((kv != 0) && (index_ != 0))
+    {
+        index_->rm(kv);
+    }
+
+    return kv;
+}
+
+
+//
+// Locate key-value pair with given key. Use the index if keys are hashed,
+// and the tree otherwise. Return zero if not found.
+//
+StringPair* StringDic::findKv(const String& k) const
+{
+    void* foundItem;
+    bool found = (index_ != 0)? index_->find(&k, foundItem): tree_.find(&k, foundItem);
+    return found? static_cast<StringPair*>(foundItem): 0;
+}
+
+
+//
+// Locate key-value pair with given key. Use the index if keys are hashed,
+// and the tree otherwise. Return zero if not found.
+//
+StringPair* StringDic::findKv(const char* k) const
+{
+    void* foundItem;
+    bool found;
+    if (index_ != 0)
+    {
+        HashTable::hash_t hashK = (compareK_ == String::compareKPI)? Str::hashKI: Str::hashK;
+        found = index_->find(k, hashK, compareK_, foundItem);
+    }
+    else
+    {
+        found = tree_.find(k, compareK_, foundItem);
+    }
+
+    return found? static_cast<StringPair*>(foundItem): 0;
+}
+
+
 //!
 //! Just as a string can be expanded into a dictionary of key-value pairs, the
 //! dictionary can be collapsed back into one string. This method collapses the
@@ -111,14 +250,14 @@ const StringDic& StringDic::operator =(const StringDic& dic)
 //!
 String StringDic::stringify(char kvDelim, const char* lineDelim) const
 {
-    String s;
+    StringBuilder s;
     String delim(lineDelim);
     stringifyArg_t arg;
     arg.dicAsString = &s;
     arg.lineDelim = &delim;
     arg.kvDelim = kvDelim;
     tree_.apply(stringifyKv, &arg);
-    return s;
+    return s.toString();
 }
 
 
@@ -129,17 +268,15 @@ String StringDic::stringify(char kvDelim, const char* lineDelim) const
 //!
 StringPair* StringDic::getKv(const String& k, bool& kvAdded)
 {
-    StringPair* kv;
-    void* foundItem;
-    if (tree_.find(&k, foundItem))
+    StringPair* kv = findKv(k);
+    if (kv != 0)
     {
-        kv = static_cast<StringPair*>(foundItem);
         kvAdded = false;
     }
     else
     {
-        kv = new StringPair(k);
-        kvAdded = tree_.add(kv);
+        kv = new StringPair(mkKey(k));
+        kvAdded = insertKv(kv);
     }
 
     return kv;
@@ -148,17 +285,15 @@ StringPair* StringDic::getKv(const String& k, bool& kvAdded)
 
 StringPair* StringDic::getKv(const String& k, const String& v, bool& kvAdded)
 {
-    StringPair* kv;
-    void* foundItem;
-    if (tree_.find(&k, foundItem))
+    StringPair* kv = findKv(k);
+    if (kv != 0)
     {
-        kv = static_cast<StringPair*>(foundItem);
         kvAdded = false;
     }
     else
     {
-        kv = new StringPair(k, v);
-        kvAdded = tree_.add(kv);
+        kv = new StringPair(mkKey(k), v);
+        kvAdded = insertKv(kv);
     }
 
     return kv;
@@ -172,17 +307,15 @@ StringPair* StringDic::getKv(const String& k, const String& v, bool& kvAdded)
 //!
 StringPair* StringDic::getKv(const char* k, bool& kvAdded)
 {
-    StringPair* kv;
-    void* foundItem;
-    if (tree_.find(k, compareK_, foundItem))
+    StringPair* kv = findKv(k);
+    if (kv != 0)
     {
-        kv = static_cast<StringPair*>(foundItem);
         kvAdded = false;
     }
     else
     {
-        kv = new StringPair(k);
-        kvAdded = tree_.add(kv);
+        kv = new StringPair(mkKey(k));
+        kvAdded = insertKv(kv);
     }
 
     return kv;
@@ -195,8 +328,8 @@ StringPair* StringDic::getKv(const char* k, bool& kvAdded)
 //!
 bool StringDic::add(const String& k, const String& v)
 {
-    StringPair* kv = new StringPair(k, v);
-    bool ok = tree_.add(kv);
+    StringPair* kv = new StringPair(mkKey(k), v);
+    bool ok = insertKv(kv);
     if (!ok)
     {
         delete kv;
@@ -253,7 +386,7 @@ bool StringDic::associate(const String& k, const String& v, char delim)
 bool StringDic::associate(const StringDic& dic)
 {
     bool modified = false;
-    void* arg[2] = {&tree_, &modified};
+    void* arg[2] = {this, &modified};
     dic.tree_.applyParentFirst(copyKv, arg);
     return modified;
 }
@@ -265,13 +398,12 @@ bool StringDic::associate(const StringDic& dic)
 //
 bool StringDic::containsKv(void* arg, void* item)
 {
-    const Tree& tree = *static_cast<const Tree*>(arg);
-    void* foundItem;
+    const StringDic& dic = *static_cast<const StringDic*>(arg);
+    const StringPair* key = static_cast<const StringPair*>(item);
+    const StringPair* foundKv = dic.findKv(key->k());
     bool keepGoing;
-    if (tree.find(item, foundItem))
+    if (foundKv != 0)
     {
-        const StringPair* key = static_cast<const StringPair*>(item);
-        const StringPair* foundKv = static_cast<const StringPair*>(foundItem);
         keepGoing = (key->v() == foundKv->v());
     }
     else
@@ -283,6 +415,22 @@ bool StringDic::containsKv(void* arg, void* item)
 }
 
 
+//
+// Add given key-value pair to the tree and, if keys are hashed, to the index.
+// Return true if successful. Return false otherwise (duplicate key).
+//
+bool StringDic::insertKv(StringPair* kv)
+{
+    bool ok = tree_.add(kv);
+    if (ok && (index_ != 0))
+    {
+        index_->add(kv);
+    }
+
+    return ok;
+}
+
+
 bool StringDic::proxy0(void* arg, void* item)
 {
     const arg0_t& r = *static_cast<const arg0_t*>(arg);
@@ -325,11 +473,10 @@ bool StringDic::reset(DelimitedTxt& txt, char kvDelim, bool trimLines)
 //!
 bool StringDic::rm(const String& k)
 {
-    void* removedItem;
-    bool ok = tree_.rm(&k, removedItem);
+    const StringPair* kv = extractKv(k);
+    bool ok = (kv != 0);
     if (ok)
     {
-        const StringPair* kv = static_cast<const StringPair*>(removedItem);
         delete kv;
     }
 
@@ -346,11 +493,10 @@ bool StringDic::rm(const String& k)
 //!
 bool StringDic::rm(const String& k, String& removedV)
 {
-    void* removedItem;
-    bool ok = tree_.rm(&k, removedItem);
+    const StringPair* kv = extractKv(k);
+    bool ok = (kv != 0);
     if (ok)
     {
-        const StringPair* kv = static_cast<const StringPair*>(removedItem);
         removedV = kv->v();
         delete kv;
     }
@@ -377,7 +523,7 @@ bool StringDic::rm(const StringDic& dic)
     else
     {
         unsigned int b4 = tree_.numItems();
-        dic.tree_.applyChildFirst(rmKv, &tree_);
+        dic.tree_.applyChildFirst(rmKv, this);
         modified = (tree_.numItems() < b4);
     }
 
@@ -409,11 +555,10 @@ bool StringDic::rm(const StringVec& keys)
 //!
 bool StringDic::rm(const char* k)
 {
-    void* removedItem;
-    bool ok = tree_.rm(k, compareK_, removedItem);
+    const StringPair* kv = extractKv(k);
+    bool ok = (kv != 0);
     if (ok)
     {
-        const StringPair* kv = static_cast<const StringPair*>(removedItem);
         delete kv;
     }
 
@@ -430,11 +575,10 @@ bool StringDic::rm(const char* k)
 //!
 bool StringDic::rm(const char* k, String& removedV)
 {
-    void* removedItem;
-    bool ok = tree_.rm(k, compareK_, removedItem);
+    const StringPair* kv = extractKv(k);
+    bool ok = (kv != 0);
     if (ok)
     {
-        const StringPair* kv = static_cast<const StringPair*>(removedItem);
         removedV = kv->v();
         delete kv;
     }
@@ -464,10 +608,10 @@ bool StringDic::vectorize(StringVec& k, StringVec& v) const
 //
 void StringDic::addKv(void* arg, void* item)
 {
-    Tree& dst = *static_cast<Tree*>(arg);
+    StringDic& dst = *static_cast<StringDic*>(arg);
     const StringPair& src = *static_cast<const StringPair*>(item);
     StringPair* cloned = new StringPair(src);
-    if (!dst.add(cloned))
+    if (!dst.insertKv(cloned))
     {
         delete cloned;
     }
@@ -499,18 +643,16 @@ void StringDic::any(String& k, String& v) const
 //
 void StringDic::associateKv(void* arg, void* item)
 {
-    Tree& dst = *static_cast<Tree*>(arg);
-    void* foundItem;
-    if (dst.find(item, foundItem))
+    StringDic& dst = *static_cast<StringDic*>(arg);
+    const StringPair* src = static_cast<const StringPair*>(item);
+    StringPair* foundKv = dst.findKv(src->k());
+    if (foundKv != 0)
     {
-        StringPair* foundKv = static_cast<StringPair*>(foundItem);
-        const StringPair* src = static_cast<const StringPair*>(item);
         foundKv->setV(src->v());
     }
     else
     {
-        const StringPair* src = static_cast<const StringPair*>(item);
-        dst.add(new StringPair(*src));
+        dst.insertKv(new StringPair(*src));
     }
 }
 
@@ -521,9 +663,9 @@ void StringDic::associateKv(void* arg, void* item)
 //
 void StringDic::cloneKv(void* arg, void* item)
 {
-    Tree& dst = *static_cast<Tree*>(arg);
+    StringDic& dst = *static_cast<StringDic*>(arg);
     const StringPair& src = *static_cast<const StringPair*>(item);
-    dst.add(new StringPair(src));
+    dst.insertKv(new StringPair(src));
 }
 
 
@@ -546,7 +688,7 @@ void StringDic::compare(const StringDic& b4, StringDic* added, StringDic* update
         if (updated)
         {
             updated->reset();
-            void* arg[3] = {const_cast<Tree*>(&b4.tree_), &added->tree_, &updated->tree_};
+            void* arg[3] = {const_cast<StringDic*>(&b4), added, updated};
             tree_.apply(findAddsAndUpdates, arg);
         }
 
@@ -554,7 +696,7 @@ void StringDic::compare(const StringDic& b4, StringDic* added, StringDic* update
         // The entries not in the before snapshot have been added.
         else
         {
-            void* arg[2] = {const_cast<Tree*>(&b4.tree_), &added->tree_};
+            void* arg[2] = {const_cast<StringDic*>(&b4), added};
             tree_.apply(findRemoves, arg);
         }
     }
@@ -564,7 +706,7 @@ void StringDic::compare(const StringDic& b4, StringDic* added, StringDic* update
     else if (updated)
     {
         updated->reset();
-        void* arg[2] = {const_cast<Tree*>(&b4.tree_), &updated->tree_};
+        void* arg[2] = {const_cast<StringDic*>(&b4), updated};
         tree_.apply(findUpdates, arg);
     }
 
@@ -573,23 +715,22 @@ void StringDic::compare(const StringDic& b4, StringDic* added, StringDic* update
     if (removed)
     {
         removed->reset();
-        void* arg[2] = {const_cast<Tree*>(&tree_), &removed->tree_};
+        void* arg[2] = {const_cast<StringDic*>(this), removed};
         b4.tree_.apply(findRemoves, arg);
     }
 }
 
 
-void StringDic::copyKv(Tree& dst, StringPair* src)
+void StringDic::copyKv(StringDic& dst, StringPair* src)
 {
-    void* foundItem;
-    if (dst.find(src, foundItem))
+    StringPair* foundKv = dst.findKv(src->k());
+    if (foundKv != 0)
     {
-        StringPair* foundKv = static_cast<StringPair*>(foundItem);
         foundKv->setV(src->v());
     }
     else
     {
-        dst.add(new StringPair(*src));
+        dst.insertKv(new StringPair(*src));
     }
 }
 
@@ -601,22 +742,21 @@ void StringDic::copyKv(Tree& dst, StringPair* src)
 void StringDic::copyKv(void* arg, void* item)
 {
     void** p = static_cast<void**>(arg);
-    Tree& tree = *static_cast<Tree*>(p[0]);
+    StringDic& dic = *static_cast<StringDic*>(p[0]);
     StringPair* src = static_cast<StringPair*>(item);
 
     // If change already occurred, don't need to check for changes any more.
     bool* modified = static_cast<bool*>(p[1]);
     if (*modified)
     {
-        copyKv(tree, src);
+        copyKv(dic, src);
         return;
     }
 
     // If key exists, update its value. However, no-op if no change.
-    void* foundItem;
-    if (tree.find(src, foundItem))
+    StringPair* dst = dic.findKv(src->k());
+    if (dst != 0)
     {
-        StringPair* dst = static_cast<StringPair*>(foundItem);
         if (src->v() != dst->v())
         {
             dst->setV(src->v());
@@ -626,7 +766,7 @@ void StringDic::copyKv(void* arg, void* item)
     }
 
     // Clone key-value pair.
-    tree.add(new StringPair(*src));
+    dic.insertKv(new StringPair(*src));
     *modified = true;
 }
 
@@ -670,24 +810,22 @@ void StringDic::doReset(DelimitedTxt& txt, char kvDelim, bool trimLines)
 void StringDic::findAddsAndUpdates(void* arg, void* item)
 {
     void** p = static_cast<void**>(arg);
-    const Tree& b4 = *static_cast<const Tree*>(p[0]);
-    Tree* added = static_cast<Tree*>(p[1]);
-    Tree* updated = static_cast<Tree*>(p[2]);
+    const StringDic& b4 = *static_cast<const StringDic*>(p[0]);
+    StringDic* added = static_cast<StringDic*>(p[1]);
+    StringDic* updated = static_cast<StringDic*>(p[2]);
 
-    void* foundItem;
-    if (b4.find(item, foundItem))
+    const StringPair* key = static_cast<const StringPair*>(item);
+    const StringPair* foundKv = b4.findKv(key->k());
+    if (foundKv != 0)
     {
-        const StringPair* foundKv = static_cast<const StringPair*>(foundItem);
-        const StringPair* key = static_cast<const StringPair*>(item);
         if (foundKv->v() != key->v())
         {
-            updated->add(new StringPair(*key));
+            updated->insertKv(new StringPair(*key));
         }
     }
     else
     {
-        const StringPair& key = *static_cast<const StringPair*>(item);
-        added->add(new StringPair(key));
+        added->insertKv(new StringPair(*key));
     }
 }
 
@@ -698,13 +836,13 @@ void StringDic::findAddsAndUpdates(void* arg, void* item)
 void StringDic::findRemoves(void* arg, void* item)
 {
     void** p = static_cast<void**>(arg);
-    const Tree& tree = *static_cast<const Tree*>(p[0]);
-    Tree* removed = static_cast<Tree*>(p[1]);
+    const StringDic& dic = *static_cast<const StringDic*>(p[0]);
+    StringDic* removed = static_cast<StringDic*>(p[1]);
 
-    if (!tree.find(item))
+    const StringPair& key = *static_cast<const StringPair*>(item);
+    if (dic.findKv(key.k()) == 0)
     {
-        const StringPair& key = *static_cast<const StringPair*>(item);
-        removed->add(new StringPair(key));
+        removed->insertKv(new StringPair(key));
     }
 }
 
@@ -715,28 +853,41 @@ void StringDic::findRemoves(void* arg, void* item)
 void StringDic::findUpdates(void* arg, void* item)
 {
     void** p = static_cast<void**>(arg);
-    const Tree& b4 = *static_cast<const Tree*>(p[0]);
-    Tree* updated = static_cast<Tree*>(p[1]);
+    const StringDic& b4 = *static_cast<const StringDic*>(p[0]);
+    StringDic* updated = static_cast<StringDic*>(p[1]);
 
-    void* foundItem;
-    if (b4.find(item, foundItem))
+    const StringPair* key = static_cast<const StringPair*>(item);
+    const StringPair* foundKv = b4.findKv(key->k());
+    if ((foundKv != 0) && (foundKv->v() != key->v()))
     {
-        const StringPair* foundKv = static_cast<const StringPair*>(foundItem);
-        const StringPair* key = static_cast<const StringPair*>(item);
-        if (foundKv->v() != key->v())
-        {
-            updated->add(new StringPair(*key));
-        }
+        updated->insertKv(new StringPair(*key));
     }
 }
 
 
+//
+// Callback to add key-value pairs to an index.
+//
+void StringDic::indexKv(void* arg, void* item)
+{
+    HashTable* index = static_cast<HashTable*>(arg);
+    index->add(item);
+}
+
+
 void StringDic::mergeKv(void* arg, void* item)
 {
-    Tree& tree = *static_cast<Tree*>(arg);
+    StringDic& dic = *static_cast<StringDic*>(arg);
     void* foundItem;
-    bool ok = tree.add(item, foundItem);
-    if (!ok)
+    bool ok = dic.tree_.add(item, foundItem);
+    if (ok)
+    {
+        if (dic.index_ != 0)
+        {
+            dic.index_->add(item);
+        }
+    }
+    else
     {
         StringPair* src = static_cast<StringPair*>(item);
         StringPair* dst = static_cast<StringPair*>(foundItem);
@@ -754,13 +905,17 @@ void StringDic::mergeInto(StringDic& result)
 {
     if ((result.tree_.numItems() == 0) && (compareK_ == result.compareK_))
     {
-        result.tree_ = &tree_; //move guts into result
+        result.takeGuts(this);
     }
     else
     {
-        void* arg = &result.tree_;
+        void* arg = &result;
         tree_.applyParentFirst(mergeKv, arg);
         tree_.reset();
+        if (index_ != 0)
+        {
+            index_->reset();
+        }
     }
 }
 
@@ -776,19 +931,28 @@ void StringDic::prepVec(StringVec& vec) const
 }
 
 
+//
+// Rebuild the index from the tree if keys are hashed.
+//
+void StringDic::reindex()
+{
+    if (index_ != 0)
+    {
+        index_->reset();
+        tree_.apply(indexKv, index_);
+    }
+}
+
+
 void StringDic::rmKv(void* arg, void* item)
 {
-    Tree& tree = *static_cast<Tree*>(arg);
-    void* foundItem;
-    if (tree.find(item, foundItem))
+    StringDic& dic = *static_cast<StringDic*>(arg);
+    const StringPair* key = static_cast<const StringPair*>(item);
+    const StringPair* foundKv = dic.findKv(key->k());
+    if ((foundKv != 0) && (foundKv->v() == key->v()))
     {
-        const StringPair* foundKv = static_cast<const StringPair*>(foundItem);
-        const StringPair* key = static_cast<const StringPair*>(item);
-        if (foundKv->v() == key->v())
-        {
-            tree.rm(foundItem);
-            delete foundKv;
-        }
+        dic.extractKv(key->k());
+        delete foundKv;
     }
 }
 
@@ -796,7 +960,7 @@ void StringDic::rmKv(void* arg, void* item)
 void StringDic::stringifyKv(void* arg, void* item)
 {
     stringifyArg_t& r = *static_cast<stringifyArg_t*>(arg);
-    String& s = *r.dicAsString;
+    StringBuilder& s = *r.dicAsString;
     const StringPair& kv = *static_cast<const StringPair*>(item);
     s += kv.k();
     s += r.kvDelim;
@@ -805,6 +969,31 @@ void StringDic::stringifyKv(void* arg, void* item)
 }
 
 
+//
+// Move dictionary contents from that into this. Assume this is empty. Keep
+// this dictionary's key modes. If both dictionaries hash their keys the same
+// way, swap the indexes. Otherwise, rebuild this dictionary's index if any.
+//
+void StringDic::takeGuts(StringDic* that)
+{
+    tree_ = &that->tree_;
+    if ((index_ != 0) && (that->index_ != 0) && (index_->cmpFunc() == that->index_->cmpFunc()))
+    {
+        HashTable* index = index_;
+        index_ = that->index_;
+        that->index_ = index;
+    }
+    else
+    {
+        reindex();
+        if (that->index_ != 0)
+        {
+            that->index_->reset();
+        }
+    }
+}
+
+
 void StringDic::vectorizeKv(void* arg, void* item)
 {
     StringVec* const* vec = static_cast<StringVec* const*>(arg);
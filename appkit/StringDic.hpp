@@ -6,6 +6,7 @@
 #define APPKIT_STRING_DIC_HPP
 
 #include "appkit/String.hpp"
+#include "syskit/HashTable.hpp"
 #include "syskit/Tree.hpp"
 #include "syskit/macros.h"
 
@@ -22,7 +23,12 @@ class StringDic
     //! A class representing a dictionary of key-value strings. Key-value pairs
     //! are added using the add() and associate() methods, and are removed using
     //! the rm() methods. Searches are provided by the find() methods. Implemented
-    //! using a 2-3-4 tree of StringPair instances. Example:
+    //! using a 2-3-4 tree of StringPair instances. Keys can optionally be interned
+    //! (see Atom::intern()) so dictionaries with recurring keys share key storage
+    //! and matching keys compare quickly. Keys can also optionally be hashed. A
+    //! hashed dictionary maintains a hash table of its key-value pairs alongside
+    //! the tree, so key lookups take constant time while iterating remains in
+    //! key order, at the cost of a table node per key-value pair. Example:
     //!\code
     //! StringDic dic;
     //! :
@@ -39,10 +45,13 @@ public:
     typedef bool(*cb1_t)(void* arg, const String& k, const String& v);
 
     // Constructors and destructor.
-    StringDic(DelimitedTxt& txt, char kvDelim = '=', bool trimLines = true, bool ignoreCase = false);
+    StringDic(DelimitedTxt& txt, char kvDelim = '=', bool trimLines = true, bool ignoreCase = false, bool internKeys = false, bool hashKeys = false);
     StringDic(StringDic* that);
-    StringDic(bool ignoreCase = false);
+    StringDic(bool ignoreCase = false, bool internKeys = false, bool hashKeys = false);
     StringDic(const StringDic& dic);
+#if HAS_RVALUE_REFS
+    StringDic(StringDic&& that);
+#endif
     ~StringDic();
 
     // Operators.
@@ -55,6 +64,9 @@ public:
     const StringDic& operator +=(const StringDic& dic);
     const StringDic& operator =(StringDic* that);
     const StringDic& operator =(const StringDic& dic);
+#if HAS_RVALUE_REFS
+    const StringDic& operator =(StringDic&& that);
+#endif
     const StringDic& operator -=(const StringDic& dic);
     const StringDic& operator -=(const StringVec& keys);
 
@@ -88,7 +100,9 @@ public:
     void reset();
 
     // Getters.
+    bool hashKeys() const;
     bool ignoreCase() const;
+    bool internKeys() const;
     unsigned int numKvPairs() const;
 
     // Variants supporting primitive value types.
@@ -143,10 +157,20 @@ private:
 
     syskit::Tree tree_;
     syskit::Tree::compare_t compareK_;
-
+    syskit::HashTable* index_;
+    bool internKeys_;
+
+    String mkKey(const String&) const;
+    StringPair* extractKv(const String&);
+    StringPair* extractKv(const char*);
+    StringPair* findKv(const String&) const;
+    StringPair* findKv(const char*) const;
     StringPair* getKv(const String&, const String&, bool&);
+    bool insertKv(StringPair*);
     void doReset(DelimitedTxt&, char, bool);
     void prepVec(StringVec&) const;
+    void reindex();
+    void takeGuts(StringDic*);
 
     static bool containsKv(void*, void*);
     static bool proxy0(void*, void*);
@@ -154,12 +178,14 @@ private:
     static void addKv(void*, void*);
     static void associateKv(void*, void*);
     static void cloneKv(void*, void*);
-    static void copyKv(syskit::Tree&, StringPair*);
+    static syskit::HashTable* mkIndex(bool);
+    static void copyKv(StringDic&, StringPair*);
     static void copyKv(void*, void*);
     static void deleteKv(void*, void*);
     static void findAddsAndUpdates(void*, void*);
     static void findRemoves(void*, void*);
     static void findUpdates(void*, void*);
+    static void indexKv(void*, void*);
     static void mergeKv(void*, void*);
     static void rmKv(void*, void*);
     static void stringifyKv(void*, void*);
@@ -182,16 +208,16 @@ BEGIN_NAMESPACE1(appkit)
 //! key is an empty string.
 inline String StringDic::operator [](const String& k) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->v(): String();
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->v(): String();
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is an empty string.
 inline String StringDic::operator [](const char* k) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->v(): String();
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->v(): String();
 }
 
 //! If given key does not exist, create new key-value pair using an empty
@@ -215,7 +241,7 @@ inline String& StringDic::operator [](const char* k)
 //! corresponding key-value pairs are not equal.
 inline bool StringDic::operator !=(const StringDic& dic) const
 {
-    bool eq = (tree_.numItems() == dic.tree_.numItems())? tree_.apply(containsKv, const_cast<syskit::Tree*>(&dic.tree_)): false;
+    bool eq = (tree_.numItems() == dic.tree_.numItems())? tree_.apply(containsKv, const_cast<StringDic*>(&dic)): false;
     return (!eq);
 }
 
@@ -224,7 +250,7 @@ inline bool StringDic::operator !=(const StringDic& dic) const
 //! key-value pairs are equal.
 inline bool StringDic::operator ==(const StringDic& dic) const
 {
-    bool eq = (tree_.numItems() == dic.tree_.numItems())? tree_.apply(containsKv, const_cast<syskit::Tree*>(&dic.tree_)): false;
+    bool eq = (tree_.numItems() == dic.tree_.numItems())? tree_.apply(containsKv, const_cast<StringDic*>(&dic)): false;
     return eq;
 }
 
@@ -233,17 +259,18 @@ inline bool StringDic::operator ==(const StringDic& dic) const
 //! from dic.
 inline const StringDic& StringDic::operator +=(const StringDic& dic)
 {
-    dic.tree_.applyParentFirst(associateKv, &tree_);
+    dic.tree_.applyParentFirst(associateKv, this);
     return *this;
 }
 
+#if HAS_RVALUE_REFS
 //! Reset and move the dictionary contents from that into this. Assume the dictionaries
 //! are compatible. That is, items unique in that are also unique in this.
-inline const StringDic& StringDic::operator =(StringDic* that)
+inline const StringDic& StringDic::operator =(StringDic&& that)
 {
-    if (this != that) tree_ = &that->tree_;
-    return *this;
+    return operator =(&that);
 }
+#endif
 
 //! Remove given key-value pairs from this dictionary.
 //! Return reference to self.
@@ -265,16 +292,16 @@ inline const StringDic& StringDic::operator -=(const StringVec& keys)
 //! key is the given default value.
 inline String StringDic::getValue(const String& k, const String& defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->v(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->v(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline String StringDic::getValue(const char* k, const String& defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->v(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->v(): defaultV;
 }
 
 //! Add key-value pairs from dic into this. If necessary, drop key-value pairs
@@ -284,7 +311,7 @@ inline String StringDic::getValue(const char* k, const String& defaultV) const
 inline bool StringDic::add(const StringDic& dic)
 {
     unsigned int b4 = tree_.numItems();
-    dic.tree_.applyParentFirst(addKv, &tree_);
+    dic.tree_.applyParentFirst(addKv, this);
     return (tree_.numItems() > b4);
 }
 
@@ -394,59 +421,65 @@ inline bool StringDic::associate(const String& k, unsigned short v)
 //! Return true if given key exists in the dictionary.
 inline bool StringDic::contains(const String& k) const
 {
-    bool found = tree_.find(&k);
+    bool found = (findKv(k) != 0);
     return found;
 }
 
 //! Return true if given key-value pair exists in the dictionary.
 inline bool StringDic::contains(const String& k, const String& v) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? (static_cast<const StringPair*>(foundItem)->v() == v): (false);
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? (kv->v() == v): (false);
 }
 
 //! Return true if this dictionary contains given dictionary.
 inline bool StringDic::contains(const StringDic& dic) const
 {
-    bool answer = (tree_.numItems() >= dic.tree_.numItems())? dic.tree_.apply(containsKv, const_cast<syskit::Tree*>(&tree_)): false;
+    bool answer = (tree_.numItems() >= dic.tree_.numItems())? dic.tree_.apply(containsKv, const_cast<StringDic*>(this)): false;
     return answer;
 }
 
 //! Return true if given key exists in the dictionary.
 inline bool StringDic::contains(const char* k) const
 {
-    bool found = tree_.find(k, compareK_);
+    bool found = (findKv(k) != 0);
     return found;
 }
 
 //! Return true if given key-value pair exists in the dictionary.
 inline bool StringDic::contains(const char* k, const String& v) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? (static_cast<const StringPair*>(foundItem)->v() == v): (false);
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? (kv->v() == v): (false);
 }
 
 //! Return true if given key-value pair exists in the dictionary.
 inline bool StringDic::contains(const char* k, const char* v) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? (static_cast<const StringPair*>(foundItem)->v() == v): (false);
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? (kv->v() == v): (false);
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline bool StringDic::getValueAsBool(const String& k, bool defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsBool(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsBool(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline bool StringDic::getValueAsBool(const char* k, bool defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsBool(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsBool(): defaultV;
+}
+
+//! Return true if keys are hashed for constant-time lookups.
+inline bool StringDic::hashKeys() const
+{
+    return (index_ != 0);
 }
 
 //! Return true if case is ignored.
@@ -460,8 +493,8 @@ inline bool StringDic::ignoreCase() const
 //! key is the given default value.
 inline const String* StringDic::find(const String& k, const String* defaultV) const
 {
-    void* foundItem;
-    const String* v = tree_.find(&k, foundItem)? &static_cast<const StringPair*>(foundItem)->v(): defaultV;
+    const StringPair* kv = findKv(k);
+    const String* v = (kv != 0)? &kv->v(): defaultV;
     return v;
 }
 
@@ -469,29 +502,27 @@ inline const String* StringDic::find(const String& k, const String* defaultV) co
 //! key is the given default value.
 inline const String* StringDic::find(const char* k, const String* defaultV) const
 {
-    void* foundItem;
-    const String* v = tree_.find(k, compareK_, foundItem)? &static_cast<const StringPair*>(foundItem)->v(): defaultV;
+    const StringPair* kv = findKv(k);
+    const String* v = (kv != 0)? &kv->v(): defaultV;
     return v;
 }
 
 inline const StringPair* StringDic::getKv(const String& k) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem): 0;
+    return findKv(k);
 }
 
 inline const StringPair* StringDic::getKv(const char* k) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem): 0;
+    return findKv(k);
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline const char* StringDic::getValueAsAscii(const String& k, const char* defaultV) const
 {
-    void* foundItem;
-    const char* v = tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsAscii(): defaultV;
+    const StringPair* kv = findKv(k);
+    const char* v = (kv != 0)? kv->vAsAscii(): defaultV;
     return v;
 }
 
@@ -499,8 +530,8 @@ inline const char* StringDic::getValueAsAscii(const String& k, const char* defau
 //! key is the given default value.
 inline const char* StringDic::getValueAsAscii(const char* k, const char* defaultV) const
 {
-    void* foundItem;
-    const char* v = tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsAscii(): defaultV;
+    const StringPair* kv = findKv(k);
+    const char* v = (kv != 0)? kv->vAsAscii(): defaultV;
     return v;
 }
 
@@ -508,64 +539,70 @@ inline const char* StringDic::getValueAsAscii(const char* k, const char* default
 //! key is the given default value.
 inline double StringDic::getValueAsD64(const String& k, double defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsD64(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsD64(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline double StringDic::getValueAsD64(const char* k, double defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsD64(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsD64(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline float StringDic::getValueAsF32(const String& k, float defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsF32(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsF32(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline float StringDic::getValueAsF32(const char* k, float defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsF32(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsF32(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline int StringDic::getValueAsS32(const String& k, int defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsS32(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsS32(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline int StringDic::getValueAsS32(const char* k, int defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsS32(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsS32(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline unsigned int StringDic::getValueAsU32(const String& k, unsigned int defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsU32(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsU32(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline unsigned int StringDic::getValueAsU32(const char* k, unsigned int defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsU32(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsU32(): defaultV;
+}
+
+//! Return true if keys are interned when added.
+inline bool StringDic::internKeys() const
+{
+    return internKeys_;
 }
 
 //! Return the current number of key-value pairs in the dictionary.
@@ -578,32 +615,32 @@ inline unsigned int StringDic::numKvPairs() const
 //! key is the given default value.
 inline unsigned long long StringDic::getValueAsU64(const String& k, unsigned long long defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsU64(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsU64(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline unsigned long long StringDic::getValueAsU64(const char* k, unsigned long long defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsU64(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsU64(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline unsigned short StringDic::getValueAsU16(const String& k, unsigned short defaultV) const
 {
-    void* foundItem;
-    return tree_.find(&k, foundItem)? static_cast<const StringPair*>(foundItem)->vAsU16(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsU16(): defaultV;
 }
 
 //! Return associated value of given key. Associated value of a non-existent
 //! key is the given default value.
 inline unsigned short StringDic::getValueAsU16(const char* k, unsigned short defaultV) const
 {
-    void* foundItem;
-    return tree_.find(k, compareK_, foundItem)? static_cast<const StringPair*>(foundItem)->vAsU16(): defaultV;
+    const StringPair* kv = findKv(k);
+    return (kv != 0)? kv->vAsU16(): defaultV;
 }
 
 //! Frequent key-value pair removal can cause a dictionary to become somewhat
@@ -619,6 +656,10 @@ inline void StringDic::reset()
 {
     tree_.applyChildFirst(deleteKv, 0 /*arg*/);
     tree_.reset();
+    if (index_ != 0)
+    {
+        index_->reset();
+    }
 }
 
 inline StringDic operator +(const StringDic& a, const StringDic& b)
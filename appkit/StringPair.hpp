@@ -8,6 +8,8 @@
 #include "appkit/String.hpp"
 #include "syskit/macros.h"
 
+DECLARE_CLASS1(syskit, Region)
+
 BEGIN_NAMESPACE1(appkit)
 
 
@@ -26,8 +28,10 @@ public:
     const StringPair& operator =(const StringPair& kv);
     static void operator delete(void* p, size_t size);
     static void operator delete(void* p, void* buf);
+    static void operator delete(void* p, syskit::Region& region);
     static void* operator new(size_t size);
     static void* operator new(size_t size, void* buf);
+    static void* operator new(size_t size, syskit::Region& region);
 
     String& v();
     const String& k() const;
@@ -65,6 +69,7 @@ private:
 END_NAMESPACE1
 
 #include "syskit/BufPool.hpp"
+#include "syskit/Region.hpp"
 
 BEGIN_NAMESPACE1(appkit)
 
@@ -87,6 +92,10 @@ inline void StringPair::operator delete(void* /*p*/, void* /*buf*/)
 {
 }
 
+inline void StringPair::operator delete(void* /*p*/, syskit::Region& /*region*/)
+{
+}
+
 inline void* StringPair::operator new(size_t size)
 {
     void* buf = syskit::BufPool::allocateBuf(size);
@@ -98,6 +107,15 @@ inline void* StringPair::operator new(size_t /*size*/, void* buf)
     return buf;
 }
 
+//! Allocate from given region. A region-allocated pair must be destructed
+//! explicitly (i.e., kv->~StringPair()) and not via the delete operator. Its
+//! memory is reclaimed when the region is reset or destructed.
+inline void* StringPair::operator new(size_t size, syskit::Region& region)
+{
+    void* buf = region.allocate(size);
+    return buf;
+}
+
 //! Return the value part.
 inline String& StringPair::v()
 {
@@ -7,6 +7,7 @@
 #include "appkit-pch.h"
 #include "appkit/DelimitedTxt.hpp"
 #include "appkit/String.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/StringVec.hpp"
 
 using namespace syskit;
@@ -44,6 +45,21 @@ empty_()
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Construct instance using guts from that. That is, move vector contents from
+//! that into this. That instance is left empty and can be reused.
+//!
+StringVec::StringVec(StringVec&& that):
+Vec(static_cast<Vec&&>(that)),
+empty_()
+{
+    compare_ = that.compare_;
+    compareK_ = that.compareK_;
+}
+#endif
+
+
 //!
 //! Construct a duplicate instance of the given vector.
 //!
@@ -103,7 +119,7 @@ StringVec::~StringVec()
 //!
 String StringVec::stringify(const char* delim, size_t maxItems) const
 {
-    String s;
+    StringBuilder s;
     const String* const* p0 = raw();
     size_t length = (numItems() <= maxItems)? numItems(): maxItems;
     for (size_t i = 0; i < length; ++i)
@@ -120,7 +136,7 @@ String StringVec::stringify(const char* delim, size_t maxItems) const
         s += "...";
     }
 
-    return s;
+    return s.toString();
 }
 
 
@@ -219,6 +235,29 @@ const StringVec& StringVec::operator =(const StringVec& vec)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Reset and move the vector contents including guts from that into this. That
+//! instance is left empty and can be reused.
+//!
+const StringVec& StringVec::operator =(StringVec&& that)
+{
+
+    // No-op if operating against the same vector.
+    if (this != &that)
+    {
+        reset();
+        Vec::operator =(static_cast<Vec&&>(that));
+        compare_ = that.compare_;
+        compareK_ = that.compareK_;
+    }
+
+    // Return reference to self.
+    return *this;
+}
+#endif
+
+
 //!
 //! Add given item to the tail end. Return true if successful (i.e.,
 //! vector is not full). Return false otherwise.
@@ -65,6 +65,9 @@ public:
     StringVec(const StringVec& vec);
     StringVec(const StringVec& vec, size_t startAt, size_t itemCount, bool ignoreCase = false);
     StringVec(unsigned int capacity = DefaultCap, int growBy = -1, bool ignoreCase = false);
+#if HAS_RVALUE_REFS
+    StringVec(StringVec&& that);
+#endif
 
     // Operators.
     String operator [](size_t index) const;
@@ -73,6 +76,9 @@ public:
     bool operator ==(const StringVec& vec) const;
     const StringVec& operator =(StringVec* that);
     const StringVec& operator =(const StringVec& vec);
+#if HAS_RVALUE_REFS
+    const StringVec& operator =(StringVec&& that);
+#endif
 
     // Vector operations.
     String stringify(const char* delim = 0, size_t maxItems = static_cast<size_t>(0) - 1) const;
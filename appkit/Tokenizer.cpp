@@ -7,6 +7,7 @@
 
 #include "appkit-pch.h"
 #include "appkit/S32.hpp"
+#include "appkit/StrVec.hpp"
 #include "appkit/StringVec.hpp"
 #include "appkit/Tokenizer.hpp"
 
@@ -495,6 +496,35 @@ bool Tokenizer::sameAsWhiteSpace(const char* delim)
 }
 
 
+//!
+//! Look at tokenizee as a vector of packed tokens. Return true if successful.
+//! Return false otherwise (result is partial due to insufficient capacity in
+//! provided vector).
+//!
+bool Tokenizer::vectorize(StrVec& vec) const
+{
+
+    // Iterate the tokens from left to right.
+    vec.reset();
+    bool ok = true;
+    if (!tokenizee_.empty())
+    {
+        const char* p = pStart_;
+        for (String token; (this->*get_)(p, token);)
+        {
+            if (!vec.add(token))
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    // Return true if successful.
+    return ok;
+}
+
+
 //!
 //! Look at tokenizee as a vector of tokens. Return true if successful. Return
 //! false otherwise (result is partial due to insufficient capacity in provided
@@ -10,6 +10,7 @@
 
 BEGIN_NAMESPACE1(appkit)
 
+class StrVec;
 class StringVec;
 
 
@@ -55,6 +56,7 @@ public:
     bool next(String& token);
     bool peek() const;
     bool peek(String& token) const;
+    bool vectorize(StrVec& vec) const;
     bool vectorize(StringVec& vec) const;
     void apply(cb1_t cb, void* arg = 0) const;
     void reset();
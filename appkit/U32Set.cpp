@@ -7,6 +7,7 @@
 #include "appkit-pch.h"
 #include "appkit/DelimitedTxt.hpp"
 #include "appkit/Str.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/U32Set.hpp"
 #include "appkit/U32.hpp"
 
@@ -196,10 +197,14 @@ String U32Set::toString(const char* delim) const
     buf[0] = '-';
 
     String rangeDelim(delim);
-    String s;
+    StringBuilder s;
     const range_t* p = rangeVec_;
-    for (const range_t* pEnd = p + numRanges_; p < pEnd; s += rangeDelim, ++p)
+    for (const range_t* pEnd = p + numRanges_; p < pEnd; ++p)
     {
+        if (p > rangeVec_)
+        {
+            s += rangeDelim;
+        }
         size_t n = U32::toDigits(p->loKey, buf + 1);
         s.append(buf + 1, n);
         if (p->loKey != p->hiKey)
@@ -209,8 +214,7 @@ String U32Set::toString(const char* delim) const
         }
     }
 
-    s.truncate(s.length() - rangeDelim.length());
-    return s;
+    return s.toString();
 }
 
 
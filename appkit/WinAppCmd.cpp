@@ -18,6 +18,7 @@
 #include "appkit/BufPoolCmd.hpp"
 #include "appkit/CmdMap.hpp"
 #include "appkit/Directory.hpp"
+#include "appkit/LockCmd.hpp"
 #include "appkit/MiscDbugCmd.hpp"
 #include "appkit/SysIo.hpp"
 #include "appkit/WinApp.hpp"
@@ -93,6 +94,7 @@ WinCmd(winApp, CMD_SET)
 
     new BufPoolCmd;
     new CmdCmd(sysIo_);
+    new LockCmd;
     new MiscDbugCmd(sysIo_);
 }
 
@@ -101,6 +103,7 @@ WinAppCmd::~WinAppCmd()
 {
     const CmdMap* map = Cmd::map();
     delete map->find("version-show"); //MiscDbugCmd
+    delete map->find("lock-profile"); //LockCmd
     delete map->find("help");         //CmdCmd
     delete map->find("bufpool-show"); //BufPoolCmd
 }
@@ -3,10 +3,12 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include "syskit/MappedTxtFile.hpp"
+#include "syskit/Region.hpp"
 #include "syskit/macros.h"
 
 #include "appkit-pch.h"
 #include "appkit/DelimitedTxt.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/XmlDoc.hpp"
 #include "appkit/XmlLexer.hpp"
 
@@ -74,7 +76,11 @@ XmlDoc::XmlDoc(const std::istream& is)
 
 XmlDoc::~XmlDoc()
 {
-    delete root_;
+    if (root_ != 0)
+    {
+        root_->destroy();
+    }
+
     delete prolog_;
 }
 
@@ -84,20 +90,21 @@ XmlDoc::~XmlDoc()
 //!
 String XmlDoc::toXml() const
 {
-    String xml(prolog_->toXml());
+    StringBuilder xml;
+    prolog_->appendXml(xml);
     size_t prologLength = xml.length();
     if (prologLength > 0)
     {
         xml += '\n';
     }
 
-    xml += root_->toXml();
+    root_->appendXml(xml);
     if (xml.length() > prologLength)
     {
         xml += '\n';
     }
 
-    return xml;
+    return xml.toString();
 }
 
 
@@ -146,7 +153,7 @@ XmlElement* XmlDoc::findByName(const String& fullName) const
 //!
 bool XmlDoc::loadFrom(const String& path)
 {
-    delete root_;
+    root_->destroy();
     delete prolog_;
     bool readOnly = true;
     bool skipBom = true;
@@ -162,7 +169,7 @@ bool XmlDoc::loadFrom(const String& path)
 //!
 bool XmlDoc::loadFrom(const char* path)
 {
-    delete root_;
+    root_->destroy();
     delete prolog_;
     String s(path);
     bool readOnly = true;
@@ -179,7 +186,7 @@ bool XmlDoc::loadFrom(const char* path)
 //!
 bool XmlDoc::loadFromXml(const String& xml)
 {
-    delete root_;
+    root_->destroy();
     delete prolog_;
 
     XmlLexer lexer(xml);
@@ -195,6 +202,34 @@ bool XmlDoc::loadFromXml(const String& xml)
 }
 
 
+//!
+//! Reset instance with given XML text. Return true if successful. Use errDesc()
+//! for more info in case of failure. Elements, attributes, their internal
+//! vectors, and the vectors' initial item arrays are allocated from given region.
+//! String payloads and the item arrays of vectors which outgrow their initial
+//! capacity still come from the heap. Destructing the document destructs the
+//! region-allocated objects in place without freeing them individually, so the
+//! document must be destructed before the region is reset or destructed, and
+//! their memory is then reclaimed in bulk.
+//!
+bool XmlDoc::loadFromXml(const String& xml, Region& region)
+{
+    root_->destroy();
+    delete prolog_;
+
+    XmlLexer lexer(xml);
+    XmlDoc* doc = lexer.scan(region);
+    errDesc_ = doc->errDesc_;
+    prolog_ = doc->prolog_;
+    root_ = doc->root_;
+    doc->prolog_ = 0;
+    doc->root_ = 0;
+    delete doc;
+
+    return (errDesc_ == 0);
+}
+
+
 void XmlDoc::construct(const MappedTxtFile& file)
 {
     if (file.isOk())
@@ -268,11 +303,10 @@ XmlDoc::Cdata::~Cdata()
 
 
 //!
-//! Return the XML form for this cdata.
+//! Append the XML form for this cdata to given builder.
 //!
-String XmlDoc::Cdata::toXml(size_t indent) const
+void XmlDoc::Cdata::appendXml(StringBuilder& xml, size_t indent) const
 {
-    String xml;
     if (numSibs() > 0)
     {
         xml.append(indent, ' ');
@@ -281,7 +315,6 @@ String XmlDoc::Cdata::toXml(size_t indent) const
     xml += "<![CDATA[";
     xml += body_;
     xml += "]]>";
-    return xml;
 }
 
 
@@ -302,7 +335,7 @@ bool XmlDoc::Cdata::giveBirth(XmlElement* baby)
 {
 
     // Kids not allowed in a cdata element.
-    delete baby;
+    baby->destroy();
     bool ok = false;
     return ok;
 }
@@ -344,11 +377,10 @@ XmlDoc::Comment::~Comment()
 
 
 //!
-//! Return the XML form for this comment.
+//! Append the XML form for this comment to given builder.
 //!
-String XmlDoc::Comment::toXml(size_t indent) const
+void XmlDoc::Comment::appendXml(StringBuilder& xml, size_t indent) const
 {
-    String xml;
     if (numSibs() > 0)
     {
         xml.append(indent, ' ');
@@ -357,7 +389,6 @@ String XmlDoc::Comment::toXml(size_t indent) const
     xml += "<!--";
     xml += body_;
     xml += "-->";
-    return xml;
 }
 
 
@@ -378,7 +409,7 @@ bool XmlDoc::Comment::giveBirth(XmlElement* baby)
 {
 
     // Kids not allowed in a comment element.
-    delete baby;
+    baby->destroy();
     bool ok = false;
     return ok;
 }
@@ -421,18 +452,16 @@ XmlDoc::Content::~Content()
 
 
 //!
-//! Return the XML form for this element content.
+//! Append the XML form for this element content to given builder.
 //!
-String XmlDoc::Content::toXml(size_t indent) const
+void XmlDoc::Content::appendXml(StringBuilder& xml, size_t indent) const
 {
-    if (numSibs() == 0)
+    if (numSibs() > 0)
     {
-        return XmlLexer::escape(body_);
+        xml.append(indent, ' ');
     }
 
-    String xml(indent, ' ');
-    xml += XmlLexer::escape(body_);
-    return xml;
+    XmlLexer::escape(xml, body_);
 }
 
 
@@ -453,7 +482,7 @@ bool XmlDoc::Content::giveBirth(XmlElement* baby)
 {
 
     // Kids not allowed in a content element.
-    delete baby;
+    baby->destroy();
     bool ok = false;
     return ok;
 }
@@ -495,17 +524,15 @@ XmlDoc::EmptyElement::~EmptyElement()
 
 
 //!
-//! Return the XML form for this empty element.
+//! Append the XML form for this empty element to given builder.
 //!
-String XmlDoc::EmptyElement::toXml(size_t indent) const
+void XmlDoc::EmptyElement::appendXml(StringBuilder& xml, size_t indent) const
 {
-    String xml(indent, ' ');
+    xml.append(indent, ' ');
     xml += '<';
     xml += name();
-    xml += attrsInXml();
+    appendAttrs(xml);
     xml += "/>";
-
-    return xml;
 }
 
 
@@ -535,7 +562,7 @@ bool XmlDoc::EmptyElement::giveBirth(XmlElement* baby)
 {
 
     // Kids not allowed in an empty element.
-    delete baby;
+    baby->destroy();
     bool ok = false;
     return ok;
 }
@@ -583,18 +610,16 @@ XmlDoc::UnknownElement::~UnknownElement()
 
 
 //!
-//! Return the XML form for this unknown element.
+//! Append the XML form for this unknown element to given builder.
 //!
-String XmlDoc::UnknownElement::toXml(size_t indent) const
+void XmlDoc::UnknownElement::appendXml(StringBuilder& xml, size_t indent) const
 {
-    if (numSibs() == 0)
+    if (numSibs() > 0)
     {
-        return body_;
+        xml.append(indent, ' ');
     }
 
-    String xml(indent, ' ');
     xml += body_;
-    return xml;
 }
 
 
@@ -615,7 +640,7 @@ bool XmlDoc::UnknownElement::giveBirth(XmlElement* baby)
 {
 
     // Kids not allowed in an unknown element.
-    delete baby;
+    baby->destroy();
     bool ok = false;
     return ok;
 }
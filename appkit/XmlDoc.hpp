@@ -11,9 +11,11 @@
 #include "syskit/macros.h"
 
 DECLARE_CLASS1(syskit, MappedTxtFile)
+DECLARE_CLASS1(syskit, Region)
 
 BEGIN_NAMESPACE1(appkit)
 
+class StringBuilder;
 class XmlLexer;
 class XmlProlog;
 
@@ -46,6 +48,7 @@ public:
     bool loadFrom(const char* path);
     bool loadFrom(const std::istream& is);
     bool loadFromXml(const String& xml);
+    bool loadFromXml(const String& xml, syskit::Region& region);
     const XmlElement& root() const;
     const XmlElement* find(const String& fullName) const;
     const XmlProlog& prolog() const;
@@ -64,7 +67,7 @@ public:
         Cdata(const String& body);
         void reset(const String& body);
         virtual ~Cdata();
-        virtual String toXml(size_t indent = 0) const;
+        virtual void appendXml(StringBuilder& xml, size_t indent = 0) const;
         virtual XmlElement* clone() const;
         virtual bool giveBirth(XmlElement* baby);
         virtual const String& body() const;
@@ -86,7 +89,7 @@ public:
         Comment(const String& body);
         void reset(const String& body);
         virtual ~Comment();
-        virtual String toXml(size_t indent = 0) const;
+        virtual void appendXml(StringBuilder& xml, size_t indent = 0) const;
         virtual XmlElement* clone() const;
         virtual bool giveBirth(XmlElement* baby);
         virtual const String& body() const;
@@ -108,7 +111,7 @@ public:
         Content(const String& body);
         void reset(const String& body);
         virtual ~Content();
-        virtual String toXml(size_t indent = 0) const;
+        virtual void appendXml(StringBuilder& xml, size_t indent = 0) const;
         virtual XmlElement* clone() const;
         virtual bool giveBirth(XmlElement* baby);
         virtual const String& body() const;
@@ -129,7 +132,7 @@ public:
     public:
         EmptyElement(const String& name, unsigned int attrCap = 0);
         virtual ~EmptyElement();
-        virtual String toXml(size_t indent = 0) const;
+        virtual void appendXml(StringBuilder& xml, size_t indent = 0) const;
         virtual XmlElement* clone() const;
         virtual bool giveBirth(XmlElement* baby);
     private:
@@ -148,7 +151,7 @@ public:
         UnknownElement(const String& body);
         void reset(const String& body);
         virtual ~UnknownElement();
-        virtual String toXml(size_t indent = 0) const;
+        virtual void appendXml(StringBuilder& xml, size_t indent = 0) const;
         virtual XmlElement* clone() const;
         virtual bool giveBirth(XmlElement* baby);
         virtual bool isUnknown() const;
@@ -229,7 +232,7 @@ inline bool XmlDoc::isOk() const
 //! Use errDesc() for more info in case of failure.
 inline bool XmlDoc::loadFrom(const std::istream& is)
 {
-    delete root_;
+    root_->destroy();
     delete prolog_;
     construct(is);
     return (errDesc_ == 0);
@@ -273,7 +276,7 @@ inline void XmlDoc::setProlog(XmlProlog* prolog)
 //! given object which will be destroyed by the document when appropriate.
 inline void XmlDoc::setRoot(XmlElement* root)
 {
-    delete root_;
+    root_->destroy();
     root_ = (root != 0)? root: new UnknownElement(String());
 }
 
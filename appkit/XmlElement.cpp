@@ -6,6 +6,7 @@
 
 #include "appkit-pch.h"
 #include "appkit/DelimitedTxt.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/XmlElement.hpp"
 #include "appkit/XmlLexer.hpp"
 
@@ -28,6 +29,7 @@ name_()
     index_ = 0;
     kid_ = 0;
     mom_ = 0;
+    region_ = 0;
 }
 
 
@@ -44,36 +46,39 @@ name_(name)
     index_ = 0;
     kid_ = (kidCap == 0)? 0: new Vec(kidCap, -1 /*growBy*/);
     mom_ = 0;
+    region_ = 0;
 }
 
 
 //!
 //! Destruct element.
-//! Destruct kids before destructing self.
+//! Destruct kids before destructing self. Internals of a region-allocated
+//! element are destructed in place and their memory is not freed.
 //!
 XmlElement::~XmlElement()
 {
     if (kid_ != 0)
     {
-        for (void* item; kid_->rmTail(item); delete static_cast<XmlElement*>(item));
-        delete kid_;
+        for (void* item; kid_->rmTail(item); static_cast<XmlElement*>(item)->destroy());
+        if (region_ == 0) delete kid_;
+        else kid_->~Vec();
     }
 
     if (attr_ != 0)
     {
-        for (void* item; attr_->rmTail(item); delete static_cast<StringPair*>(item));
-        delete attr_;
+        for (void* item; attr_->rmTail(item); destroyAttr(static_cast<StringPair*>(item)));
+        if (region_ == 0) delete attr_;
+        else attr_->~Vec();
     }
 }
 
 
 //!
-//! Return the XML form for the attributes.
-//! Return an empty string if this element has no attributes.
+//! Append the XML form for the attributes to given builder.
+//! Append nothing if this element has no attributes.
 //!
-String XmlElement::attrsInXml() const
+void XmlElement::appendAttrs(StringBuilder& xml) const
 {
-    String xml;
     if (attr_ != 0)
     {
         for (size_t i = 0, numAttrs = attr_->numItems(); i < numAttrs; ++i)
@@ -82,12 +87,10 @@ String XmlElement::attrsInXml() const
             xml += ' ';
             xml += nv->n();
             xml += "=\"";
-            xml += XmlLexer::escape(nv->v());
+            XmlLexer::escape(xml, nv->v());
             xml += '"';
         }
     }
-
-    return xml;
 }
 
 
@@ -120,16 +123,57 @@ String XmlElement::fullName() const
 
 
 //!
-//! Return the XML form for this element content.
+//! Return the XML form for this element.
 //!
 String XmlElement::toXml(size_t indent) const
+{
+    StringBuilder xml;
+    appendXml(xml, indent);
+    return xml.toString();
+}
+
+
+//
+// Create a growable vector for attributes or kids. Allocate it and its
+// initial item array from the element's region if any. Region memory is
+// not reclaimed until the region is reset, so such a vector starts small
+// and grows into the heap only when needed.
+//
+Vec* XmlElement::createVec(unsigned int capacity) const
+{
+    Vec* vec = (region_ == 0)? new Vec(capacity, -1 /*growBy*/): new(*region_) Vec(RegionVecCap, -1 /*growBy*/, *region_);
+    return vec;
+}
+
+
+//
+// Destroy given attribute. Attributes of a region-allocated element
+// are destructed in place.
+//
+void XmlElement::destroyAttr(StringPair* nv) const
+{
+    if (region_ == 0)
+    {
+        delete nv;
+    }
+    else
+    {
+        nv->~StringPair();
+    }
+}
+
+
+//!
+//! Append the XML form for this element to given builder.
+//!
+void XmlElement::appendXml(StringBuilder& xml, size_t indent) const
 {
 
     // start.
-    String xml(indent, ' ');
+    xml.append(indent, ' ');
     xml += '<';
     xml += name_;
-    xml += attrsInXml();
+    appendAttrs(xml);
     xml += '>';
 
     // kids.
@@ -141,7 +185,7 @@ String XmlElement::toXml(size_t indent) const
             (static_cast<const XmlElement*>(kid_->peek(0))->kid_ == 0) &&
             (static_cast<const XmlElement*>(kid_->peek(0))->name_.empty()))
         {
-            xml += static_cast<const XmlElement*>(kid_->peek(0))->toXml(indent);
+            static_cast<const XmlElement*>(kid_->peek(0))->appendXml(xml, indent);
             indentEnd = 0;
         }
         else
@@ -151,7 +195,7 @@ String XmlElement::toXml(size_t indent) const
                 const XmlElement* kid = static_cast<const XmlElement*>(kid_->peek(i));
                 xml += '\n';
                 indent += INDENT;
-                xml += kid->toXml(indent);
+                kid->appendXml(xml, indent);
                 indent -= INDENT;
             }
             xml += '\n';
@@ -167,7 +211,6 @@ String XmlElement::toXml(size_t indent) const
     xml += "</";
     xml += name_;
     xml += '>';
-    return xml;
 }
 
 
@@ -587,7 +630,7 @@ bool XmlElement::giveBirth(XmlElement* baby)
 {
     if (kid_ == 0)
     {
-        kid_ = new Vec(Vec::DefaultCap, -1 /*growBy*/);
+        kid_ = createVec(Vec::DefaultCap);
     }
 
     baby->index_ = kid_->numItems();
@@ -598,6 +641,24 @@ bool XmlElement::giveBirth(XmlElement* baby)
 }
 
 
+//!
+//! Destroy this element. A heap-allocated element is destroyed via the delete
+//! operator. A region-allocated element is destructed in place, and its memory
+//! is reclaimed when the region is reset or destructed.
+//!
+void XmlElement::destroy()
+{
+    if (region_ == 0)
+    {
+        delete this;
+    }
+    else
+    {
+        this->~XmlElement();
+    }
+}
+
+
 //!
 //! Return true if element is unknown.
 //!
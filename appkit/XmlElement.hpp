@@ -9,12 +9,15 @@
 #include "appkit/String.hpp"
 #include "syskit/macros.h"
 
+DECLARE_CLASS1(syskit, Region)
 DECLARE_CLASS1(syskit, Vec)
 
 BEGIN_NAMESPACE1(appkit)
 
+class StringBuilder;
 class StringPair;
 class XmlDoc;
+class XmlLexer;
 
 
 //! xml element
@@ -23,7 +26,12 @@ class XmlElement
     //! XML element. An XML document contains an optional prolog and one root
     //! element. An element can have kids. A typical element has a name and
     //! zero or more attributes. Some element does not have a name but only a
-    //! body part (e.g., a comment does not have a name).
+    //! body part (e.g., a comment does not have a name). Elements are normally
+    //! allocated from the default buffer pool. Elements of a region-backed
+    //! document (see XmlDoc::loadFromXml()) are allocated from a caller-supplied
+    //! region instead, and such elements are destructed in place and never freed
+    //! individually. Use destroy() instead of the delete operator to dispose of
+    //! an element which might have been allocated from a region.
     //!
 {
 
@@ -36,10 +44,15 @@ public:
     XmlElement(const String& name, unsigned int attrCap = 0, unsigned int kidCap = 0);
     static void operator delete(void* p, size_t size);
     static void operator delete(void* p, void* buf);
+    static void operator delete(void* p, syskit::Region& region);
     static void* operator new(size_t size);
     static void* operator new(size_t size, void* buf);
+    static void* operator new(size_t size, syskit::Region& region);
     String fullName() const;
+    String toXml(size_t indent = 0) const;
+    bool isInRegion() const;
     const String& name() const;
+    void destroy();
 
     // Attributes.
     StringPair& attr(size_t index);
@@ -105,7 +118,7 @@ public:
     void sterilize();
 
     virtual ~XmlElement();
-    virtual String toXml(size_t indent = 0) const;
+    virtual void appendXml(StringBuilder& xml, size_t indent = 0) const;
     virtual XmlElement* clone() const;
     virtual bool giveBirth(XmlElement* baby);
     virtual bool isUnknown() const;
@@ -114,18 +127,27 @@ public:
 
 protected:
     XmlElement();
-    String attrsInXml() const;
+    void appendAttrs(StringBuilder& xml) const;
 
 private:
+    enum
+    {
+        RegionVecCap = 4 //initial capacity of region-allocated vectors
+    };
+
     String name_;
     syskit::Vec* attr_;
     syskit::Vec* kid_;
     XmlElement* mom_;
     size_t index_;
+    syskit::Region* region_;
 
     XmlElement(const XmlElement&); //prohibit usage
     const XmlElement& operator =(const XmlElement&); //prohibit usage
 
+    syskit::Vec* createVec(unsigned int) const;
+    void destroyAttr(StringPair*) const;
+
     StringPair* findAttrByName(const String&) const;
     StringPair* findAttrByName(const char*) const;
     XmlElement* findKidByName(const String&) const;
@@ -137,6 +159,8 @@ private:
     XmlElement* getNextSib() const;
     XmlElement* getPrevSib() const;
 
+    friend class XmlLexer;
+
 };
 
 //! Append the XML form of the element to the given output stream. Return
@@ -151,6 +175,7 @@ END_NAMESPACE1
 
 #include "appkit/StringPair.hpp"
 #include "syskit/BufPool.hpp"
+#include "syskit/Region.hpp"
 #include "syskit/Vec.hpp"
 
 BEGIN_NAMESPACE1(appkit)
@@ -164,6 +189,10 @@ inline void XmlElement::operator delete(void* /*p*/, void* /*buf*/)
 {
 }
 
+inline void XmlElement::operator delete(void* /*p*/, syskit::Region& /*region*/)
+{
+}
+
 inline void* XmlElement::operator new(size_t size)
 {
     void* buf = syskit::BufPool::allocateBuf(size);
@@ -175,6 +204,12 @@ inline void* XmlElement::operator new(size_t /*size*/, void* buf)
     return buf;
 }
 
+inline void* XmlElement::operator new(size_t size, syskit::Region& region)
+{
+    void* buf = region.allocate(size);
+    return buf;
+}
+
 //! Return associated value of given attribute. Associated value of a non-existent
 //! attribute is an empty string.
 inline String XmlElement::getAttr(const String& n) const
@@ -294,10 +329,12 @@ inline XmlElement* XmlElement::prevSib()
 }
 
 //! Add given attribute to this element. Take over ownership of the attribute
-//! and destroy it via the delete operator when the element is destructed.
+//! and destroy it via the delete operator when the element is destructed. The
+//! attribute of a region-allocated element must be allocated from the same
+//! region and is destructed in place instead.
 inline bool XmlElement::addAttr(const StringPair* nv)
 {
-    if (attr_ == 0) attr_ = new syskit::Vec(syskit::Vec::DefaultCap, -1 /*growBy*/);
+    if (attr_ == 0) attr_ = createVec(syskit::Vec::DefaultCap);
     return attr_->add(const_cast<StringPair*>(nv));
 }
 
@@ -323,11 +360,17 @@ inline bool XmlElement::getAttrAsBool(const char* n, bool defaultV) const
 inline bool XmlElement::setAttr(size_t index, const StringPair* nv)
 {
     if ((attr_ == 0) || (index >= attr_->numItems())) return false;
-    delete static_cast<const StringPair*>(attr_->peek(index));
+    destroyAttr(static_cast<StringPair*>(attr_->peek(index)));
     attr_->setItem(index, const_cast<StringPair*>(nv));
     return true;
 }
 
+//! Return true if this element was allocated from a region.
+inline bool XmlElement::isInRegion() const
+{
+    return (region_ != 0);
+}
+
 //! Return the element's name.
 inline const String& XmlElement::name() const
 {
@@ -385,12 +428,12 @@ inline const XmlElement* XmlElement::find(const String& path) const
 }
 
 //! Replace the kid residing at given index. Take over ownership of the given
-//! object and destroy it via the delete operator when the element is destructed.
+//! object and destroy it via destroy() when the element is destructed.
 //! Return true if successful. Return false otherwise (i.e., invalid index).
 inline bool XmlElement::setKid(size_t index, const XmlElement* kid)
 {
     if ((kid_ == 0) || (index >= kid_->numItems())) return false;
-    delete static_cast<XmlElement*>(kid_->peek(index));
+    static_cast<XmlElement*>(kid_->peek(index))->destroy();
     kid_->setItem(index, const_cast<XmlElement*>(kid));
     return true;
 }
@@ -556,18 +599,21 @@ inline unsigned short XmlElement::getAttrAsU16(const char* n, unsigned short def
 
 //! Assume no more attributes will be added to the element and clean up the
 //! internals to minimize memory use. Still, more attributes can be added to
-//! the element if necessary.
+//! the element if necessary. No-op for a region-allocated element since
+//! shrinking would only move the attribute array from the region to the heap.
 inline void XmlElement::freezeAttrs()
 {
-    if (attr_ != 0) attr_->resize(attr_->numItems());
+    if ((attr_ != 0) && (region_ == 0)) attr_->resize(attr_->numItems());
 }
 
 //! Sterilize element, but make it reversible. That is, assume no more kids will
 //! be added to the element and clean up the internals to minimize memory use.
-//! Still, more kids can be added to the element if necessary.
+//! Still, more kids can be added to the element if necessary. No-op for a
+//! region-allocated element since shrinking would only move the kid array from
+//! the region to the heap.
 inline void XmlElement::sterilize()
 {
-    if (kid_ != 0) kid_->resize(kid_->numItems());
+    if ((kid_ != 0) && (region_ == 0)) kid_->resize(kid_->numItems());
 }
 
 END_NAMESPACE1
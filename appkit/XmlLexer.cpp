@@ -2,10 +2,14 @@
  * Software by Thanh Phung -- thanhtphung@yahoo.com.
  * No copyrights. No warranties. No restrictions in reuse.
  */
+#include <string.h>
+#include "syskit/Region.hpp"
 #include "syskit/Utf8.hpp"
 #include "syskit/macros.h"
 
 #include "appkit-pch.h"
+#include "appkit/Atom.hpp"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/U8.hpp"
 #include "appkit/XmlDoc.hpp"
 #include "appkit/XmlElement.hpp"
@@ -54,6 +58,31 @@ static void resetStr(appkit::String& str, int isAscii, const syskit::utf8_t* s,
     }
 }
 
+//
+// Reset string str with the interned form of given UTF8 sequence (numU8s bytes
+// starting at s). Names repeat throughout a document, so interned names share
+// their storage and compare quickly. See resetStr() for the meaning of isAscii.
+//
+static void internStr(appkit::String& str, int isAscii, const syskit::utf8_t* s, size_t numU8s)
+{
+    const syskit::utf8_t* p = s;
+    const syskit::utf8_t* pEnd = s + numU8s;
+    if (isAscii <= 0) //non-ascii or containing invalid bytes
+    {
+        for (; (p < pEnd) && (*p < 0x80U); ++p);
+    }
+
+    if (p == pEnd) //ascii
+    {
+        str = appkit::Atom::intern(s, numU8s, numU8s);
+    }
+    else
+    {
+        str.reset8(s, numU8s);
+        str = appkit::Atom::intern(str);
+    }
+}
+
 BEGIN_NAMESPACE1(appkit)
 
 //
@@ -331,8 +360,36 @@ void XmlLexer::skipSpaces()
 //!
 XmlDoc* XmlLexer::scan()
 {
-    Utf8 c8;
     kb_.reset(&XmlLexer::scan0, lexee_, numU8s_);
+    XmlDoc* doc = scanLexee();
+    return doc;
+}
+
+
+//!
+//! Scan the XML lexical analyzee and form and return an appropriate document.
+//! The returned document is constructed for the caller. Caller must destroy
+//! the document using the delete operator when done. Elements, attributes, and
+//! their internal vectors are allocated from given region, so the document must
+//! be destructed before the region is reset or destructed. The scan can fail if
+//! the XML input cannot be interpreted properly. To validate the returned document,
+//! use XmlDoc::isOk() and XmlDoc::errDesc().
+//!
+XmlDoc* XmlLexer::scan(Region& region)
+{
+    kb_.reset(&XmlLexer::scan0, lexee_, numU8s_);
+    kb_.region = &region;
+    XmlDoc* doc = scanLexee();
+    return doc;
+}
+
+
+//
+// Scan the XML lexical analyzee. Knowledgebase has been reset.
+//
+XmlDoc* XmlLexer::scanLexee()
+{
+    Utf8 c8;
     for (size_t bytesDecoded = 0; kb_.remainingBytes > 0; kb_.curByte += bytesDecoded, kb_.remainingBytes -= bytesDecoded)
     {
 
@@ -363,10 +420,22 @@ XmlDoc* XmlLexer::scan()
 }
 
 
+//
+// Make content element with given body. Allocate from given region if any.
+//
+XmlElement* XmlLexer::mkContent(const String& body, Region* region)
+{
+    XmlElement* baby = (region == 0)? new XmlDoc::Content(body): new(*region) XmlDoc::Content(body);
+    baby->region_ = region;
+    return baby;
+}
+
+
 //
 // Make element from given UTF-8 sequence ("<name...>" or "<name.../>").
+// Allocate element and attributes from given region if any.
 //
-XmlElement* XmlLexer::mkElement(const utf8_t* lAngle, const utf8_t* rAngle, size_t ampCount, int isAscii)
+XmlElement* XmlLexer::mkElement(const utf8_t* lAngle, const utf8_t* rAngle, size_t ampCount, int isAscii, Region* region)
 {
 
     // Element name. Element name has been validated.
@@ -375,23 +444,25 @@ XmlElement* XmlLexer::mkElement(const utf8_t* lAngle, const utf8_t* rAngle, size
     const utf8_t* space;
     for (space = bound.n0 + 1; (!isSpaceZ(*space)); ++space);
     size_t numU8s = space - bound.n0;
+    bool isEmpty = (rAngle[-1] == SLASH);
+    if (isEmpty && (space == rAngle))
+    {
+        --numU8s; //"<name/>"
+    }
     String n;
-    resetStr(n, isAscii, bound.n0, numU8s);
+    internStr(n, isAscii, bound.n0, numU8s);
 
     // Empty or non-empty element?
     XmlElement* baby;
-    if (rAngle[-1] == SLASH)
+    if (isEmpty)
     {
-        if (space == rAngle)
-        {
-            n.truncate(n.length() - 1);
-        }
-        baby = new XmlDoc::EmptyElement(n);
+        baby = (region == 0)? new XmlDoc::EmptyElement(n): new(*region) XmlDoc::EmptyElement(n);
     }
     else
     {
-        baby = new XmlElement(n);
+        baby = (region == 0)? new XmlElement(n): new(*region) XmlElement(n);
     }
+    baby->region_ = region;
 
     // Attributes.
     if (space < rAngle)
@@ -399,14 +470,14 @@ XmlElement* XmlLexer::mkElement(const utf8_t* lAngle, const utf8_t* rAngle, size
         for (String v; findAttrBound(bound, space, rAngle); space = bound.v1 + 1)
         {
             numU8s = bound.n1 - bound.n0 + 1;
-            resetStr(n, isAscii, bound.n0, numU8s);
+            internStr(n, isAscii, bound.n0, numU8s);
             numU8s = bound.v1 - bound.v0 - 1;
             resetStr(v, isAscii, bound.v0 + 1, numU8s);
             if (ampCount > 0)
             {
                 v = unescape(v);
             }
-            StringPair* nv = new StringPair(n, v);
+            StringPair* nv = (region == 0)? new StringPair(n, v): new(*region) StringPair(n, v);
             baby->addAttr(nv);
         }
         baby->freezeAttrs();
@@ -422,7 +493,7 @@ XmlElement* XmlLexer::mkElement(const utf8_t* lAngle, const utf8_t* rAngle, size
 // leading spaces. Trim trailing spaces. Given content is known to be
 // ASCII. Return result as a content element.
 //
-XmlElement* XmlLexer::normalizeSpace(const utf8_t* s8, size_t numU8s)
+XmlElement* XmlLexer::normalizeSpace(const utf8_t* s8, size_t numU8s, Region* region)
 {
 
     // Copy characters in bulk when possible.
@@ -471,7 +542,7 @@ XmlElement* XmlLexer::normalizeSpace(const utf8_t* s8, size_t numU8s)
     result.append(notCopiedYet0, n, n);
 
     // Return new content element.
-    XmlElement* baby = new XmlDoc::Content(noAmps? result: unescape(result));
+    XmlElement* baby = mkContent(noAmps? result: unescape(result), region);
     return baby;
 }
 
@@ -482,7 +553,7 @@ XmlElement* XmlLexer::normalizeSpace(const utf8_t* s8, size_t numU8s)
 // non-ASCII characters or to contain some invalid bytes. Return result
 // as a content element.
 //
-XmlElement* XmlLexer::normalizeSpace8(const utf8_t* s8, size_t numU8s)
+XmlElement* XmlLexer::normalizeSpace8(const utf8_t* s8, size_t numU8s, Region* region)
 {
     Utf8 c8;
     Utf8Seq seq;
@@ -523,7 +594,7 @@ XmlElement* XmlLexer::normalizeSpace8(const utf8_t* s8, size_t numU8s)
     utf8_t* s = seq.detachRaw(byteSize);
     String result;
     result.attachRaw(s, byteSize, numChars);
-    XmlElement* baby = new XmlDoc::Content(noAmps? result: unescape(result));
+    XmlElement* baby = mkContent(noAmps? result: unescape(result), region);
     return baby;
 }
 
@@ -754,7 +825,7 @@ void XmlLexer::addElement(XmlElement* baby)
     else
     {
         ++kb_.orphanCount;
-        delete baby;
+        baby->destroy();
     }
 }
 
@@ -810,6 +881,48 @@ void XmlLexer::copyStream(const std::istream& lexee)
 }
 
 
+//!
+//! Append the XML form of given native string to given builder by converting
+//! special characters to XML escape sequences. Characters which need no
+//! conversion are appended in bulk.
+//!
+void XmlLexer::escape(StringBuilder& xml, const String& native)
+{
+    const utf8_t* p0 = native.raw();
+    size_t numChars = 0;
+    for (const utf8_t* p = p0;; ++p)
+    {
+
+        // Multi-byte characters and most ASCII characters require no conversion.
+        // Count characters by skipping UTF8 continuation bytes.
+        if (*p > '>')
+        {
+            numChars += ((*p & 0xc0U) != 0x80U);
+            continue;
+        }
+
+        const char* escSeq = ESC_SEQ[*p];
+        if ((escSeq == 0) && (*p != 0))
+        {
+            ++numChars;
+            continue;
+        }
+
+        xml.append(p0, p - p0, numChars);
+        if (*p == 0)
+        {
+            break;
+        }
+
+        // Conversion required for pre-defined special character.
+        // Escape sequence length includes the terminating null.
+        xml.append(escSeq + 1, *escSeq - 1);
+        p0 = p + 1;
+        numChars = 0;
+    }
+}
+
+
 void XmlLexer::popElement(const utf8_t* lAngle, const utf8_t* /*rAngle*/)
 {
     if (kb_.mom != 0)
@@ -818,9 +931,9 @@ void XmlLexer::popElement(const utf8_t* lAngle, const utf8_t* /*rAngle*/)
         const utf8_t* space;
         for (space = n0; (!isSpaceZ(*space)); ++space);
         size_t numU8s = space - n0;
-        String n;
-        resetStr(n, kb_.isAscii, n0, numU8s);
-        if (n == kb_.mom->name())
+        unsigned int byteSize;
+        const utf8_t* name = kb_.mom->name().raw(byteSize);
+        if ((numU8s == byteSize - 1) && (memcmp(n0, name, numU8s) == 0))
         {
             kb_.mom->sterilize();
             kb_.mom = const_cast<XmlElement*>(kb_.mom->mom());
@@ -943,7 +1056,9 @@ void XmlLexer::scan0(utf32_t c)
             size_t numU8s = kb_.curByte - kb_.lAngle + 1;
             String body;
             resetStr(body, kb_.isAscii, kb_.lAngle, numU8s);
-            addElement(new XmlDoc::UnknownElement(body));
+            XmlElement* baby = (kb_.region == 0)? new XmlDoc::UnknownElement(body): new(*kb_.region) XmlDoc::UnknownElement(body);
+            baby->region_ = kb_.region;
+            addElement(baby);
             kb_.ampCount = 0;
             kb_.isAscii = 1;
         }
@@ -1113,7 +1228,9 @@ void XmlLexer::scanCdataZ1(utf32_t c)
         size_t numU8s = kb_.curByte - kb_.lAngle + 1 - 9 /*head*/ - 3 /*tail*/; //"<![CDATA[body]]>"
         String body;
         resetStr(body, kb_.isAscii, kb_.lAngle + 9, numU8s);
-        addElement(new XmlDoc::Cdata(body));
+        XmlElement* baby = (kb_.region == 0)? new XmlDoc::Cdata(body): new(*kb_.region) XmlDoc::Cdata(body);
+        baby->region_ = kb_.region;
+        addElement(baby);
         kb_.ampCount = 0;
         kb_.isAscii = 1;
         if (kb_.mom != 0)
@@ -1204,7 +1321,9 @@ void XmlLexer::scanCommentZ1(utf32_t c)
         size_t numU8s = kb_.curByte - kb_.lAngle + 1 - 4 /*head*/ - 3 /*tail*/; //"<!--body-->"
         String body;
         resetStr(body, kb_.isAscii, kb_.lAngle + 4, numU8s);
-        addElement(new XmlDoc::Comment(body));
+        XmlElement* baby = (kb_.region == 0)? new XmlDoc::Comment(body): new(*kb_.region) XmlDoc::Comment(body);
+        baby->region_ = kb_.region;
+        addElement(baby);
         kb_.ampCount = 0;
         kb_.isAscii = 1;
         if (kb_.mom != 0)
@@ -1243,7 +1362,7 @@ void XmlLexer::scanContent(utf32_t /*c*/)
         {
             kb_.setLexee(p, pEnd - p);
             size_t numU8s = kb_.curByte - kb_.text;
-            XmlElement* baby = (kb_.isAscii > 0)? normalizeSpace(kb_.text, numU8s): normalizeSpace8(kb_.text, numU8s);
+            XmlElement* baby = (kb_.isAscii > 0)? normalizeSpace(kb_.text, numU8s, kb_.region): normalizeSpace8(kb_.text, numU8s, kb_.region);
             addElement(baby);
             kb_.ampCount = 0;
             kb_.isAscii = 1;
@@ -1429,7 +1548,7 @@ void XmlLexer::scanElement(utf32_t /*c*/)
             return;
         case '>':
             kb_.setLexee(p, pEnd - p);
-            baby = mkElement(kb_.lAngle, kb_.curByte, kb_.ampCount, kb_.isAscii);
+            baby = mkElement(kb_.lAngle, kb_.curByte, kb_.ampCount, kb_.isAscii, kb_.region);
             pushElement(baby);
             kb_.ampCount = 0;
             kb_.isAscii = 1;
@@ -1479,7 +1598,7 @@ void XmlLexer::scanElementA0(utf32_t /*c*/)
             return;
         case '>':
             kb_.setLexee(p, remainingBytes);
-            baby = mkElement(kb_.lAngle, kb_.curByte, kb_.ampCount, kb_.isAscii);
+            baby = mkElement(kb_.lAngle, kb_.curByte, kb_.ampCount, kb_.isAscii, kb_.region);
             pushElement(baby);
             kb_.ampCount = 0;
             kb_.isAscii = 1;
@@ -1548,7 +1667,7 @@ void XmlLexer::scanEmptyElementZ0(utf32_t c)
     {
 
     case '>':
-        baby = mkElement(kb_.lAngle, kb_.curByte, kb_.ampCount, kb_.isAscii);
+        baby = mkElement(kb_.lAngle, kb_.curByte, kb_.ampCount, kb_.isAscii, kb_.region);
         kb_.ampCount = 0;
         kb_.isAscii = 1;
         if (kb_.mom != 0)
@@ -1946,6 +2065,7 @@ void XmlLexer::lexKb_t::reset(scan_t scan, const utf8_t* curByte, size_t remaini
     mom = 0;
     orphanCount = 0;
     prolog = 0;
+    region = 0;
     root = 0;
     scanErr = 0;
     text = 0;
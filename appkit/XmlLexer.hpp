@@ -10,8 +10,11 @@
 #include "appkit/XmlDoc.hpp"
 #include "syskit/sys.hpp"
 
+DECLARE_CLASS1(syskit, Region)
+
 BEGIN_NAMESPACE1(appkit)
 
+class StringBuilder;
 class XmlElement;
 class XmlProlog;
 
@@ -31,6 +34,7 @@ public:
     ~XmlLexer();
 
     XmlDoc* scan();
+    XmlDoc* scan(syskit::Region& region);
     const syskit::utf8_t* lexee() const;
     const syskit::utf8_t* lexee(unsigned int& byteSize) const;
     unsigned int lexeeByteSize() const;
@@ -42,6 +46,7 @@ public:
     // XML escape sequence resolution.
     static String escape(const String& native);
     static String unescape(const String& xml);
+    static void escape(StringBuilder& xml, const String& native);
 
 private:
     typedef struct
@@ -74,6 +79,7 @@ private:
         XmlElement* mom;
         XmlElement* root;
         XmlProlog* prolog;
+        syskit::Region* region;
         const char* scanErr;
         const syskit::utf8_t* curByte;
         const syskit::utf8_t* curElement;
@@ -115,6 +121,7 @@ private:
     const XmlLexer& operator =(const XmlLexer&); //prohibit usage
 
     // XML scanner support.
+    XmlDoc* scanLexee();
     const char* errDesc() const;
     void addElement(XmlElement*);
     void copyStream(const std::istream&);
@@ -125,9 +132,10 @@ private:
     static size_t countInvalidBytes(const syskit::utf8_t*, size_t);
 
     // More XML scanner support.
-    static XmlElement* mkElement(const syskit::utf8_t*, const syskit::utf8_t*, size_t, int);
-    static XmlElement* normalizeSpace(const syskit::utf8_t*, size_t);
-    static XmlElement* normalizeSpace8(const syskit::utf8_t*, size_t);
+    static XmlElement* mkContent(const String&, syskit::Region*);
+    static XmlElement* mkElement(const syskit::utf8_t*, const syskit::utf8_t*, size_t, int, syskit::Region*);
+    static XmlElement* normalizeSpace(const syskit::utf8_t*, size_t, syskit::Region*);
+    static XmlElement* normalizeSpace8(const syskit::utf8_t*, size_t, syskit::Region*);
     static XmlProlog* mkProlog(const syskit::utf8_t*, const syskit::utf8_t*);
     static bool findAttrBound(attrBound_t&, const syskit::utf8_t*, const syskit::utf8_t*);
     static bool isDigit(syskit::utf32_t);
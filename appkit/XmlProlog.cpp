@@ -5,6 +5,7 @@
 #include "syskit/macros.h"
 
 #include "appkit-pch.h"
+#include "appkit/StringBuilder.hpp"
 #include "appkit/XmlElement.hpp"
 #include "appkit/XmlProlog.hpp"
 
@@ -92,18 +93,9 @@ String XmlProlog::declInXml() const
 //!
 String XmlProlog::toXml() const
 {
-    String xml(declInXml());
-    if (misc_ != 0)
-    {
-        for (size_t i = 0, numItems = misc_->numItems(); i < numItems; ++i)
-        {
-            const XmlElement* item = static_cast<const XmlElement*>(misc_->peek(i));
-            xml += '\n';
-            xml += item->toXml();
-        }
-    }
-
-    return xml;
+    StringBuilder xml;
+    appendXml(xml);
+    return xml.toString();
 }
 
 
@@ -129,11 +121,29 @@ XmlProlog* XmlProlog::clone() const
 }
 
 
+//!
+//! Append the XML form for this prolog to given builder.
+//!
+void XmlProlog::appendXml(StringBuilder& xml) const
+{
+    xml += declInXml();
+    if (misc_ != 0)
+    {
+        for (size_t i = 0, numItems = misc_->numItems(); i < numItems; ++i)
+        {
+            const XmlElement* item = static_cast<const XmlElement*>(misc_->peek(i));
+            xml += '\n';
+            item->appendXml(xml);
+        }
+    }
+}
+
+
 void XmlProlog::destruct()
 {
     if (misc_ != 0)
     {
-        for (void* item; misc_->rmTail(item); delete static_cast<XmlElement*>(item));
+        for (void* item; misc_->rmTail(item); static_cast<XmlElement*>(item)->destroy());
         delete misc_;
     }
 }
@@ -12,6 +12,7 @@ DECLARE_CLASS1(syskit, Vec)
 
 BEGIN_NAMESPACE1(appkit)
 
+class StringBuilder;
 class XmlElement;
 
 
@@ -41,6 +42,7 @@ public:
     const XmlElement& item(size_t index) const;
     unsigned int numItems() const;
     void addItem(const XmlElement* item);
+    void appendXml(StringBuilder& xml) const;
     void freezeItems();
     void reset(const String& version, const String& encoding, const String& standalone);
 
@@ -96,7 +98,7 @@ inline unsigned int XmlProlog::numItems() const
 }
 
 //! Add given miscellaneous item to this prolog. Take over ownership of the
-//! item and destroy it via the delete operator when the prolog is destructed.
+//! item and destroy it via XmlElement::destroy() when the prolog is destructed.
 inline void XmlProlog::addItem(const XmlElement* item)
 {
     if (misc_ == 0) misc_ = new syskit::Vec(syskit::Vec::DefaultCap, -1 /*growBy*/);
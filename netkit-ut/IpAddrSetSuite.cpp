@@ -742,11 +742,11 @@ void IpAddrSetSuite::testRm01()
 void IpAddrSetSuite::testSize00()
 {
     size_t size = sizeof(Set);
-    bool ok = (size == (sizeof(Growable) + sizeof(void*))); //Win32:20 x64:28
+    bool ok = (size == (sizeof(Growable) + sizeof(void*))); //Win32:24 x64:32
     CPPUNIT_ASSERT(ok);
 
     size = sizeof(IpAddrSet);
-    ok = (size == (sizeof(Set) + sizeof(void*) + 20)); //Win32:44 x64:56
+    ok = (size == (sizeof(Set) + sizeof(void*) + 20)); //Win32:48 x64:60
     CPPUNIT_ASSERT(ok);
 }
 
@@ -0,0 +1,147 @@
+#include <cstring>
+#include "syskit/BufPool.hpp"
+#include "syskit/BufProfile.hpp"
+
+#include "syskit-ut-pch.h"
+#include "BufProfileSuite.hpp"
+
+using namespace syskit;
+
+
+BufProfileSuite::BufProfileSuite()
+{
+}
+
+
+BufProfileSuite::~BufProfileSuite()
+{
+}
+
+
+void BufProfileSuite::testDescribe00()
+{
+    BufPool pool;
+    bool ok = pool.startProfiling(1 /*sampleRate*/);
+    CPPUNIT_ASSERT(ok);
+
+    void* buf = pool.allocate(24);
+    char* desc = pool.profile()->describe();
+    ok = (std::strstr(desc, "running") != 0) && (std::strstr(desc, "outstanding") != 0);
+    CPPUNIT_ASSERT(ok);
+    delete[] desc;
+
+    pool.free(buf, 24);
+    pool.stopProfiling();
+    desc = pool.profile()->describe();
+    ok = (std::strstr(desc, "stopped") != 0);
+    CPPUNIT_ASSERT(ok);
+    delete[] desc;
+}
+
+
+//
+// Sample all allocations.
+//
+void BufProfileSuite::testSample00()
+{
+    BufPool pool;
+    pool.startProfiling(1 /*sampleRate*/);
+    const BufProfile* profile = pool.profile();
+
+    enum
+    {
+        NumBufs = 100
+    };
+    void* buf[NumBufs];
+    for (unsigned int i = 0; i < NumBufs; ++i)
+    {
+        buf[i] = pool.allocate(i + 1);
+    }
+    bool ok = (profile->numSamples() == NumBufs) && (profile->numOutstanding() == NumBufs);
+    CPPUNIT_ASSERT(ok);
+
+    for (unsigned int i = 0; i < NumBufs; ++i)
+    {
+        pool.free(buf[i], i + 1);
+    }
+    ok = (profile->numSamples() == NumBufs) && (profile->numOutstanding() == 0);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Sample one in four allocations.
+//
+void BufProfileSuite::testSample01()
+{
+    BufPool pool;
+    pool.startProfiling(4 /*sampleRate*/);
+    const BufProfile* profile = pool.profile();
+    bool ok = (profile->sampleRate() == 4);
+    CPPUNIT_ASSERT(ok);
+
+    for (unsigned int i = 0; i < 400; ++i)
+    {
+        void* buf = pool.allocate(64);
+        pool.free(buf, 64);
+    }
+    ok = (profile->numSamples() == 100) && (profile->numOutstanding() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Stopped profiles do not sample.
+    pool.stopProfiling();
+    void* buf = pool.allocate(64);
+    pool.free(buf, 64);
+    ok = (!profile->isSampling()) && (profile->numSamples() == 100);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void BufProfileSuite::testStart00()
+{
+    BufPool pool;
+    bool ok = (pool.profile() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Restarting discards the existing profile.
+    pool.startProfiling(1 /*sampleRate*/);
+    void* buf = pool.allocate(8);
+    const BufProfile* profile = pool.profile();
+    ok = (profile != 0) && profile->isSampling() && (profile->numOutstanding() == 1);
+    CPPUNIT_ASSERT(ok);
+    pool.startProfiling(1 /*sampleRate*/);
+    ok = (pool.profile() == profile) && (profile->numOutstanding() == 0);
+    CPPUNIT_ASSERT(ok);
+    pool.free(buf, 8);
+    ok = (profile->numOutstanding() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Profiling a disabled pool is not supported.
+    const char* config = "0:0:0;";
+    BufPool disabledPool(config);
+    ok = (!disabledPool.startProfiling(1 /*sampleRate*/)) && (disabledPool.profile() == 0);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Sampled buffers freed after a stop are not reported as outstanding.
+//
+void BufProfileSuite::testStop00()
+{
+    BufPool pool;
+    pool.startProfiling(1 /*sampleRate*/);
+    const BufProfile* profile = pool.profile();
+    void* buf0 = pool.allocate(16);
+    void* buf1 = pool.allocate(32);
+    bool ok = (profile->numOutstanding() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    pool.stopProfiling();
+    pool.free(buf1, 32);
+    ok = (profile->numOutstanding() == 1);
+    CPPUNIT_ASSERT(ok);
+    pool.free(buf0, 16);
+    ok = (profile->numOutstanding() == 0) && (profile->numSamples() == 2);
+    CPPUNIT_ASSERT(ok);
+}
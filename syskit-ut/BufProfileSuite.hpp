@@ -0,0 +1,35 @@
+#ifndef BUF_PROFILE_SUITE_HPP
+#define BUF_PROFILE_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class BufProfileSuite: public CppUnit::TestFixture
+{
+
+public:
+    BufProfileSuite();
+
+    virtual ~BufProfileSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(BufProfileSuite);
+    CPPUNIT_TEST(testDescribe00);
+    CPPUNIT_TEST(testSample00);
+    CPPUNIT_TEST(testSample01);
+    CPPUNIT_TEST(testStart00);
+    CPPUNIT_TEST(testStop00);
+    CPPUNIT_TEST_SUITE_END();
+
+    BufProfileSuite(const BufProfileSuite&); //prohibit usage
+    const BufProfileSuite& operator =(const BufProfileSuite&); //prohibit usage
+
+    void testDescribe00();
+    void testSample00();
+    void testSample01();
+    void testStart00();
+    void testStop00();
+
+};
+
+#endif
@@ -0,0 +1,435 @@
+#include <cstdio>
+#include "syskit/AtomicWord.hpp"
+#include "syskit/BufPool.hpp"
+#include "syskit/Epoch.hpp"
+#include "syskit/Semaphore.hpp"
+#include "syskit/Thread.hpp"
+
+#include "syskit-ut-pch.h"
+#include "EpochSuite.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+enum
+{
+    Dead = 0xdeadbeefU,
+    Live = 0x600dcafeU,
+    NumKeys = 64
+};
+
+// Read-mostly map entry. Reclaimed entries are marked dead before being
+// freed. A reader seeing a dead or a recycled entry indicates a premature
+// reclamation.
+typedef struct
+{
+    unsigned int key;
+    unsigned int magic;
+    unsigned int version;
+    unsigned int check;
+} entry_t;
+
+// Read-mostly map of NumKeys keys with lock-free readers and one writer.
+typedef struct
+{
+    Epoch* epoch;
+    AtomicWord entry[NumKeys];
+    Atomic32 numReclaimed;
+    unsigned int numReads;
+    unsigned int numWrites;
+} map_t;
+
+// A reader holding a critical section while the main thread retires items.
+typedef struct
+{
+    Epoch* epoch;
+    Semaphore entered;
+    Semaphore release;
+} guard_t;
+
+entry_t* newEntry(unsigned int key, unsigned int version)
+{
+    entry_t* entry = static_cast<entry_t*>(BufPool::allocateBuf(sizeof(entry_t)));
+    entry->key = key;
+    entry->magic = Live;
+    entry->version = version;
+    entry->check = key ^ version;
+    return entry;
+}
+
+END_NAMESPACE
+
+
+EpochSuite::EpochSuite()
+{
+}
+
+
+EpochSuite::~EpochSuite()
+{
+}
+
+
+//
+// Reclaim callback. Count reclaimed items in arg.
+//
+void EpochSuite::countItem(void* arg, void* /*item*/)
+{
+    ++*static_cast<Atomic32*>(arg);
+}
+
+
+//
+// Reclaim callback. Mark the entry dead and free it.
+//
+void EpochSuite::killEntry(void* arg, void* item)
+{
+    entry_t* entry = static_cast<entry_t*>(item);
+    entry->magic = Dead;
+    BufPool::freeBuf(entry, sizeof(*entry));
+    ++*static_cast<Atomic32*>(arg);
+}
+
+
+//
+// Reader. Look up the map and validate the found entries.
+//
+void* EpochSuite::entry00(void* arg)
+{
+    map_t* map = static_cast<map_t*>(arg);
+    bool ok = true;
+    for (unsigned int i = 0; i < map->numReads; ++i)
+    {
+        Epoch::Guard guard(*map->epoch);
+        unsigned int key = i % NumKeys;
+        const entry_t* entry = reinterpret_cast<const entry_t*>(map->entry[key].asWord());
+        if ((i & 255) == 0)
+        {
+            Thread::yield(); //let the writer retire the entry
+        }
+        if ((entry->magic != Live) || (entry->key != key) || (entry->check != (key ^ entry->version)))
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    map->epoch->detach();
+    return ok? map: 0;
+}
+
+
+//
+// Writer. Replace map entries and retire the replaced ones.
+//
+void* EpochSuite::entry01(void* arg)
+{
+    map_t* map = static_cast<map_t*>(arg);
+    for (unsigned int i = 0; i < map->numWrites; ++i)
+    {
+        unsigned int key = i % NumKeys;
+        AtomicWord::item_t old;
+        map->entry[key].set(reinterpret_cast<AtomicWord::item_t>(newEntry(key, i)), old);
+        map->epoch->retire(reinterpret_cast<entry_t*>(old), killEntry, &map->numReclaimed);
+    }
+
+    map->epoch->detach();
+    return map;
+}
+
+
+//
+// Reader. Stay in a critical section until released.
+//
+void* EpochSuite::entry02(void* arg)
+{
+    guard_t* guard = static_cast<guard_t*>(arg);
+    {
+        Epoch::Guard epochGuard(*guard->epoch);
+        guard->entered.increment();
+        guard->release.decrement();
+    }
+
+    guard->epoch->detach();
+    return guard;
+}
+
+
+//
+// Retire some items and detach without waiting for their reclamation.
+//
+void* EpochSuite::entry03(void* arg)
+{
+    map_t* map = static_cast<map_t*>(arg);
+    for (unsigned int i = 0; i < map->numWrites; ++i)
+    {
+        map->epoch->retire(map, countItem, &map->numReclaimed);
+    }
+
+    map->epoch->detach();
+    return map;
+}
+
+
+void EpochSuite::testCtor00()
+{
+    Epoch epoch;
+    bool ok = (epoch.current() == 0) && (epoch.numThreads() == 0) && (epoch.numRetired() == 0) && (epoch.numReclaimed() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Critical sections can be nested.
+    {
+        Epoch::Guard guard0(epoch);
+        Epoch::Guard guard1(epoch);
+    }
+    ok = (epoch.numThreads() == 1) && epoch.tryAdvance() && (epoch.current() == 1);
+    CPPUNIT_ASSERT(ok);
+
+    // Retired items are not reclaimed until the epoch advances twice.
+    Atomic32 numReclaimed(0U);
+    epoch.retire(0, countItem, &numReclaimed);
+    epoch.retire(0, countItem, &numReclaimed);
+    epoch.retireBuf(BufPool::allocateBuf(32), 32);
+    ok = (epoch.numRetired() == 3) && (epoch.numReclaimed() == 0) && (numReclaimed == 0);
+    CPPUNIT_ASSERT(ok);
+
+    epoch.synchronize();
+    ok = (epoch.numReclaimed() == 3) && (numReclaimed == 2) && (epoch.current() >= 3);
+    CPPUNIT_ASSERT(ok);
+
+    // Items pending at destruction are reclaimed.
+    {
+        Epoch epoch1;
+        epoch1.retire(0, countItem, &numReclaimed);
+    }
+    ok = (numReclaimed == 3);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Items retired by detached threads should be reclaimed by others.
+//
+void EpochSuite::testDetach00()
+{
+    Epoch epoch;
+    map_t* map = new map_t;
+    map->epoch = &epoch;
+    map->numWrites = 100;
+
+    enum
+    {
+        NumThreads = 4
+    };
+    Thread* thread[NumThreads];
+    for (unsigned int i = 0; i < NumThreads; ++i)
+    {
+        thread[i] = new Thread(entry03, map);
+    }
+    for (unsigned int i = 0; i < NumThreads; ++i)
+    {
+        thread[i]->waitTilDone();
+        delete thread[i];
+    }
+
+    epoch.synchronize();
+    bool ok = (epoch.numRetired() == map->numWrites * NumThreads) &&
+        (epoch.numReclaimed() == epoch.numRetired()) &&
+        (map->numReclaimed == epoch.numRetired());
+    CPPUNIT_ASSERT(ok);
+
+    delete map;
+}
+
+
+//
+// A reader in a critical section should hold off reclamation.
+//
+void EpochSuite::testGuard00()
+{
+    Epoch epoch(1 /*batchSize*/);
+    guard_t guard;
+    guard.epoch = &epoch;
+    Thread reader(entry02, &guard);
+    guard.entered.decrement();
+
+    Atomic32 numReclaimed(0U);
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        epoch.retire(0, countItem, &numReclaimed);
+        epoch.tryAdvance();
+    }
+    bool ok = (numReclaimed == 0) && (epoch.current() <= 1);
+    guard.release.increment();
+    reader.waitTilDone();
+    CPPUNIT_ASSERT(ok);
+
+    epoch.synchronize();
+    ok = (numReclaimed == 100);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Lock-free readers of a read-mostly map should never see reclaimed entries.
+//
+void EpochSuite::testStress00()
+{
+    Epoch epoch(16 /*batchSize*/);
+    map_t* map = new map_t;
+    map->epoch = &epoch;
+    map->numReads = 200000;
+    map->numWrites = 20000;
+    for (unsigned int key = 0; key < NumKeys; ++key)
+    {
+        map->entry[key] = reinterpret_cast<AtomicWord::item_t>(newEntry(key, key));
+    }
+
+    enum
+    {
+        NumReaders = 6
+    };
+    Thread* thread[NumReaders + 1];
+    for (unsigned int i = 0; i <= NumReaders; ++i)
+    {
+        thread[i] = new Thread((i < NumReaders)? entry00: entry01, map);
+    }
+
+    bool ok = true;
+    for (unsigned int i = 0; i <= NumReaders; ++i)
+    {
+        void* exitCode = 0;
+        thread[i]->waitTilDone(&exitCode);
+        if (exitCode != map)
+        {
+            ok = false;
+        }
+        delete thread[i];
+    }
+    CPPUNIT_ASSERT(ok);
+
+    epoch.synchronize();
+    ok = (epoch.numRetired() == map->numWrites) && (map->numReclaimed == map->numWrites);
+    CPPUNIT_ASSERT(ok);
+
+    for (unsigned int key = 0; key < NumKeys; ++key)
+    {
+        BufPool::freeBuf(reinterpret_cast<void*>(map->entry[key].asWord()), sizeof(entry_t));
+    }
+    delete map;
+}
+
+
+#if 0
+#include "syskit/RwSection.hpp"
+#include "syskit/TickTime.hpp"
+
+BEGIN_NAMESPACE
+
+// Shared state for the benchmark. Readers look up a read-mostly map
+// protected either by an epoch or by a reader-writer section.
+typedef struct
+{
+    Epoch epoch;
+    RwSection rws;
+    AtomicWord entry[NumKeys];
+    Atomic32 numReclaimed;
+    bool useEpoch;
+    unsigned int numLoops;
+} bench_t;
+
+END_NAMESPACE
+
+//
+// Benchmark reader. One in 4096 accesses is an update.
+//
+void* EpochSuite::entry04(void* arg)
+{
+    bench_t* bench = static_cast<bench_t*>(arg);
+    unsigned long long sum = 0;
+    for (unsigned int i = 0; i < bench->numLoops; ++i)
+    {
+        unsigned int key = i % NumKeys;
+        if ((i & 4095) == 0)
+        {
+            AtomicWord::item_t old;
+            if (bench->useEpoch)
+            {
+                bench->entry[key].set(reinterpret_cast<AtomicWord::item_t>(newEntry(key, i)), old);
+                bench->epoch.retire(reinterpret_cast<entry_t*>(old), killEntry, &bench->numReclaimed);
+            }
+            else
+            {
+                RwSection::WriteLock lock(bench->rws);
+                bench->entry[key].set(reinterpret_cast<AtomicWord::item_t>(newEntry(key, i)), old);
+                killEntry(&bench->numReclaimed, reinterpret_cast<entry_t*>(old));
+            }
+        }
+        else if (bench->useEpoch)
+        {
+            Epoch::Guard guard(bench->epoch);
+            sum += reinterpret_cast<const entry_t*>(bench->entry[key].asWord())->version;
+        }
+        else
+        {
+            RwSection::ReadLock lock(bench->rws);
+            sum += reinterpret_cast<const entry_t*>(bench->entry[key].asWord())->version;
+        }
+    }
+
+    bench->epoch.detach();
+    return reinterpret_cast<void*>(static_cast<size_t>(sum));
+}
+
+
+//
+// Compare read throughput of a read-mostly map protected by an epoch and
+// by a reader-writer section at 1-64 readers. Epoch-protected readers do
+// not write shared cache lines and should scale linearly.
+//
+void EpochSuite::testPerf00()
+{
+    std::printf("\n%8s%14s%14s (nsecs per access)\n", "readers", "RwSection", "Epoch");
+    bench_t* bench = new bench_t;
+    bench->numLoops = 1000000;
+    for (unsigned int key = 0; key < NumKeys; ++key)
+    {
+        bench->entry[key] = reinterpret_cast<AtomicWord::item_t>(newEntry(key, key));
+    }
+
+    for (unsigned int numReaders = 1; numReaders <= 64; numReaders <<= 1)
+    {
+        std::printf("%8u", numReaders);
+        for (unsigned int useEpoch = 0; useEpoch < 2; ++useEpoch)
+        {
+            bench->useEpoch = (useEpoch != 0);
+            Thread** thread = new Thread*[numReaders];
+            unsigned long long t0 = TickTime::curTime();
+            for (unsigned int i = 0; i < numReaders; ++i)
+            {
+                thread[i] = new Thread(entry04, bench);
+            }
+            for (unsigned int i = 0; i < numReaders; ++i)
+            {
+                thread[i]->waitTilDone();
+                delete thread[i];
+            }
+            unsigned long long t1 = TickTime::curTime();
+            delete[] thread;
+            double nsecs = (t1 - t0) * 1e9 / TickTime::ticksPerSec() / bench->numLoops / numReaders;
+            std::printf("%14.1f", nsecs);
+        }
+        std::printf("\n");
+    }
+
+    bench->epoch.synchronize();
+    for (unsigned int key = 0; key < NumKeys; ++key)
+    {
+        BufPool::freeBuf(reinterpret_cast<void*>(bench->entry[key].asWord()), sizeof(entry_t));
+    }
+    delete bench;
+    bool ok = true;
+    CPPUNIT_ASSERT(ok);
+}
+#endif
@@ -0,0 +1,43 @@
+#ifndef EPOCH_SUITE_HPP
+#define EPOCH_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class EpochSuite: public CppUnit::TestFixture
+{
+
+public:
+    EpochSuite();
+
+    virtual ~EpochSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(EpochSuite);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testDetach00);
+    CPPUNIT_TEST(testGuard00);
+    //CPPUNIT_TEST(testPerf00);
+    CPPUNIT_TEST(testStress00);
+    CPPUNIT_TEST_SUITE_END();
+
+    EpochSuite(const EpochSuite&); //prohibit usage
+    const EpochSuite& operator =(const EpochSuite&); //prohibit usage
+
+    void testCtor00();
+    void testDetach00();
+    void testGuard00();
+    //void testPerf00();
+    void testStress00();
+
+    static void countItem(void*, void*);
+    static void killEntry(void*, void*);
+    static void* entry00(void*);
+    static void* entry01(void*);
+    static void* entry02(void*);
+    static void* entry03(void*);
+    //static void* entry04(void*);
+
+};
+
+#endif
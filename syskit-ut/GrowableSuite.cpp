@@ -1,4 +1,9 @@
+#if __linux || __CYGWIN__
+#include <stdio.h>
+#endif
 #include "syskit/Growable.hpp"
+#include "syskit/TickTime.hpp"
+#include "syskit/U32Vec.hpp"
 
 #include "syskit-ut-pch.h"
 #include "GrowableSuite.hpp"
@@ -51,6 +56,107 @@ GrowableSuite::~GrowableSuite()
 }
 
 
+//
+// Big arrays are backed by memory mappings where supported.
+//
+void GrowableSuite::testBigArray00()
+{
+    unsigned int numBigArrays = Growable::numBigArrays();
+    bool enabled = Growable::enableBigArrays(4096 /*minByteSize*/);
+    bool ok = (enabled == (Growable::bigArraySize() == 4096));
+    CPPUNIT_ASSERT(ok);
+
+    // Small arrays still come from the heap.
+    // Growing beyond the threshold uses a big array.
+    U32Vec vec(16 /*capacity*/, -1 /*growBy*/);
+    ok = (Growable::numBigArrays() == numBigArrays);
+    CPPUNIT_ASSERT(ok);
+    for (unsigned int i = 0; i < 100000; ++i)
+    {
+        vec.add(i);
+    }
+    ok = (Growable::numBigArrays() == (enabled? (numBigArrays + 1): numBigArrays));
+    CPPUNIT_ASSERT(ok);
+    for (unsigned int i = 0; i < 100000; ++i)
+    {
+        if (vec[i] != i)
+        {
+            ok = false;
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    // Copy and shrink.
+    U32Vec* copy = new U32Vec(vec);
+    ok = copy->resize(copy->numItems()) && (*copy == vec);
+    CPPUNIT_ASSERT(ok);
+    ok = (Growable::numBigArrays() == (enabled? (numBigArrays + 2): numBigArrays));
+    CPPUNIT_ASSERT(ok);
+    delete copy;
+    ok = (Growable::numBigArrays() == (enabled? (numBigArrays + 1): numBigArrays));
+    CPPUNIT_ASSERT(ok);
+
+    // A detached array is always freed using the delete[] operator.
+    Growable::disableBigArrays();
+    ok = (Growable::bigArraySize() == 0);
+    CPPUNIT_ASSERT(ok);
+    unsigned int numItems;
+    U32Vec::item_t* raw = vec.detachRaw(numItems);
+    ok = (numItems == 100000) && (raw[0] == 0) && (raw[99999] == 99999);
+    CPPUNIT_ASSERT(ok);
+    delete[] raw;
+    ok = (Growable::numBigArrays() == numBigArrays);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// The number of big arrays is not limited. Big and heap arrays can be
+// freed in any order, also after big arrays have been disabled.
+//
+void GrowableSuite::testBigArray01()
+{
+    unsigned int numBigArrays = Growable::numBigArrays();
+    bool enabled = Growable::enableBigArrays(4096 /*minByteSize*/);
+
+    const unsigned int numVecs = 600;
+    U32Vec* vec[numVecs];
+    for (unsigned int i = 0; i < numVecs; ++i)
+    {
+        vec[i] = new U32Vec(((i & 1) == 0)? 4096: 16 /*capacity*/, -1 /*growBy*/);
+        vec[i]->add(i);
+    }
+    unsigned int numBigVecs = numVecs / 2;
+    bool ok = (Growable::numBigArrays() == (enabled? (numBigArrays + numBigVecs): numBigArrays));
+    CPPUNIT_ASSERT(ok);
+
+    // Grow small vectors into big ones.
+    for (unsigned int i = 1; i < numVecs; i += 4)
+    {
+        vec[i]->resize(4096);
+        ++numBigVecs;
+    }
+    ok = (Growable::numBigArrays() == (enabled? (numBigArrays + numBigVecs): numBigArrays));
+    CPPUNIT_ASSERT(ok);
+
+    for (unsigned int i = 0; i < numVecs; ++i)
+    {
+        if ((vec[i]->numItems() != 1) || ((*vec[i])[0] != i))
+        {
+            ok = false;
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    Growable::disableBigArrays();
+    for (unsigned int i = numVecs; i > 0; delete vec[--i]);
+    ok = (Growable::numBigArrays() == numBigArrays);
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void GrowableSuite::testCtor00()
 {
     Container fixed(123, 0);
@@ -149,3 +255,66 @@ void GrowableSuite::testNextCap00()
     ok = ((flex2.increaseCap(3) == 10) && (flex2.capacity() == 10));
     CPPUNIT_ASSERT(ok);
 }
+
+
+#if 0
+//
+// Measure add() throughput and peak resident set size when growing a vector
+// to 100M items with and without big arrays.
+//
+void GrowableSuite::testPerf00()
+{
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        if (mode == 0)
+        {
+            Growable::disableBigArrays();
+        }
+        else
+        {
+            Growable::enableBigArrays(Growable::DefaultBigArraySize, (mode == 2) /*useHugePages*/);
+        }
+
+#if __linux || __CYGWIN__
+        // Reset the peak resident set size.
+        FILE* f = fopen("/proc/self/clear_refs", "w");
+        if (f != 0)
+        {
+            fputs("5", f);
+            fclose(f);
+        }
+#endif
+
+        unsigned long long t0 = TickTime::curTime();
+        U32Vec vec(1 /*capacity*/, -1 /*growBy*/);
+        for (unsigned int i = 0; i < 100000000; ++i)
+        {
+            vec.add(i);
+        }
+        unsigned long long t1 = TickTime::curTime();
+        double secs = (t1 - t0) * TickTime::secsPerTick();
+        printf("mode=%d items=%u secs=%.3f itemsPerSec=%.0f\n", mode, vec.numItems(), secs, vec.numItems() / secs);
+
+#if __linux || __CYGWIN__
+        // Show the peak resident set size.
+        f = fopen("/proc/self/status", "r");
+        char line[256];
+        while ((f != 0) && (fgets(line, sizeof(line), f) != 0))
+        {
+            if (memcmp(line, "VmHWM:", 6) == 0)
+            {
+                fputs(line, stdout);
+            }
+        }
+        if (f != 0)
+        {
+            fclose(f);
+        }
+#endif
+    }
+
+    Growable::disableBigArrays();
+    bool ok = true;
+    CPPUNIT_ASSERT(ok);
+}
+#endif
@@ -14,21 +14,27 @@ public:
 
 private:
     CPPUNIT_TEST_SUITE(GrowableSuite);
+    CPPUNIT_TEST(testBigArray00);
+    CPPUNIT_TEST(testBigArray01);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
     CPPUNIT_TEST(testCtor02);
     CPPUNIT_TEST(testCtor03);
     CPPUNIT_TEST(testNextCap00);
+    //CPPUNIT_TEST(testPerf00);
     CPPUNIT_TEST_SUITE_END();
 
     GrowableSuite(const GrowableSuite&); //prohibit usage
     const GrowableSuite& operator =(const GrowableSuite&); //prohibit usage
 
+    void testBigArray00();
+    void testBigArray01();
     void testCtor00();
     void testCtor01();
     void testCtor02();
     void testCtor03();
     void testNextCap00();
+    //void testPerf00();
 
 };
 
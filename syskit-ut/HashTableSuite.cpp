@@ -1,5 +1,7 @@
 #include "appkit/U32.hpp"
 #include "syskit/HashTable.hpp"
+#include "syskit/ThreadPool.hpp"
+#include "syskit/Vec.hpp"
 
 #include "syskit-ut-pch.h"
 #include "HashTableSuite.hpp"
@@ -42,6 +44,31 @@ void HashTableSuite::deleteItem(void* /*arg*/, void* item)
 }
 
 
+//
+// Reduction hooks for parallel traversals. Each partition collects its
+// items in a vector, and the vectors are concatenated into the one in arg.
+//
+void HashTableSuite::closeVec(void* arg, void* partial)
+{
+    Vec* vec = static_cast<Vec*>(partial);
+    static_cast<Vec*>(arg)->add(*vec);
+    delete vec;
+}
+
+
+void HashTableSuite::collectItem(void* /*arg*/, void* partial, void* item)
+{
+    static_cast<Vec*>(partial)->add(item);
+}
+
+
+void* HashTableSuite::openVec(void* /*arg*/)
+{
+    Vec* vec = new Vec(0, -1 /*growBy*/);
+    return vec;
+}
+
+
 void HashTableSuite::testAdd00()
 {
     HashTable t(U32::compareP, U32::hashP);
@@ -241,6 +268,37 @@ void HashTableSuite::testAdd03()
 }
 
 
+//
+// Interfaces under test:
+// - void HashTable::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const;
+// The bucket partitions should collectively hold each item exactly once,
+// also when the table has more buckets than items.
+//
+void HashTableSuite::testApplyParallel00()
+{
+    const unsigned int numItems = 1000;
+    HashTable t(U32::compareP, U32::hashP, 4096 /*capacity*/);
+    for (unsigned int i = 1; i <= numItems; t.add(new unsigned int(i++)));
+
+    bool ok = true;
+    ThreadPool pool(4 /*numWorkers*/);
+    for (unsigned int withPool = 0; ok && (withPool <= 1); ++withPool)
+    {
+        Vec items(numItems, -1 /*growBy*/);
+        t.applyParallel(collectItem, &items, openVec, closeVec, withPool? &pool: 0);
+        items.sort(U32::compareP);
+        ok = (items.numItems() == numItems);
+        for (unsigned int i = 0; ok && (i < numItems); ++i)
+        {
+            ok = (*static_cast<const unsigned int*>(items.peek(i)) == i + 1);
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    t.apply(deleteItem);
+}
+
+
 void HashTableSuite::testCtor00()
 {
     HashTable t(U32::compareP, U32::hashP, HashTable::DefaultCap, 1.0 /*bucketCap*/);
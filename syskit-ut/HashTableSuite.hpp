@@ -18,6 +18,7 @@ private:
     CPPUNIT_TEST(testAdd01);
     CPPUNIT_TEST(testAdd02);
     CPPUNIT_TEST(testAdd03);
+    CPPUNIT_TEST(testApplyParallel00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testSize00);
     CPPUNIT_TEST_SUITE_END();
@@ -29,12 +30,16 @@ private:
     void testAdd01();
     void testAdd02();
     void testAdd03();
+    void testApplyParallel00();
     void testCtor00();
     void testSize00();
 
     static bool cb0a(void*, void*);
     static bool cb0b(void*, void*);
+    static void closeVec(void*, void*);
+    static void collectItem(void*, void*, void*);
     static void deleteItem(void*, void*);
+    static void* openVec(void*);
 
 };
 
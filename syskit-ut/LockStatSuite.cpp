@@ -0,0 +1,178 @@
+#include <cstring>
+#include "syskit/CriSection.hpp"
+#include "syskit/LockStat.hpp"
+#include "syskit/Mutex.hpp"
+#include "syskit/Semaphore.hpp"
+#include "syskit/SpinSection.hpp"
+#include "syskit/Thread.hpp"
+
+#include "syskit-ut-pch.h"
+#include "LockStatSuite.hpp"
+
+using namespace syskit;
+
+
+LockStatSuite::LockStatSuite()
+{
+}
+
+
+LockStatSuite::~LockStatSuite()
+{
+}
+
+
+void* LockStatSuite::entry00(void* arg)
+{
+    SpinSection* ss = static_cast<SpinSection*>(arg);
+    ss->lock();
+    ss->unlock();
+    return ss;
+}
+
+
+//
+// Hold a profiled lock while another thread waits for it.
+//
+void LockStatSuite::testContention00()
+{
+    LockStat::enable(true);
+    SpinSection ss(0U /*spinCount*/);
+    ss.startProfiling("LockStatSuite.contention");
+    ss.lock();
+    Thread thread(entry00, &ss);
+    Semaphore sem(0U /*capacity*/);
+    sem.decrement(50 /*timeoutInMsecs*/);
+    ss.unlock();
+
+    void* exitCode = 0;
+    thread.waitTilDone(&exitCode);
+    const LockStat* stat = ss.stat();
+    bool ok = (exitCode == &ss) && (stat->numAcquisitions() == 2) && (stat->numContentions() == 1);
+    CPPUNIT_ASSERT(ok);
+    ok = (stat->waitTime() > 0) && (stat->maxWaitTime() == stat->waitTime());
+    CPPUNIT_ASSERT(ok);
+
+    unsigned long long numWaits = 0;
+    for (unsigned int b = 0; b < LockStat::NumBuckets; ++b)
+    {
+        numWaits += stat->waitHist()[b];
+    }
+    ok = (numWaits == 1);
+    CPPUNIT_ASSERT(ok);
+    LockStat::enable(false);
+}
+
+
+//
+// Recursive acquisitions are counted, but only the outermost hold is timed.
+//
+void LockStatSuite::testCriSection00()
+{
+    LockStat::enable(true);
+    CriSection cs;
+    bool ok = (cs.stat() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    cs.startProfiling("LockStatSuite.cs");
+    cs.lock();
+    cs.lock();
+    cs.unlock();
+    ok = cs.tryLock();
+    CPPUNIT_ASSERT(ok);
+    cs.unlock();
+    cs.unlock();
+
+    const LockStat* stat = cs.stat();
+    ok = (stat->numAcquisitions() == 3) && (stat->numContentions() == 0) && (stat->numSpins() == 0);
+    CPPUNIT_ASSERT(ok);
+    ok = (std::strcmp(stat->kind(), "CriSection") == 0) && (std::strcmp(stat->name(), "LockStatSuite.cs") == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Nothing is recorded while disabled.
+    LockStat::enable(false);
+    cs.lock();
+    cs.unlock();
+    ok = (stat->numAcquisitions() == 3);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void LockStatSuite::testDescribe00()
+{
+    unsigned int numLocks = LockStat::numLocks();
+    SpinSection* ss = new SpinSection;
+    ss->startProfiling("LockStatSuite.describe");
+    bool ok = (LockStat::numLocks() == numLocks + 1);
+    CPPUNIT_ASSERT(ok);
+
+    LockStat::enable(true);
+    ss->lock();
+    ss->unlock();
+    char* desc = LockStat::describe(LockStat::numLocks());
+    ok = (std::strstr(desc, "running") != 0) && (std::strstr(desc, "LockStatSuite.describe") != 0);
+    CPPUNIT_ASSERT(ok);
+    delete[] desc;
+
+    LockStat::enable(false);
+    LockStat::resetAll();
+    ok = (ss->stat()->numAcquisitions() == 0);
+    CPPUNIT_ASSERT(ok);
+    desc = LockStat::describe(0 /*maxLocks*/);
+    ok = (std::strstr(desc, "stopped") != 0) && (std::strstr(desc, "LockStatSuite.describe") == 0);
+    CPPUNIT_ASSERT(ok);
+    delete[] desc;
+
+    delete ss;
+    ok = (LockStat::numLocks() == numLocks);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void LockStatSuite::testMutex00()
+{
+    LockStat::enable(true);
+    Mutex mutex;
+    mutex.startProfiling("LockStatSuite.mutex");
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        Mutex::Lock lock(mutex);
+    }
+    bool ok = mutex.tryLock();
+    CPPUNIT_ASSERT(ok);
+    mutex.unlock();
+
+    const LockStat* stat = mutex.stat();
+    ok = (stat->numAcquisitions() == 11) && (stat->numContentions() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Restarting resets the statistics.
+    mutex.startProfiling("ignored");
+    ok = (stat->numAcquisitions() == 0) && (std::strcmp(stat->name(), "LockStatSuite.mutex") == 0);
+    CPPUNIT_ASSERT(ok);
+    LockStat::enable(false);
+}
+
+
+void LockStatSuite::testSpinSection00()
+{
+    LockStat::enable(true);
+    SpinSection ss;
+    ss.startProfiling("LockStatSuite.ss");
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        SpinSection::Lock lock(ss);
+    }
+    bool ok = ss.tryLock();
+    CPPUNIT_ASSERT(ok);
+    ok = !ss.tryLock();
+    CPPUNIT_ASSERT(ok);
+    ss.unlock();
+
+    const LockStat* stat = ss.stat();
+    ok = (stat->numAcquisitions() == 11) && (stat->numContentions() == 0) && (stat->waitTime() == 0);
+    CPPUNIT_ASSERT(ok);
+    ok = (std::strcmp(stat->kind(), "SpinSection") == 0);
+    CPPUNIT_ASSERT(ok);
+    LockStat::enable(false);
+}
@@ -0,0 +1,37 @@
+#ifndef LOCK_STAT_SUITE_HPP
+#define LOCK_STAT_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class LockStatSuite: public CppUnit::TestFixture
+{
+
+public:
+    LockStatSuite();
+
+    virtual ~LockStatSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(LockStatSuite);
+    CPPUNIT_TEST(testContention00);
+    CPPUNIT_TEST(testCriSection00);
+    CPPUNIT_TEST(testDescribe00);
+    CPPUNIT_TEST(testMutex00);
+    CPPUNIT_TEST(testSpinSection00);
+    CPPUNIT_TEST_SUITE_END();
+
+    LockStatSuite(const LockStatSuite&); //prohibit usage
+    const LockStatSuite& operator =(const LockStatSuite&); //prohibit usage
+
+    void testContention00();
+    void testCriSection00();
+    void testDescribe00();
+    void testMutex00();
+    void testSpinSection00();
+
+    static void* entry00(void*);
+
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "syskit/RefCounted.hpp"
+#include "syskit/Thread.hpp"
 
 #include "syskit-ut-pch.h"
 #include "RefCountedSuite.hpp"
@@ -10,15 +11,15 @@ BEGIN_NAMESPACE
 class One: public RefCounted
 {
 public:
-    One(bool* destroyed = 0);
+    One(bool* destroyed = 0, bool isShared = true);
 protected:
     virtual ~One();
 private:
     bool* destroyed_;
 };
 
-One::One(bool* destroyed):
-RefCounted(0)
+One::One(bool* destroyed, bool isShared):
+RefCounted(0, isShared)
 {
 
     destroyed_ = destroyed;
@@ -37,6 +38,27 @@ One::~One()
     }
 }
 
+class Two: public RefCounted
+{
+public:
+    Two(Atomic32* numDestroyed);
+protected:
+    virtual ~Two();
+private:
+    Atomic32* numDestroyed_;
+};
+
+Two::Two(Atomic32* numDestroyed):
+RefCounted(0)
+{
+    numDestroyed_ = numDestroyed;
+}
+
+Two::~Two()
+{
+    ++*numDestroyed_;
+}
+
 END_NAMESPACE
 
 
@@ -116,6 +138,90 @@ void RefCountedSuite::testCtor00()
 }
 
 
+//
+// Release one reference to each instance in given array.
+//
+void* RefCountedSuite::entry00(void* arg)
+{
+    RefCounted** two = static_cast<RefCounted**>(arg);
+    for (size_t i = 0; two[i] != 0; ++i)
+    {
+        two[i]->rmRef();
+    }
+
+    return arg;
+}
+
+
+void RefCountedSuite::testCtor01()
+{
+    bool destroyed = false;
+    bool isShared = false;
+    One* one = new One(&destroyed, isShared);
+    one->addRef();
+    one->addRef();
+    one->incrementRefBy(3);
+    one->decrementRefBy(2);
+    bool ok = (!one->isShared()) && (one->refCount() == 3U) && (!one->rmRef()) && (one->refCount() == 2U);
+    CPPUNIT_ASSERT(ok);
+
+    one->share();
+    ok = one->isShared() && (one->refCount() == 2U) && (!one->rmRef()) && (!destroyed);
+    CPPUNIT_ASSERT(ok);
+    ok = one->rmRef() && destroyed;
+    CPPUNIT_ASSERT(ok);
+
+    one = new One(&destroyed, isShared);
+    one->incrementRefBy(4);
+    ok = (!one->rmRef(3)) && (one->refCount() == 1U) && one->rmRef(1) && destroyed;
+    CPPUNIT_ASSERT(ok);
+
+    one = new One;
+    ok = one->isShared();
+    CPPUNIT_ASSERT(ok);
+    one->addRef();
+    one->rmRef();
+}
+
+
+//
+// Threads releasing references to the same instances concurrently.
+// Each instance must be destroyed exactly once.
+//
+void RefCountedSuite::testRmRef00()
+{
+    enum
+    {
+        NumItems = 20000,
+        NumThreads = 4
+    };
+
+    Atomic32 numDestroyed(0);
+    RefCounted** two = new RefCounted*[NumItems + 1];
+    for (size_t i = 0; i < NumItems; ++i)
+    {
+        two[i] = new Two(&numDestroyed);
+        two[i]->incrementRefBy(NumThreads);
+    }
+    two[NumItems] = 0;
+
+    Thread* thread[NumThreads];
+    for (size_t i = 0; i < NumThreads; ++i)
+    {
+        thread[i] = new Thread(entry00, two);
+    }
+    for (size_t i = 0; i < NumThreads; ++i)
+    {
+        thread[i]->waitTilDone();
+        delete thread[i];
+    }
+
+    bool ok = (numDestroyed == NumItems);
+    CPPUNIT_ASSERT(ok);
+    delete[] two;
+}
+
+
 void RefCountedSuite::testSize00()
 {
     bool ok = (sizeof(RefCounted) == sizeof(void*) * 2);
@@ -17,6 +17,8 @@ private:
     CPPUNIT_TEST(testCount00);
     CPPUNIT_TEST(testCount01);
     CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testCtor01);
+    CPPUNIT_TEST(testRmRef00);
     CPPUNIT_TEST(testSize00);
     CPPUNIT_TEST_SUITE_END();
 
@@ -26,8 +28,12 @@ private:
     void testCount00();
     void testCount01();
     void testCtor00();
+    void testCtor01();
+    void testRmRef00();
     void testSize00();
 
+    static void* entry00(void*);
+
 };
 
 #endif
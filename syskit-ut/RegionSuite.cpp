@@ -0,0 +1,165 @@
+#include <cstring>
+#include "syskit/Region.hpp"
+#include "syskit/Vec.hpp"
+
+#include "syskit-ut-pch.h"
+#include "RegionSuite.hpp"
+
+using namespace syskit;
+
+
+RegionSuite::RegionSuite()
+{
+}
+
+
+RegionSuite::~RegionSuite()
+{
+}
+
+
+//
+// Small allocations are aligned and bumped from regular chunks.
+//
+void RegionSuite::testAllocate00()
+{
+    Region region(1024 /*chunkSize*/);
+    bool ok = (region.chunkSize() == 1024) && (region.numChunks() == 0) && (region.capacity() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    unsigned char* prev = 0;
+    for (size_t size = 1; size <= 200; ++size)
+    {
+        unsigned char* buf = static_cast<unsigned char*>(region.allocate(size));
+        if ((buf == 0) || ((reinterpret_cast<size_t>(buf) % Region::Alignment) != 0) || (!region.ownsAddr(buf + size - 1)))
+        {
+            ok = false;
+            break;
+        }
+        memset(buf, static_cast<int>(size), size);
+        if ((prev != 0) && (prev[0] != static_cast<unsigned char>(size - 1)))
+        {
+            ok = false;
+            break;
+        }
+        prev = buf;
+    }
+    CPPUNIT_ASSERT(ok);
+
+    ok = (region.numChunks() > 1) && (region.capacity() == region.numChunks() * region.chunkSize());
+    CPPUNIT_ASSERT(ok);
+    ok = (!region.ownsAddr(&region));
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Large allocations get dedicated chunks.
+//
+void RegionSuite::testAllocate01()
+{
+    Region region(1024 /*chunkSize*/);
+    void* small0 = region.allocate(8);
+    void* large = region.allocate(4000);
+    void* small1 = region.allocate(8);
+    bool ok = (region.numChunks() == 2) && (region.capacity() == 1024 + 4000);
+    CPPUNIT_ASSERT(ok);
+    ok = (static_cast<unsigned char*>(small1) == static_cast<unsigned char*>(small0) + 8) && region.ownsAddr(large);
+    CPPUNIT_ASSERT(ok);
+    ok = (region.numBytes() == 8 + 4000 + 8);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Only the most recent allocation can be freed.
+//
+void RegionSuite::testFree00()
+{
+    Region region;
+    void* buf0 = region.allocate(24);
+    void* buf1 = region.allocate(24);
+    bool ok = (!region.free(buf0, 24)) && region.free(buf1, 24) && (region.numBytes() == 24);
+    CPPUNIT_ASSERT(ok);
+    ok = (region.allocate(24) == buf1);
+    CPPUNIT_ASSERT(ok);
+    ok = (!region.free(0, 0));
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void RegionSuite::testReset00()
+{
+    Region region(1024 /*chunkSize*/);
+    region.reset();
+    bool ok = (region.numChunks() == 0) && (region.numBytes() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        region.allocate(100);
+    }
+    region.allocate(2000);
+    ok = (region.numChunks() > 2);
+    CPPUNIT_ASSERT(ok);
+
+    // One regular chunk is retained.
+    region.reset();
+    ok = (region.numChunks() == 1) && (region.capacity() == 1024) && (region.numBytes() == 0);
+    CPPUNIT_ASSERT(ok);
+    void* buf = region.allocate(100);
+    ok = region.ownsAddr(buf) && (region.numChunks() == 1);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Opt into region allocation.
+//
+void RegionSuite::testVec00()
+{
+    Region region;
+    Vec* vec = new(region) Vec(4, -1 /*growBy*/);
+    bool ok = region.ownsAddr(vec);
+    CPPUNIT_ASSERT(ok);
+    for (size_t i = 0; i < 100; ++i)
+    {
+        vec->add(reinterpret_cast<void*>(i));
+    }
+    ok = (vec->numItems() == 100) && (vec->peek(99) == reinterpret_cast<void*>(99));
+    CPPUNIT_ASSERT(ok);
+    vec->~Vec();
+}
+
+
+//
+// Region-backed item array.
+//
+void RegionSuite::testVec01()
+{
+    Region region;
+    Vec* vec = new(region) Vec(4, -1 /*growBy*/, region);
+    bool ok = region.ownsAddr(vec) && region.ownsAddr(vec->raw());
+    CPPUNIT_ASSERT(ok);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        vec->add(reinterpret_cast<void*>(i));
+    }
+    ok = region.ownsAddr(vec->raw()) && (vec->numItems() == 4);
+    CPPUNIT_ASSERT(ok);
+
+    // Growth moves the items to the heap.
+    vec->add(reinterpret_cast<void*>(4));
+    ok = (!region.ownsAddr(vec->raw())) && (vec->numItems() == 5) && (vec->peek(3) == reinterpret_cast<void*>(3));
+    CPPUNIT_ASSERT(ok);
+    vec->~Vec();
+
+    // A detached array always comes from the heap.
+    Vec vec1(4, -1 /*growBy*/, region);
+    vec1.add(reinterpret_cast<void*>(1));
+    unsigned int numItems;
+    Vec::item_t* raw = vec1.detachRaw(numItems);
+    ok = (!region.ownsAddr(raw)) && (numItems == 1) && (raw[0] == reinterpret_cast<void*>(1));
+    CPPUNIT_ASSERT(ok);
+    delete[] raw;
+}
@@ -0,0 +1,37 @@
+#ifndef REGION_SUITE_HPP
+#define REGION_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RegionSuite: public CppUnit::TestFixture
+{
+
+public:
+    RegionSuite();
+
+    virtual ~RegionSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(RegionSuite);
+    CPPUNIT_TEST(testAllocate00);
+    CPPUNIT_TEST(testAllocate01);
+    CPPUNIT_TEST(testFree00);
+    CPPUNIT_TEST(testReset00);
+    CPPUNIT_TEST(testVec00);
+    CPPUNIT_TEST(testVec01);
+    CPPUNIT_TEST_SUITE_END();
+
+    RegionSuite(const RegionSuite&); //prohibit usage
+    const RegionSuite& operator =(const RegionSuite&); //prohibit usage
+
+    void testAllocate00();
+    void testAllocate01();
+    void testFree00();
+    void testReset00();
+    void testVec00();
+    void testVec01();
+
+};
+
+#endif
@@ -0,0 +1,263 @@
+#include <cstdio>
+#include "syskit/CriSection.hpp"
+#include "syskit/RwSection.hpp"
+#include "syskit/SeqLock.hpp"
+#include "syskit/Thread.hpp"
+#include "syskit/TickTime.hpp"
+
+#include "syskit-ut-pch.h"
+#include "RwSectionSuite.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    RwSection rws;
+    unsigned long long u64[4];
+    unsigned int numLoops;
+} sample_t;
+
+END_NAMESPACE
+
+
+RwSectionSuite::RwSectionSuite()
+{
+}
+
+
+RwSectionSuite::~RwSectionSuite()
+{
+}
+
+
+//
+// Reader. Validate the shared resource.
+//
+void* RwSectionSuite::entry00(void* arg)
+{
+    sample_t* sample = static_cast<sample_t*>(arg);
+    bool ok = true;
+    for (unsigned int i = 0; i < sample->numLoops; ++i)
+    {
+        RwSection::ReadLock lock(sample->rws);
+        const unsigned long long* u64 = sample->u64;
+        if ((u64[1] != u64[0]) || (u64[2] != u64[0]) || (u64[3] != u64[0]))
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    return ok? sample: 0;
+}
+
+
+//
+// Writer. Update the shared resource.
+//
+void* RwSectionSuite::entry01(void* arg)
+{
+    sample_t* sample = static_cast<sample_t*>(arg);
+    for (unsigned int i = 0; i < sample->numLoops; ++i)
+    {
+        RwSection::WriteLock lock(sample->rws);
+        unsigned long long* u64 = sample->u64;
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            ++u64[j];
+            if ((i % 64) == 0)
+            {
+                Thread::yield();
+            }
+        }
+    }
+
+    return sample;
+}
+
+
+void RwSectionSuite::testCtor00()
+{
+    RwSection rws;
+    bool ok = (!rws.isWriteLocked());
+    CPPUNIT_ASSERT(ok);
+
+    // Try lock/unlock using RwSection::ReadLock and RwSection::WriteLock.
+    {
+        RwSection::ReadLock lock(rws);
+    }
+    {
+        RwSection::WriteLock lock(rws);
+        ok = rws.isWriteLocked();
+        CPPUNIT_ASSERT(ok);
+    }
+
+    // Readers share the section.
+    ok = rws.tryReadLock() && rws.tryReadLock() && (!rws.tryWriteLock());
+    CPPUNIT_ASSERT(ok);
+    rws.readUnlock();
+    rws.readUnlock();
+
+    // Writers do not.
+    ok = rws.tryWriteLock() && (!rws.tryWriteLock()) && (!rws.tryReadLock());
+    CPPUNIT_ASSERT(ok);
+    rws.writeUnlock();
+    ok = (!rws.isWriteLocked()) && rws.tryReadLock();
+    CPPUNIT_ASSERT(ok);
+    rws.readUnlock();
+
+    // Make sure spin count can be set if allowed.
+    bool spinAllowed = (rws.spinCount() == RwSection::DefaultSpinCount);
+    ok = (rws.setSpinCount(12345U) == spinAllowed);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Readers should never see a partially updated resource.
+//
+void RwSectionSuite::testLock00()
+{
+    sample_t sample;
+    sample.numLoops = 20000;
+    memset(sample.u64, 0, sizeof(sample.u64));
+
+    enum
+    {
+        NumReaders = 6,
+        NumWriters = 2
+    };
+    Thread* thread[NumReaders + NumWriters];
+    for (unsigned int i = 0; i < NumReaders + NumWriters; ++i)
+    {
+        thread[i] = new Thread((i < NumReaders)? entry00: entry01, &sample);
+    }
+
+    bool ok = true;
+    for (unsigned int i = 0; i < NumReaders + NumWriters; ++i)
+    {
+        void* exitCode = 0;
+        thread[i]->waitTilDone(&exitCode);
+        if (exitCode != &sample)
+        {
+            ok = false;
+        }
+        delete thread[i];
+    }
+    CPPUNIT_ASSERT(ok);
+
+    unsigned long long numWrites = sample.numLoops * NumWriters;
+    ok = (sample.u64[0] == numWrites) && (sample.u64[3] == numWrites);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+#if 0
+BEGIN_NAMESPACE
+
+// Shared state for the benchmark. One lock kind is used at a time.
+typedef struct
+{
+    CriSection cs;
+    RwSection rws;
+    SeqLock sl;
+    unsigned long long u64[4];
+    unsigned int kind; //0:CriSection 1:RwSection 2:SeqLock
+    unsigned int numLoops;
+} bench_t;
+
+END_NAMESPACE
+
+//
+// Benchmark reader. Read a small snapshot using the lock of interest.
+// One in 1024 accesses is an update.
+//
+void* RwSectionSuite::entry02(void* arg)
+{
+    bench_t* bench = static_cast<bench_t*>(arg);
+    unsigned long long sum = 0;
+    unsigned long long u64[4];
+    for (unsigned int i = 0; i < bench->numLoops; ++i)
+    {
+        bool writing = ((i & 1023) == 0);
+        switch (bench->kind)
+        {
+        case 0:
+        {
+            CriSection::Lock lock(bench->cs);
+            writing? (++bench->u64[0]): (sum += bench->u64[0] + bench->u64[3]);
+            break;
+        }
+        case 1:
+            if (writing)
+            {
+                RwSection::WriteLock lock(bench->rws);
+                ++bench->u64[0];
+            }
+            else
+            {
+                RwSection::ReadLock lock(bench->rws);
+                sum += bench->u64[0] + bench->u64[3];
+            }
+            break;
+        default:
+            if (writing)
+            {
+                SeqLock::WriteLock lock(bench->sl);
+                ++bench->u64[0];
+            }
+            else
+            {
+                bench->sl.read(u64, bench->u64, sizeof(u64));
+                sum += u64[0] + u64[3];
+            }
+            break;
+        }
+    }
+
+    return reinterpret_cast<void*>(static_cast<size_t>(sum));
+}
+
+
+//
+// Compare read throughput of CriSection, RwSection, and SeqLock at 1-64 readers.
+//
+void RwSectionSuite::testPerf00()
+{
+    const char* kindName[] = {"CriSection", "RwSection", "SeqLock"};
+    std::printf("\n%8s%14s%14s%14s (nsecs per access)\n", "readers", kindName[0], kindName[1], kindName[2]);
+    bench_t* bench = new bench_t;
+    bench->numLoops = 1000000;
+    memset(bench->u64, 0, sizeof(bench->u64));
+    for (unsigned int numReaders = 1; numReaders <= 64; numReaders <<= 1)
+    {
+        std::printf("%8u", numReaders);
+        for (unsigned int kind = 0; kind < 3; ++kind)
+        {
+            bench->kind = kind;
+            Thread** thread = new Thread*[numReaders];
+            unsigned long long t0 = TickTime::curTime();
+            for (unsigned int i = 0; i < numReaders; ++i)
+            {
+                thread[i] = new Thread(entry02, bench);
+            }
+            for (unsigned int i = 0; i < numReaders; ++i)
+            {
+                thread[i]->waitTilDone();
+                delete thread[i];
+            }
+            unsigned long long t1 = TickTime::curTime();
+            delete[] thread;
+            double nsecs = (t1 - t0) * 1e9 / TickTime::ticksPerSec() / bench->numLoops / numReaders;
+            std::printf("%14.1f", nsecs);
+        }
+        std::printf("\n");
+    }
+
+    delete bench;
+    bool ok = true;
+    CPPUNIT_ASSERT(ok);
+}
+#endif
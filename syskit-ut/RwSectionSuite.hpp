@@ -0,0 +1,35 @@
+#ifndef RW_SECTION_SUITE_HPP
+#define RW_SECTION_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RwSectionSuite: public CppUnit::TestFixture
+{
+
+public:
+    RwSectionSuite();
+
+    virtual ~RwSectionSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(RwSectionSuite);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testLock00);
+    //CPPUNIT_TEST(testPerf00);
+    CPPUNIT_TEST_SUITE_END();
+
+    RwSectionSuite(const RwSectionSuite&); //prohibit usage
+    const RwSectionSuite& operator =(const RwSectionSuite&); //prohibit usage
+
+    void testCtor00();
+    void testLock00();
+    //void testPerf00();
+
+    static void* entry00(void*);
+    static void* entry01(void*);
+    //static void* entry02(void*);
+
+};
+
+#endif
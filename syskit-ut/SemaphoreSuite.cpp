@@ -161,6 +161,29 @@ void SemaphoreSuite::testDecrement01()
 }
 
 
+//
+// Waiters wanting multiple tokens must not miss tokens released one at a time.
+//
+void SemaphoreSuite::testDecrement02()
+{
+    Semaphore sem(0U /*capacity*/);
+    Thread thread(entry02, &sem);
+    for (unsigned int i = 0; i < 3 * 1000; ++i)
+    {
+        sem.increment();
+        if ((i % 64) == 0)
+        {
+            Thread::yield();
+        }
+    }
+
+    void* exitCode = 0;
+    thread.waitTilDone(&exitCode);
+    bool ok = (exitCode != 0) && (!sem.tryDecrement());
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void SemaphoreSuite::testDetach00()
 {
     Xema4 xem0(123U);
@@ -322,3 +345,20 @@ void* SemaphoreSuite::entry01(void* arg)
     bool ok = sem->waitTilNonEmpty();
     return ok? sem: 0;
 }
+
+
+void* SemaphoreSuite::entry02(void* arg)
+{
+    Semaphore* sem = static_cast<Semaphore*>(arg);
+    bool ok = true;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        if (!sem->decrementBy(3, 5000 /*waitTimeInMsecs*/))
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    return ok? sem: 0;
+}
@@ -18,6 +18,7 @@ private:
     CPPUNIT_TEST(testCtor01);
     CPPUNIT_TEST(testDecrement00);
     CPPUNIT_TEST(testDecrement01);
+    CPPUNIT_TEST(testDecrement02);
     CPPUNIT_TEST(testDetach00);
     CPPUNIT_TEST(testLock00);
     CPPUNIT_TEST(testLock01);
@@ -30,6 +31,7 @@ private:
     void testCtor01();
     void testDecrement00();
     void testDecrement01();
+    void testDecrement02();
     void testDetach00();
     void testLock00();
     void testLock01();
@@ -39,6 +41,7 @@ private:
 
     static void* entry00(void*);
     static void* entry01(void*);
+    static void* entry02(void*);
 
 };
 
@@ -0,0 +1,125 @@
+#include "syskit/SeqLock.hpp"
+#include "syskit/Thread.hpp"
+
+#include "syskit-ut-pch.h"
+#include "SeqLockSuite.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    SeqLock sl;
+    unsigned int u32[8];
+    unsigned int numLoops;
+} sample_t;
+
+END_NAMESPACE
+
+
+SeqLockSuite::SeqLockSuite()
+{
+}
+
+
+SeqLockSuite::~SeqLockSuite()
+{
+}
+
+
+//
+// Reader. Snapshots should never be partially updated.
+//
+void* SeqLockSuite::entry00(void* arg)
+{
+    sample_t* sample = static_cast<sample_t*>(arg);
+    bool ok = true;
+    unsigned int u32[8];
+    for (unsigned int i = 0; i < sample->numLoops; ++i)
+    {
+        sample->sl.read(u32, sample->u32, sizeof(u32));
+        for (unsigned int j = 1; j < 8; ++j)
+        {
+            if (u32[j] != u32[0])
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    return ok? sample: 0;
+}
+
+
+void SeqLockSuite::testRead00()
+{
+    SeqLock sl;
+    bool ok = (sl.seq() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    unsigned long long data = 0;
+    unsigned long long v = 0x123456789abcdef0ULL;
+    sl.write(&data, &v, sizeof(v));
+    ok = (data == v) && (sl.seq() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    unsigned long long snapshot = 0;
+    sl.read(&snapshot, &data, sizeof(data));
+    ok = (snapshot == v) && (sl.seq() == 2);
+    CPPUNIT_ASSERT(ok);
+
+    // A read overlapping an update must be retried.
+    unsigned int seq = sl.beginRead();
+    {
+        SeqLock::WriteLock lock(sl);
+        ok = ((sl.seq() & 1) != 0);
+        CPPUNIT_ASSERT(ok);
+        ++data;
+    }
+    ok = (!sl.endRead(seq)) && sl.endRead(sl.beginRead());
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void SeqLockSuite::testRead01()
+{
+    sample_t sample;
+    sample.numLoops = 100000;
+    memset(sample.u32, 0, sizeof(sample.u32));
+
+    enum
+    {
+        NumReaders = 4
+    };
+    Thread* thread[NumReaders];
+    for (unsigned int i = 0; i < NumReaders; ++i)
+    {
+        thread[i] = new Thread(entry00, &sample);
+    }
+
+    // Keep updating while the readers are reading.
+    unsigned int u32[8];
+    for (unsigned int i = 1; i <= sample.numLoops; ++i)
+    {
+        for (unsigned int j = 0; j < 8; u32[j++] = i);
+        sample.sl.write(sample.u32, u32, sizeof(u32));
+    }
+
+    bool ok = true;
+    for (unsigned int i = 0; i < NumReaders; ++i)
+    {
+        void* exitCode = 0;
+        thread[i]->waitTilDone(&exitCode);
+        if (exitCode != &sample)
+        {
+            ok = false;
+        }
+        delete thread[i];
+    }
+    CPPUNIT_ASSERT(ok);
+
+    ok = (sample.u32[7] == sample.numLoops) && (sample.sl.seq() == sample.numLoops * 2);
+    CPPUNIT_ASSERT(ok);
+}
@@ -0,0 +1,31 @@
+#ifndef SEQ_LOCK_SUITE_HPP
+#define SEQ_LOCK_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class SeqLockSuite: public CppUnit::TestFixture
+{
+
+public:
+    SeqLockSuite();
+
+    virtual ~SeqLockSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(SeqLockSuite);
+    CPPUNIT_TEST(testRead00);
+    CPPUNIT_TEST(testRead01);
+    CPPUNIT_TEST_SUITE_END();
+
+    SeqLockSuite(const SeqLockSuite&); //prohibit usage
+    const SeqLockSuite& operator =(const SeqLockSuite&); //prohibit usage
+
+    void testRead00();
+    void testRead01();
+
+    static void* entry00(void*);
+
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include <cstring>
+#include "syskit/Atomic32.hpp"
+#include "syskit/ThreadPool.hpp"
+
+#include "syskit-ut-pch.h"
+#include "ThreadPoolSuite.hpp"
+
+using namespace syskit;
+
+BEGIN_NAMESPACE
+
+// Recursive sum of [lo, hi) using nested groups.
+typedef struct
+{
+    ThreadPool* pool;
+    unsigned long long lo;
+    unsigned long long hi;
+    unsigned long long sum;
+} sum_t;
+
+END_NAMESPACE
+
+
+ThreadPoolSuite::ThreadPoolSuite()
+{
+}
+
+
+ThreadPoolSuite::~ThreadPoolSuite()
+{
+}
+
+
+void ThreadPoolSuite::count(void* arg)
+{
+    Atomic32* numCalls = static_cast<Atomic32*>(arg);
+    ++*numCalls;
+}
+
+
+//
+// Visit each index in given range once.
+//
+void ThreadPoolSuite::countRange(void* arg, size_t loIndex, size_t hiIndex)
+{
+    unsigned char* visitCount = static_cast<unsigned char*>(arg);
+    for (size_t i = loIndex; i < hiIndex; ++visitCount[i++]);
+}
+
+
+void ThreadPoolSuite::sum(void* arg)
+{
+    sum_t* p = static_cast<sum_t*>(arg);
+    if ((p->hi - p->lo) <= 64)
+    {
+        p->sum = 0;
+        for (unsigned long long i = p->lo; i < p->hi; p->sum += i++);
+        return;
+    }
+
+    // Split in halves and wait for both. Waiting executes queued tasks,
+    // so deep nesting does not exhaust the workers.
+    unsigned long long mid = p->lo + (p->hi - p->lo) / 2;
+    sum_t lower = {p->pool, p->lo, mid, 0};
+    sum_t upper = {p->pool, mid, p->hi, 0};
+    ThreadPool::Group group(*p->pool);
+    group.run(sum, &lower);
+    group.run(sum, &upper);
+    group.wait();
+    p->sum = lower.sum + upper.sum;
+}
+
+
+void ThreadPoolSuite::testApply00()
+{
+    ThreadPool pool(4);
+    const size_t NumItems = 100001;
+    unsigned char* visitCount = new unsigned char[NumItems];
+    memset(visitCount, 0, NumItems);
+    pool.apply(NumItems, countRange, visitCount);
+
+    bool ok = true;
+    for (size_t i = 0; i < NumItems; ++i)
+    {
+        if (visitCount[i] != 1)
+        {
+            ok = false;
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    // Explicit grain size.
+    pool.apply(NumItems, countRange, visitCount, 1000 /*grainSize*/);
+    ok = (visitCount[0] == 2) && (visitCount[NumItems - 1] == 2);
+    CPPUNIT_ASSERT(ok);
+
+    // No items.
+    pool.apply(0, countRange, visitCount);
+    ok = (visitCount[0] == 2);
+    CPPUNIT_ASSERT(ok);
+
+    delete[] visitCount;
+}
+
+
+void ThreadPoolSuite::testCtor00()
+{
+    ThreadPool pool0;
+    bool ok = pool0.isOk() && (pool0.numWorkers() == ThreadPool::numCpus()) && (!pool0.isWorker());
+    CPPUNIT_ASSERT(ok);
+
+    bool pinWorkers = true;
+    ThreadPool pool1(3, pinWorkers);
+    ok = pool1.isOk() && (pool1.numWorkers() == 3) && (pool1.numTasks() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    ThreadPool& pool2 = ThreadPool::instance();
+    ok = pool2.isOk() && (&ThreadPool::instance() == &pool2);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+void ThreadPoolSuite::testGroup00()
+{
+    ThreadPool pool(4);
+    Atomic32 numCalls(0U);
+    {
+        ThreadPool::Group group(pool);
+        for (unsigned int i = 0; i < 1000; ++i)
+        {
+            group.run(count, &numCalls);
+        }
+        group.wait();
+        bool ok = (numCalls == 1000) && (group.numPendingTasks() == 0);
+        CPPUNIT_ASSERT(ok);
+
+        // The destructor also waits.
+        group.run(count, &numCalls);
+    }
+
+    bool ok = (numCalls == 1001);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Nested groups.
+//
+void ThreadPoolSuite::testGroup01()
+{
+    ThreadPool pool(2);
+    sum_t s = {&pool, 0, 100000, 0};
+    sum(&s);
+    bool ok = (s.sum == 100000ULL * 99999ULL / 2);
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Submitted tasks are executed before the pool is destructed.
+//
+void ThreadPoolSuite::testSubmit00()
+{
+    Atomic32 numCalls(0U);
+    {
+        ThreadPool pool(2);
+        for (unsigned int i = 0; i < 500; ++i)
+        {
+            pool.submit(count, &numCalls);
+        }
+    }
+
+    bool ok = (numCalls == 500);
+    CPPUNIT_ASSERT(ok);
+}
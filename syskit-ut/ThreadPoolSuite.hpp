@@ -0,0 +1,39 @@
+#ifndef THREAD_POOL_SUITE_HPP
+#define THREAD_POOL_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class ThreadPoolSuite: public CppUnit::TestFixture
+{
+
+public:
+    ThreadPoolSuite();
+
+    virtual ~ThreadPoolSuite();
+
+private:
+    CPPUNIT_TEST_SUITE(ThreadPoolSuite);
+    CPPUNIT_TEST(testApply00);
+    CPPUNIT_TEST(testCtor00);
+    CPPUNIT_TEST(testGroup00);
+    CPPUNIT_TEST(testGroup01);
+    CPPUNIT_TEST(testSubmit00);
+    CPPUNIT_TEST_SUITE_END();
+
+    ThreadPoolSuite(const ThreadPoolSuite&); //prohibit usage
+    const ThreadPoolSuite& operator =(const ThreadPoolSuite&); //prohibit usage
+
+    void testApply00();
+    void testCtor00();
+    void testGroup00();
+    void testGroup01();
+    void testSubmit00();
+
+    static void count(void*);
+    static void countRange(void*, size_t, size_t);
+    static void sum(void*);
+
+};
+
+#endif
@@ -1,4 +1,6 @@
+#include <utility>
 #include "appkit/U32.hpp"
+#include "syskit/ThreadPool.hpp"
 #include "syskit/Tree.hpp"
 
 #include "syskit-ut-pch.h"
@@ -61,6 +63,17 @@ void TreeSuite::deleteItem(void* /*arg*/, void* item)
 }
 
 
+//
+// Count a visit to given item in the visit counts in arg. Items are unique,
+// so parallel partitions never update the same count.
+//
+void TreeSuite::markItem(void* arg, void* /*partial*/, void* item)
+{
+    unsigned char* numVisits = static_cast<unsigned char*>(arg);
+    ++numVisits[*static_cast<const unsigned int*>(item)];
+}
+
+
 //
 // Interfaces under test:
 // - bool Tree::add(void* item);
@@ -232,6 +245,52 @@ void TreeSuite::testApply00()
 }
 
 
+//
+// Interfaces under test:
+// - void Tree::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const;
+// Items above the cut and items in the subtrees below it should each be
+// visited exactly once, also in a tree thinned out by removals.
+//
+void TreeSuite::testApplyParallel00()
+{
+
+    // Add items in scrambled order, then remove every third one.
+    const unsigned int numItems = 1000;
+    Tree tree(U32::compareP);
+    for (unsigned int i = 0; i < numItems; ++i)
+    {
+        tree.add(new unsigned int((i * 7919U) % numItems + 1));
+    }
+    for (unsigned int i = 3; i <= numItems; i += 3)
+    {
+        Tree::item_t removedItem;
+        if (tree.rm(&i, U32::compareP, removedItem))
+        {
+            deleteItem(0, removedItem);
+        }
+    }
+
+    bool ok = (tree.numItems() == numItems - numItems / 3);
+    ThreadPool pool(4 /*numWorkers*/);
+    for (unsigned int withPool = 0; ok && (withPool <= 1); ++withPool)
+    {
+        unsigned char numVisits[numItems + 1] = {0};
+        tree.applyParallel(markItem, numVisits, 0 /*open*/, 0 /*close*/, withPool? &pool: 0);
+        for (unsigned int i = 0; i <= numItems; ++i)
+        {
+            if (numVisits[i] != (((i == 0) || (i % 3 == 0))? 0: 1))
+            {
+                ok = false;
+                break;
+            }
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+
+    tree.apply(deleteItem);
+}
+
+
 void TreeSuite::testCtor00()
 {
     Tree::compare_t compare = 0;
@@ -305,6 +364,45 @@ void TreeSuite::testCtor01()
 }
 
 
+//
+// Interfaces under test:
+// - Tree::Tree(Tree&& that);
+// - const Tree& Tree::operator =(Tree&& that);
+//
+void TreeSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+
+    // Add random items.
+    Tree tree0(U32::compareP);
+    for (const char* p = ITEMS + NUM_ITEMS - 1; p >= ITEMS; --p)
+    {
+        for (unsigned int u32 = *p; u32 != 0; u32 <<= 1)
+        {
+            unsigned int* item = new unsigned int(u32);
+            if (!tree0.add(item))
+            {
+                delete item;
+            }
+        }
+    }
+
+    Tree tree1(tree0);
+    Tree tree2(std::move(tree1));
+    bool ok = (tree2 == tree0) && (tree1.numItems() == 0) && (tree2.cmpFunc() == U32::compareP);
+    CPPUNIT_ASSERT(ok);
+
+    tree1 = std::move(tree2);
+    ok = (tree1 == tree0) && (tree2.numItems() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    tree1 = std::move(tree0);
+    tree1.apply(deleteItem, 0 /*arg*/);
+    tree1.reset();
+#endif
+}
+
+
 //
 // Interfaces under test:
 // - void Tree::operator delete(void* p, size_t size);
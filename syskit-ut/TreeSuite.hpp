@@ -17,8 +17,10 @@ private:
     CPPUNIT_TEST(testAdd00);
     CPPUNIT_TEST(testAdd01);
     CPPUNIT_TEST(testApply00);
+    CPPUNIT_TEST(testApplyParallel00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testNew00);
     CPPUNIT_TEST(testRm00);
     CPPUNIT_TEST(testSize00);
@@ -30,8 +32,10 @@ private:
     void testAdd00();
     void testAdd01();
     void testApply00();
+    void testApplyParallel00();
     void testCtor00();
     void testCtor01();
+    void testMove00();
     void testNew00();
     void testRm00();
     void testSize00();
@@ -39,6 +43,7 @@ private:
     static bool checkItem(void*, void*);
     static bool rmItem(void*, void*);
     static void deleteItem(void*, void*);
+    static void markItem(void*, void*, void*);
 
 };
 
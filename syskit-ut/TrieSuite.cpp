@@ -1,3 +1,4 @@
+#include "syskit/ThreadPool.hpp"
 #include "syskit/Trie.hpp"
 
 #include "syskit-ut-pch.h"
@@ -5,6 +6,8 @@
 
 using namespace syskit;
 
+const unsigned int KEY_STEP = 7919;
+
 
 TrieSuite::TrieSuite()
 {
@@ -32,6 +35,41 @@ void TrieSuite::deleteV(void* /*arg*/, const unsigned char* /*k*/, void* v)
 }
 
 
+//
+// Reduction hooks for parallel traversals. A partial result counts the
+// key-value pairs visited and those whose key does not match the value.
+// Each value v was added with key v*KEY_STEP. The totals reside in arg.
+//
+void TrieSuite::checkKv(void* /*arg*/, void* partial, const unsigned char* k, void* v)
+{
+    unsigned int* count = static_cast<unsigned int*>(partial);
+    ++count[0];
+    if (Trie::U32Key::decode(k) != reinterpret_cast<size_t>(v) * KEY_STEP)
+    {
+        ++count[1];
+    }
+}
+
+
+void TrieSuite::closeCount(void* arg, void* partial)
+{
+    unsigned int* total = static_cast<unsigned int*>(arg);
+    unsigned int* count = static_cast<unsigned int*>(partial);
+    total[0] += count[0];
+    total[1] += count[1];
+    delete[] count;
+}
+
+
+void* TrieSuite::openCount(void* /*arg*/)
+{
+    unsigned int* count = new unsigned int[2];
+    count[0] = 0;
+    count[1] = 0;
+    return count;
+}
+
+
 void TrieSuite::rmKv(void* arg, const unsigned char* k, void* v)
 {
     Trie& trie = *static_cast<Trie*>(arg);
@@ -224,6 +262,34 @@ void TrieSuite::testAdd02()
 }
 
 
+//
+// Interfaces under test:
+// - void Trie::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const;
+// Each key-value pair should be visited once with its full key, although
+// partitions start below the root.
+//
+void TrieSuite::testApplyParallel00()
+{
+    const unsigned int numKvPairs = 1000;
+    Trie trie;
+    for (size_t i = 1; i <= numKvPairs; ++i)
+    {
+        Trie::U32Key k(static_cast<unsigned int>(i * KEY_STEP));
+        trie.add(k, reinterpret_cast<void*>(i));
+    }
+
+    bool ok = true;
+    ThreadPool pool(4 /*numWorkers*/);
+    for (unsigned int withPool = 0; ok && (withPool <= 1); ++withPool)
+    {
+        unsigned int total[2] = {0, 0};
+        trie.applyParallel(checkKv, total, openCount, closeCount, withPool? &pool: 0);
+        ok = (total[0] == numKvPairs) && (total[1] == 0);
+    }
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void TrieSuite::testCtor00()
 {
     Trie trie;
@@ -17,6 +17,7 @@ private:
     CPPUNIT_TEST(testAdd00);
     CPPUNIT_TEST(testAdd01);
     CPPUNIT_TEST(testAdd02);
+    CPPUNIT_TEST(testApplyParallel00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testFind00);
     CPPUNIT_TEST(testKey00);
@@ -40,6 +41,7 @@ private:
     void testAdd00();
     void testAdd01();
     void testAdd02();
+    void testApplyParallel00();
     void testCtor00();
     void testFind00();
     void testKey00();
@@ -57,8 +59,11 @@ private:
     void testSize00();
 
     static bool validateOrder(void*, const unsigned char*, void*);
+    static void checkKv(void*, void*, const unsigned char*, void*);
+    static void closeCount(void*, void*);
     static void deleteV(void*, const unsigned char*, void*);
     static void rmKv(void*, const unsigned char*, void*);
+    static void* openCount(void*);
 
 };
 
@@ -1,3 +1,4 @@
+#include <utility>
 #include "syskit/U32Vec.hpp"
 
 #include "syskit-ut-pch.h"
@@ -353,6 +354,35 @@ void U32VecSuite::testFindKthSmallest00()
 }
 
 
+//
+// Interfaces under test:
+// - U32Vec::U32Vec(U32Vec&& that);
+// - const U32Vec& U32Vec::operator =(U32Vec&& that);
+//
+void U32VecSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+    Sample1 vec1;
+    U32Vec vec0(vec1);
+
+    U32Vec vec(std::move(vec1));
+    bool ok = (vec1.numItems() == 0) && (vec == vec0);
+    CPPUNIT_ASSERT(ok);
+    ok = vec1.add(123) && (vec1.numItems() == 1) && (vec1[0] == 123); //moved-from instance is reusable
+    CPPUNIT_ASSERT(ok);
+
+    U32Vec vec2(vec0);
+    vec2 = std::move(vec);
+    ok = (vec.numItems() == 0) && (vec2 == vec0);
+    CPPUNIT_ASSERT(ok);
+
+    vec = std::move(vec2);
+    ok = (vec2.numItems() == 0) && (vec == vec0) && vec2.add(123);
+    CPPUNIT_ASSERT(ok);
+#endif
+}
+
+
 //
 // Assignment operator. No growing required.
 //
@@ -22,6 +22,7 @@ private:
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testFind00);
     CPPUNIT_TEST(testFindKthSmallest00);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
     CPPUNIT_TEST(testOp02);
@@ -43,6 +44,7 @@ private:
     void testCtor00();
     void testFind00();
     void testFindKthSmallest00();
+    void testMove00();
     void testOp00();
     void testOp01();
     void testOp02();
@@ -1,4 +1,5 @@
 #include <string>
+#include <utility>
 #include "appkit/U16.hpp"
 #include "syskit/Utf16.hpp"
 #include "syskit/Utf16Seq.hpp"
@@ -393,6 +394,56 @@ void Utf16SeqSuite::testConvert04()
 }
 
 
+//
+// Convert from UTF8. Compare against a per-character conversion of random
+// data having ASCII runs and multi-byte characters of all lengths.
+//
+void Utf16SeqSuite::testConvert05()
+{
+    const utf32_t SOME_CHARS[] = {'a', 0x7fU, 0x80U, 0x7ffU, 0x800U, 0xd7ffU, 0xe000U, 0xffffU, 0x10000U, 0x10ffffU};
+    utf32_t chars[200];
+    bool ok = true;
+    unsigned int seed = 1;
+    for (unsigned int i = 0; ok && (i < 5000); ++i)
+    {
+        size_t numChars = 0;
+        while (numChars < 180)
+        {
+            seed = seed * 1103515245U + 12345U;
+            unsigned int r = seed >> 16;
+            if ((r % 4) == 0)
+            {
+                for (size_t n = r % 40; (n > 0) && (numChars < 180); --n) chars[numChars++] = 'A' + n % 26;
+            }
+            else
+            {
+                chars[numChars++] = SOME_CHARS[r % 10];
+            }
+        }
+        numChars -= (seed >> 8) % 8;
+
+        Utf8Seq seq8;
+        seq8.shrink(chars, numChars);
+        Utf16Seq seqA;
+        seqA.shrink(chars, numChars);
+        Utf16Seq seqB;
+        ok = (seqB.convert8(seq8.raw(), seq8.byteSize()) == 0) && (seqB == seqA) && (seqB.numChars() == numChars);
+        seqB.reset(seq8.raw(), seq8.byteSize(), seq8.numChars());
+        ok = ok && (seqB == seqA);
+
+        // Invalid data takes the slow path.
+        if (ok && (seq8.byteSize() > 0))
+        {
+            utf8_t* raw8 = seq8.detachRaw();
+            raw8[(seed >> 4) % numChars] = 0xffU;
+            ok = (seqB.convert8(raw8, numChars) > 0);
+            delete[] raw8;
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void Utf16SeqSuite::testCountChars00()
 {
     unsigned int numChars = 0x12345678U;
@@ -506,6 +557,38 @@ void Utf16SeqSuite::testIsValid00()
 }
 
 
+//
+// Interfaces under test:
+// - Utf16Seq::Utf16Seq(Utf16Seq&& seq);
+// - const Utf16Seq& Utf16Seq::operator =(Utf16Seq&& seq);
+//
+void Utf16SeqSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+    Utf8Seq seq8("abcdefghijklmnopqrstuvwxyz", 26);
+    Utf16Seq seq1;
+    seq1.reset(seq8.raw(), seq8.byteSize(), seq8.numChars());
+    Utf16Seq seq0(seq1);
+    const utf16_t* raw = seq1.raw();
+
+    Utf16Seq seq(std::move(seq1));
+    bool ok = (seq == seq0) && (seq.raw() == raw) && (seq1.numChars() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    Utf16Seq seq2(16U);
+    seq2 = std::move(seq);
+    ok = (seq2 == seq0) && (seq2.raw() == raw) && (seq2.capacity() == seq0.capacity()) && (seq.numChars() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    // Moved-from instances are reusable.
+    seq1.reset(seq8.raw(), seq8.byteSize(), seq8.numChars());
+    seq = seq1;
+    ok = (seq1 == seq0) && (seq == seq0);
+    CPPUNIT_ASSERT(ok);
+#endif
+}
+
+
 //
 // Iterate left to right.
 //
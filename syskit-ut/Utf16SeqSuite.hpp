@@ -30,12 +30,14 @@ private:
     CPPUNIT_TEST(testConvert02);
     CPPUNIT_TEST(testConvert03);
     CPPUNIT_TEST(testConvert04);
+    CPPUNIT_TEST(testConvert05);
     CPPUNIT_TEST(testCountChars00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
     CPPUNIT_TEST(testCtor02);
     CPPUNIT_TEST(testCtor03);
     CPPUNIT_TEST(testIsValid00);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testNext00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
@@ -64,12 +66,14 @@ private:
     void testConvert02();
     void testConvert03();
     void testConvert04();
+    void testConvert05();
     void testCountChars00();
     void testCtor00();
     void testCtor01();
     void testCtor02();
     void testCtor03();
     void testIsValid00();
+    void testMove00();
     void testNext00();
     void testOp00();
     void testOp01();
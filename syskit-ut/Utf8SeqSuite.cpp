@@ -1,4 +1,5 @@
 #include <string>
+#include <utility>
 #include "appkit/U16.hpp"
 #include "syskit/Utf16Seq.hpp"
 #include "syskit/Utf8.hpp"
@@ -14,6 +15,7 @@ class MyString: public syskit::Utf8Seq
 {
 public:
     MyString();
+    bool seekIsOk() const;
     using Utf8Seq::addNull;
     using Utf8Seq::addNullIfNone;
     using Utf8Seq::rmNull;
@@ -30,6 +32,21 @@ MyString::~MyString()
 {
 }
 
+// Return true if seek() agrees with a walk from the beginning.
+bool MyString::seekIsOk() const
+{
+    bool ok = true;
+    const syskit::utf8_t* p = raw();
+    for (size_t i = 0; ok && (i < numChars()); ++i)
+    {
+        ok = (seek(i) == p);
+        p += syskit::Utf8::getSeqLength(*p);
+    }
+
+    ok = ok && (seek(numChars()) == p);
+    return ok;
+}
+
 END_NAMESPACE
 
 using namespace appkit;
@@ -83,6 +100,30 @@ Utf8SeqSuite::~Utf8SeqSuite()
 }
 
 
+//
+// Return true if Utf8Seq::isValid() and Utf8Seq::countChars() agree with
+// a per-character scan of given UTF8 byte sequence.
+//
+bool Utf8SeqSuite::agree(const utf8_t* s, size_t numU8s)
+{
+    const utf8_t* p = s;
+    size_t count = 0;
+    for (size_t remaining = numU8s; (remaining > 0) && Utf8::isValid(p, remaining); ++count)
+    {
+        size_t charLength = Utf8::getSeqLength(*p);
+        p += charLength;
+        remaining -= charLength;
+    }
+
+    const utf8_t* badSeq = 0;
+    bool isValid = Utf8Seq::isValid(s, numU8s, &badSeq);
+    unsigned int numChars = 0;
+    bool ok = (Utf8Seq::countChars(s, numU8s, numChars) == isValid) && (numChars == count);
+    ok = ok && (isValid? (p == s + numU8s): (badSeq == p));
+    return ok;
+}
+
+
 bool Utf8SeqSuite::cb0a(void* arg, size_t index, utf32_t c)
 {
     size_t& i = *static_cast<size_t *>(arg);
@@ -462,6 +503,95 @@ void Utf8SeqSuite::testConvert03()
 }
 
 
+//
+// Convert from UTF16. Compare against a per-character conversion of random
+// data having ASCII runs, other BMP characters, surrogate pairs, and some
+// invalid codes.
+//
+void Utf8SeqSuite::testConvert04()
+{
+    const utf16_t SOME_U16S[] = {'a', 0x7fU, 0x80U, 0x7ffU, 0x800U, 0xd7ffU, 0xe000U, 0xffffU};
+    utf16_t u16[200];
+    utf16_t u61[200];
+    utf32_t expected[200];
+    bool ok = true;
+    unsigned int seed = 1;
+    for (unsigned int i = 0; ok && (i < 5000); ++i)
+    {
+        size_t numU16s = 0;
+        while (numU16s < 180)
+        {
+            seed = seed * 1103515245U + 12345U;
+            unsigned int r = seed >> 16;
+            switch (r % 10)
+            {
+            case 0:
+            case 1:
+                for (size_t n = r % 40; (n > 0) && (numU16s < 180); --n) u16[numU16s++] = static_cast<utf16_t>('A' + n % 26);
+                break;
+            case 2:
+                u16[numU16s++] = static_cast<utf16_t>(0xd800U + r % 0x400U);
+                u16[numU16s++] = static_cast<utf16_t>(0xdc00U + (r >> 3) % 0x400U);
+                break;
+            case 3:
+                u16[numU16s++] = ((i % 4) != 0)? 'b': (((r & 1) != 0)? 0xdc00U: 0xdbffU);
+                break;
+            default:
+                u16[numU16s++] = SOME_U16S[r % 8];
+                break;
+            }
+        }
+        numU16s -= (seed >> 8) % 8;
+
+        size_t numChars = 0;
+        unsigned int numInvalids = 0;
+        for (size_t k = 0; k < numU16s; ++numChars)
+        {
+            utf16_t c = u16[k];
+            if ((c < Utf16::HiHalfMin) || (c > Utf16::LoHalfMax))
+            {
+                expected[numChars] = c;
+                ++k;
+            }
+            else if ((k + 1 < numU16s) && (c <= Utf16::HiHalfMax) && (u16[k + 1] >= Utf16::LoHalfMin) && (u16[k + 1] <= Utf16::LoHalfMax))
+            {
+                expected[numChars] = Utf16::convertSurrogate(u16 + k);
+                k += 2;
+            }
+            else
+            {
+                expected[numChars] = DEFAULT_CHAR;
+                ++numInvalids;
+                k += 2;
+            }
+        }
+        for (size_t k = 0; k < numU16s; u61[k] = bswap16(u16[k]), ++k);
+
+        Utf8Seq seqA;
+        Utf8Seq seqB;
+        unsigned int n = 0;
+        ok = (seqA.convert16(u16, numU16s, DEFAULT_CHAR) == numInvalids) &&
+            (seqB.convert61(u61, numU16s, DEFAULT_CHAR) == numInvalids) &&
+            (seqA == seqB) &&
+            (seqA.numChars() == numChars) &&
+            Utf8Seq::countChars(seqA.raw(), seqA.byteSize(), n) &&
+            (n == numChars);
+        utf32_t* s = seqA.expand();
+        ok = ok && (memcmp(s, expected, numChars * sizeof(*s)) == 0);
+        delete[] s;
+
+        if (ok && (numInvalids == 0))
+        {
+            seqB.reset(u16, numU16s, numChars);
+            ok = (seqB == seqA);
+            seqB.reset(u16, 0, numChars);
+            ok = ok && (seqB == seqA);
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void Utf8SeqSuite::testCountChars00()
 {
     unsigned int numChars = 1234567;
@@ -679,6 +809,92 @@ void Utf8SeqSuite::testIsValid00()
 }
 
 
+//
+// The bulk ASCII path and the state machine must agree with a per-character
+// scan, including the reported failure location. Exhaustively check 2-byte
+// combinations followed by ASCII or by subsequent bytes, and randomly check
+// mixed sequences, all embedded at varying offsets in ASCII runs.
+//
+void Utf8SeqSuite::testIsValid01()
+{
+    utf8_t buf[160];
+    memset(buf, 'a', sizeof(buf));
+    bool ok = true;
+    for (unsigned int i = 0; ok && (i <= 0x1ffffU); ++i)
+    {
+        size_t at = (i * 7) % 140;
+        buf[at] = static_cast<utf8_t>(i >> 8);
+        buf[at + 1] = static_cast<utf8_t>(i);
+        buf[at + 2] = (i > 0xffffU)? static_cast<utf8_t>(0x80U | (i % 64)): 'a';
+        buf[at + 3] = (i > 0xffffU)? 0xbfU: 'a';
+        ok = agree(buf, at + 2 + (i % 19));
+        memset(buf + at, 'a', 4);
+    }
+    CPPUNIT_ASSERT(ok);
+
+    unsigned int seed = 1;
+    for (unsigned int i = 0; ok && (i < 20000); ++i)
+    {
+        size_t n = 0;
+        while (n + Utf8::MaxSeqLength <= sizeof(buf))
+        {
+            seed = seed * 1103515245U + 12345U;
+            unsigned int r = seed >> 8;
+            switch (r % 8)
+            {
+            case 0:
+                buf[n++] = static_cast<utf8_t>(r >> 3); //random byte
+                break;
+            case 1:
+            case 2:
+            case 3:
+                n += Utf8((r >> 3) % (Utf8::MaxChar + 1)).encode(buf + n);
+                break;
+            default:
+                for (size_t m = n + (r >> 3) % 40; (n < m) && (n < sizeof(buf)); buf[n++] = 'a');
+                break;
+            }
+        }
+        ok = agree(buf, n - (seed >> 30));
+    }
+    CPPUNIT_ASSERT(ok);
+}
+
+
+//
+// Interfaces under test:
+// - Utf8Seq::Utf8Seq(Utf8Seq&& seq);
+// - const Utf8Seq& Utf8Seq::operator =(Utf8Seq&& seq);
+//
+void Utf8SeqSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+    const char s[] = "abcdefghijklmnopqrstuvwxyz";
+    Utf8Seq seq1(s, sizeof(s));
+    Utf8Seq seq0(seq1);
+    const utf8_t* raw = seq1.raw();
+
+    Utf8Seq seq(std::move(seq1));
+    bool ok = (seq == seq0) && (seq.raw() == raw) && (seq.capacity() == seq0.capacity()) && (seq1.numChars() == 0);
+    CPPUNIT_ASSERT(ok);
+
+    Utf8Seq seq2(16U);
+    seq2 = std::move(seq);
+    ok = (seq2 == seq0) && (seq2.raw() == raw) && (seq2.capacity() == seq0.capacity()) && (seq.byteSize() == 0);
+    CPPUNIT_ASSERT(ok);
+    seq2 += 'z';
+    ok = (seq2.byteSize() == sizeof(s) + 1);
+    CPPUNIT_ASSERT(ok);
+
+    // Moved-from instances are reusable.
+    seq1 += 'a';
+    seq += seq0;
+    ok = (seq1.numChars() == 1) && (seq1[0] == 'a') && (seq == seq0);
+    CPPUNIT_ASSERT(ok);
+#endif
+}
+
+
 //
 // Iterate left to right.
 //
@@ -1200,6 +1416,65 @@ void Utf8SeqSuite::testSeek00()
 }
 
 
+//
+// Interfaces under test:
+// - const utf8_t* seek(size_t index) const;
+// Long non-ASCII sequences are indexed. Make sure the index remains valid
+// as the sequence grows, shrinks, and is overwritten.
+//
+void Utf8SeqSuite::testSeek01()
+{
+    const unsigned int C[] = {'a', 0xe9U, 0x4e2dU, 0x1f600U, 'b', 'c'};
+    MyString str;
+    for (unsigned int i = 0; i < 3000; ++i)
+    {
+        str += Utf8(C[i % 6]);
+    }
+    bool ok = (str.numChars() == 3000) && str.seekIsOk();
+    CPPUNIT_ASSERT(ok);
+
+    ok = str.truncate(1000) && (str.numChars() == 1000) && str.seekIsOk();
+    CPPUNIT_ASSERT(ok);
+    for (unsigned int i = 0; i < 4000; ++i)
+    {
+        str += Utf8(C[(i * 5) % 6]);
+    }
+    ok = (str.numChars() == 5000) && str.seekIsOk();
+    CPPUNIT_ASSERT(ok);
+
+    // Entries beyond a truncation point must not survive regrowth.
+    str.truncate(700);
+    str.append(300, 'x');
+    ok = (str.numChars() == 1000) && str.seekIsOk();
+    CPPUNIT_ASSERT(ok);
+    str.truncate(960);
+    str.addNull();
+    ok = str.seekIsOk();
+    CPPUNIT_ASSERT(ok);
+    str.rmNull();
+    str += Utf8(0x1f600U);
+    ok = (str.numChars() == 961) && str.seekIsOk();
+    CPPUNIT_ASSERT(ok);
+
+    // The index is extended as the sequence grows between seeks.
+    for (unsigned int i = 0; ok && (i < 1000); ++i)
+    {
+        str += Utf8(C[(i * 5) % 6]);
+        ok = ((i % 97) != 0) || str.seekIsOk();
+    }
+    CPPUNIT_ASSERT(ok);
+
+    Utf8Seq seq;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        seq += Utf8(C[(i * 7 + 3) % 6]);
+    }
+    str.reset(seq, 0, seq.numChars());
+    ok = str.seekIsOk() && (str[1999] == seq[1999]) && (str.getByteSize(500, 1000) == seq.getByteSize(500, 1000));
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void Utf8SeqSuite::testShrink00()
 {
     Utf8Seq seq0;
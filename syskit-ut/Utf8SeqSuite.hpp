@@ -32,6 +32,7 @@ private:
     CPPUNIT_TEST(testConvert01);
     CPPUNIT_TEST(testConvert02);
     CPPUNIT_TEST(testConvert03);
+    CPPUNIT_TEST(testConvert04);
     CPPUNIT_TEST(testCountChars00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
@@ -40,6 +41,8 @@ private:
     CPPUNIT_TEST(testCtor04);
     CPPUNIT_TEST(testDetachRaw00);
     CPPUNIT_TEST(testIsValid00);
+    CPPUNIT_TEST(testIsValid01);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testNext00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
@@ -59,6 +62,7 @@ private:
     CPPUNIT_TEST(testReset03);
     CPPUNIT_TEST(testResize00);
     CPPUNIT_TEST(testSeek00);
+    CPPUNIT_TEST(testSeek01);
     CPPUNIT_TEST(testShrink00);
     CPPUNIT_TEST(testTruncate00);
     CPPUNIT_TEST_SUITE_END();
@@ -76,6 +80,7 @@ private:
     void testConvert01();
     void testConvert02();
     void testConvert03();
+    void testConvert04();
     void testCountChars00();
     void testCtor00();
     void testCtor01();
@@ -84,6 +89,8 @@ private:
     void testCtor04();
     void testDetachRaw00();
     void testIsValid00();
+    void testIsValid01();
+    void testMove00();
     void testNext00();
     void testOp00();
     void testOp01();
@@ -103,9 +110,11 @@ private:
     void testReset03();
     void testResize00();
     void testSeek00();
+    void testSeek01();
     void testShrink00();
     void testTruncate00();
 
+    static bool agree(const syskit::utf8_t*, size_t);
     static bool cb0a(void*, size_t, syskit::utf32_t);
     static bool cb0b(void*, size_t, syskit::utf32_t);
     static bool cb0c(void*, size_t, syskit::utf32_t);
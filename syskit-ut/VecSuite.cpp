@@ -1,4 +1,7 @@
+#include <cstring>
+#include <utility>
 #include "appkit/U32.hpp"
+#include "syskit/ThreadPool.hpp"
 #include "syskit/Vec.hpp"
 
 #include "syskit-ut-pch.h"
@@ -73,6 +76,17 @@ VecSuite::~VecSuite()
 }
 
 
+//
+// Each item is an index into the visit counts in arg. Partitions cover
+// disjoint index ranges, so no locking is needed.
+//
+void VecSuite::markItem(void* arg, void* partial, void* item)
+{
+    unsigned char* numVisits = static_cast<unsigned char*>(arg);
+    numVisits[reinterpret_cast<size_t>(item)] += (partial == 0)? 1: 0x80U;
+}
+
+
 //
 // Add random items to the end.
 //
@@ -313,6 +327,42 @@ void VecSuite::testCtor00()
 }
 
 
+//
+// Interfaces under test:
+// - void Vec::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const;
+// Each index should be visited exactly once, with or without a pool, and
+// including vectors smaller than the number of workers. Without reduction
+// hooks, the callback should see a zero partial result.
+//
+void VecSuite::testApplyParallel00()
+{
+    const size_t numItems = 1000;
+    unsigned char numVisits[numItems];
+    const size_t size[] = {0, 1, 3, numItems};
+    ThreadPool pool(4 /*numWorkers*/);
+    bool ok = true;
+    for (unsigned int i = 0; ok && (i < sizeof(size) / sizeof(size[0])); ++i)
+    {
+        Vec vec(numItems, -1 /*growBy*/);
+        for (size_t k = 0; k < size[i]; vec.add(reinterpret_cast<void*>(k++)));
+        for (unsigned int withPool = 0; ok && (withPool <= 1); ++withPool)
+        {
+            memset(numVisits, 0, sizeof(numVisits));
+            vec.applyParallel(markItem, numVisits, 0 /*open*/, 0 /*close*/, withPool? &pool: 0);
+            for (size_t k = 0; k < numItems; ++k)
+            {
+                if (numVisits[k] != ((k < size[i])? 1: 0))
+                {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+    CPPUNIT_ASSERT(ok);
+}
+
+
 void VecSuite::testCtor01()
 {
     Sample1 vec1;
@@ -392,6 +442,35 @@ void VecSuite::testFindKthSmallest00()
 }
 
 
+//
+// Interfaces under test:
+// - Vec::Vec(Vec&& that);
+// - const Vec& Vec::operator =(Vec&& that);
+//
+void VecSuite::testMove00()
+{
+#if HAS_RVALUE_REFS
+    Sample1 vec1;
+    Vec vec0(vec1);
+
+    Vec vec(std::move(vec1));
+    bool ok = (vec1.numItems() == 0) && (vec == vec0);
+    CPPUNIT_ASSERT(ok);
+    ok = vec1.add(vec0[0]) && (vec1.numItems() == 1); //moved-from instance is reusable
+    CPPUNIT_ASSERT(ok);
+
+    Vec vec2(vec0);
+    vec2 = std::move(vec);
+    ok = (vec.numItems() == 0) && (vec2 == vec0);
+    CPPUNIT_ASSERT(ok);
+
+    vec = std::move(vec2);
+    ok = (vec2.numItems() == 0) && (vec == vec0) && vec.add(vec0[0]) && vec2.add(vec0[0]);
+    CPPUNIT_ASSERT(ok);
+#endif
+}
+
+
 void VecSuite::testNew00()
 {
     Vec* vec = new Vec;
@@ -636,8 +715,8 @@ void VecSuite::testRm02()
 
 void VecSuite::testSize00()
 {
-    bool ok = (sizeof(Growable) == (sizeof(void*) + 12)) && //Win32:16 x64:20
-        (sizeof(Vec) == (sizeof(Growable) + sizeof(void*) + 4)); //Win32:24 x64:32
+    bool ok = (sizeof(Growable) == (sizeof(void*) + 16)) && //Win32:20 x64:24
+        (sizeof(Vec) == (sizeof(Growable) + sizeof(void*) + 4)); //Win32:28 x64:36
     CPPUNIT_ASSERT(ok);
 }
 
@@ -19,10 +19,12 @@ private:
     CPPUNIT_TEST(testAdd02);
     CPPUNIT_TEST(testAdd03);
     CPPUNIT_TEST(testAdd04);
+    CPPUNIT_TEST(testApplyParallel00);
     CPPUNIT_TEST(testCtor00);
     CPPUNIT_TEST(testCtor01);
     CPPUNIT_TEST(testFind00);
     CPPUNIT_TEST(testFindKthSmallest00);
+    CPPUNIT_TEST(testMove00);
     CPPUNIT_TEST(testNew00);
     CPPUNIT_TEST(testOp00);
     CPPUNIT_TEST(testOp01);
@@ -44,10 +46,12 @@ private:
     void testAdd02();
     void testAdd03();
     void testAdd04();
+    void testApplyParallel00();
     void testCtor00();
     void testCtor01();
     void testFind00();
     void testFindKthSmallest00();
+    void testMove00();
     void testNew00();
     void testOp00();
     void testOp01();
@@ -60,6 +64,8 @@ private:
     void testSize00();
     void testSort00();
 
+    static void markItem(void*, void*, void*);
+
 };
 
 #endif
@@ -13,9 +13,11 @@
 #include "BomSuite.hpp"
 #include "BstSuite.hpp"
 #include "BufArenaSuite.hpp"
+#include "BufProfileSuite.hpp"
 #include "CriSectionSuite.hpp"
 #include "D64HeapSuite.hpp"
 #include "D64VecSuite.hpp"
+#include "EpochSuite.hpp"
 #include "F32HeapSuite.hpp"
 #include "F32VecSuite.hpp"
 #include "FifoSuite.hpp"
@@ -25,15 +27,20 @@
 #include "HeapXSuite.hpp"
 #include "ItemQSuite.hpp"
 #include "LifoSuite.hpp"
+#include "LockStatSuite.hpp"
 #include "MappedFileSuite.hpp"
 #include "MappedTxtFileSuite.hpp"
 #include "MiscSuite.hpp"
 #include "ProcessSuite.hpp"
 #include "PrimeSuite.hpp"
 #include "RefCountedSuite.hpp"
+#include "RegionSuite.hpp"
+#include "RwSectionSuite.hpp"
 #include "SemaphoreSuite.hpp"
+#include "SeqLockSuite.hpp"
 #include "ShmSuite.hpp"
 #include "SpinSectionSuite.hpp"
+#include "ThreadPoolSuite.hpp"
 #include "ThreadSuite.hpp"
 #include "TreeSuite.hpp"
 #include "TrieSuite.hpp"
@@ -61,9 +68,11 @@ CPPUNIT_TEST_SUITE_REGISTRATION(BitVecSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(BomSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(BstSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(BufArenaSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(BufProfileSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(CriSectionSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(D64HeapSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(D64VecSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(EpochSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(F32HeapSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(F32VecSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(FifoSuite);
@@ -73,15 +82,20 @@ CPPUNIT_TEST_SUITE_REGISTRATION(HeapSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(HeapXSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(ItemQSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(LifoSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(LockStatSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(MappedFileSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(MappedTxtFileSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(MiscSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(PrimeSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(ProcessSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(RefCountedSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(RegionSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(RwSectionSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(SemaphoreSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(SeqLockSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(ShmSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(SpinSectionSuite);
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadPoolSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(ThreadSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(TreeSuite);
 CPPUNIT_TEST_SUITE_REGISTRATION(TrieSuite);
@@ -63,6 +63,7 @@ public:
     void set(item_t v, item_t& old);
     void setIfEqual(item_t v, item_t comperand);
     void setIfEqual(item_t v, item_t comperand, item_t& old);
+    void setNonAtomic(item_t v);
 
 private:
     volatile union
@@ -91,6 +92,13 @@ inline Atomic32::item_t Atomic32::asWord() const
     return v_;
 }
 
+//! Set the unsigned int value using a plain store. Use only when no other
+//! thread can access the instance concurrently.
+inline void Atomic32::setNonAtomic(item_t v)
+{
+    v_ = v;
+}
+
 END_NAMESPACE1
 
 #if __linux || __CYGWIN__ || __FREERTOS__
@@ -6,8 +6,10 @@
 #include <new>
 
 #include "syskit-pch.h"
+#include "syskit/AtomicWord.hpp"
 #include "syskit/BufArena.hpp"
 #include "syskit/BufPool.hpp"
+#include "syskit/BufProfile.hpp"
 #include "syskit/Foundation.hpp"
 #include "syskit/RefCounted.hpp"
 #include "syskit/SpinSection.hpp"
@@ -61,6 +63,8 @@ BufPool::~BufPool()
         delete ss_[bufSize];
         delete arena_[bufSize];
     }
+
+    delete profiler_;
 }
 
 
@@ -93,6 +97,12 @@ bool BufPool::free(const void* buf, unsigned int bufSize)
     bool ok;
     if ((bufSize > 0) && (bufSize <= maxBufSize_))
     {
+        BufProfile* profile = tracker_;
+        if (profile != 0)
+        {
+            ok = free(profile, buf, bufSize);
+            return ok;
+        }
         SpinSection::Lock lock(*ss_[bufSize]);
         ok = arena_[bufSize]->freeBuf(buf);
     }
@@ -106,6 +116,28 @@ bool BufPool::free(const void* buf, unsigned int bufSize)
 }
 
 
+//
+// Free a small-sized buffer while profiling.
+//
+bool BufPool::free(BufProfile* profile, const void* buf, unsigned int bufSize)
+{
+    bool ok;
+    bool mightBeTracked;
+    {
+        SpinSection::Lock lock(*ss_[bufSize]);
+        ok = arena_[bufSize]->freeBuf(buf);
+        mightBeTracked = ok && profile->countFree(buf, bufSize);
+    }
+
+    if (mightBeTracked)
+    {
+        profile->trackFree(buf);
+    }
+
+    return ok;
+}
+
+
 bool BufPool::getArenaConfig(char* config, unsigned int& bufSize, unsigned int& capacity, int& growBy)
 {
     bool ok = false;
@@ -188,6 +220,9 @@ void BufPool::freeBuf(const void* p, size_t size)
 void BufPool::construct(const char* config)
 {
     arena_[0] = 0;
+    profile_ = 0;
+    profiler_ = 0;
+    tracker_ = 0;
     ss_[0] = 0;
     for (unsigned int bufSize = 4; bufSize <= maxBufSize_; bufSize += 4)
     {
@@ -234,6 +269,86 @@ void BufPool::construct(const char* config)
 }
 
 
+//!
+//! Start profiling allocations of small-sized buffers. Sample one in sampleRate
+//! allocations. Existing profile data, if any, is discarded. Return true if
+//! successful. Profiling is not available for a disabled pool.
+//!
+bool BufPool::startProfiling(unsigned int sampleRate)
+{
+    bool ok = (maxBufSize_ > 0);
+    if (!ok)
+    {
+        return ok;
+    }
+
+    // Create the profiler on first use. It is retained until the pool is destructed,
+    // so threads racing with a stop can still safely use it.
+    if (profiler_ == 0)
+    {
+        BufProfile* profiler = new BufProfile(maxBufSize_);
+        AtomicWord* p = reinterpret_cast<AtomicWord*>(const_cast<BufProfile**>(&profiler_));
+        AtomicWord::item_t old;
+        p->setIfEqual(reinterpret_cast<AtomicWord::item_t>(profiler), 0, old);
+        if (old != 0)
+        {
+            delete profiler;
+        }
+    }
+
+    // Discard existing samples, then reset per-size-class counts under the
+    // respective locks before enabling the allocation/free hooks.
+    BufProfile* profiler = profiler_;
+    profile_ = 0;
+    tracker_ = 0;
+    profiler->reset(sampleRate);
+    for (unsigned int bufSize = 4; bufSize <= maxBufSize_; bufSize += 4)
+    {
+        SpinSection::Lock lock(*ss_[bufSize]);
+        profiler->resetClass(bufSize);
+    }
+
+    profiler->start();
+    tracker_ = profiler;
+    profile_ = profiler;
+    return ok;
+}
+
+
+//!
+//! Stop profiling. Allocations are no longer counted or sampled, and the profile
+//! collected so far remains available via profile(). Sampled buffers freed after
+//! the stop are still untracked, so the outstanding buffers in the profile remain
+//! accurate. This costs a filter lookup per free until profiling is restarted.
+//!
+void BufPool::stopProfiling()
+{
+    BufProfile* profiler = profiler_;
+    if (profiler != 0)
+    {
+        profile_ = 0;
+        profiler->stop();
+    }
+}
+
+
+//!
+//! Collect contention statistics for the per-size locks. Each lock is named
+//! after its buffer size (e.g., "BufPool.16" if prefix is "BufPool"). The
+//! statistics are updated while lock profiling is enabled (see LockStat).
+//!
+void BufPool::profileLocks(const char* prefix)
+{
+    char name[64];
+    for (unsigned int bufSize = 4; bufSize <= maxBufSize_; bufSize += 4)
+    {
+        sprintf_s(name, sizeof(name), "%.48s.%u", prefix, bufSize);
+        SpinSection::Lock lock(*ss_[bufSize]);
+        ss_[bufSize]->startProfiling(name);
+    }
+}
+
+
 //!
 //! Reset stats.
 //!
@@ -257,6 +372,12 @@ void* BufPool::allocate(unsigned int bufSize)
     void* buf;
     if ((bufSize > 0) && (bufSize <= maxBufSize_))
     {
+        BufProfile* profile = profile_;
+        if (profile != 0)
+        {
+            buf = allocate(profile, bufSize);
+            return buf;
+        }
         SpinSection::Lock lock(*ss_[bufSize]);
         buf = arena_[bufSize]->allocateBuf();
     }
@@ -269,6 +390,30 @@ void* BufPool::allocate(unsigned int bufSize)
 }
 
 
+//
+// Allocate a small-sized buffer while profiling. Sampled allocations have their
+// call stacks captured outside the arena lock.
+//
+void* BufPool::allocate(BufProfile* profile, unsigned int bufSize)
+{
+    void* buf;
+    bool sampleIt;
+    unsigned long long numAllocs;
+    {
+        SpinSection::Lock lock(*ss_[bufSize]);
+        buf = arena_[bufSize]->allocateBuf();
+        sampleIt = (buf != 0) && profile->countAlloc(bufSize, numAllocs);
+    }
+
+    if (sampleIt)
+    {
+        profile->trackAlloc(buf, bufSize, numAllocs);
+    }
+
+    return buf;
+}
+
+
 void* BufPool::allocateBuf(size_t size)
 {
 
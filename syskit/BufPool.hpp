@@ -17,6 +17,7 @@
 BEGIN_NAMESPACE1(syskit)
 
 class BufArena;
+class BufProfile;
 class SpinSection;
 
 
@@ -27,7 +28,9 @@ class BufPool
     //! buffers are allocated in bulk. Each pool can be used to produce
     //! and recycle buffers of small sizes (up to MaxBufSize). Buffers
     //! are managed using the allocate() and free() methods. Buffers are
-    //! allocated in a least-recently-used manner.
+    //! allocated in a least-recently-used manner. An allocation profile
+    //! can be collected at runtime using startProfiling(). When never
+    //! started, profiling costs one pointer check per allocation or free.
     //!
 {
 
@@ -49,6 +52,12 @@ public:
     bool shrinkArena(unsigned int bufSize);
     unsigned int maxBufSize() const;
     void resetStat();
+
+    // Profiling.
+    bool startProfiling(unsigned int sampleRate);
+    const BufProfile* profile() const;
+    void profileLocks(const char* prefix = "BufPool");
+    void stopProfiling();
     static BufPool& instance();
     static void freeBuf(const void* p, size_t size);
     static void* allocateBuf(size_t size);
@@ -89,13 +98,18 @@ public:
 
 private:
     BufArena* arena_[MaxBufSize + 1];
+    BufProfile* volatile profile_; //non-zero while profiling
+    BufProfile* volatile tracker_; //non-zero once profiling starts, untracks sampled buffers even after a stop
+    BufProfile* volatile profiler_; //created on first use, retained until destruction
     SpinSection mutable* ss_[MaxBufSize + 1];
     unsigned int maxBufSize_;
 
     BufPool(const BufPool&); //prohibit usage
     const BufPool& operator =(const BufPool&); //prohibit usage
 
+    bool free(BufProfile*, const void*, unsigned int);
     void construct(const char*);
+    void* allocate(BufProfile*, unsigned int);
 
     static bool getArenaConfig(char*, unsigned int&, unsigned int&, int&);
 
@@ -109,6 +123,13 @@ inline unsigned int BufPool::maxBufSize() const
     return maxBufSize_;
 }
 
+//! Return the allocation profile. Return zero if profiling has never been started.
+//! The profile remains available after profiling has been stopped.
+inline const BufProfile* BufPool::profile() const
+{
+    return profiler_;
+}
+
 //! Get stats for given buffer size. Use zeroes if given buffer size
 //! is not in the small-size range (1..MaxBufSize).
 inline BufPool::Stat::Stat(const BufPool& pool, unsigned int bufSize)
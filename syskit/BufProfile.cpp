@@ -0,0 +1,583 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <cstdio>
+#include <cstring>
+
+#include "syskit-pch.h"
+#include "syskit/BufProfile.hpp"
+#include "syskit/TickTime.hpp"
+#include "syskit/sys.hpp"
+
+const size_t LINE_SIZE = 512;
+const unsigned int OTHER_SITE = 0;
+const unsigned int SKIPPED_FRAMES = 3; //BufProfile::trackAlloc() and two BufPool::allocate() levels
+
+BEGIN_NAMESPACE
+
+
+// growable text buffer for profile reports
+class Text
+{
+public:
+    Text();
+    ~Text();
+    char* detach();
+    void add(const char* s);
+private:
+    char* s_;
+    size_t length_;
+    size_t capacity_;
+    Text(const Text&); //prohibit usage
+    const Text& operator =(const Text&); //prohibit usage
+};
+
+Text::Text()
+{
+    capacity_ = 4096;
+    length_ = 0;
+    s_ = new char[capacity_];
+    s_[0] = 0;
+}
+
+Text::~Text()
+{
+    delete[] s_;
+}
+
+void Text::add(const char* s)
+{
+    size_t n = strlen(s);
+    if (length_ + n >= capacity_)
+    {
+        size_t capacity = (capacity_ + n) << 1;
+        char* p = new char[capacity];
+        memcpy(p, s_, length_ + 1);
+        delete[] s_;
+        s_ = p;
+        capacity_ = capacity;
+    }
+
+    memcpy(s_ + length_, s, n + 1);
+    length_ += n;
+}
+
+//
+// Detach and return the accumulated text. Caller must delete it using delete[].
+//
+char* Text::detach()
+{
+    char* s = s_;
+    s_ = 0;
+    return s;
+}
+
+END_NAMESPACE
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Construct an idle profile for a buffer pool with given maximum buffer size.
+//! Use start() to start sampling.
+//!
+BufProfile::BufProfile(unsigned int maxBufSize):
+ss_()
+{
+    maxBufSize_ = maxBufSize;
+    numClasses_ = (maxBufSize_ >> 2) + 1;
+    class_ = new class_t[numClasses_];
+    site_ = new site_t[MaxSites];
+    tracked_ = new tracked_t[MaxTracked];
+    filter_ = new unsigned short[MaxTracked];
+
+    memset(class_, 0, numClasses_ * sizeof(*class_));
+    sampling_ = false;
+    sampleRate_ = DefaultSampleRate;
+    startTime_ = 0;
+    stopTime_ = 0;
+    reset(sampleRate_);
+}
+
+
+BufProfile::~BufProfile()
+{
+    delete[] filter_;
+    delete[] tracked_;
+    delete[] site_;
+    delete[] class_;
+}
+
+
+//!
+//! Save a profile report in given file. Show at most maxSites call sites
+//! in each call site section. Return true if successful.
+//!
+bool BufProfile::dump(const char* path, unsigned int maxSites) const
+{
+    std::FILE* f = std::fopen(path, "wb");
+    bool ok = (f != 0);
+    if (ok)
+    {
+        show(f, maxSites);
+        ok = (std::fclose(f) == 0);
+    }
+
+    return ok;
+}
+
+
+//!
+//! Return a profile report. Show at most maxSites call sites in each call
+//! site section. The returned text is allocated from the heap, and the caller
+//! is responsible for deleting it using the delete[] operator.
+//!
+char* BufProfile::describe(unsigned int maxSites) const
+{
+
+    // Take a snapshot. Keep the critical section short.
+    class_t* k = new class_t[numClasses_];
+    site_t* site = new site_t[MaxSites];
+    unsigned long long* oldest = new unsigned long long[MaxSites];
+    unsigned long long now = TickTime::curTime();
+    unsigned long long numDrops;
+    unsigned long long elapsed;
+    unsigned int numOutstanding;
+    unsigned int sampleRate;
+    bool sampling;
+    {
+        SpinSection::Lock lock(ss_);
+        memcpy(k, class_, numClasses_ * sizeof(*k));
+        memcpy(site, site_, MaxSites * sizeof(*site));
+        memset(oldest, 0, MaxSites * sizeof(*oldest));
+        for (unsigned int i = 0; i < MaxTracked; ++i)
+        {
+            const tracked_t& t = tracked_[i];
+            if ((t.buf != 0) && ((oldest[t.site] == 0) || (t.allocTime < oldest[t.site])))
+            {
+                oldest[t.site] = t.allocTime;
+            }
+        }
+        numDrops = numDrops_;
+        numOutstanding = numOutstanding_;
+        sampleRate = sampleRate_;
+        sampling = sampling_;
+        elapsed = (startTime_ == 0)? 0: (((stopTime_ == 0)? now: stopTime_) - startTime_);
+    }
+
+    Text text;
+    char line[LINE_SIZE];
+    double secsPerTick = 1.0 / TickTime::ticksPerSec();
+    double secs = elapsed * secsPerTick;
+    sprintf_s(line, sizeof(line), "BufPool profile: %s, 1 in %u allocations sampled, %.3f secs\n"
+        "Sampled buffers: %u outstanding, %llu dropped\n\n",
+        sampling? "running": "stopped", sampleRate, secs, numOutstanding, numDrops);
+    text.add(line);
+
+    // Per-size-class counts.
+    sprintf_s(line, sizeof(line), "%6s%13s%13s%12s%10s%8s\n%6s%13s%13s%12s%10s%8s\n",
+        "size", "allocs", "frees", "allocs/s", "samples", "outst",
+        "----", "------", "-----", "--------", "-------", "-----");
+    text.add(line);
+    for (unsigned int i = 1; i < numClasses_; ++i)
+    {
+        const class_t& c = k[i];
+        if ((c.numAllocs > 0) || (c.numSamples > 0))
+        {
+            double rate = (secs > 0)? (c.numAllocs / secs): 0.0;
+            sprintf_s(line, sizeof(line), "%6u%13llu%13llu%12.1f%10llu%8u\n",
+                i << 2, c.numAllocs, c.numFrees, rate, c.numSamples, c.numOutstanding);
+            text.add(line);
+        }
+    }
+
+    // Histograms. Show non-empty log2 buckets only, each as "upperBound:count".
+    text.add("\nAllocation rate histogram (allocs/s upper bound:count):\n");
+    for (unsigned int i = 1; i < numClasses_; ++i)
+    {
+        const class_t& c = k[i];
+        if (c.numSamples > 1)
+        {
+            sprintf_s(line, sizeof(line), "%6u:", i << 2);
+            text.add(line);
+            for (unsigned int b = 0; b < NumBuckets; ++b)
+            {
+                if (c.rateHist[b] > 0)
+                {
+                    sprintf_s(line, sizeof(line), " %.0f:%u", (b == 0)? 0.0: static_cast<double>(1ULL << (b - 1)) * 2.0, c.rateHist[b]);
+                    text.add(line);
+                }
+            }
+            text.add("\n");
+        }
+    }
+
+    text.add("\nLifetime histogram (usecs upper bound:count):\n");
+    double usecsPerTick = secsPerTick * 1e6;
+    for (unsigned int i = 1; i < numClasses_; ++i)
+    {
+        const class_t& c = k[i];
+        bool hasLifetimes = false;
+        for (unsigned int b = 0; b < NumBuckets; ++b)
+        {
+            if (c.lifeHist[b] > 0)
+            {
+                if (!hasLifetimes)
+                {
+                    sprintf_s(line, sizeof(line), "%6u:", i << 2);
+                    text.add(line);
+                    hasLifetimes = true;
+                }
+                double upperBound = (b == 0)? 0.0: static_cast<double>(1ULL << (b - 1)) * 2.0 * usecsPerTick;
+                sprintf_s(line, sizeof(line), " %.3g:%u", upperBound, c.lifeHist[b]);
+                text.add(line);
+            }
+        }
+        if (hasLifetimes)
+        {
+            text.add("\n");
+        }
+    }
+
+    // Hot call sites by sample count, then outstanding sampled buffers by call
+    // site. Use a simple selection since only the top few sites are shown.
+    char desc[LINE_SIZE];
+    for (int section = 0; section < 2; ++section)
+    {
+        text.add((section == 0)?
+            "\nHot call sites (by samples):\n":
+            "\nOutstanding sampled buffers (possible leaks, by call site):\n");
+        for (unsigned int n = 0; n < maxSites; ++n)
+        {
+            unsigned int top = MaxSites;
+            unsigned long long topV = 0;
+            for (unsigned int i = 0; i < MaxSites; ++i)
+            {
+                unsigned long long v = (section == 0)? site[i].numSamples: site[i].numOutstanding;
+                if (v > topV)
+                {
+                    top = i;
+                    topV = v;
+                }
+            }
+            if (top == MaxSites)
+            {
+                break;
+            }
+
+            site_t& s = site[top];
+            if (section == 0)
+            {
+                sprintf_s(line, sizeof(line), "#%u samples=%llu bytes=%llu outstanding=%u\n",
+                    n + 1, s.numSamples, s.numBytes, s.numOutstanding);
+                s.numSamples = 0;
+            }
+            else
+            {
+                double age = (now - oldest[top]) * secsPerTick;
+                sprintf_s(line, sizeof(line), "#%u outstanding=%u oldest=%.3fsecs\n", n + 1, s.numOutstanding, age);
+                s.numOutstanding = 0;
+            }
+            text.add(line);
+
+            if (top == OTHER_SITE)
+            {
+                text.add("    (call site table full)\n");
+            }
+            for (unsigned int i = 0; i < s.numFrames; ++i)
+            {
+                describeFrame(s.frame[i], desc, sizeof(desc));
+                text.add("    ");
+                text.add(desc);
+                text.add("\n");
+            }
+        }
+    }
+
+    delete[] oldest;
+    delete[] site;
+    delete[] k;
+    return text.detach();
+}
+
+
+//
+// Return the log2 bucket of given value. Bucket zero holds zero values.
+// Bucket b holds values in the [2**(b-1), 2**b) range.
+//
+unsigned int BufProfile::bucketOf(unsigned long long v)
+{
+    unsigned int b = 0;
+    for (; v != 0; v >>= 1, ++b);
+    return (b < NumBuckets)? b: (NumBuckets - 1);
+}
+
+
+//
+// Locate the call site for given call stack. Add a new site if necessary.
+// Return the site index. If the site table is full, return the catch-all site.
+// Must be invoked while holding the profile lock.
+//
+unsigned int BufProfile::findSite(const void* const* frame, unsigned int numFrames)
+{
+    size_t hash = 2166136261U;
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        hash = (hash ^ reinterpret_cast<size_t>(frame[i])) * 16777619U;
+    }
+    hash |= 1; //zero is reserved
+
+    // The site table is used as a hash table. Site zero is reserved for
+    // the catch-all site and is never probed.
+    const unsigned int mask = MaxSites - 1;
+    unsigned int i = static_cast<unsigned int>(hash & mask);
+    for (;; i = (i + 1) & mask)
+    {
+        if (i == OTHER_SITE)
+        {
+            continue;
+        }
+
+        site_t& s = site_[i];
+        if (s.hash == 0)
+        {
+            if (numSites_ >= (MaxSites >> 2) * 3)
+            {
+                i = OTHER_SITE;
+                break;
+            }
+            s.hash = hash;
+            s.numFrames = numFrames;
+            memcpy(s.frame, frame, numFrames * sizeof(*frame));
+            ++numSites_;
+            break;
+        }
+
+        if ((s.hash == hash) && (s.numFrames == numFrames) && (memcmp(s.frame, frame, numFrames * sizeof(*frame)) == 0))
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+//!
+//! Return the number of sampled allocations.
+//!
+unsigned long long BufProfile::numSamples() const
+{
+    unsigned long long n = 0;
+    SpinSection::Lock lock(ss_);
+    for (unsigned int i = 1; i < numClasses_; ++i)
+    {
+        n += class_[i].numSamples;
+    }
+
+    return n;
+}
+
+
+//!
+//! Stop sampling and discard all samples. Subsequent sampling, if any, will use
+//! the given sample rate. A zero sample rate is treated as one. Per-size-class
+//! allocation and free counts must be reset separately using resetClass().
+//!
+void BufProfile::reset(unsigned int sampleRate)
+{
+    SpinSection::Lock lock(ss_);
+    sampling_ = false;
+    sampleRate_ = (sampleRate == 0)? 1: sampleRate;
+    for (unsigned int i = 0; i < numClasses_; ++i)
+    {
+        class_t& k = class_[i];
+        k.lastSampleAllocs = 0;
+        k.lastSampleTime = 0;
+        k.numSamples = 0;
+        k.numOutstanding = 0;
+        memset(k.rateHist, 0, sizeof(k.rateHist));
+        memset(k.lifeHist, 0, sizeof(k.lifeHist));
+    }
+
+    memset(site_, 0, MaxSites * sizeof(*site_));
+    memset(tracked_, 0, MaxTracked * sizeof(*tracked_));
+    memset(const_cast<unsigned short*>(filter_), 0, MaxTracked * sizeof(*filter_));
+    numDrops_ = 0;
+    numOutstanding_ = 0;
+    numSites_ = 1; //catch-all site
+}
+
+
+//!
+//! Reset the allocation and free counts for the size class of given buffer size.
+//! Must be invoked while holding the BufPool lock for the given size.
+//!
+void BufProfile::resetClass(unsigned int bufSize)
+{
+    class_t& k = class_[(bufSize + 3) >> 2];
+    k.countdown = sampleRate_;
+    k.numAllocs = 0;
+    k.numFrees = 0;
+}
+
+
+//!
+//! Write a profile report to given file. Show at most maxSites call sites
+//! in each call site section.
+//!
+void BufProfile::show(std::FILE* f, unsigned int maxSites) const
+{
+    char* s = describe(maxSites);
+    std::fputs(s, f);
+    delete[] s;
+}
+
+
+//!
+//! Start sampling.
+//!
+void BufProfile::start()
+{
+    SpinSection::Lock lock(ss_);
+    startTime_ = TickTime::curTime();
+    stopTime_ = 0;
+    sampling_ = true;
+}
+
+
+//!
+//! Stop sampling. Existing samples are retained.
+//!
+void BufProfile::stop()
+{
+    SpinSection::Lock lock(ss_);
+    if (sampling_)
+    {
+        stopTime_ = TickTime::curTime();
+        sampling_ = false;
+    }
+}
+
+
+//!
+//! Record a sampled allocation. The call stack is captured here, so this method
+//! must be invoked directly by the allocating BufPool method and must not be
+//! invoked while holding any BufPool lock.
+//!
+void BufProfile::trackAlloc(const void* buf, unsigned int bufSize, unsigned long long numAllocs)
+{
+    const void* eip[MaxFrames + SKIPPED_FRAMES];
+    unsigned int numFrames = captureStack(eip, MaxFrames + SKIPPED_FRAMES);
+    const void* const* frame = eip;
+    if (numFrames > SKIPPED_FRAMES)
+    {
+        frame += SKIPPED_FRAMES;
+        numFrames -= SKIPPED_FRAMES;
+    }
+
+    unsigned long long now = TickTime::curTime();
+    SpinSection::Lock lock(ss_);
+    if (!sampling_)
+    {
+        return;
+    }
+
+    // Allocation rate since the previous sample of this size class.
+    class_t& k = class_[(bufSize + 3) >> 2];
+    ++k.numSamples;
+    if ((k.lastSampleTime != 0) && (now > k.lastSampleTime))
+    {
+        double rate = static_cast<double>(numAllocs - k.lastSampleAllocs) * TickTime::ticksPerSec() / (now - k.lastSampleTime);
+        ++k.rateHist[bucketOf(static_cast<unsigned long long>(rate))];
+    }
+    k.lastSampleAllocs = numAllocs;
+    k.lastSampleTime = now;
+
+    unsigned int i = findSite(frame, numFrames);
+    site_t& site = site_[i];
+    ++site.numSamples;
+    site.numBytes += bufSize;
+
+    // Track buffer until freed. Keep the table sparse.
+    if (numOutstanding_ >= (MaxTracked >> 2) * 3)
+    {
+        ++numDrops_;
+        return;
+    }
+
+    const unsigned int mask = MaxTracked - 1;
+    unsigned int j = trackIndex(buf);
+    for (; tracked_[j].buf != 0; j = (j + 1) & mask);
+    tracked_t& t = tracked_[j];
+    t.buf = buf;
+    t.allocTime = now;
+    t.bufSize = bufSize;
+    t.site = i;
+    ++site.numOutstanding;
+    ++k.numOutstanding;
+    ++numOutstanding_;
+    ++filter_[filterIndex(buf)];
+}
+
+
+//!
+//! Record a free of a possibly sampled buffer.
+//!
+void BufProfile::trackFree(const void* buf)
+{
+    unsigned long long now = TickTime::curTime();
+    SpinSection::Lock lock(ss_);
+    const unsigned int mask = MaxTracked - 1;
+    for (unsigned int i = trackIndex(buf); tracked_[i].buf != 0; i = (i + 1) & mask)
+    {
+        tracked_t& t = tracked_[i];
+        if (t.buf == buf)
+        {
+            class_t& k = class_[(t.bufSize + 3) >> 2];
+            ++k.lifeHist[bucketOf(now - t.allocTime)];
+            --k.numOutstanding;
+            --site_[t.site].numOutstanding;
+            --numOutstanding_;
+            --filter_[filterIndex(buf)];
+            untrack(i);
+            break;
+        }
+    }
+}
+
+
+//
+// Remove tracked buffer at given slot. Shift subsequent entries in the probe
+// sequence backward to keep the linear-probing table free of tombstones.
+//
+void BufProfile::untrack(unsigned int i)
+{
+    const unsigned int mask = MaxTracked - 1;
+    for (unsigned int j = i;;)
+    {
+        tracked_[i].buf = 0;
+        for (;;)
+        {
+            j = (j + 1) & mask;
+            if (tracked_[j].buf == 0)
+            {
+                return;
+            }
+
+            // Entry stays if its home slot is cyclically in (i, j].
+            unsigned int home = trackIndex(tracked_[j].buf);
+            bool stays = (i <= j)? ((i < home) && (home <= j)): ((i < home) || (home <= j));
+            if (!stays)
+            {
+                break;
+            }
+        }
+
+        tracked_[i] = tracked_[j];
+        i = j;
+    }
+}
+
+END_NAMESPACE1
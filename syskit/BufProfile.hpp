@@ -0,0 +1,194 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_BUF_PROFILE_HPP
+#define SYSKIT_BUF_PROFILE_HPP
+
+#include <cstdio>
+#include "syskit/SpinSection.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//! allocation profile for a BufPool
+class BufProfile
+    //!
+    //! A class representing an allocation profile for a buffer pool. The profile
+    //! counts all allocations and frees per size class (4-byte granularity), and
+    //! samples one in sampleRate() allocations. Each sampled allocation has its call
+    //! stack captured. Sampled allocations feed per-size-class histograms of the
+    //! allocation rate and of the buffer lifetime, and are aggregated per call site
+    //! to identify hot allocators. Sampled buffers which have not been freed are
+    //! tracked as outstanding to help find leaks. A profile is normally owned by a
+    //! BufPool and controlled via BufPool::startProfiling() and stopProfiling().
+    //! All internal memory comes from the default c++ heap, never from a BufPool.
+    //!
+{
+
+public:
+    enum
+    {
+        DefaultSampleRate = 1024,
+        DefaultMaxSites = 16,
+        MaxFrames = 12,
+        MaxSites = 4096, //must be power of two
+        MaxTracked = 65536, //must be power of two
+        NumBuckets = 48
+    };
+
+    BufProfile(unsigned int maxBufSize);
+    ~BufProfile();
+
+    bool dump(const char* path, unsigned int maxSites = DefaultMaxSites) const;
+    bool isSampling() const;
+    char* describe(unsigned int maxSites = DefaultMaxSites) const;
+    unsigned int numOutstanding() const;
+    unsigned int sampleRate() const;
+    unsigned long long numSamples() const;
+    void show(std::FILE* f, unsigned int maxSites = DefaultMaxSites) const;
+
+    // Used by BufPool.
+    bool countAlloc(unsigned int bufSize, unsigned long long& numAllocs);
+    bool countFree(const void* buf, unsigned int bufSize);
+    void reset(unsigned int sampleRate);
+    void resetClass(unsigned int bufSize);
+    void start();
+    void stop();
+    void trackAlloc(const void* buf, unsigned int bufSize, unsigned long long numAllocs);
+    void trackFree(const void* buf);
+
+    static unsigned int captureStack(const void* eip[], unsigned int maxFrames);
+    static void describeFrame(const void* eip, char* desc, size_t descSize);
+
+private:
+
+    // Per-size-class stats. Counts are protected by the BufPool lock of the
+    // size class. Histograms are protected by the profile lock.
+    typedef struct class_s
+    {
+        unsigned long long numAllocs;
+        unsigned long long numFrees;
+        unsigned int countdown;
+        unsigned long long lastSampleAllocs;
+        unsigned long long lastSampleTime;
+        unsigned long long numSamples;
+        unsigned int numOutstanding;
+        unsigned int rateHist[NumBuckets]; //log2(allocs per sec)
+        unsigned int lifeHist[NumBuckets]; //log2(ticks)
+    } class_t;
+
+    // Unique call stack of sampled allocations.
+    typedef struct site_s
+    {
+        size_t hash;
+        unsigned int numFrames;
+        unsigned int numOutstanding;
+        unsigned long long numBytes;
+        unsigned long long numSamples;
+        const void* frame[MaxFrames];
+    } site_t;
+
+    // Outstanding sampled buffer.
+    typedef struct tracked_s
+    {
+        const void* buf;
+        unsigned long long allocTime;
+        unsigned int bufSize;
+        unsigned int site;
+    } tracked_t;
+
+    SpinSection mutable ss_;
+    bool volatile sampling_;
+    class_t* class_;
+    site_t* site_;
+    tracked_t* tracked_;
+    unsigned int maxBufSize_;
+    unsigned int numClasses_;
+    unsigned int numOutstanding_;
+    unsigned int numSites_;
+    unsigned int sampleRate_;
+    unsigned long long numDrops_;
+    unsigned long long startTime_;
+    unsigned long long stopTime_;
+    unsigned short volatile* filter_;
+
+    BufProfile(const BufProfile&); //prohibit usage
+    const BufProfile& operator =(const BufProfile&); //prohibit usage
+
+    unsigned int findSite(const void* const*, unsigned int);
+    void untrack(unsigned int);
+
+    static unsigned int bucketOf(unsigned long long);
+    static unsigned int filterIndex(const void*);
+    static unsigned int trackIndex(const void*);
+
+};
+
+//! Return true if allocations are currently being sampled.
+inline bool BufProfile::isSampling() const
+{
+    return sampling_;
+}
+
+//! Return the number of sampled buffers not yet freed.
+inline unsigned int BufProfile::numOutstanding() const
+{
+    return numOutstanding_;
+}
+
+//! Return the sample rate. One in sampleRate() allocations is sampled.
+inline unsigned int BufProfile::sampleRate() const
+{
+    return sampleRate_;
+}
+
+//! Count an allocation of given size. Must be invoked while holding the
+//! BufPool lock for the given size. Return true if the allocation should
+//! be sampled. If so, also return the allocation count for its size class.
+inline bool BufProfile::countAlloc(unsigned int bufSize, unsigned long long& numAllocs)
+{
+    class_t& k = class_[(bufSize + 3) >> 2];
+    numAllocs = ++k.numAllocs;
+    bool sampleIt = sampling_ && (--k.countdown == 0);
+    if (sampleIt)
+    {
+        k.countdown = sampleRate_;
+    }
+
+    return sampleIt;
+}
+
+//! Count a free of given buffer. Must be invoked while holding the BufPool
+//! lock for the given size. Frees are counted while sampling only. Return true
+//! if the buffer might have been sampled and trackFree() should be invoked.
+inline bool BufProfile::countFree(const void* buf, unsigned int bufSize)
+{
+    if (sampling_)
+    {
+        class_t& k = class_[(bufSize + 3) >> 2];
+        ++k.numFrees;
+    }
+
+    bool mightBeTracked = (filter_[filterIndex(buf)] != 0);
+    return mightBeTracked;
+}
+
+inline unsigned int BufProfile::filterIndex(const void* buf)
+{
+    size_t k = reinterpret_cast<size_t>(buf) >> 2;
+    unsigned int i = static_cast<unsigned int>((k ^ (k >> 13)) & (MaxTracked - 1));
+    return i;
+}
+
+inline unsigned int BufProfile::trackIndex(const void* buf)
+{
+    size_t k = reinterpret_cast<size_t>(buf) >> 2;
+    unsigned int i = static_cast<unsigned int>((k * 0x9e3779b1U) & (MaxTracked - 1));
+    return i;
+}
+
+END_NAMESPACE1
+
+#endif
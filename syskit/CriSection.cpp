@@ -4,6 +4,7 @@
  */
 #include "syskit-pch.h"
 #include "syskit/CriSection.hpp"
+#include "syskit/LockStat.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -26,4 +27,23 @@ CriSection::Lock::~Lock()
     criSection_.unlock();
 }
 
+
+//!
+//! Start collecting contention statistics under given name. The statistics
+//! are registered process-wide and are updated while profiling is enabled
+//! (see LockStat::enable()). If already profiled, the existing statistics
+//! are reset and kept under their original name.
+//!
+void CriSection::startProfiling(const char* name)
+{
+    if (stat_ == 0)
+    {
+        stat_ = new LockStat(name, "CriSection");
+    }
+    else
+    {
+        stat_->reset();
+    }
+}
+
 END_NAMESPACE1
@@ -9,6 +9,8 @@
 
 BEGIN_NAMESPACE1(syskit)
 
+class LockStat;
+
 
 //! section of critical code which needs synchronization across threads
 class CriSection
@@ -20,7 +22,8 @@ class CriSection
     //! A critical section should be locked/unlocked by contructing/destructing a
     //! CriSection::Lock instance. Use lock() and unlock() only if CriSection::Lock
     //! cannot be used. Use tryLock() to avoid blocking calls. Recursive locks are
-    //! allowed. Example:
+    //! allowed. Use startProfiling() to collect contention statistics (see LockStat).
+    //! Example:
     //!\code
     //! cs_.lock(); //cs_ is a CriSection instance
     //! thisFuncDoesNotWorkIfConcurrentlyUsed();
@@ -41,7 +44,9 @@ public:
     ~CriSection();
 
     bool tryLock();
+    const LockStat* stat() const;
     void lock();
+    void startProfiling(const char* name);
     void unlock();
 
 
@@ -71,12 +76,19 @@ public:
 
 private:
     criSection_t* cs_;
+    LockStat* stat_;
 
     CriSection(const CriSection&); //prohibit usage
     const CriSection& operator=(const CriSection&); //prohibit usage
 
 };
 
+//! Return the contention statistics. Return zero if not profiled.
+inline const LockStat* CriSection::stat() const
+{
+    return stat_;
+}
+
 END_NAMESPACE1
 
 #endif
@@ -13,13 +13,31 @@ const unsigned int INVALID_CAP = 0xffffffffU;
 BEGIN_NAMESPACE1(syskit)
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Construct instance using guts from that. That is, move vector contents from
+//! that into this. That instance is left empty and can be reused.
+//!
+D64Vec::D64Vec(D64Vec&& that):
+Growable(that)
+{
+    item_ = that.item_;
+    adoptItems(that);
+    numItems_ = that.numItems_;
+    that.setCapacity(0);
+    that.item_ = that.allocateItems<item_t>(that.capacity());
+    that.numItems_ = 0;
+}
+#endif
+
+
 //!
 //! Construct a duplicate instance of the given vector.
 //!
 D64Vec::D64Vec(const D64Vec& vec):
 Growable(vec)
 {
-    item_ = new item_t[capacity()];
+    item_ = allocateItems<item_t>(capacity());
     numItems_ = vec.numItems_;
 
     // Copy the utilized items only. Don't care about the
@@ -34,7 +52,7 @@ Growable(vec)
 D64Vec::D64Vec(const D64Vec& vec, size_t startAt, size_t itemCount):
 Growable(vec)
 {
-    item_ = new item_t[capacity()];
+    item_ = allocateItems<item_t>(capacity());
     numItems_ = static_cast<unsigned int>(itemCount);
 
     // Copy the utilized items only. Don't care about the
@@ -53,14 +71,14 @@ Growable(capacity, growBy)
 {
 
     // Allocate all items. Initialize each item when used.
-    item_ = new item_t[D64Vec::capacity()];
+    item_ = allocateItems<item_t>(D64Vec::capacity());
     numItems_ = 0;
 }
 
 
 D64Vec::~D64Vec()
 {
-    delete[] item_;
+    freeItems(item_);
 }
 
 
@@ -86,8 +104,8 @@ const D64Vec& D64Vec::operator =(const D64Vec& vec)
     {
         if (canGrow())
         {
-            delete[] item_;
-            item_ = new item_t[setNextCap(minCap)];
+            freeItems(item_);
+            item_ = allocateItems<item_t>(setNextCap(minCap));
         }
         else
         {
@@ -104,6 +122,33 @@ const D64Vec& D64Vec::operator =(const D64Vec& vec)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Reset and move the vector contents including guts from that into this. That
+//! instance is left empty and can be reused.
+//!
+const D64Vec& D64Vec::operator =(D64Vec&& that)
+{
+
+    // No-op if operating against the same vector.
+    if (this != &that)
+    {
+        freeItems(item_);
+        Growable::operator =(that);
+        item_ = that.item_;
+        adoptItems(that);
+        numItems_ = that.numItems_;
+        that.setCapacity(0);
+        that.item_ = that.allocateItems<item_t>(that.capacity());
+        that.numItems_ = 0;
+    }
+
+    // Return reference to self.
+    return *this;
+}
+#endif
+
+
 //!
 //! Find and return the kth smallest item. Given items can be arbitrarily rearranged.
 //! Behavior is unpredictable if k is not less than the number of items. The original
@@ -143,7 +188,7 @@ D64Vec::item_t D64Vec::findKthSmallest(item_t* item, size_t itemCount, size_t k)
 //!
 D64Vec::item_t* D64Vec::detachRaw()
 {
-    item_t* raw = item_;
+    item_t* raw = detachItems(item_, capacity(), numItems_);
     item_ = 0;
     numItems_ = 0;
     setCapacity(INVALID_CAP);
@@ -256,10 +301,7 @@ bool D64Vec::resize(unsigned int newCap)
         ok = true;
         if (newCap != capacity())
         {
-            item_t* item = new item_t[newCap];
-            memcpy(item, item_, numItems_ * sizeof(*item_));
-            delete[] item_;
-            item_ = item;
+            item_ = resizeItems(item_, newCap, numItems_);
             setCapacity(newCap);
         }
     }
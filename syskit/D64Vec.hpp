@@ -47,9 +47,15 @@ public:
     D64Vec(const D64Vec& vec);
     D64Vec(const D64Vec& vec, size_t startAt, size_t itemCount);
     D64Vec(unsigned int capacity = DefaultCap, int growBy = 0);
+#if HAS_RVALUE_REFS
+    D64Vec(D64Vec&& that);
+#endif
 
     // Operators.
     const D64Vec& operator =(const D64Vec& vec);
+#if HAS_RVALUE_REFS
+    const D64Vec& operator =(D64Vec&& that);
+#endif
     bool operator !=(const D64Vec& vec) const;
     bool operator ==(const D64Vec& vec) const;
     item_t operator [](size_t index) const;
@@ -0,0 +1,346 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit-pch.h"
+#include "syskit/BufPool.hpp"
+#include "syskit/Epoch.hpp"
+#include "syskit/Thread.hpp"
+#include "syskit/sys.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+static Epoch* volatile s_epoch = 0;
+static SpinSection s_epochSs;
+
+
+//!
+//! Construct an empty reclamation domain. A thread which has retired at least
+//! batchSize items tries to advance the epoch and to reclaim its retired items.
+//!
+Epoch::Epoch(unsigned int batchSize):
+epoch_(0U),
+numSlots_(0U),
+orphanSs_(),
+key_()
+{
+    orphan_ = 0;
+    slot_ = new slot_t[MaxThreads];
+    for (unsigned int i = 0; i < MaxThreads; ++i)
+    {
+        slot_t& slot = slot_[i];
+        slot.nesting = 0;
+        slot.numPending = 0;
+        slot.head = 0;
+        slot.tail = 0;
+        slot.numReclaimed = 0;
+        slot.numRetired = 0;
+    }
+
+    batchSize_ = (batchSize > 0)? batchSize: 1;
+    numOrphansReclaimed_ = 0;
+}
+
+
+//!
+//! Destruct the domain. Reclaim all retired items. The caller must make sure
+//! no thread is in a critical section or is using the domain otherwise.
+//!
+Epoch::~Epoch()
+{
+    for (unsigned int i = 0, numSlots = numSlots_.asWord(); i < numSlots; ++i)
+    {
+        for (retired_t* r = slot_[i].head; r != 0;)
+        {
+            retired_t* next = r->next;
+            r->reclaim(r->arg, r->item);
+            BufPool::freeBuf(r, sizeof(*r));
+            r = next;
+        }
+    }
+
+    for (retired_t* r = orphan_; r != 0;)
+    {
+        retired_t* next = r->next;
+        r->reclaim(r->arg, r->item);
+        BufPool::freeBuf(r, sizeof(*r));
+        r = next;
+    }
+
+    delete[] slot_;
+}
+
+
+//!
+//! Try advancing the global epoch. The epoch advances if every thread in a
+//! critical section has observed the current epoch. Return true if the epoch
+//! has advanced (by the caller or by some other thread).
+//!
+bool Epoch::tryAdvance()
+{
+    unsigned int e = epoch_.asWord();
+    loadFence();
+
+    unsigned int current = (e & EpochMask) | Active;
+    for (const slot_t* slot = slot_, * slotEnd = slot_ + numSlots_.asWord(); slot < slotEnd; ++slot)
+    {
+        unsigned int state = slot->state.asWord();
+        if (((state & Active) != 0) && (state != current))
+        {
+            return false;
+        }
+    }
+
+    unsigned int old;
+    epoch_.setIfEqual(e + 1, e, old);
+    return true;
+}
+
+
+//
+// Register the calling thread. Claim a free slot. Wait if all slots are in use.
+//
+Epoch::slot_t* Epoch::attach()
+{
+    for (;;)
+    {
+        for (unsigned int i = 0; i < MaxThreads; ++i)
+        {
+            slot_t* slot = slot_ + i;
+            unsigned int wasInUse = 1;
+            if (slot->inUse.asWord() == 0)
+            {
+                slot->inUse.setIfEqual(1, 0, wasInUse);
+            }
+            if (wasInUse != 0)
+            {
+                continue;
+            }
+
+            // Advancers scan all slots ever used.
+            for (unsigned int n = numSlots_.asWord(); n <= i; n = numSlots_.asWord())
+            {
+                numSlots_.setIfEqual(i + 1, n);
+            }
+
+            key_.setValue(slot);
+            return slot;
+        }
+
+        Thread::yield();
+    }
+}
+
+
+//
+// Reclaim given slot's items which are safe to reclaim in given epoch.
+// Items are unlinked before being reclaimed since a reclaim callback
+// can retire other items. Return the number of reclaimed items.
+//
+unsigned int Epoch::reclaimSlot(slot_t* slot, unsigned int e)
+{
+    unsigned int n = 0;
+    for (retired_t* r = slot->head; (r != 0) && isSafe(r->epoch, e); r = slot->head, ++n)
+    {
+        slot->head = r->next;
+        if (slot->head == 0)
+        {
+            slot->tail = 0;
+        }
+        --slot->numPending;
+        ++slot->numReclaimed;
+        r->reclaim(r->arg, r->item);
+        BufPool::freeBuf(r, sizeof(*r));
+    }
+
+    return n;
+}
+
+
+//
+// Reclaim items left behind by detached threads which are safe to reclaim
+// in given epoch. Return the number of reclaimed items.
+//
+unsigned int Epoch::reclaimOrphans(unsigned int e)
+{
+    retired_t* safe = 0;
+    unsigned int n = 0;
+    {
+        SpinSection::Lock lock(orphanSs_);
+        for (retired_t** p = &orphan_; *p != 0;)
+        {
+            retired_t* r = *p;
+            if (isSafe(r->epoch, e))
+            {
+                *p = r->next;
+                r->next = safe;
+                safe = r;
+                ++n;
+            }
+            else
+            {
+                p = &r->next;
+            }
+        }
+        numOrphansReclaimed_ += n;
+    }
+
+    while (safe != 0)
+    {
+        retired_t* r = safe;
+        safe = r->next;
+        r->reclaim(r->arg, r->item);
+        BufPool::freeBuf(r, sizeof(*r));
+    }
+
+    return n;
+}
+
+
+//!
+//! Return the number of items reclaimed so far.
+//!
+unsigned long long Epoch::numReclaimed() const
+{
+    unsigned long long n = numOrphansReclaimed_;
+    for (unsigned int i = 0, numSlots = numSlots_.asWord(); i < numSlots; ++i)
+    {
+        n += slot_[i].numReclaimed;
+    }
+
+    return n;
+}
+
+
+//!
+//! Return the number of items retired so far.
+//!
+unsigned long long Epoch::numRetired() const
+{
+    unsigned long long n = 0;
+    for (unsigned int i = 0, numSlots = numSlots_.asWord(); i < numSlots; ++i)
+    {
+        n += slot_[i].numRetired;
+    }
+
+    return n;
+}
+
+
+//!
+//! Unregister the calling thread. Its pending retired items are handed over
+//! to the domain and will be reclaimed later by some other thread. The thread
+//! must not be in a critical section. The thread is registered again if it
+//! uses the domain again.
+//!
+void Epoch::detach()
+{
+    slot_t* slot = static_cast<slot_t*>(key_.value());
+    if (slot == 0)
+    {
+        return;
+    }
+
+    if (slot->head != 0)
+    {
+        SpinSection::Lock lock(orphanSs_);
+        slot->tail->next = orphan_;
+        orphan_ = slot->head;
+    }
+
+    slot->head = 0;
+    slot->tail = 0;
+    slot->numPending = 0;
+    slot->state = epoch_.asWord() & EpochMask;
+    key_.setValue(0);
+    slot->inUse = 0;
+}
+
+
+//
+// Reclaim callback for retireBuf(). Look at arg as the buffer size.
+//
+void Epoch::freeBuf(void* arg, void* item)
+{
+    BufPool::freeBuf(item, reinterpret_cast<size_t>(arg));
+}
+
+
+//!
+//! Retire given item which has been unlinked from shared data. The item will be
+//! reclaimed as reclaim(arg, item) when no reader can hold a reference to it.
+//! The reclaim callback might be invoked from some other thread if the calling
+//! thread detaches before the item is reclaimed.
+//!
+void Epoch::retire(void* item, cb0_t reclaim, void* arg)
+{
+    slot_t* slot = mySlot();
+    retired_t* r = static_cast<retired_t*>(BufPool::allocateBuf(sizeof(*r)));
+    r->next = 0;
+    r->item = item;
+    r->reclaim = reclaim;
+    r->arg = arg;
+
+    // The unlink must be visible before the epoch is sampled.
+    fullFence();
+    r->epoch = epoch_.asWord();
+    (slot->tail != 0)? (slot->tail->next = r): (slot->head = r);
+    slot->tail = r;
+    ++slot->numRetired;
+
+    if (++slot->numPending >= batchSize_)
+    {
+        tryAdvance();
+        unsigned int e = epoch_.asWord();
+        reclaimSlot(slot, e);
+        if (orphan_ != 0)
+        {
+            reclaimOrphans(e);
+        }
+    }
+}
+
+
+//!
+//! Wait until all items retired so far are safe to reclaim, then reclaim the
+//! caller's retired items and the items left behind by detached threads. Must
+//! not be invoked while in a critical section.
+//!
+void Epoch::synchronize()
+{
+    slot_t* slot = mySlot();
+    fullFence();
+    unsigned int target = epoch_.asWord() + 2;
+    for (unsigned int e = epoch_.asWord(); static_cast<int>(target - e) > 0; e = epoch_.asWord())
+    {
+        if (!tryAdvance())
+        {
+            Thread::yield();
+        }
+    }
+
+    unsigned int e = epoch_.asWord();
+    reclaimSlot(slot, e);
+    reclaimOrphans(e);
+}
+
+
+//!
+//! Return the process-wide reclamation domain.
+//! Construct on first use. The domain persists until process exit.
+//!
+Epoch& Epoch::instance()
+{
+    if (s_epoch == 0)
+    {
+        SpinSection::Lock lock(s_epochSs);
+        if (s_epoch == 0)
+        {
+            s_epoch = new Epoch;
+        }
+    }
+
+    return *s_epoch;
+}
+
+END_NAMESPACE1
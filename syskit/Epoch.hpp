@@ -0,0 +1,223 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_EPOCH_HPP
+#define SYSKIT_EPOCH_HPP
+
+#include <sys/types.h>
+#include "syskit/Atomic32.hpp"
+#include "syskit/SpinSection.hpp"
+#include "syskit/ThreadKey.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//! epoch-based memory reclamation
+class Epoch
+    //!
+    //! A class representing an epoch-based memory reclamation domain. It allows
+    //! lock-free readers to traverse shared data while writers unlink and retire
+    //! items concurrently. A reader brackets its accesses with enter() and exit(),
+    //! preferably by constructing/destructing an Epoch::Guard instance. Entering
+    //! only publishes the current epoch in a per-thread slot, so readers do not
+    //! write any shared cache line. A writer unlinks an item, then hands it to
+    //! retire() instead of freeing it. A retired item is reclaimed once every
+    //! reader which might still hold a reference has exited, that is, once the
+    //! global epoch has advanced twice. The epoch advances when all readers in
+    //! critical sections have observed the current one. Retired items are queued
+    //! per thread and reclaimed in batches. Use retireBuf() for buffers allocated
+    //! via BufPool. Each participating thread is registered on first use. At most
+    //! MaxThreads threads can be registered at once. A thread should detach()
+    //! before exiting so its slot can be reused. Example:
+    //!\code
+    //! Epoch& epoch = Epoch::instance();
+    //! {
+    //!   Epoch::Guard guard(epoch);
+    //!   const Config* config = s_config; //read-mostly data
+    //!   lookUp(config);
+    //! }
+    //! const Config* oldConfig = s_config;
+    //! s_config = newConfig;
+    //! epoch.retire(const_cast<Config*>(oldConfig), deleteConfig);
+    //!\endcode
+    //!
+{
+
+public:
+    typedef void(*cb0_t)(void* arg, void* item);
+
+    enum
+    {
+        DefaultBatchSize = 64,
+        MaxThreads = 256
+    };
+
+    Epoch(unsigned int batchSize = DefaultBatchSize);
+    ~Epoch();
+
+    bool tryAdvance();
+    unsigned int current() const;
+    unsigned int numThreads() const;
+    unsigned long long numReclaimed() const;
+    unsigned long long numRetired() const;
+    void detach();
+    void enter();
+    void exit();
+    void retire(void* item, cb0_t reclaim, void* arg = 0);
+    void retireBuf(void* buf, size_t size);
+    void synchronize();
+
+    static Epoch& instance();
+
+
+    //! epoch-protected critical section
+    class Guard
+        //!
+        //! A class representing a read-side critical section. Construct an instance
+        //! to enter an epoch-based reclamation domain, and destruct it to leave.
+        //! Items reachable during the critical section will not be reclaimed until
+        //! the instance is destructed. Guards can be nested. Example:
+        //!\code
+        //! {
+        //!   Epoch::Guard guard(Epoch::instance());
+        //!   traverseSharedData();
+        //! }
+        //!\endcode
+        //!
+    {
+    public:
+        Guard(Epoch& epoch);
+        ~Guard();
+    private:
+        Epoch& epoch_;
+        Guard(const Guard&); //prohibit usage
+        const Guard& operator=(const Guard&); //prohibit usage
+    };
+
+private:
+    enum
+    {
+        Active = 0x80000000U, //high bit, low bits hold the epoch
+        CacheLineSize = 64,
+        EpochMask = 0x7fffffffU
+    };
+
+    // Retired item. Items retired in the same thread are queued in epoch order.
+    typedef struct retired_s
+    {
+        struct retired_s* next;
+        void* item;
+        cb0_t reclaim;
+        void* arg;
+        unsigned int epoch;
+    } retired_t;
+
+    // Per-thread state. Each slot occupies its own cache line. The owner updates
+    // everything. Other threads read the state when advancing the epoch.
+    typedef struct slot_s
+    {
+        Atomic32 state;
+        Atomic32 inUse;
+        unsigned int nesting;
+        unsigned int numPending;
+        retired_t* head;
+        retired_t* tail;
+        unsigned long long numReclaimed;
+        unsigned long long numRetired;
+        unsigned char pad[CacheLineSize - 2 * sizeof(Atomic32) - 2 * sizeof(unsigned int) - 2 * sizeof(retired_t*) - 2 * sizeof(unsigned long long)];
+    } slot_t;
+
+    Atomic32 epoch_;
+    Atomic32 numSlots_;
+    SpinSection orphanSs_;
+    ThreadKey key_;
+    retired_t* orphan_;
+    slot_t* slot_;
+    unsigned int batchSize_;
+    unsigned long long numOrphansReclaimed_;
+
+    Epoch(const Epoch&); //prohibit usage
+    const Epoch& operator=(const Epoch&); //prohibit usage
+
+    slot_t* attach();
+    slot_t* mySlot();
+    unsigned int reclaimSlot(slot_t*, unsigned int);
+    unsigned int reclaimOrphans(unsigned int);
+
+    static bool isSafe(unsigned int, unsigned int);
+    static void freeBuf(void*, void*);
+
+};
+
+//! Return the current global epoch.
+inline unsigned int Epoch::current() const
+{
+    return epoch_.asWord();
+}
+
+//! Return the number of thread slots ever used.
+inline unsigned int Epoch::numThreads() const
+{
+    return numSlots_.asWord();
+}
+
+//! Return true if items retired in given epoch can be reclaimed in the current
+//! epoch. That is, if the epoch has advanced at least twice since. The unsigned
+//! difference tolerates wrap-around.
+inline bool Epoch::isSafe(unsigned int retiredEpoch, unsigned int currentEpoch)
+{
+    return ((currentEpoch - retiredEpoch) >= 2);
+}
+
+//! Return the calling thread's slot. Register the thread if necessary.
+inline Epoch::slot_t* Epoch::mySlot()
+{
+    slot_t* slot = static_cast<slot_t*>(key_.value());
+    return (slot != 0)? slot: attach();
+}
+
+//! Enter a read-side critical section. Critical sections can be nested.
+//! Items reachable while in a critical section will not be reclaimed until
+//! the outermost critical section is exited.
+inline void Epoch::enter()
+{
+    slot_t* slot = mySlot();
+    if (slot->nesting++ == 0)
+    {
+        slot->state = (epoch_.asWord() & EpochMask) | Active; //full fence
+    }
+}
+
+//! Exit a read-side critical section.
+inline void Epoch::exit()
+{
+    slot_t* slot = static_cast<slot_t*>(key_.value());
+    if (--slot->nesting == 0)
+    {
+        slot->state = epoch_.asWord() & EpochMask;
+    }
+}
+
+//! Retire given BufPool buffer of given size. The buffer will be freed via
+//! BufPool::freeBuf() when no reader can hold a reference to it.
+inline void Epoch::retireBuf(void* buf, size_t size)
+{
+    retire(buf, freeBuf, reinterpret_cast<void*>(size));
+}
+
+inline Epoch::Guard::Guard(Epoch& epoch):
+epoch_(epoch)
+{
+    epoch_.enter();
+}
+
+inline Epoch::Guard::~Guard()
+{
+    epoch_.exit();
+}
+
+END_NAMESPACE1
+
+#endif
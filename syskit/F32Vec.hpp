@@ -47,9 +47,15 @@ public:
     F32Vec(const F32Vec& vec);
     F32Vec(const F32Vec& vec, size_t startAt, size_t itemCount);
     F32Vec(unsigned int capacity = DefaultCap, int growBy = 0);
+#if HAS_RVALUE_REFS
+    F32Vec(F32Vec&& that);
+#endif
 
     // Operators.
     const F32Vec& operator =(const F32Vec& vec);
+#if HAS_RVALUE_REFS
+    const F32Vec& operator =(F32Vec&& that);
+#endif
     bool operator !=(const F32Vec& vec) const;
     bool operator ==(const F32Vec& vec) const;
     item_t operator [](size_t index) const;
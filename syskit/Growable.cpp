@@ -8,10 +8,18 @@
 
 const unsigned long long MAX_CAP = 0x00000000ffffffffULL;
 
+// Each big array starts with a header holding the mapped size in bytes.
+// The items follow the header. Keep them cache-line aligned.
+const size_t BIG_ARRAY_HEADER_SIZE = 64;
+
 BEGIN_NAMESPACE1(syskit)
 
 const unsigned int Growable::INVALID_INDEX = 0xffffffffU;
 
+bool volatile Growable::useHugePages_ = false;
+size_t volatile Growable::bigArraySize_ = 0;
+Atomic32 Growable::numBigArrays_(0);
+
 
 //!
 //! Construct a container with given capacity and growth factor. A container
@@ -23,6 +31,7 @@ const unsigned int Growable::INVALID_INDEX = 0xffffffffU;
 Growable::Growable(unsigned int capacity, int growBy)
 {
     growBy_ = growBy;
+    itemFlags_ = 0;
 
     setCapacity(capacity);
     initialCap_ = capacity_;
@@ -30,11 +39,13 @@ Growable::Growable(unsigned int capacity, int growBy)
 
 
 //!
-//! Construct a duplicate instance of the given container.
+//! Construct a duplicate instance of the given container. Item arrays
+//! are not shared, so none of them is a big array or a region array yet.
 //!
 Growable::Growable(const Growable& growable)
 {
     growBy_ = growable.growBy_;
+    itemFlags_ = 0;
 
     capacity_ = growable.capacity_;
     initialCap_ = growable.capacity_;
@@ -50,7 +61,8 @@ Growable::~Growable()
 
 
 //!
-//! Copy everything except the initial capacity from given instance.
+//! Copy everything except the initial capacity and the big array and region
+//! status of the item arrays from given instance.
 //!
 const Growable& Growable::operator =(const Growable& growable)
 {
@@ -111,6 +123,88 @@ bool Growable::setGrowth(int growBy)
 }
 
 
+//!
+//! Enable big arrays process-wide. Item arrays of at least minByteSize bytes
+//! allocated after this call will be backed by anonymous memory mappings and
+//! will grow in place if possible. Use huge pages if useHugePages is true.
+//! Return true if successful. Return false if big arrays are not supported
+//! on this platform. Existing arrays are not affected.
+//!
+bool Growable::enableBigArrays(size_t minByteSize, bool useHugePages)
+{
+    bool ok = canMap();
+    if (ok)
+    {
+        useHugePages_ = useHugePages;
+        bigArraySize_ = (minByteSize > 0)? minByteSize: 1;
+    }
+
+    return ok;
+}
+
+
+//
+// Free given big array.
+//
+void Growable::freeBig(void* item)
+{
+    unsigned char* addr = static_cast<unsigned char*>(item) - BIG_ARRAY_HEADER_SIZE;
+    size_t size = *reinterpret_cast<const size_t*>(addr);
+    unmapArray(addr, size);
+    --numBigArrays_;
+}
+
+
+//!
+//! Disable big arrays process-wide. Item arrays allocated after this call
+//! will come from the default c++ heap. Existing big arrays remain valid
+//! and are released normally.
+//!
+void Growable::disableBigArrays()
+{
+    bigArraySize_ = 0;
+}
+
+
+//
+// Allocate and return a big array of given size. Return zero if the
+// mapping cannot be created.
+//
+void* Growable::allocateBig(size_t byteSize)
+{
+    size_t size = BIG_ARRAY_HEADER_SIZE + byteSize;
+    unsigned char* addr = static_cast<unsigned char*>(mapArray(size, useHugePages_));
+    if (addr == 0)
+    {
+        return 0;
+    }
+
+    *reinterpret_cast<size_t*>(addr) = size;
+    ++numBigArrays_;
+    return addr + BIG_ARRAY_HEADER_SIZE;
+}
+
+
+//
+// Resize given big array in place if possible. The array can move
+// without copying on platforms supporting remapping. Return the
+// resulting array. Return zero if it cannot be resized.
+//
+void* Growable::resizeBig(void* item, size_t newByteSize)
+{
+    unsigned char* addr = static_cast<unsigned char*>(item) - BIG_ARRAY_HEADER_SIZE;
+    size_t size = BIG_ARRAY_HEADER_SIZE + newByteSize;
+    unsigned char* newAddr = static_cast<unsigned char*>(remapArray(addr, *reinterpret_cast<const size_t*>(addr), size, useHugePages_));
+    if (newAddr == 0)
+    {
+        return 0;
+    }
+
+    *reinterpret_cast<size_t*>(newAddr) = size;
+    return newAddr + BIG_ARRAY_HEADER_SIZE;
+}
+
+
 //!
 //! The container is growable and needs to grow. Compute and return
 //! the next capacity if growth occurs. Return zero if container is
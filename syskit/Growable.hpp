@@ -6,6 +6,8 @@
 #define SYSKIT_GROWABLE_HPP
 
 #include <string.h>
+#include "syskit/Atomic32.hpp"
+#include "syskit/Region.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -29,10 +31,24 @@ class Growable
     //!   growable.resize(initialCap);
     //! }
     //!\endcode
+    //! Containers growing to tens of millions of items can opt into big arrays
+    //! process-wide using enableBigArrays(). Where supported, item arrays of at
+    //! least bigArraySize() bytes are then backed by anonymous memory mappings
+    //! which grow in place without copying and can use huge pages. Each
+    //! container remembers which of its item arrays are big arrays, so
+    //! freeing an array needs neither a lookup nor a lock. An item array can
+    //! also be carved out of a caller-supplied region. Such an array is never
+    //! freed individually, and it is replaced by a heap array if the container
+    //! needs to grow.
     //!
 {
 
 public:
+    enum
+    {
+        DefaultBigArraySize = 32 * 1024 * 1024
+    };
+
     static const unsigned int INVALID_INDEX;
 
     bool canGrow() const;
@@ -41,6 +57,12 @@ public:
     unsigned int capacity() const;
     unsigned int initialCap() const;
 
+    // Big arrays.
+    static bool enableBigArrays(size_t minByteSize = DefaultBigArraySize, bool useHugePages = false);
+    static size_t bigArraySize();
+    static unsigned int numBigArrays();
+    static void disableBigArrays();
+
     virtual ~Growable();
     virtual bool resize(unsigned int newCap);
     virtual bool setGrowth(int growBy);
@@ -62,11 +84,45 @@ protected:
 
     virtual bool grow();
 
+    // Item arrays. A container with several item arrays tells them apart
+    // using the array argument (0..15).
+    template<typename T> T* allocateItems(unsigned int capacity, Region& region, unsigned int array = 0);
+    template<typename T> T* allocateItems(unsigned int capacity, unsigned int array = 0);
+    template<typename T> T* detachItems(T* item, unsigned int capacity, unsigned int numItems, unsigned int array = 0);
+    template<typename T> T* resizeItems(T* item, unsigned int newCap, unsigned int numItems, unsigned int array = 0);
+    template<typename T> void freeItems(T* item, unsigned int array = 0);
+    void adoptItems(Growable& that, unsigned int array = 0);
+
 private:
+    enum
+    {
+        RegionShift = 16
+    };
+
     int growBy_;
+    unsigned int itemFlags_; //bit i: item array i is a big array, bit 16+i: item array i is in a region
     unsigned int capacity_;
     unsigned int initialCap_;
 
+    static bool volatile useHugePages_;
+    static size_t volatile bigArraySize_;
+    static Atomic32 numBigArrays_;
+
+    bool isBig(unsigned int) const;
+    bool isInRegion(unsigned int) const;
+    void setBig(unsigned int, bool);
+    void setInRegion(unsigned int, bool);
+
+    static void freeBig(void*);
+    static void* allocateBig(size_t);
+    static void* resizeBig(void*, size_t);
+
+    // Platform-specific.
+    static bool canMap();
+    static void unmapArray(void*, size_t);
+    static void* mapArray(size_t&, bool);
+    static void* remapArray(void*, size_t, size_t&, bool);
+
 };
 
 #if _WIN32
@@ -132,6 +188,145 @@ inline void Growable::setCapacity(unsigned int capacity)
     capacity_ = ((growBy_ < 0) && (capacity == 0))? 1: capacity;
 }
 
+//! The given item array of that container has been handed over to this container.
+//! Take over its big array and region status. This container's own array must have
+//! been freed.
+inline void Growable::adoptItems(Growable& that, unsigned int array)
+{
+    setBig(array, that.isBig(array));
+    setInRegion(array, that.isInRegion(array));
+    that.setBig(array, false);
+    that.setInRegion(array, false);
+}
+
+inline bool Growable::isBig(unsigned int array) const
+{
+    return ((itemFlags_ >> array) & 1U) != 0;
+}
+
+inline bool Growable::isInRegion(unsigned int array) const
+{
+    return ((itemFlags_ >> (RegionShift + array)) & 1U) != 0;
+}
+
+inline void Growable::setBig(unsigned int array, bool big)
+{
+    big? (itemFlags_ |= (1U << array)): (itemFlags_ &= ~(1U << array));
+}
+
+inline void Growable::setInRegion(unsigned int array, bool inRegion)
+{
+    unsigned int mask = 1U << (RegionShift + array);
+    inRegion? (itemFlags_ |= mask): (itemFlags_ &= ~mask);
+}
+
+//! Return the minimum size in bytes of a big array. Return zero if big
+//! arrays are disabled.
+inline size_t Growable::bigArraySize()
+{
+    return bigArraySize_;
+}
+
+//! Return the number of big arrays currently in use.
+inline unsigned int Growable::numBigArrays()
+{
+    return numBigArrays_;
+}
+
+//! Allocate and return an array of capacity items to be used as the given
+//! item array. Carve the array out of given region. Items are not constructed,
+//! so T must be a plain type. The region must outlive the array. Freeing the
+//! array using freeItems() is still required but releases no memory. The
+//! memory is reclaimed when the region is reset or destructed.
+template<typename T> inline T* Growable::allocateItems(unsigned int capacity, Region& region, unsigned int array)
+{
+    void* buf = region.allocate(static_cast<size_t>(capacity) * sizeof(T));
+    setBig(array, false);
+    setInRegion(array, true);
+    return static_cast<T*>(buf);
+}
+
+//! Allocate and return an array of capacity items to be used as the given
+//! item array. Use a big array if big arrays are enabled and if the array
+//! is big enough. Use the default c++ heap otherwise. Free the array using
+//! freeItems() when done.
+template<typename T> inline T* Growable::allocateItems(unsigned int capacity, unsigned int array)
+{
+    size_t byteSize = static_cast<size_t>(capacity) * sizeof(T);
+    size_t minByteSize = bigArraySize_;
+    void* big = ((minByteSize > 0) && (byteSize >= minByteSize))? allocateBig(byteSize): 0;
+    setBig(array, big != 0);
+    setInRegion(array, false);
+    return (big != 0)? static_cast<T*>(big): new T[capacity];
+}
+
+//! Prepare given item array for detaching from its container. The returned array
+//! is allocated from the heap and is to be freed by the caller using the delete[]
+//! operator. A big array or a region array is copied into a heap array and then
+//! freed.
+template<typename T> inline T* Growable::detachItems(T* item, unsigned int capacity, unsigned int numItems, unsigned int array)
+{
+    if ((!isBig(array)) && (!isInRegion(array)))
+    {
+        return item;
+    }
+
+    T* raw = new T[capacity];
+    memcpy(raw, item, static_cast<size_t>(numItems) * sizeof(T));
+    freeItems(item, array);
+    return raw;
+}
+
+//! Resize given item array to newCap items preserving the first numItems items.
+//! A big array grows or shrinks in place if possible. Otherwise, a new array
+//! is allocated, the utilized items are copied, and the given array is freed.
+//! A region array is always replaced by an array from the heap. Return the
+//! resulting array.
+template<typename T> inline T* Growable::resizeItems(T* item, unsigned int newCap, unsigned int numItems, unsigned int array)
+{
+    bool big = isBig(array);
+    bool inRegion = isInRegion(array);
+    size_t newByteSize = static_cast<size_t>(newCap) * sizeof(T);
+    size_t minByteSize = bigArraySize_;
+    void* resized = (big && (minByteSize > 0) && (newByteSize >= minByteSize))? resizeBig(item, newByteSize): 0;
+    if (resized != 0)
+    {
+        return static_cast<T*>(resized);
+    }
+
+    T* newItem = allocateItems<T>(newCap, array);
+    memcpy(newItem, item, static_cast<size_t>(numItems) * sizeof(T));
+    if (big)
+    {
+        freeBig(item);
+    }
+    else if (!inRegion)
+    {
+        delete[] item;
+    }
+
+    return newItem;
+}
+
+//! Free given item array allocated using allocateItems() or resizeItems().
+//! A region array is left for the region to reclaim.
+template<typename T> inline void Growable::freeItems(T* item, unsigned int array)
+{
+    if (isBig(array))
+    {
+        freeBig(item);
+        setBig(array, false);
+    }
+    else if (isInRegion(array))
+    {
+        setInRegion(array, false);
+    }
+    else
+    {
+        delete[] item;
+    }
+}
+
 END_NAMESPACE1
 
 #include "syskit/win/link-with-syskit.h"
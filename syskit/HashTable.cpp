@@ -7,6 +7,7 @@
 #include "syskit-pch.h"
 #include "syskit/HashTable.hpp"
 #include "syskit/Prime.hpp"
+#include "syskit/ThreadPool.hpp"
 #include "syskit/macros.h"
 
 inline void incrementWmark(unsigned int& counter, unsigned int& wmark)
@@ -17,6 +18,18 @@ inline void incrementWmark(unsigned int& counter, unsigned int& wmark)
     }
 }
 
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    syskit::HashTable::cb2_t cb;
+    void* arg;
+    syskit::ThreadPool::Reduction* reduction;
+    const syskit::HashTable* table;
+} applyArg_t;
+
+END_NAMESPACE
+
 BEGIN_NAMESPACE1(syskit)
 
 
@@ -262,16 +275,17 @@ bool HashTable::apply(cb0_t cb, void* arg) const
 
 
 //!
-//! Locate given item. Behavior is unpredictable if the hash function
-//! does not behave. Return true if found (also return the found item
-//! in foundItem). Return false otherwise. Use given compatible comparison
-//! function for this search.
+//! Locate given item. Use given compatible hash and comparison functions for
+//! this search. That is, the hash function must map given item to the bucket
+//! where an equal item resides. This allows searching with an item of another
+//! form (e.g., a key instead of a key-value pair). Return true if found (also
+//! return the found item in foundItem). Return false otherwise.
 //!
-bool HashTable::find(const void* item, diff_t diff, item_t& foundItem) const
+bool HashTable::find(const void* item, hash_t hash, diff_t diff, item_t& foundItem) const
 {
     bool found = false;
     size_t numBuckets = capacity();
-    size_t i = hash_(item, numBuckets);
+    size_t i = hash(item, numBuckets);
     for (const node_t* p = bucket_[i]; p != 0; p = p->next)
     {
         if (diff(item, p->item) == 0)
@@ -332,17 +346,17 @@ bool HashTable::resize(unsigned int newCap)
 
 
 //!
-//! Locate given item. Use given compatible comparison function. Behavior is
-//! unpredictable if the hash function does not behave. If found, remove it
-//! from the table and return true (also return the removed item in removedItem).
-//! Return false otherwise.
+//! Locate given item. Use given compatible hash and comparison functions. That
+//! is, the hash function must map given item to the bucket where an equal item
+//! resides. If found, remove it from the table and return true (also return the
+//! removed item in removedItem). Return false otherwise.
 //!
-bool HashTable::rm(const void* item, diff_t diff, item_t& removedItem)
+bool HashTable::rm(const void* item, hash_t hash, diff_t diff, item_t& removedItem)
 {
     bool ok = false;
     node_t* prev = 0;
     size_t numBuckets = capacity();
-    size_t i = hash_(item, numBuckets);
+    size_t i = hash(item, numBuckets);
     for (node_t* p = bucket_[i]; p != 0; prev = p, p = p->next)
     {
         if (diff(item, p->item) == 0)
@@ -397,6 +411,40 @@ void HashTable::apply(cb1_t cb, void* arg) const
     }
 }
 
+//!
+//! Apply callback to all entries in parallel using given thread pool (the process-wide
+//! pool if zero). The buckets are partitioned into ranges. Each range gets its own
+//! partial result from open(arg), the callback is invoked as cb(arg, partial, item),
+//! and the partial result is handed back via close(arg, partial). The close hook is
+//! serialized. Either hook can be zero. The callback must be thread-safe.
+//!
+void HashTable::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const
+{
+    ThreadPool& threadPool = (pool != 0)? *pool: ThreadPool::instance();
+    ThreadPool::Reduction reduction(open, close, arg);
+    applyArg_t applyArg = {cb, arg, &reduction, this};
+    threadPool.apply(capacity(), applyRange, &applyArg);
+}
+
+
+//
+// Apply callback to entries in the [loIndex, hiIndex) bucket range using one partial result.
+//
+void HashTable::applyRange(void* arg, size_t loIndex, size_t hiIndex)
+{
+    const applyArg_t* p = static_cast<const applyArg_t*>(arg);
+    void* partial = p->reduction->open();
+    node_t* const* bucket = p->table->bucket_;
+    for (size_t i = loIndex; i < hiIndex; ++i)
+    {
+        for (const node_t* node = bucket[i]; node != 0; node = node->next)
+        {
+            p->cb(p->arg, partial, node->item);
+        }
+    }
+    p->reduction->close(partial);
+}
+
 
 //
 // Copy items from given hash table. Metadata has already been copy.
@@ -13,6 +13,8 @@ class HashTableSuite;
 
 BEGIN_NAMESPACE1(syskit)
 
+class ThreadPool;
+
 
 //! hash table of opaque items
 class HashTable: public Growable
@@ -48,6 +50,9 @@ public:
 
     typedef unsigned int(*hash_t)(const void* item, size_t numBuckets);
     typedef void(*cb1_t)(void* arg, item_t item);
+    typedef void(*cb2_t)(void* arg, void* partial, item_t item);
+    typedef void(*close_t)(void* arg, void* partial);
+    typedef void* (*open_t)(void* arg);
 
     // Constructors.
     HashTable(diff_t diff, hash_t hash, unsigned int capacity = DefaultCap, double bucketCap = 1.0);
@@ -64,10 +69,12 @@ public:
     bool find(const void* item) const;
     bool find(const void* item, diff_t diff) const;
     bool find(const void* item, diff_t diff, item_t& foundItem) const;
+    bool find(const void* item, hash_t hash, diff_t diff, item_t& foundItem) const;
     bool find(const void* item, item_t& foundItem) const;
     bool rm(const void* item);
     bool rm(const void* item, diff_t diff);
     bool rm(const void* item, diff_t, item_t& removedItem);
+    bool rm(const void* item, hash_t hash, diff_t diff, item_t& removedItem);
     bool rm(const void* item, item_t& removedItem);
     void reset();
 
@@ -85,6 +92,7 @@ public:
     // Iterator support.
     bool apply(cb0_t cb, void* arg = 0) const;
     void apply(cb1_t cb, void* arg = 0) const;
+    void applyParallel(cb2_t cb, void* arg = 0, open_t open = 0, close_t close = 0, ThreadPool* pool = 0) const;
 
     // Override Growable.
     virtual ~HashTable();
@@ -119,6 +127,8 @@ private:
     void copy(const node_t* const*, size_t);
     void rehash(node_t* const*, unsigned int);
 
+    static void applyRange(void*, size_t, size_t);
+
     friend class ::HashTableSuite;
 
 };
@@ -171,6 +181,16 @@ inline bool HashTable::find(const void* item, diff_t diff) const
     return found;
 }
 
+//! Locate given item. Behavior is unpredictable if the hash function
+//! does not behave. Return true if found (also return the found item
+//! in foundItem). Return false otherwise. Use given compatible comparison
+//! function for this search.
+inline bool HashTable::find(const void* item, diff_t diff, item_t& foundItem) const
+{
+    bool found = find(item, hash_, diff, foundItem);
+    return found;
+}
+
 //! Locate given item. Behavior is unpredictable if the hash function
 //! does not behave. Return true if found (also return the found item
 //! in foundItem). Return false otherwise.
@@ -198,6 +218,16 @@ inline bool HashTable::rm(const void* item, diff_t diff)
     return found;
 }
 
+//! Locate given item. Use given compatible comparison function. Behavior is
+//! unpredictable if the hash function does not behave. If found, remove it
+//! from the table and return true (also return the removed item in removedItem).
+//! Return false otherwise.
+inline bool HashTable::rm(const void* item, diff_t diff, item_t& removedItem)
+{
+    bool found = rm(item, hash_, diff, removedItem);
+    return found;
+}
+
 //! Locate given item. Behavior is unpredictable if the hash function does not
 //! behave. If found, remove it from the table and return true (also return the
 //! removed item in removedItem). Return false otherwise.
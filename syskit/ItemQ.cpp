@@ -223,6 +223,17 @@ bool ItemQ::put(Item* item, unsigned int timeoutInMsecs)
 }
 
 
+//!
+//! Collect contention statistics for the queue lock under given name.
+//! The statistics are updated while lock profiling is enabled (see LockStat).
+//!
+void ItemQ::profileLock(const char* name)
+{
+    SpinSection::Lock lock(ss_);
+    ss_.startProfiling(name);
+}
+
+
 ItemQ::Item::Item()
 {
 }
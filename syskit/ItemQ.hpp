@@ -69,6 +69,7 @@ public:
     bool expedite(Item* item, unsigned int timeoutInMsecs = ETERNITY);
     bool get(Item*& item, unsigned int timeoutInMsecs = ETERNITY);
     bool put(Item* item, unsigned int timeoutInMsecs = ETERNITY);
+    void profileLock(const char* name);
     void resetStat();
 
     virtual ~ItemQ();
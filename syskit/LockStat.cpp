@@ -0,0 +1,269 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "syskit-pch.h"
+#include "syskit/LockStat.hpp"
+#include "syskit/SpinSection.hpp"
+#include "syskit/TickTime.hpp"
+#include "syskit/sys.hpp"
+
+const size_t LINE_SIZE = 256;
+
+BEGIN_NAMESPACE
+
+// Protects the registry. This lock itself is never profiled.
+syskit::SpinSection s_registrySs;
+
+// Compare two stats. Higher wait time first. More contentions first.
+int compareWait(const void* item0, const void* item1)
+{
+    const syskit::LockStat* stat0 = *static_cast<const syskit::LockStat* const*>(item0);
+    const syskit::LockStat* stat1 = *static_cast<const syskit::LockStat* const*>(item1);
+    if (stat0->waitTime() != stat1->waitTime())
+    {
+        return (stat0->waitTime() > stat1->waitTime())? -1: 1;
+    }
+    if (stat0->numContentions() != stat1->numContentions())
+    {
+        return (stat0->numContentions() > stat1->numContentions())? -1: 1;
+    }
+
+    return 0;
+}
+
+END_NAMESPACE
+
+BEGIN_NAMESPACE1(syskit)
+
+LockStat* LockStat::head_ = 0;
+bool volatile LockStat::enabled_ = false;
+unsigned int LockStat::numLocks_ = 0;
+
+
+//!
+//! Construct empty statistics for a lock with given name and kind. The
+//! instance is registered so describe() can report it. The name is copied.
+//! The kind is not and must persist (typically a string literal).
+//!
+LockStat::LockStat(const char* name, const char* kind)
+{
+    size_t n = strlen(name) + 1;
+    name_ = new char[n];
+    memcpy(name_, name, n);
+    kind_ = kind;
+    depth_ = 0;
+    holdStart_ = 0;
+    reset();
+
+    SpinSection::Lock lock(s_registrySs);
+    prev_ = 0;
+    next_ = head_;
+    if (head_ != 0)
+    {
+        head_->prev_ = this;
+    }
+    head_ = this;
+    ++numLocks_;
+}
+
+
+LockStat::~LockStat()
+{
+    {
+        SpinSection::Lock lock(s_registrySs);
+        (prev_ == 0)? (head_ = next_): (prev_->next_ = next_);
+        if (next_ != 0)
+        {
+            next_->prev_ = prev_;
+        }
+        --numLocks_;
+    }
+
+    delete[] name_;
+}
+
+
+//!
+//! Save a report of the most contended locks, at most maxLocks of them, in
+//! given file. Return true if successful.
+//!
+bool LockStat::dump(const char* path, unsigned int maxLocks)
+{
+    std::FILE* f = std::fopen(path, "wb");
+    bool ok = (f != 0);
+    if (ok)
+    {
+        char* text = describe(maxLocks);
+        size_t n = strlen(text);
+        ok = (std::fwrite(text, 1, n, f) == n);
+        ok = (std::fclose(f) == 0) && ok;
+        delete[] text;
+    }
+
+    return ok;
+}
+
+
+//!
+//! Return a report of the most contended locks, at most maxLocks of them,
+//! ordered by total wait time. The returned text is allocated from the heap,
+//! and the caller is responsible for deleting it using the delete[] operator.
+//!
+char* LockStat::describe(unsigned int maxLocks)
+{
+    char line[LINE_SIZE];
+    double usecsPerTick = 1000000.0 / TickTime::ticksPerSec();
+    SpinSection::Lock lock(s_registrySs);
+
+    // Rank all registered locks.
+    unsigned int numLocks = numLocks_;
+    const LockStat** stat = new const LockStat*[numLocks + 1];
+    unsigned int i = 0;
+    for (const LockStat* p = head_; p != 0; p = p->next_)
+    {
+        stat[i++] = p;
+    }
+    qsort(stat, numLocks, sizeof(*stat), compareWait);
+    if (maxLocks > numLocks)
+    {
+        maxLocks = numLocks;
+    }
+
+    // Header. Each lock then occupies one line, plus one line of
+    // non-empty wait histogram buckets if contended.
+    size_t capacity = (maxLocks * 2 + 4) * LINE_SIZE;
+    char* text = new char[capacity];
+    size_t length = sprintf_s(text, capacity, "Lock profile: %s, %u locks\n\n%-32s%-12s%12s%12s%14s%12s%12s%12s\n",
+        enabled_? "running": "stopped", numLocks,
+        "name", "kind", "acquires", "contended", "spins", "wait(us)", "hold(us)", "maxWait(us)");
+
+    // Body.
+    for (i = 0; i < maxLocks; ++i)
+    {
+        const LockStat& s = *stat[i];
+        int n = sprintf_s(line, sizeof(line), "%-32s%-12s%12llu%12llu%14llu%12.0f%12.0f%12.1f\n",
+            s.name_, s.kind_,
+            s.numAcquisitions_, s.numContentions_, s.numSpins_,
+            s.waitTime_ * usecsPerTick, s.holdTime_ * usecsPerTick, s.maxWaitTime_ * usecsPerTick);
+        memcpy(text + length, line, n + 1);
+        length += n;
+        if (s.numContentions_ == 0)
+        {
+            continue;
+        }
+
+        // Show the wait histogram as usecs:count pairs.
+        n = sprintf_s(line, sizeof(line), "%-32s", "  waits(us):");
+        for (unsigned int b = 0; b < NumBuckets; ++b)
+        {
+            if ((s.waitHist_[b] > 0) && (n < static_cast<int>(LINE_SIZE) - 40))
+            {
+                n += sprintf_s(line + n, sizeof(line) - n, " <%u:%llu", 1U << b, s.waitHist_[b]);
+            }
+        }
+        line[n++] = '\n';
+        line[n] = 0;
+        memcpy(text + length, line, n + 1);
+        length += n;
+    }
+
+    delete[] stat;
+    return text;
+}
+
+
+//
+// Return the log2 bucket of given wait time.
+//
+unsigned int LockStat::bucketOf(unsigned long long ticks)
+{
+    unsigned long long usecs = ticks * 1000000ULL / TickTime::ticksPerSec();
+    unsigned int b = 0;
+    for (; usecs != 0; usecs >>= 1, ++b);
+    return (b < NumBuckets)? b: (NumBuckets - 1);
+}
+
+
+//!
+//! Record an acquisition. Must be invoked by the lock owner while holding
+//! the lock. The wait started at waitStart ticks if the acquisition was
+//! contended. The waitStart value is zero otherwise. The lock spun
+//! numSpins times while waiting.
+//!
+void LockStat::onLock(unsigned long long waitStart, unsigned int numSpins)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+
+    // Recursive acquisition. Not contended.
+    if (++depth_ > 1)
+    {
+        ++numAcquisitions_;
+        return;
+    }
+
+    unsigned long long now = TickTime::curTime();
+    holdStart_ = now;
+    ++numAcquisitions_;
+    numSpins_ += numSpins;
+    if (waitStart != 0)
+    {
+        unsigned long long wait = now - waitStart;
+        ++numContentions_;
+        waitTime_ += wait;
+        if (wait > maxWaitTime_)
+        {
+            maxWaitTime_ = wait;
+        }
+        ++waitHist_[bucketOf(wait)];
+    }
+}
+
+
+//!
+//! Record a release. Must be invoked by the lock owner before releasing the lock.
+//!
+void LockStat::onUnlock()
+{
+    if ((depth_ > 0) && (--depth_ == 0))
+    {
+        holdTime_ += TickTime::curTime() - holdStart_;
+    }
+}
+
+
+//!
+//! Reset the statistics. An ongoing hold is still measured.
+//!
+void LockStat::reset()
+{
+    holdTime_ = 0;
+    maxWaitTime_ = 0;
+    numAcquisitions_ = 0;
+    numContentions_ = 0;
+    numSpins_ = 0;
+    waitTime_ = 0;
+    memset(waitHist_, 0, sizeof(waitHist_));
+}
+
+
+//!
+//! Reset the statistics of all registered locks.
+//!
+void LockStat::resetAll()
+{
+    SpinSection::Lock lock(s_registrySs);
+    for (LockStat* p = head_; p != 0; p = p->next_)
+    {
+        p->reset();
+    }
+}
+
+END_NAMESPACE1
@@ -0,0 +1,161 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_LOCK_STAT_HPP
+#define SYSKIT_LOCK_STAT_HPP
+
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//! lock contention statistics
+class LockStat
+    //!
+    //! A class representing the contention statistics of a named lock. A
+    //! SpinSection, CriSection, or Mutex instance owns a LockStat instance
+    //! after its startProfiling() method is invoked. The lock reports its
+    //! acquisitions and releases, and the statistics are updated while the
+    //! lock is held. Recording occurs only while profiling is enabled
+    //! process-wide using enable(). All LockStat instances are registered,
+    //! and describe() reports the most contended ones. Times are in ticks
+    //! (see TickTime).
+    //!
+{
+
+public:
+    enum
+    {
+        DefaultMaxLocks = 16,
+        NumBuckets = 24
+    };
+
+    LockStat(const char* name, const char* kind);
+    ~LockStat();
+
+    const char* kind() const;
+    const char* name() const;
+    const unsigned long long* waitHist() const;
+    unsigned long long holdTime() const;
+    unsigned long long maxWaitTime() const;
+    unsigned long long numAcquisitions() const;
+    unsigned long long numContentions() const;
+    unsigned long long numSpins() const;
+    unsigned long long waitTime() const;
+    void reset();
+
+    // Used by locks.
+    void onLock(unsigned long long waitStart, unsigned int numSpins);
+    void onUnlock();
+
+    static bool dump(const char* path, unsigned int maxLocks = DefaultMaxLocks);
+    static bool isEnabled();
+    static char* describe(unsigned int maxLocks = DefaultMaxLocks);
+    static unsigned int numLocks();
+    static void enable(bool enabled);
+    static void resetAll();
+
+private:
+    LockStat* next_;
+    LockStat* prev_;
+    char* name_;
+    const char* kind_;
+    unsigned int depth_;
+    unsigned long long holdStart_;
+    unsigned long long holdTime_;
+    unsigned long long maxWaitTime_;
+    unsigned long long numAcquisitions_;
+    unsigned long long numContentions_;
+    unsigned long long numSpins_;
+    unsigned long long waitTime_;
+    unsigned long long waitHist_[NumBuckets]; //log2(usecs)
+
+    static LockStat* head_;
+    static bool volatile enabled_;
+    static unsigned int numLocks_;
+
+    LockStat(const LockStat&); //prohibit usage
+    const LockStat& operator =(const LockStat&); //prohibit usage
+
+    static unsigned int bucketOf(unsigned long long);
+
+};
+
+//! Return the lock kind (e.g., "SpinSection").
+inline const char* LockStat::kind() const
+{
+    return kind_;
+}
+
+//! Return the lock name.
+inline const char* LockStat::name() const
+{
+    return name_;
+}
+
+//! Return the wait time histogram. Bucket zero counts contended waits shorter
+//! than one microsecond. Bucket b counts waits in the [2**(b-1), 2**b) usecs
+//! range. The last bucket also counts longer waits.
+inline const unsigned long long* LockStat::waitHist() const
+{
+    return waitHist_;
+}
+
+//! Return the total hold time in ticks.
+inline unsigned long long LockStat::holdTime() const
+{
+    return holdTime_;
+}
+
+//! Return the longest wait time in ticks.
+inline unsigned long long LockStat::maxWaitTime() const
+{
+    return maxWaitTime_;
+}
+
+//! Return the number of acquisitions.
+inline unsigned long long LockStat::numAcquisitions() const
+{
+    return numAcquisitions_;
+}
+
+//! Return the number of contended acquisitions.
+inline unsigned long long LockStat::numContentions() const
+{
+    return numContentions_;
+}
+
+//! Return the total number of spin iterations.
+inline unsigned long long LockStat::numSpins() const
+{
+    return numSpins_;
+}
+
+//! Return the total wait time in ticks.
+inline unsigned long long LockStat::waitTime() const
+{
+    return waitTime_;
+}
+
+//! Return true if lock profiling is enabled process-wide.
+inline bool LockStat::isEnabled()
+{
+    return enabled_;
+}
+
+//! Return the number of registered instances.
+inline unsigned int LockStat::numLocks()
+{
+    return numLocks_;
+}
+
+//! Enable or disable lock profiling process-wide.
+inline void LockStat::enable(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+END_NAMESPACE1
+
+#endif
@@ -3,6 +3,7 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include "syskit-pch.h"
+#include "syskit/LockStat.hpp"
 #include "syskit/Mutex.hpp"
 #include "syskit/macros.h"
 
@@ -28,4 +29,23 @@ Mutex::Lock::~Lock()
     mutex_.unlock();
 }
 
+
+//!
+//! Start collecting contention statistics under given name. The statistics
+//! are registered process-wide and are updated while profiling is enabled
+//! (see LockStat::enable()). If already profiled, the existing statistics
+//! are reset and kept under their original name.
+//!
+void Mutex::startProfiling(const char* name)
+{
+    if (stat_ == 0)
+    {
+        stat_ = new LockStat(name, "Mutex");
+    }
+    else
+    {
+        stat_->reset();
+    }
+}
+
 END_NAMESPACE1
@@ -9,6 +9,8 @@
 
 BEGIN_NAMESPACE1(syskit)
 
+class LockStat;
+
 
 //! mutual exclusion device
 class Mutex
@@ -20,7 +22,8 @@ class Mutex
     //! should be locked/unlocked by contructing/destructing a lock using
     //! Mutex::Lock. Use Mutex::lock() and Mutex::unlock() only if Mutex::Lock
     //! is not feasible. Use tryLock() to avoid blocking calls. Recursive locks
-    //! are not allowed. That is, recursive locks will result in a deadlock. Example:
+    //! are not allowed. That is, recursive locks will result in a deadlock. Use
+    //! startProfiling() to collect contention statistics (see LockStat). Example:
     //!\code
     //! static Mutex s_mutex;
     //! s_mutex.lock();
@@ -41,6 +44,8 @@ public:
     bool lock();
     bool tryLock();
     bool unlock();
+    const LockStat* stat() const;
+    void startProfiling(const char* name);
 
 
     //!
@@ -69,12 +74,19 @@ public:
 
 private:
     mutex_t mu_;
+    LockStat* stat_;
 
     Mutex(const Mutex&); //prohibit usage
     const Mutex& operator=(const Mutex&); //prohibit usage
 
 };
 
+//! Return the contention statistics. Return zero if not profiled.
+inline const LockStat* Mutex::stat() const
+{
+    return stat_;
+}
+
 END_NAMESPACE1
 
 #endif
@@ -5,6 +5,7 @@
 #include "syskit-pch.h"
 #include "syskit/RefCounted.hpp"
 #include "syskit/macros.h"
+#include "syskit/sys.hpp"
 
 BEGIN_NAMESPACE1(syskit)
 
@@ -12,10 +13,12 @@ BEGIN_NAMESPACE1(syskit)
 //!
 //! Construct a reference-counted instance with given initial reference count.
 //! A reference-counted instance is destroyed when its reference count reaches
-//! zero via a rmRef() method.
+//! zero via a rmRef() method. An unshared instance updates its reference count
+//! using plain operations and must not be referenced by other threads until
+//! share() is invoked.
 //!
-RefCounted::RefCounted(unsigned int initialRefCount):
-count_(initialRefCount)
+RefCounted::RefCounted(unsigned int initialRefCount, bool isShared):
+count_(isShared? initialRefCount: (initialRefCount | Unshared))
 {
 }
 
@@ -42,8 +45,28 @@ RefCounted* RefCounted::clone() const
 //!
 bool RefCounted::rmRef() const
 {
+
+    // Releasing the last reference. No other thread can hold a reference,
+    // so the atomic decrement is unnecessary.
+    unsigned int count = count_.asWord();
     bool destroyed;
-    if (--count_ == 0U)
+    if ((count & ~Unshared) == 1U)
+    {
+        loadFence();
+        count_.setNonAtomic(count - 1);
+        destroy();
+        destroyed = true;
+    }
+
+    // Unshared instance.
+    else if ((count & Unshared) != 0U)
+    {
+        count_.setNonAtomic(count - 1);
+        destroyed = false;
+    }
+
+    // Shared instance.
+    else if (--count_ == 0U)
     {
         destroy();
         destroyed = true;
@@ -64,19 +87,38 @@ bool RefCounted::rmRef() const
 //!
 bool RefCounted::rmRef(unsigned int delta) const
 {
+
+    // Releasing the last references. No other thread can hold a reference,
+    // so the atomic decrement is unnecessary.
+    unsigned int count = count_.asWord();
     bool destroyed;
-    unsigned int oldRefCount;
-    count_.decrementBy(delta, oldRefCount);
-    if (oldRefCount == delta)
+    if ((count & ~Unshared) == delta)
     {
+        loadFence();
+        count_.setNonAtomic(count - delta);
         destroy();
         destroyed = true;
     }
-    else
+
+    // Unshared instance.
+    else if ((count & Unshared) != 0U)
     {
+        count_.setNonAtomic(count - delta);
         destroyed = false;
     }
 
+    // Shared instance.
+    else
+    {
+        unsigned int oldRefCount;
+        count_.decrementBy(delta, oldRefCount);
+        destroyed = (oldRefCount == delta);
+        if (destroyed)
+        {
+            destroy();
+        }
+    }
+
     return destroyed;
 }
 
@@ -19,7 +19,11 @@ class RefCounted
     //! classes can override the destroy() method if some application-specific code is
     //! required right before destruction or if the object cannot be destroyed via the
     //! delete operator. Derived classes should implement the clone() method if duplication
-    //! of the reference-counted objects is allowed. Example:
+    //! of the reference-counted objects is allowed. By default, the reference count
+    //! is updated atomically, except that releasing the last reference skips the
+    //! atomic decrement since no other thread can hold a reference at that point. An
+    //! instance constructed as unshared uses plain updates instead, and must not be
+    //! referenced by other threads until share() is invoked. Example:
     //!\code
     //! singleton->addRef(); //mark singleton in-use
     //! :
@@ -51,24 +55,31 @@ public:
         const Count& operator =(const Count&); //prohibit usage
     };
 
+    bool isShared() const;
     bool rmRef() const;
     bool rmRef(unsigned int delta) const;
     unsigned int refCount() const;
     void addRef() const;
     void decrementRefBy(unsigned int delta) const;
     void incrementRefBy(unsigned int delta) const;
+    void share() const;
 
     virtual RefCounted* clone() const;
 
     static bool rmRef(RefCounted* refCounted);
 
 protected:
-    RefCounted(unsigned int initialRefCount = 0U);
+    RefCounted(unsigned int initialRefCount = 0U, bool isShared = true);
 
     virtual ~RefCounted();
     virtual void destroy() const;
 
 private:
+    enum
+    {
+        Unshared = 0x80000000U //high bit, low bits hold the count
+    };
+
     Atomic32 mutable count_;
 
     RefCounted(const RefCounted&); //prohibit usage
@@ -85,31 +96,70 @@ inline bool RefCounted::rmRef(RefCounted* refCounted)
     return destroyed;
 }
 
+//! Return true if the reference count is updated atomically. That is, if
+//! the instance can be referenced by multiple threads.
+inline bool RefCounted::isShared() const
+{
+    return ((count_.asWord() & Unshared) == 0U);
+}
+
 //! Return the current reference count.
 inline unsigned int RefCounted::refCount() const
 {
-    return count_.asWord();
+    return count_.asWord() & ~Unshared;
 }
 
 //! Increment reference count. A reference-counted instance is destroyed
 //! when its reference count reaches zero via a rmRef() method.
 inline void RefCounted::addRef() const
 {
-    ++count_;
+    unsigned int count = count_.asWord();
+    if ((count & Unshared) == 0U)
+    {
+        ++count_;
+    }
+    else
+    {
+        count_.setNonAtomic(count + 1);
+    }
 }
 
 //! Decrement reference count by given delta. A reference-counted instance
 //! is destroyed when its reference count reaches zero via a rmRef() method.
 inline void RefCounted::decrementRefBy(unsigned int delta) const
 {
-    count_ -= delta;
+    unsigned int count = count_.asWord();
+    if ((count & Unshared) == 0U)
+    {
+        count_ -= delta;
+    }
+    else
+    {
+        count_.setNonAtomic(count - delta);
+    }
 }
 
 //! Increment reference count by given delta. A reference-counted instance
 //! is destroyed when its reference count reaches zero via a rmRef() method.
 inline void RefCounted::incrementRefBy(unsigned int delta) const
 {
-    count_ += delta;
+    unsigned int count = count_.asWord();
+    if ((count & Unshared) == 0U)
+    {
+        count_ += delta;
+    }
+    else
+    {
+        count_.setNonAtomic(count + delta);
+    }
+}
+
+//! Switch an unshared instance to atomic reference counting. Must be invoked
+//! before the instance is made available to other threads. No-op if already
+//! shared.
+inline void RefCounted::share() const
+{
+    count_.setNonAtomic(count_.asWord() & ~Unshared);
 }
 
 END_NAMESPACE1
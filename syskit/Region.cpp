@@ -0,0 +1,157 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit-pch.h"
+#include "syskit/Region.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Construct an empty region. Memory is obtained from the default c++ heap
+//! in chunks of chunkSize bytes as needed. Allocations larger than a quarter
+//! of a chunk get dedicated chunks to avoid wasting the unused tail of the
+//! current chunk.
+//!
+Region::Region(size_t chunkSize)
+{
+    capacity_ = 0;
+    chunkSize_ = (chunkSize < 256)? 256: chunkSize;
+    chunk_ = 0;
+    end_ = 0;
+    numBytes_ = 0;
+    numChunks_ = 0;
+    top_ = 0;
+}
+
+
+//!
+//! Destruct region. All allocations are released. Objects residing in the
+//! region are not destructed.
+//!
+Region::~Region()
+{
+    for (chunk_t* next; chunk_ != 0; chunk_ = next)
+    {
+        next = chunk_->next;
+        delete[] reinterpret_cast<unsigned char*>(chunk_);
+    }
+}
+
+
+//!
+//! Free given buffer. Only the most recent allocation can actually be freed.
+//! Freeing other buffers is a no-op, and their memory is reclaimed when the
+//! region is reset or destructed. Return true if the buffer was reclaimed.
+//!
+bool Region::free(const void* p, size_t size)
+{
+    size_t alignedSize = (size + Alignment - 1) & ~static_cast<size_t>(Alignment - 1);
+    bool ok = (p != 0) && (static_cast<const unsigned char*>(p) + alignedSize == top_);
+    if (ok)
+    {
+        top_ -= alignedSize;
+        numBytes_ -= alignedSize;
+    }
+
+    return ok;
+}
+
+
+//!
+//! Return true if given address resides in this region.
+//! This is a linear search through the held chunks.
+//!
+bool Region::ownsAddr(const void* addr) const
+{
+    const unsigned char* p = static_cast<const unsigned char*>(addr);
+    for (chunk_t* chunk = chunk_; chunk != 0; chunk = chunk->next)
+    {
+        const unsigned char* base = chunkBase(chunk);
+        if ((p >= base) && (p < base + chunk->size))
+        {
+            bool owned = true;
+            return owned;
+        }
+    }
+
+    bool owned = false;
+    return owned;
+}
+
+
+//!
+//! Release all allocations in bulk. Objects residing in the region are not
+//! destructed. One regular chunk is retained for reuse, and all others are
+//! returned to the heap.
+//!
+void Region::reset()
+{
+    chunk_t* kept = 0;
+    for (chunk_t* next; chunk_ != 0; chunk_ = next)
+    {
+        next = chunk_->next;
+        if ((kept == 0) && (chunk_->size == chunkSize_))
+        {
+            kept = chunk_;
+            continue;
+        }
+        delete[] reinterpret_cast<unsigned char*>(chunk_);
+    }
+
+    chunk_ = kept;
+    numBytes_ = 0;
+    if (kept == 0)
+    {
+        capacity_ = 0;
+        end_ = 0;
+        numChunks_ = 0;
+        top_ = 0;
+    }
+    else
+    {
+        kept->next = 0;
+        capacity_ = chunkSize_;
+        numChunks_ = 1;
+        top_ = chunkBase(kept);
+        end_ = top_ + chunkSize_;
+    }
+}
+
+
+//
+// Current chunk is exhausted. Allocate given aligned size from a new chunk.
+// Use a dedicated chunk for a large allocation and keep bumping from the
+// current chunk. Otherwise, start a new regular chunk.
+//
+void* Region::allocateSlow(size_t alignedSize)
+{
+    bool isLarge = (alignedSize > (chunkSize_ >> 2));
+    size_t size = isLarge? alignedSize: chunkSize_;
+    unsigned char* mem = new unsigned char[HeaderSize + size];
+    chunk_t* chunk = reinterpret_cast<chunk_t*>(mem);
+    chunk->size = size;
+    capacity_ += size;
+    numBytes_ += alignedSize;
+    ++numChunks_;
+
+    unsigned char* buf = chunkBase(chunk);
+    if (isLarge && (chunk_ != 0))
+    {
+        chunk->next = chunk_->next;
+        chunk_->next = chunk;
+    }
+    else
+    {
+        chunk->next = chunk_;
+        chunk_ = chunk;
+        top_ = buf + alignedSize;
+        end_ = buf + size;
+    }
+
+    return buf;
+}
+
+END_NAMESPACE1
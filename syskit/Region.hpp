@@ -0,0 +1,136 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_REGION_HPP
+#define SYSKIT_REGION_HPP
+
+#include <sys/types.h>
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//! monotonic memory region
+class Region
+    //!
+    //! A class representing a monotonic memory region (aka bump allocator).
+    //! Memory is carved out of large chunks by advancing a pointer, and chunks
+    //! are chained as the region grows. Individual allocations are normally
+    //! not freed. Instead, all allocations are released in bulk using reset()
+    //! or when the region is destructed. Useful for building short-lived object
+    //! graphs such as a parsed document or the state of a request. A region is
+    //! not thread-safe. Classes can opt into region allocation by providing an
+    //! operator new(size_t, Region&) overload. Example:
+    //!\code
+    //! Region region;
+    //! Vec* vec = new(region) Vec;
+    //! :
+    //! vec->~Vec();
+    //! region.reset();
+    //!\endcode
+    //!
+{
+
+public:
+    enum
+    {
+        Alignment = sizeof(double) > sizeof(void*)? sizeof(double): sizeof(void*),
+        DefaultChunkSize = 65536
+    };
+
+    Region(size_t chunkSize = DefaultChunkSize);
+    ~Region();
+
+    // Memory management.
+    bool free(const void* p, size_t size);
+    bool ownsAddr(const void* addr) const;
+    void reset();
+    void* allocate(size_t size);
+
+    // Getters.
+    size_t capacity() const;
+    size_t chunkSize() const;
+    size_t numBytes() const;
+    unsigned int numChunks() const;
+
+private:
+    typedef struct chunk_s
+    {
+        struct chunk_s* next;
+        size_t size;
+    } chunk_t;
+
+    enum
+    {
+        HeaderSize = (sizeof(chunk_t) + Alignment - 1) & ~(Alignment - 1)
+    };
+
+    chunk_t* chunk_; //most recent chunk first
+    size_t capacity_;
+    size_t chunkSize_;
+    size_t numBytes_;
+    unsigned char* end_;
+    unsigned char* top_;
+    unsigned int numChunks_;
+
+    Region(const Region&); //prohibit usage
+    const Region& operator =(const Region&); //prohibit usage
+
+    void* allocateSlow(size_t);
+
+    static unsigned char* chunkBase(chunk_t*);
+
+};
+
+//! Return the total number of bytes held in the chunks.
+inline size_t Region::capacity() const
+{
+    return capacity_;
+}
+
+//! Return the size of a regular chunk. Larger allocations get dedicated chunks.
+inline size_t Region::chunkSize() const
+{
+    return chunkSize_;
+}
+
+//! Return the number of bytes allocated since construction or the most recent reset.
+//! Alignment padding is included.
+inline size_t Region::numBytes() const
+{
+    return numBytes_;
+}
+
+//! Return the number of chunks currently held.
+inline unsigned int Region::numChunks() const
+{
+    return numChunks_;
+}
+
+//! Allocate and return a buffer of given size. The buffer is aligned at
+//! Alignment bytes and remains valid until the region is reset or destructed.
+//! A new chunk is obtained from the heap using the new operator when needed,
+//! so failure is reported the same way (i.e., std::bad_alloc is thrown).
+inline void* Region::allocate(size_t size)
+{
+    size_t alignedSize = (size + Alignment - 1) & ~static_cast<size_t>(Alignment - 1);
+    if (alignedSize <= static_cast<size_t>(end_ - top_))
+    {
+        void* buf = top_;
+        top_ += alignedSize;
+        numBytes_ += alignedSize;
+        return buf;
+    }
+
+    return allocateSlow(alignedSize);
+}
+
+inline unsigned char* Region::chunkBase(chunk_t* chunk)
+{
+    return reinterpret_cast<unsigned char*>(chunk) + HeaderSize;
+}
+
+END_NAMESPACE1
+
+#endif
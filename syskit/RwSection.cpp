@@ -0,0 +1,132 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit-pch.h"
+#include "syskit/BitVec.hpp"
+#include "syskit/Process.hpp"
+#include "syskit/RwSection.hpp"
+#include "syskit/Thread.hpp"
+#include "syskit/sys.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Construct a reader-writer section. A waiting thread spins up to spinCount
+//! times before yielding the processor. The spin count is ignored if the
+//! calling process is initially bound to one and only one processor.
+//!
+RwSection::RwSection(unsigned int spinCount):
+state_(Unlocked),
+numWaitingWriters_(0U)
+{
+    setSpinCount(spinCount);
+}
+
+
+RwSection::~RwSection()
+{
+}
+
+
+//!
+//! Set spin count. Return true if successful. Spinning is not allowed (and
+//! the effective spin count is zero) if the calling process is initially
+//! bound to one and only one processor.
+//!
+bool RwSection::setSpinCount(unsigned int spinCount)
+{
+    static bool s_allowSpin = (BitVec::countSetBits(Process::affinityMask()) > 1);
+    spinCount_ = s_allowSpin? spinCount: 0;
+    return s_allowSpin;
+}
+
+
+//!
+//! Try entering the section as a reader without blocking. Return true if successful.
+//!
+bool RwSection::tryReadLock()
+{
+
+    // Optimistically count this reader. Back out if a writer holds or awaits
+    // the section. Meanwhile, the transient count makes tryWriteLock() fail,
+    // and writeUnlock() clears the writer bit only, preserving the count.
+    unsigned int oldState;
+    state_.increment(oldState);
+    bool ok = ((oldState & WriteLocked) == 0) && (numWaitingWriters_.asWord() == 0);
+    if (!ok)
+    {
+        state_.decrement();
+    }
+
+    return ok;
+}
+
+
+//!
+//! Try entering the section as a writer without blocking. Return true if successful.
+//!
+bool RwSection::tryWriteLock()
+{
+    unsigned int oldState;
+    state_.setIfEqual(WriteLocked, Unlocked, oldState);
+    return (oldState == Unlocked);
+}
+
+
+//
+// Wait after given number of failed attempts. Spin while allowed, then yield.
+//
+void RwSection::backOff(unsigned int numTries) const
+{
+    if (numTries < spinCount_)
+    {
+        cpuRelax();
+    }
+    else
+    {
+        Thread::yield();
+    }
+}
+
+
+//!
+//! Enter the section as a reader. Wait if necessary.
+//!
+void RwSection::readLock()
+{
+    for (unsigned int i = 0; !tryReadLock(); ++i)
+    {
+
+        // Wait for the writers to go away before trying again.
+        // This avoids bouncing the state word while waiting.
+        for (; isWriteLocked() || (numWaitingWriters_.asWord() != 0); backOff(i++));
+    }
+}
+
+
+//!
+//! Enter the section as a writer. Wait if necessary.
+//!
+void RwSection::writeLock()
+{
+    if (tryWriteLock())
+    {
+        return;
+    }
+
+    // Announce the wait so arriving readers stay out. Try again only
+    // when the section looks available.
+    numWaitingWriters_.increment();
+    for (unsigned int i = 0;; backOff(i++))
+    {
+        if ((state_.asWord() == Unlocked) && tryWriteLock())
+        {
+            break;
+        }
+    }
+    numWaitingWriters_.decrement();
+}
+
+END_NAMESPACE1
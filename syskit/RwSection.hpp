@@ -0,0 +1,178 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_RW_SECTION_HPP
+#define SYSKIT_RW_SECTION_HPP
+
+#include "syskit/Atomic32.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//! section of critical code shared by readers and writers
+class RwSection
+    //!
+    //! A class representing a reader-writer critical section for read-mostly data.
+    //! Any number of readers can hold the section concurrently, but a writer holds
+    //! it exclusively. Writers have precedence: once a writer is waiting, arriving
+    //! readers stay out until the writer is done. A reader enters with one atomic
+    //! increment, so readers do not serialize behind each other as they would on
+    //! a SpinSection or CriSection. A thread waits for the section by spinning up
+    //! to spinCount() times and then by yielding the processor, so held sections
+    //! should be short. The section should be locked/unlocked by constructing/
+    //! destructing a RwSection::ReadLock or RwSection::WriteLock instance. Use
+    //! tryReadLock() and tryWriteLock() to avoid blocking calls. Recursive locks
+    //! are not allowed. That is, recursive locks might result in a deadlock.
+    //! Example:
+    //!\code
+    //! static RwSection s_rws;
+    //! {
+    //!   RwSection::ReadLock lock(s_rws);
+    //!   lookUpSharedConfig();
+    //! }
+    //! {
+    //!   RwSection::WriteLock lock(s_rws);
+    //!   updateSharedConfig();
+    //! }
+    //!\endcode
+    //!
+{
+
+public:
+    enum
+    {
+        DefaultSpinCount = 4000
+    };
+
+    RwSection(unsigned int spinCount = DefaultSpinCount);
+    ~RwSection();
+
+    bool isWriteLocked() const;
+    bool setSpinCount(unsigned int spinCount);
+    bool tryReadLock();
+    bool tryWriteLock();
+    unsigned int spinCount() const;
+    void readLock();
+    void readUnlock();
+    void writeLock();
+    void writeUnlock();
+
+
+    //! reader lock
+    class ReadLock
+        //!
+        //! A class representing a reader lock. Construct an instance to enter a
+        //! reader-writer section as a reader, and destruct it to leave. Example:
+        //!\code
+        //! static RwSection s_rws;
+        //! {
+        //!   RwSection::ReadLock lock(s_rws);
+        //!   lookUpSharedConfig();
+        //! }
+        //!\endcode
+        //!
+    {
+    public:
+        ReadLock(RwSection& rwSection);
+        ~ReadLock();
+    private:
+        RwSection& rws_;
+        ReadLock(const ReadLock&); //prohibit usage
+        const ReadLock& operator=(const ReadLock&); //prohibit usage
+    };
+
+
+    //! writer lock
+    class WriteLock
+        //!
+        //! A class representing a writer lock. Construct an instance to enter a
+        //! reader-writer section as a writer, and destruct it to leave. Example:
+        //!\code
+        //! static RwSection s_rws;
+        //! {
+        //!   RwSection::WriteLock lock(s_rws);
+        //!   updateSharedConfig();
+        //! }
+        //!\endcode
+        //!
+    {
+    public:
+        WriteLock(RwSection& rwSection);
+        ~WriteLock();
+    private:
+        RwSection& rws_;
+        WriteLock(const WriteLock&); //prohibit usage
+        const WriteLock& operator=(const WriteLock&); //prohibit usage
+    };
+
+private:
+    enum
+    {
+        Unlocked = 0,
+        WriteLocked = 0x80000000U //high bit, low bits count readers
+    };
+
+    Atomic32 state_;
+    Atomic32 numWaitingWriters_;
+    unsigned int spinCount_;
+
+    RwSection(const RwSection&); //prohibit usage
+    const RwSection& operator=(const RwSection&); //prohibit usage
+
+    void backOff(unsigned int) const;
+
+};
+
+//! Return true if the section is currently held by a writer.
+inline bool RwSection::isWriteLocked() const
+{
+    return ((state_.asWord() & WriteLocked) != 0);
+}
+
+//! Return the effective spin count. The effective spin count is zero if
+//! the calling process is initially bound to one and only one processor.
+inline unsigned int RwSection::spinCount() const
+{
+    return spinCount_;
+}
+
+//! Leave the section as a reader.
+inline void RwSection::readUnlock()
+{
+    state_.decrement();
+}
+
+//! Leave the section as a writer. Readers which have transiently
+//! incremented the reader count while backing off are not disturbed.
+inline void RwSection::writeUnlock()
+{
+    state_.decrementBy(WriteLocked);
+}
+
+inline RwSection::ReadLock::ReadLock(RwSection& rwSection):
+rws_(rwSection)
+{
+    rws_.readLock();
+}
+
+inline RwSection::ReadLock::~ReadLock()
+{
+    rws_.readUnlock();
+}
+
+inline RwSection::WriteLock::WriteLock(RwSection& rwSection):
+rws_(rwSection)
+{
+    rws_.writeLock();
+}
+
+inline RwSection::WriteLock::~WriteLock()
+{
+    rws_.writeUnlock();
+}
+
+END_NAMESPACE1
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit-pch.h"
+#include "syskit/SeqLock.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Construct a sequence lock. The initial sequence number is zero.
+//!
+SeqLock::SeqLock():
+seq_(0U),
+ss_()
+{
+}
+
+
+SeqLock::~SeqLock()
+{
+}
+
+END_NAMESPACE1
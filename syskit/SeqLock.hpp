@@ -0,0 +1,156 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_SEQ_LOCK_HPP
+#define SYSKIT_SEQ_LOCK_HPP
+
+#include <string.h>
+#include "syskit/Atomic32.hpp"
+#include "syskit/SpinSection.hpp"
+#include "syskit/macros.h"
+#include "syskit/sys.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//! sequence lock
+class SeqLock
+    //!
+    //! A class representing a sequence lock for small plain-old-data snapshots
+    //! which are read often and written rarely (e.g., a few counters or a small
+    //! configuration struct). Writers are serialized and bump a sequence number
+    //! before and after updating the data. Readers never write shared memory and
+    //! never block writers. Instead, a reader copies the data and retries if the
+    //! sequence number shows a concurrent update. Data must be safe to copy while
+    //! being updated (i.e., no pointers followed while reading). Use read() and
+    //! write() to copy a snapshot in or out, or use beginRead()/endRead() and a
+    //! SeqLock::WriteLock instance for finer control. Example:
+    //!\code
+    //! static SeqLock s_sl;
+    //! static stat_t s_stat;
+    //! stat_t stat;
+    //! s_sl.read(&stat, &s_stat, sizeof(stat));
+    //! ...
+    //! s_sl.write(&s_stat, &stat, sizeof(stat));
+    //!\endcode
+    //!
+{
+
+public:
+    SeqLock();
+    ~SeqLock();
+
+    bool endRead(unsigned int seq) const;
+    unsigned int beginRead() const;
+    unsigned int seq() const;
+    void beginWrite();
+    void endWrite();
+    void read(void* snapshot, const void* data, size_t size) const;
+    void write(void* data, const void* snapshot, size_t size);
+
+
+    //! writer lock
+    class WriteLock
+        //!
+        //! A class representing a sequence writer lock. Construct an instance
+        //! to start updating the data, and destruct it when done. Example:
+        //!\code
+        //! static SeqLock s_sl;
+        //! {
+        //!   SeqLock::WriteLock lock(s_sl);
+        //!   updateSharedStat();
+        //! }
+        //!\endcode
+        //!
+    {
+    public:
+        WriteLock(SeqLock& seqLock);
+        ~WriteLock();
+    private:
+        SeqLock& sl_;
+        WriteLock(const WriteLock&); //prohibit usage
+        const WriteLock& operator=(const WriteLock&); //prohibit usage
+    };
+
+private:
+    Atomic32 seq_;
+    SpinSection ss_;
+
+    SeqLock(const SeqLock&); //prohibit usage
+    const SeqLock& operator=(const SeqLock&); //prohibit usage
+
+};
+
+//! Finish reading. Return true if the data read since beginRead() returned
+//! seq is a consistent snapshot. Return false if the read must be retried.
+inline bool SeqLock::endRead(unsigned int seq) const
+{
+    loadFence();
+    return (seq_.asWord() == seq);
+}
+
+//! Start reading. Wait for an ongoing update, if any, to finish. Return the
+//! sequence number to be given to endRead() when done reading.
+inline unsigned int SeqLock::beginRead() const
+{
+    unsigned int seq;
+    for (; ((seq = seq_.asWord()) & 1) != 0; cpuRelax());
+    loadFence();
+    return seq;
+}
+
+//! Return the current sequence number. The sequence number
+//! is odd while an update is in progress.
+inline unsigned int SeqLock::seq() const
+{
+    return seq_.asWord();
+}
+
+//! Start updating. Wait for other writers, if any.
+inline void SeqLock::beginWrite()
+{
+    ss_.lock();
+    seq_.increment();
+}
+
+//! Finish updating.
+inline void SeqLock::endWrite()
+{
+    seq_.increment();
+    ss_.unlock();
+}
+
+//! Copy a consistent snapshot of given data of given size.
+inline void SeqLock::read(void* snapshot, const void* data, size_t size) const
+{
+    unsigned int seq;
+    do
+    {
+        seq = beginRead();
+        memcpy(snapshot, data, size);
+    } while (!endRead(seq));
+}
+
+//! Update given data of given size using given snapshot.
+inline void SeqLock::write(void* data, const void* snapshot, size_t size)
+{
+    beginWrite();
+    memcpy(data, snapshot, size);
+    endWrite();
+}
+
+inline SeqLock::WriteLock::WriteLock(SeqLock& seqLock):
+sl_(seqLock)
+{
+    sl_.beginWrite();
+}
+
+inline SeqLock::WriteLock::~WriteLock()
+{
+    sl_.endWrite();
+}
+
+END_NAMESPACE1
+
+#endif
@@ -4,8 +4,10 @@
  */
 #include "syskit-pch.h"
 #include "syskit/BitVec.hpp"
+#include "syskit/LockStat.hpp"
 #include "syskit/Process.hpp"
 #include "syskit/SpinSection.hpp"
+#include "syskit/TickTime.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -23,12 +25,15 @@ SpinSection::SpinSection(unsigned int spinCount):
 state_(Unlocked),
 sem_(0U)
 {
+    spinLimit_ = 0;
+    stat_ = 0;
     setSpinCount(spinCount);
 }
 
 
 SpinSection::~SpinSection()
 {
+    delete stat_;
 }
 
 
@@ -52,7 +57,13 @@ bool SpinSection::tryLock()
 {
     unsigned int oldState;
     state_.setIfEqual(LockedWithNoWaiters, Unlocked, oldState);
-    return (oldState == Unlocked);
+    bool ok = (oldState == Unlocked);
+    if (ok && (stat_ != 0))
+    {
+        stat_->onLock(0 /*waitStart*/, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -61,7 +72,9 @@ bool SpinSection::tryLock()
 //!
 void SpinSection::lock()
 {
-    for (;;)
+    unsigned int numSpins = 0;
+    unsigned long long waitStart = 0;
+    for (bool locked = false; !locked;)
     {
 
         // Successfully locked this critical section. Move on.
@@ -69,7 +82,13 @@ void SpinSection::lock()
         state_.setIfEqual(LockedWithNoWaiters, Unlocked, oldState);
         if (oldState == Unlocked)
         {
-            return;
+            break;
+        }
+
+        // Contended. Note when the wait started if profiling.
+        if ((stat_ != 0) && (waitStart == 0) && LockStat::isEnabled())
+        {
+            waitStart = TickTime::curTime();
         }
 
         // Spin and monitor the lock status. As soon as it changes, stop spinning
@@ -79,17 +98,32 @@ void SpinSection::lock()
         // initially bound to one and only one processor. If there are waiters,
         // don't bother spinning and just join the wait. Otherwise, there's a good
         // chance a late-arriving spinner would get the lock before the waiters.
-        for (int i = (oldState > LockedWithNoWaiters)? 0: spinCount_;; --i)
+        // The spin limit tracks the number of spins recently needed to see the
+        // lock released and is allowed to double each round. It shrinks when
+        // spinning fails, so long holds quickly lead to parking instead.
+        int spinLimit = spinLimit_;
+        int maxSpins = (oldState > LockedWithNoWaiters)? 0: (spinLimit * 2 + 10);
+        if (maxSpins > static_cast<int>(spinCount_))
         {
-            if (i <= 0)
+            maxSpins = spinCount_;
+        }
+        for (int i = 0;; ++i)
+        {
+            if (i >= maxSpins)
             {
+                numSpins += i;
+                if (maxSpins > 0)
+                {
+                    spinLimit_ = spinLimit - spinLimit / 8;
+                }
 
                 // Didn't really mean to, but successfully locked this critical section.
                 // Move on.
                 oldState = state_++;
                 if (oldState == Unlocked)
                 {
-                    return;
+                    locked = true;
+                    break;
                 }
 
                 // Wait forever until unlocked to try again.
@@ -98,10 +132,38 @@ void SpinSection::lock()
             }
             if (state_.asWord() == Unlocked)
             {
+                numSpins += i;
+                spinLimit_ = spinLimit + (i - spinLimit) / 8;
                 break;
             }
+            cpuRelax();
         }
     }
+
+    // Record the acquisition if profiling.
+    if (stat_ != 0)
+    {
+        stat_->onLock(waitStart, numSpins);
+    }
+}
+
+
+//!
+//! Start collecting contention statistics under given name. The statistics
+//! are registered process-wide and are updated while profiling is enabled
+//! (see LockStat::enable()). If already profiled, the existing statistics
+//! are reset and kept under their original name.
+//!
+void SpinSection::startProfiling(const char* name)
+{
+    if (stat_ == 0)
+    {
+        stat_ = new LockStat(name, "SpinSection");
+    }
+    else
+    {
+        stat_->reset();
+    }
 }
 
 
@@ -111,6 +173,12 @@ void SpinSection::lock()
 void SpinSection::unlock()
 {
 
+    // Record the release if profiling.
+    if (stat_ != 0)
+    {
+        stat_->onUnlock();
+    }
+
     // Unlock by updating the critical section's state.
     unsigned int oldState;
     state_.set(Unlocked, oldState);
@@ -11,6 +11,8 @@
 
 BEGIN_NAMESPACE1(syskit)
 
+class LockStat;
+
 
 //! section of critical code synchronized by a spin lock
 class SpinSection
@@ -21,7 +23,10 @@ class SpinSection
     //! is initially bound to more than one processor, a thread waits for a
     //! critical section by first spinning in a loop and if the critical section
     //! becomes free during the spin, the thread would avoid a real wait. The
-    //! critical section should be locked/unlocked by contructing/destructing a
+    //! spin adapts to recent hold times. It lengthens when spinning recently
+    //! succeeded and shortens when it recently failed, never exceeding the spin
+    //! count. Use startProfiling() to collect contention statistics (see LockStat).
+    //! The critical section should be locked/unlocked by contructing/destructing a
     //! lock using SpinSection::Lock. Use lock() and unlock() only if SpinSection::Lock
     //! cannot be used. Use tryLock() to avoid blocking calls. Unlike a standard
     //! critical section, recursive locks are not allowed. That is, recursive locks
@@ -48,8 +53,10 @@ public:
     bool isOk() const;
     bool setSpinCount(unsigned int spinCount);
     bool tryLock();
+    const LockStat* stat() const;
     unsigned int spinCount() const;
     void lock();
+    void startProfiling(const char* name);
     void unlock();
 
 
@@ -88,7 +95,9 @@ private:
     };
 
     Atomic32 state_;
+    LockStat* stat_;
     Semaphore sem_;
+    int spinLimit_;
     unsigned int spinCount_;
 
     SpinSection(const SpinSection&); //prohibit usage
@@ -102,6 +111,12 @@ inline bool SpinSection::isOk() const
     return sem_.isOk();
 }
 
+//! Return the contention statistics. Return zero if not profiled.
+inline const LockStat* SpinSection::stat() const
+{
+    return stat_;
+}
+
 //! Return the effective spin count. The effective spin count is zero if
 //! the calling process is initially bound to one and only one processor.
 inline unsigned int SpinSection::spinCount() const
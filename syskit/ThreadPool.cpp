@@ -0,0 +1,530 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit-pch.h"
+#include "syskit/BitVec.hpp"
+#include "syskit/Process.hpp"
+#include "syskit/Thread.hpp"
+#include "syskit/ThreadPool.hpp"
+#include "syskit/sys.hpp"
+
+const unsigned int GRAINS_PER_WORKER = 8;
+const unsigned int SPIN_COUNT = 64;
+
+BEGIN_NAMESPACE1(syskit)
+
+static ThreadPool* volatile s_pool = 0;
+static SpinSection s_poolSs;
+
+
+//!
+//! Construct a pool with numWorkers worker threads. Use one worker per available
+//! processor if numWorkers is zero. If pinWorkers is true, pin each worker to one
+//! processor from the process affinity mask in a round-robin manner. Use isOk()
+//! to determine if all workers were successfully started.
+//!
+ThreadPool::ThreadPool(unsigned int numWorkers, bool pinWorkers):
+numSleepers_(0U),
+inbox_(),
+wakeup_(0U),
+key_()
+{
+    ok_ = wakeup_.isOk() && key_.isOk();
+    stopping_ = false;
+    numWorkers_ = (numWorkers == 0)? numCpus(): numWorkers;
+    worker_ = new worker_t[numWorkers_];
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        worker_t& w = worker_[i];
+        w.pool = this;
+        w.thread = 0;
+        w.deque = new Deque;
+        w.index = i;
+        w.numSteals = 0;
+        w.numTasks = 0;
+    }
+
+    // Start the workers only after all queues exist since workers steal from each other.
+    size_t cpuMask = Process::affinityMask();
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        Thread* thread = new Thread(entry, &worker_[i]);
+        if (!thread->isOk())
+        {
+            delete thread;
+            ok_ = false;
+            continue;
+        }
+
+        worker_[i].thread = thread;
+        if (pinWorkers && (cpuMask != 0))
+        {
+            size_t cpu = 0;
+            for (unsigned int n = i % BitVec::countSetBits(cpuMask); ; ++cpu)
+            {
+                if (((cpuMask >> cpu) & 1) && (n-- == 0))
+                {
+                    break;
+                }
+            }
+            thread->setAffinityMask(static_cast<size_t>(1) << cpu);
+        }
+    }
+}
+
+
+//!
+//! Destruct the pool. Queued tasks are executed before the workers exit.
+//!
+ThreadPool::~ThreadPool()
+{
+    stopping_ = true;
+    wakeup_.incrementBy(numWorkers_);
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        Thread* thread = worker_[i].thread;
+        if (thread != 0)
+        {
+            thread->waitTilDone();
+            delete thread;
+        }
+    }
+
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        delete worker_[i].deque;
+    }
+    delete[] worker_;
+}
+
+
+//
+// Return true if some queue seems to have tasks.
+//
+bool ThreadPool::hasWork() const
+{
+    bool found = !inbox_.isEmpty();
+    for (unsigned int i = 0; (!found) && (i < numWorkers_); ++i)
+    {
+        found = !worker_[i].deque->isEmpty();
+    }
+
+    return found;
+}
+
+
+//
+// Execute one queued task, if any, on behalf of the caller. Return true if a task was executed.
+//
+bool ThreadPool::runOne()
+{
+    worker_t* worker = static_cast<worker_t*>(key_.value());
+    task_t task;
+    bool ok = takeTask(worker, task);
+    if (ok)
+    {
+        run(worker, task);
+    }
+
+    return ok;
+}
+
+
+//
+// Find a task for given worker (zero if caller is not a worker). Prefer the
+// worker's own most recent task, then the oldest submitted task, then the
+// oldest task of some other worker. Return true if found.
+//
+bool ThreadPool::takeTask(worker_t* worker, task_t& task)
+{
+    if (((worker != 0) && worker->deque->popTail(task)) || inbox_.takeHead(task))
+    {
+        return true;
+    }
+
+    unsigned int start = (worker != 0)? (worker->index + 1): 0;
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        worker_t& victim = worker_[(start + i) % numWorkers_];
+        if ((&victim != worker) && victim.deque->takeHead(task))
+        {
+            if (worker != 0)
+            {
+                ++worker->numSteals;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//!
+//! Run a loop over numItems items in parallel, and wait until done. The loop is
+//! split into ranges of at most grainSize items, and cb is invoked once per range
+//! with the [loIndex, hiIndex) range and the opaque arg. Ranges are split lazily,
+//! so idle workers steal large ranges first. If grainSize is zero, use a grain size
+//! resulting in a few ranges per worker. The caller also executes some ranges.
+//!
+void ThreadPool::apply(size_t numItems, cb1_t cb, void* arg, size_t grainSize)
+{
+    if (numItems == 0)
+    {
+        return;
+    }
+
+    if (grainSize == 0)
+    {
+        grainSize = numItems / (numWorkers_ * GRAINS_PER_WORKER);
+        if (grainSize == 0)
+        {
+            grainSize = 1;
+        }
+    }
+
+    Group group(*this);
+    task_t task = {0, cb, arg, &group, grainSize, numItems, 0};
+    ++group.numPendingTasks_;
+    run(static_cast<worker_t*>(key_.value()), task);
+    group.wait();
+}
+
+
+//
+// Queue given task. Use the caller's queue if the caller is a worker.
+// Use the shared inbox otherwise. Wake up a sleeping worker, if any.
+//
+void ThreadPool::push(const task_t& task)
+{
+    worker_t* worker = static_cast<worker_t*>(key_.value());
+    (worker != 0)? worker->deque->pushTail(task): inbox_.pushTail(task);
+    if (numSleepers_.asWord() != 0)
+    {
+        wakeup_.increment();
+    }
+}
+
+
+//
+// Execute given task on behalf of given worker (zero if caller is not a worker).
+// A range task is first split until it is no larger than its grain size. The
+// upper halves are queued so idle workers can steal them.
+//
+void ThreadPool::run(worker_t* worker, task_t& task)
+{
+    if (task.cb1 != 0)
+    {
+        while ((task.hiIndex - task.loIndex) > task.grainSize)
+        {
+            size_t midIndex = task.loIndex + (task.hiIndex - task.loIndex) / 2;
+            task_t upper = task;
+            upper.loIndex = midIndex;
+            ++task.group->numPendingTasks_;
+            push(upper);
+            task.hiIndex = midIndex;
+        }
+        task.cb1(task.arg, task.loIndex, task.hiIndex);
+    }
+    else
+    {
+        task.cb0(task.arg);
+    }
+
+    if (worker != 0)
+    {
+        ++worker->numTasks;
+    }
+
+    if (task.group != 0)
+    {
+        --task.group->numPendingTasks_;
+    }
+}
+
+
+//!
+//! Submit a task. The task will be executed by some worker as cb(arg).
+//! Use a ThreadPool::Group instead to wait for the task completion.
+//!
+void ThreadPool::submit(cb0_t cb, void* arg)
+{
+    task_t task = {cb, 0, arg, 0, 0, 0, 0};
+    push(task);
+}
+
+
+//!
+//! Return the process-wide pool with one worker per available processor.
+//! Construct on first use. The pool persists until process exit.
+//!
+ThreadPool& ThreadPool::instance()
+{
+    if (s_pool == 0)
+    {
+        SpinSection::Lock lock(s_poolSs);
+        if (s_pool == 0)
+        {
+            s_pool = new ThreadPool;
+        }
+    }
+
+    return *s_pool;
+}
+
+
+//!
+//! Return the number of processors available to the process.
+//!
+unsigned int ThreadPool::numCpus()
+{
+    unsigned int n = BitVec::countSetBits(Process::affinityMask());
+    return (n > 0)? n: 1;
+}
+
+
+//!
+//! Return the number of tasks stolen from other workers so far.
+//!
+unsigned long long ThreadPool::numSteals() const
+{
+    unsigned long long n = 0;
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        n += worker_[i].numSteals;
+    }
+
+    return n;
+}
+
+
+//!
+//! Return the number of tasks executed by the workers so far. Tasks
+//! executed by non-worker threads while waiting are not counted.
+//!
+unsigned long long ThreadPool::numTasks() const
+{
+    unsigned long long n = 0;
+    for (unsigned int i = 0; i < numWorkers_; ++i)
+    {
+        n += worker_[i].numTasks;
+    }
+
+    return n;
+}
+
+
+//
+// Worker thread. Execute tasks until the pool is destructed.
+// Sleep when there is nothing to do.
+//
+void* ThreadPool::entry(void* arg)
+{
+    worker_t* worker = static_cast<worker_t*>(arg);
+    ThreadPool* pool = worker->pool;
+    pool->key_.setValue(worker);
+
+    task_t task;
+    for (;;)
+    {
+        if (pool->takeTask(worker, task))
+        {
+            pool->run(worker, task);
+            continue;
+        }
+
+        if (pool->stopping_)
+        {
+            break;
+        }
+
+        // Announce the sleep before checking the queues one last time.
+        // A task queued after the check will cause a wake-up.
+        ++pool->numSleepers_;
+        if (!pool->hasWork())
+        {
+            pool->wakeup_.decrement(IdleNapTime);
+        }
+        --pool->numSleepers_;
+    }
+
+    return 0;
+}
+
+
+ThreadPool::Deque::Deque():
+ss_()
+{
+    item_ = new task_t[DefaultCap];
+    head_ = 0;
+    tail_ = 0;
+    mask_ = DefaultCap - 1;
+}
+
+
+ThreadPool::Deque::~Deque()
+{
+    delete[] item_;
+}
+
+
+//
+// Pop the most recent task. Return true if successful.
+//
+bool ThreadPool::Deque::popTail(task_t& task)
+{
+    if (head_ == tail_)
+    {
+        return false;
+    }
+
+    SpinSection::Lock lock(ss_);
+    bool ok = (head_ != tail_);
+    if (ok)
+    {
+        task = item_[--tail_ & mask_];
+    }
+
+    return ok;
+}
+
+
+//
+// Take the oldest task. Return true if successful.
+//
+bool ThreadPool::Deque::takeHead(task_t& task)
+{
+    if (head_ == tail_)
+    {
+        return false;
+    }
+
+    SpinSection::Lock lock(ss_);
+    bool ok = (head_ != tail_);
+    if (ok)
+    {
+        task = item_[head_++ & mask_];
+    }
+
+    return ok;
+}
+
+
+//
+// Double the queue capacity.
+//
+void ThreadPool::Deque::grow()
+{
+    size_t mask = (mask_ << 1) | 1;
+    task_t* item = new task_t[mask + 1];
+    for (size_t i = head_; i != tail_; ++i)
+    {
+        item[i & mask] = item_[i & mask_];
+    }
+
+    delete[] item_;
+    item_ = item;
+    mask_ = mask;
+}
+
+
+//
+// Queue given task as the most recent one.
+//
+void ThreadPool::Deque::pushTail(const task_t& task)
+{
+    SpinSection::Lock lock(ss_);
+    if ((tail_ - head_) > mask_)
+    {
+        grow();
+    }
+    item_[tail_++ & mask_] = task;
+}
+
+
+//!
+//! Construct an empty group of tasks to be run by given pool.
+//!
+ThreadPool::Group::Group(ThreadPool& pool):
+pool_(pool),
+numPendingTasks_(0U)
+{
+}
+
+
+//!
+//! Destruct the group after waiting for its tasks to be done.
+//!
+ThreadPool::Group::~Group()
+{
+    wait();
+}
+
+
+//!
+//! Run given task as part of this group. The task will be executed as cb(arg).
+//!
+void ThreadPool::Group::run(cb0_t cb, void* arg)
+{
+    task_t task = {cb, 0, arg, this, 0, 0, 0};
+    ++numPendingTasks_;
+    pool_.push(task);
+}
+
+
+//!
+//! Wait until all tasks in this group are done. Help execute queued tasks while waiting.
+//!
+void ThreadPool::Group::wait()
+{
+    for (unsigned int i = 0; numPendingTasks_.asWord() != 0;)
+    {
+        if (pool_.runOne())
+        {
+            i = 0;
+        }
+        else if (++i < SPIN_COUNT)
+        {
+            cpuRelax();
+        }
+        else
+        {
+            Thread::yield();
+        }
+    }
+}
+
+
+//!
+//! Construct a reduction using given hooks. The hooks will be invoked as
+//! open(arg) and close(arg, partial). Either hook can be zero.
+//!
+ThreadPool::Reduction::Reduction(open_t open, close_t close, void* arg):
+ss_()
+{
+    close_ = close;
+    open_ = open;
+    arg_ = arg;
+}
+
+
+ThreadPool::Reduction::~Reduction()
+{
+}
+
+
+//!
+//! Hand back given partial result. Invoke the close hook, if any, while
+//! holding a lock so partial results are merged one at a time.
+//!
+void ThreadPool::Reduction::close(void* partial)
+{
+    if (close_ != 0)
+    {
+        SpinSection::Lock lock(ss_);
+        close_(arg_, partial);
+    }
+}
+
+END_NAMESPACE1
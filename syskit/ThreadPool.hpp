@@ -0,0 +1,253 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#ifndef SYSKIT_THREAD_POOL_HPP
+#define SYSKIT_THREAD_POOL_HPP
+
+#include <sys/types.h>
+#include "syskit/Atomic32.hpp"
+#include "syskit/Semaphore.hpp"
+#include "syskit/SpinSection.hpp"
+#include "syskit/ThreadKey.hpp"
+#include "syskit/macros.h"
+
+BEGIN_NAMESPACE1(syskit)
+
+class Thread;
+
+
+//! work-stealing thread pool
+class ThreadPool
+    //!
+    //! A class representing a pool of worker threads executing short tasks. Each
+    //! worker owns a double-ended task queue. A worker queues the tasks it spawns
+    //! and executes them most-recent first. An idle worker steals the oldest tasks
+    //! from the other workers. Tasks submitted by non-worker threads are queued in
+    //! a shared inbox. Workers can optionally be pinned to individual processors.
+    //! A task is a callback and its opaque argument. Use a ThreadPool::Group to
+    //! wait for a set of tasks, and use apply() to run a loop in parallel. A
+    //! waiting thread helps execute queued tasks, so tasks can spawn and wait for
+    //! other tasks without exhausting the workers. A process-wide instance is
+    //! available via instance() so independent users share one set of workers
+    //! instead of oversubscribing the processors. Example:
+    //!\code
+    //! ThreadPool& pool = ThreadPool::instance();
+    //! ThreadPool::Group group(pool);
+    //! group.run(doThis, thisArg);
+    //! group.run(doThat, thatArg);
+    //! group.wait();
+    //!\endcode
+    //!
+{
+
+public:
+    typedef void(*cb0_t)(void* arg);
+    typedef void(*cb1_t)(void* arg, size_t loIndex, size_t hiIndex);
+    typedef void(*close_t)(void* arg, void* partial);
+    typedef void* (*open_t)(void* arg);
+
+    enum
+    {
+        DefaultCap = 256, //per queue, grows as needed
+        IdleNapTime = 100 //msecs
+    };
+
+    class Group;
+    class Reduction;
+
+    ThreadPool(unsigned int numWorkers = 0, bool pinWorkers = false);
+    ~ThreadPool();
+
+    bool isOk() const;
+    bool isWorker() const;
+    unsigned int numWorkers() const;
+    unsigned long long numSteals() const;
+    unsigned long long numTasks() const;
+    void apply(size_t numItems, cb1_t cb, void* arg = 0, size_t grainSize = 0);
+    void submit(cb0_t cb, void* arg = 0);
+
+    static ThreadPool& instance();
+    static unsigned int numCpus();
+
+
+    //! group of tasks
+    class Group
+        //!
+        //! A class representing a group of tasks which can be waited for. Tasks run
+        //! using run() are counted until done. Use wait() to wait until all tasks in
+        //! the group are done. The destructor also waits. Example:
+        //!\code
+        //! ThreadPool::Group group(ThreadPool::instance());
+        //! for (size_t i = 0; i < numParts; ++i)
+        //! {
+        //!   group.run(processPart, &part[i]);
+        //! }
+        //! group.wait();
+        //!\endcode
+        //!
+    {
+    public:
+        Group(ThreadPool& pool);
+        ~Group();
+        ThreadPool& pool() const;
+        unsigned int numPendingTasks() const;
+        void run(cb0_t cb, void* arg = 0);
+        void wait();
+    private:
+        friend class ThreadPool;
+        ThreadPool& pool_;
+        Atomic32 numPendingTasks_;
+        Group(const Group&); //prohibit usage
+        const Group& operator=(const Group&); //prohibit usage
+    };
+
+
+    //! reduction of per-task partial results
+    class Reduction
+        //!
+        //! A class helping parallel loops accumulate partial results. Each range task
+        //! obtains a fresh partial result via open(), updates it without locking, and
+        //! hands it back via close(). The close hook is serialized so it can safely
+        //! merge the partial result into a shared total. Either hook can be zero. If
+        //! there is no open hook, partial results are zero. Example:
+        //!\code
+        //! ThreadPool::Reduction reduction(newCount, addCount, &total);
+        //! void* partial = reduction.open();
+        //! ..
+        //! reduction.close(partial);
+        //!\endcode
+        //!
+    {
+    public:
+        Reduction(open_t open, close_t close, void* arg = 0);
+        ~Reduction();
+        void close(void* partial);
+        void* open();
+    private:
+        SpinSection ss_;
+        close_t close_;
+        open_t open_;
+        void* arg_;
+        Reduction(const Reduction&); //prohibit usage
+        const Reduction& operator=(const Reduction&); //prohibit usage
+    };
+
+private:
+
+    // A plain task, or a range task if cb1 is non-zero.
+    typedef struct task_s
+    {
+        cb0_t cb0;
+        cb1_t cb1;
+        void* arg;
+        Group* group;
+        size_t grainSize;
+        size_t hiIndex;
+        size_t loIndex;
+    } task_t;
+
+
+    // Double-ended task queue. The owner pushes and pops at the tail.
+    // Thieves and inbox readers take from the head.
+    class Deque
+    {
+    public:
+        Deque();
+        ~Deque();
+        bool isEmpty() const;
+        bool popTail(task_t& task);
+        bool takeHead(task_t& task);
+        void pushTail(const task_t& task);
+    private:
+        SpinSection ss_;
+        task_t* item_;
+        size_t volatile head_;
+        size_t volatile tail_;
+        size_t mask_;
+        Deque(const Deque&); //prohibit usage
+        const Deque& operator=(const Deque&); //prohibit usage
+        void grow();
+    };
+
+
+    // Worker thread and its task queue. Stats are updated by the owner only.
+    typedef struct worker_s
+    {
+        ThreadPool* pool;
+        Thread* thread;
+        Deque* deque;
+        unsigned int index;
+        unsigned long long numSteals;
+        unsigned long long numTasks;
+    } worker_t;
+
+    Atomic32 numSleepers_;
+    Deque inbox_;
+    Semaphore wakeup_;
+    ThreadKey key_;
+    bool ok_;
+    bool volatile stopping_;
+    unsigned int numWorkers_;
+    worker_t* worker_;
+
+    ThreadPool(const ThreadPool&); //prohibit usage
+    const ThreadPool& operator=(const ThreadPool&); //prohibit usage
+
+    bool hasWork() const;
+    bool runOne();
+    bool takeTask(worker_t*, task_t&);
+    void push(const task_t&);
+    void run(worker_t*, task_t&);
+
+    static void* entry(void*);
+
+};
+
+//! Return true if instance was successfully constructed.
+inline bool ThreadPool::isOk() const
+{
+    return ok_;
+}
+
+//! Return true if the caller is a worker thread of this pool.
+inline bool ThreadPool::isWorker() const
+{
+    return (key_.value() != 0);
+}
+
+//! Return the number of worker threads.
+inline unsigned int ThreadPool::numWorkers() const
+{
+    return numWorkers_;
+}
+
+//! Return the pool running the group's tasks.
+inline ThreadPool& ThreadPool::Group::pool() const
+{
+    return pool_;
+}
+
+//! Return the number of tasks in the group which are not done yet.
+inline unsigned int ThreadPool::Group::numPendingTasks() const
+{
+    return numPendingTasks_.asWord();
+}
+
+//! Return a fresh partial result, or zero if there is no open hook.
+inline void* ThreadPool::Reduction::open()
+{
+    void* partial = (open_ != 0)? open_(arg_): 0;
+    return partial;
+}
+
+//! Return true if the queue is empty. The result is a hint
+//! only since the queue can be concurrently updated.
+inline bool ThreadPool::Deque::isEmpty() const
+{
+    return (head_ == tail_);
+}
+
+END_NAMESPACE1
+
+#endif
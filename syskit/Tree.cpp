@@ -3,14 +3,52 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include "syskit-pch.h"
+#include "syskit/ThreadPool.hpp"
 #include "syskit/Tree.hpp"
 #include "syskit/macros.h"
 
+const unsigned int MAX_SPLIT_DEPTH = 6; //up to 4**6 subtrees
+const unsigned int SUBTREES_PER_WORKER = 8;
+
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    syskit::Tree::cb2_t cb;
+    void* arg;
+    void* partial;
+} itemArg_t;
+
+void applyItem(void* arg, syskit::Tree::item_t item)
+{
+    const itemArg_t* p = static_cast<const itemArg_t*>(arg);
+    p->cb(p->arg, p->partial, item);
+}
+
+END_NAMESPACE
+
 BEGIN_NAMESPACE1(syskit)
 
 Tree::Node* const Tree::NOT_FOUND = (Node*)(0x0badcafeUL); //must be non-zero and must be an invalid address
 
 
+//
+// Tree cut at some depth for parallel traversals. Subtrees below the
+// cut are traversed independently. Items above the cut are collected
+// and traversed as one extra partition.
+//
+struct Tree::applyArg_s
+{
+    cb2_t cb;
+    void* arg;
+    ThreadPool::Reduction* reduction;
+    const Node** subtree;
+    item_t* item;
+    unsigned int numItems;
+    unsigned int numSubtrees;
+};
+
+
 //!
 //! Construct instance using guts from that. That is, move tree contents from
 //! that into this. Also, use the same comparison function.
@@ -25,6 +63,22 @@ Tree::Tree(Tree* that)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Construct instance using guts from that. That is, move tree contents from
+//! that into this. Also, use the same comparison function.
+//!
+Tree::Tree(Tree&& that)
+{
+    compare_ = that.compare_;
+    numItems_ = that.numItems_;
+    root_ = that.root_;
+    that.numItems_ = 0;
+    that.root_ = new Node0;
+}
+#endif
+
+
 //!
 //! Construct an empty tree. When items are compared, the given comparison
 //! function will be used. A primitive comparison function comparing opaque
@@ -327,6 +381,65 @@ int Tree::compare(const void* item0, const void* item1)
 }
 
 
+//
+// Apply callback to items in the [loIndex, hiIndex) partition range using one
+// partial result. Partition numSubtrees holds the items above the cut.
+//
+void Tree::applyRange(void* arg, size_t loIndex, size_t hiIndex)
+{
+    const applyArg_s* p = static_cast<const applyArg_s*>(arg);
+    itemArg_t itemArg = {p->cb, p->arg, p->reduction->open()};
+    for (size_t i = loIndex; i < hiIndex; ++i)
+    {
+        if (i < p->numSubtrees)
+        {
+            p->subtree[i]->apply(applyItem, &itemArg);
+            continue;
+        }
+
+        for (unsigned int j = 0; j < p->numItems; ++j)
+        {
+            applyItem(&itemArg, p->item[j]);
+        }
+    }
+    p->reduction->close(itemArg.partial);
+}
+
+
+//!
+//! Apply callback to all items in parallel, in no particular order, using given
+//! thread pool (the process-wide pool if zero). The tree is cut into subtrees,
+//! a few per worker. Each partition gets its own partial result from open(arg),
+//! the callback is invoked as cb(arg, partial, item), and the partial result is
+//! handed back via close(arg, partial). The close hook is serialized. Either hook
+//! can be zero. The callback must be thread-safe. The tree must not be modified
+//! until this method returns.
+//!
+void Tree::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const
+{
+    if (numItems_ == 0)
+    {
+        return;
+    }
+
+    // Each level below the root at least doubles the number of subtrees.
+    ThreadPool& threadPool = (pool != 0)? *pool: ThreadPool::instance();
+    unsigned int depth = 0;
+    for (size_t n = 1, minSubtrees = threadPool.numWorkers() * SUBTREES_PER_WORKER; (n < minSubtrees) && (depth < MAX_SPLIT_DEPTH); n <<= 1)
+    {
+        ++depth;
+    }
+
+    size_t maxSubtrees = static_cast<size_t>(1) << (depth << 1);
+    ThreadPool::Reduction reduction(open, close, arg);
+    applyArg_s applyArg = {cb, arg, &reduction, new const Node*[maxSubtrees], new item_t[maxSubtrees], 0, 0};
+    root_->split(applyArg, depth);
+    threadPool.apply(applyArg.numSubtrees + 1, applyRange, &applyArg, 1 /*grainSize*/);
+    delete[] applyArg.item;
+    delete[] applyArg.subtree;
+}
+
+
 //
 // Look at arg as a tree pointer. Add given item to the tree.
 // Ignore errors (i.e., it's okay if an item is not added
@@ -467,6 +580,15 @@ void Tree::Node::applyParentFirst(cb1_t /*cb*/, void* /*arg*/) const
 }
 
 
+//
+// Cut the tree rooted at this node at given depth. Save the
+// subtrees and the items above the cut in given argument.
+//
+void Tree::Node::split(applyArg_s& /*applyArg*/, unsigned int /*depth*/) const
+{
+}
+
+
 Tree::Node0::Node0():
 Node()
 {
@@ -816,6 +938,25 @@ void Tree::Node1::applyParentFirst(cb1_t cb, void* arg) const
 }
 
 
+void Tree::Node1::split(applyArg_s& applyArg, unsigned int depth) const
+{
+    if (depth == 0)
+    {
+        applyArg.subtree[applyArg.numSubtrees++] = this;
+        return;
+    }
+
+    for (unsigned int i = 0; i < 1; ++i)
+    {
+        applyArg.item[applyArg.numItems++] = item_[i];
+    }
+    for (unsigned int i = 0; i <= 1; ++i)
+    {
+        if (link_[i] != 0) link_[i]->split(applyArg, depth - 1);
+    }
+}
+
+
 Tree::Node2::Node2(item_t item0, item_t item1, Node* link0, Node* link1, Node* link2):
 Node()
 {
@@ -1280,6 +1421,25 @@ void Tree::Node2::applyParentFirst(cb1_t cb, void* arg) const
 }
 
 
+void Tree::Node2::split(applyArg_s& applyArg, unsigned int depth) const
+{
+    if (depth == 0)
+    {
+        applyArg.subtree[applyArg.numSubtrees++] = this;
+        return;
+    }
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        applyArg.item[applyArg.numItems++] = item_[i];
+    }
+    for (unsigned int i = 0; i <= 2; ++i)
+    {
+        if (link_[i] != 0) link_[i]->split(applyArg, depth - 1);
+    }
+}
+
+
 Tree::Node3::Node3(item_t item0, item_t item1, item_t item2, Node* link0, Node* link1, Node* link2, Node* link3):
 Node()
 {
@@ -1911,6 +2071,25 @@ void Tree::Node3::applyParentFirst(cb1_t cb, void* arg) const
 }
 
 
+void Tree::Node3::split(applyArg_s& applyArg, unsigned int depth) const
+{
+    if (depth == 0)
+    {
+        applyArg.subtree[applyArg.numSubtrees++] = this;
+        return;
+    }
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        applyArg.item[applyArg.numItems++] = item_[i];
+    }
+    for (unsigned int i = 0; i <= 3; ++i)
+    {
+        if (link_[i] != 0) link_[i]->split(applyArg, depth - 1);
+    }
+}
+
+
 Tree::NodeX::NodeX(item_t orphan, Node* left, Node* right):
 Node()
 {
@@ -13,6 +13,8 @@ class TreeSuite;
 
 BEGIN_NAMESPACE1(syskit)
 
+class ThreadPool;
+
 
 //! 2-3-4 tree of opaque items
 class Tree
@@ -34,11 +36,17 @@ public:
     typedef int(*compare_t)(const void* item0, const void* item1);
 
     typedef void(*cb1_t)(void* arg, item_t item);
+    typedef void(*cb2_t)(void* arg, void* partial, item_t item);
+    typedef void(*close_t)(void* arg, void* partial);
+    typedef void* (*open_t)(void* arg);
 
     // Constructors and destructor.
     Tree(Tree* that);
     Tree(compare_t compare);
     Tree(const Tree& tree);
+#if HAS_RVALUE_REFS
+    Tree(Tree&& that);
+#endif
     ~Tree();
 
     // Operators.
@@ -46,6 +54,9 @@ public:
     bool operator ==(const Tree& tree) const;
     const Tree& operator =(Tree* that);
     const Tree& operator =(const Tree& tree);
+#if HAS_RVALUE_REFS
+    const Tree& operator =(Tree&& that);
+#endif
     static void operator delete(void* p, size_t size);
     static void operator delete(void* p, void* buf);
     static void* operator new(size_t size);
@@ -80,9 +91,12 @@ public:
     void apply(cb1_t cb, void* arg = 0) const;
     void applyChildFirst(cb1_t cb, void* arg = 0) const;
     void applyParentFirst(cb1_t cb, void* arg = 0) const;
+    void applyParallel(cb2_t cb, void* arg = 0, open_t open = 0, close_t close = 0, ThreadPool* pool = 0) const;
 
 private:
 
+    struct applyArg_s;
+
     //
     // ABC for all nodes.
     //
@@ -103,6 +117,7 @@ private:
         virtual void apply(cb1_t cb, void* arg) const;
         virtual void applyChildFirst(cb1_t cb, void* arg) const;
         virtual void applyParentFirst(cb1_t cb, void* arg) const;
+        virtual void split(applyArg_s& applyArg, unsigned int depth) const;
         static void operator delete(void* p, size_t size);
         static void* operator new(size_t size);
     protected:
@@ -147,6 +162,7 @@ private:
         virtual void applyChildFirst(cb1_t cb, void* arg) const;
         virtual void apply(cb1_t cb, void* arg) const;
         virtual void applyParentFirst(cb1_t cb, void* arg) const;
+        virtual void split(applyArg_s& applyArg, unsigned int depth) const;
     private:
         Node* link_[2];
         item_t item_[1];
@@ -174,6 +190,7 @@ private:
         virtual void applyChildFirst(cb1_t cb, void* arg) const;
         virtual void apply(cb1_t cb, void* arg) const;
         virtual void applyParentFirst(cb1_t cb, void* arg) const;
+        virtual void split(applyArg_s& applyArg, unsigned int depth) const;
     private:
         Node* link_[3];
         item_t item_[2];
@@ -201,6 +218,7 @@ private:
         virtual void apply(cb1_t cb, void* arg) const;
         virtual void applyChildFirst(cb1_t cb, void* arg) const;
         virtual void applyParentFirst(cb1_t cb, void* arg) const;
+        virtual void split(applyArg_s& applyArg, unsigned int depth) const;
     private:
         Node* link_[4];
         item_t item_[3];
@@ -241,6 +259,7 @@ private:
     static bool peekAny(void*, item_t);
     static int compare(const void*, const void*);
     static void addItem(void*, item_t);
+    static void applyRange(void*, size_t, size_t);
 
     friend class ::TreeSuite;
 
@@ -260,6 +279,15 @@ inline bool Tree::operator !=(const Tree& tree) const
     return !(operator ==(tree));
 }
 
+#if HAS_RVALUE_REFS
+//! Reset and move the tree contents from that into this. Assume the trees
+//! are compatible. That is, items unique in that are also unique in this.
+inline const Tree& Tree::operator =(Tree&& that)
+{
+    return operator =(&that);
+}
+#endif
+
 inline void Tree::operator delete(void* p, size_t size)
 {
     BufPool::freeBuf(p, size);
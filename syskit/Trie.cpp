@@ -5,14 +5,59 @@
 #include <string.h>
 
 #include "syskit-pch.h"
+#include "syskit/ThreadPool.hpp"
 #include "syskit/Trie.hpp"
 #include "syskit/sys.hpp"
 
+const unsigned int MAX_SPLIT_DEPTH = 8;
+const unsigned int SUBTREES_PER_WORKER = 8;
+
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    syskit::Trie::cb2_t cb;
+    void* arg;
+    void* partial;
+} kvArg_t;
+
+// Node reachable via given key prefix.
+typedef struct
+{
+    const syskit::Trie::Node* node;
+    unsigned char k[1 + MAX_SPLIT_DEPTH];
+} prefix_t;
+
+void applyKv(void* arg, const unsigned char* k, void* v)
+{
+    const kvArg_t* p = static_cast<const kvArg_t*>(arg);
+    p->cb(p->arg, p->partial, k, v);
+}
+
+END_NAMESPACE
+
 BEGIN_NAMESPACE1(syskit)
 
 Trie::Node* const Trie::NODE_ADDED = (Node*)(0x900dcafeUL); //must be non-zero and must be an invalid address
 
 
+//
+// Trie cut at some depth for parallel traversals. Subtrees below the
+// cut are traversed independently. Key-value pairs above the cut are
+// collected and traversed as one extra partition.
+//
+struct Trie::applyArg_s
+{
+    cb2_t cb;
+    void* arg;
+    ThreadPool::Reduction* reduction;
+    prefix_t* kv;
+    prefix_t* subtree;
+    unsigned int numKvPairs;
+    unsigned int numSubtrees;
+};
+
+
 //!
 //! Construct a duplicate instance of the given trie.
 //!
@@ -581,6 +626,118 @@ void Trie::applyParentFirst(cb1_t cb, void* arg) const
 }
 
 
+//!
+//! Iterate trie in parallel using given thread pool (the process-wide pool if
+//! zero). Key-value pairs are visited in no particular order. The trie is cut
+//! into subtrees, deep enough to yield a few subtrees per worker. Each partition
+//! gets its own partial result from open(arg), the callback is invoked as cb(arg,
+//! partial, k, v), and the partial result is handed back via close(arg, partial).
+//! The close hook is serialized. Either hook can be zero. The callback must be
+//! thread-safe. The trie must not be modified until this method returns.
+//!
+void Trie::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const
+{
+    if (numKvPairs_ == 0)
+    {
+        return;
+    }
+
+    // Cut one level deeper until there are enough subtrees. Each level above
+    // the cut has less than minSubtrees nodes, and that bounds the array sizes.
+    ThreadPool& threadPool = (pool != 0)? *pool: ThreadPool::instance();
+    unsigned int minSubtrees = threadPool.numWorkers() * SUBTREES_PER_WORKER;
+    ThreadPool::Reduction reduction(open, close, arg);
+    applyArg_s applyArg = {cb, arg, &reduction, 0, 0, 0, 0};
+    applyArg.kv = new prefix_t[MAX_SPLIT_DEPTH * minSubtrees];
+    applyArg.subtree = new prefix_t[(maxDigit_ + 1) * minSubtrees];
+    unsigned char k[1 + MAX_SPLIT_DEPTH];
+    for (unsigned int depth = 1; depth <= MAX_SPLIT_DEPTH; ++depth)
+    {
+        applyArg.numKvPairs = 0;
+        applyArg.numSubtrees = 0;
+        k[0] = 0;
+        split(applyArg, root_, k, depth);
+        if ((applyArg.numSubtrees == 0) || (applyArg.numSubtrees >= minSubtrees))
+        {
+            break;
+        }
+    }
+
+    threadPool.apply(applyArg.numSubtrees + 1, applyRange, &applyArg, 1 /*grainSize*/);
+    delete[] applyArg.subtree;
+    delete[] applyArg.kv;
+}
+
+
+//
+// Apply callback to key-value pairs in the [loIndex, hiIndex) partition range using
+// one partial result. Partition numSubtrees holds the key-value pairs above the cut.
+//
+void Trie::applyRange(void* arg, size_t loIndex, size_t hiIndex)
+{
+    const applyArg_s* p = static_cast<const applyArg_s*>(arg);
+    kvArg_t kvArg = {p->cb, p->arg, p->reduction->open()};
+    unsigned char k[1 + MaxKeyLength];
+    for (size_t i = loIndex; i < hiIndex; ++i)
+    {
+        if (i < p->numSubtrees)
+        {
+            const prefix_t& subtree = p->subtree[i];
+            memcpy(k, subtree.k, 1 + subtree.k[0]);
+            subtree.node->applyParentFirst(k, applyKv, &kvArg);
+            continue;
+        }
+
+        for (unsigned int j = 0; j < p->numKvPairs; ++j)
+        {
+            const prefix_t& kv = p->kv[j];
+            applyKv(&kvArg, kv.k, kv.node->v());
+        }
+    }
+    p->reduction->close(kvArg.partial);
+}
+
+
+//
+// Cut the subtrie rooted at given node (reachable via key prefix k) at given
+// depth. Save the subtrees and the key-value pairs above the cut in applyArg.
+//
+void Trie::split(applyArg_s& applyArg, const Node* node, unsigned char* k, unsigned int depth) const
+{
+    if (depth == 0)
+    {
+        prefix_t& subtree = applyArg.subtree[applyArg.numSubtrees++];
+        subtree.node = node;
+        memcpy(subtree.k, k, 1 + k[0]);
+        return;
+    }
+
+    if (node->v() != 0)
+    {
+        prefix_t& kv = applyArg.kv[applyArg.numKvPairs++];
+        kv.node = node;
+        memcpy(kv.k, k, 1 + k[0]);
+    }
+
+    if (node->isLeaf())
+    {
+        return;
+    }
+
+    unsigned int numDigits = ++*k;
+    for (unsigned int digit = 0; digit <= maxDigit_; ++digit)
+    {
+        const Node* child = node->child(static_cast<unsigned char>(digit));
+        if (child != 0)
+        {
+            k[numDigits] = static_cast<unsigned char>(digit);
+            split(applyArg, child, k, depth - 1);
+        }
+    }
+    --*k;
+}
+
+
 //!
 //! Reset the trie by recursively removing all key-value pairs.
 //!
@@ -13,6 +13,8 @@ class TrieSuite;
 
 BEGIN_NAMESPACE1(syskit)
 
+class ThreadPool;
+
 
 //! digit trie
 class Trie
@@ -49,6 +51,9 @@ public:
 
     typedef bool(*cb0_t)(void* arg, const unsigned char* k, void* v);
     typedef void(*cb1_t)(void* arg, const unsigned char* k, void* v);
+    typedef void(*cb2_t)(void* arg, void* partial, const unsigned char* k, void* v);
+    typedef void(*close_t)(void* arg, void* partial);
+    typedef void* (*open_t)(void* arg);
 
     class Node;
 
@@ -89,6 +94,7 @@ public:
     const Node* root() const;
     void applyChildFirst(cb1_t cb, void* arg = 0) const;
     void applyParentFirst(cb1_t cb, void* arg = 0) const;
+    void applyParallel(cb2_t cb, void* arg = 0, open_t open = 0, close_t close = 0, ThreadPool* pool = 0) const;
 
 
     //!
@@ -436,6 +442,8 @@ private:
         NodeN(const NodeN&);
     };
 
+    struct applyArg_s;
+
     Node* root_;
     unsigned char maxDigit_;
     unsigned int numKvPairs_;
@@ -448,9 +456,11 @@ private:
     Node* mkNodes(const unsigned char*, const unsigned char*, void*) const;
     bool addKv(const unsigned char*, void*, void*&);
     bool associateKv(const unsigned char*, void*, void*&);
+    void split(applyArg_s&, const Node*, unsigned char*, unsigned int) const;
 
     static bool isEqual(void*, const unsigned char*, void*);
     static void addNode(void*, const unsigned char*, void*);
+    static void applyRange(void*, size_t, size_t);
 
     friend class ::TrieSuite;
 
@@ -47,9 +47,15 @@ public:
     U16Vec(const U16Vec& vec);
     U16Vec(const U16Vec& vec, size_t startAt, size_t itemCount);
     U16Vec(unsigned int capacity = DefaultCap, int growBy = 0);
+#if HAS_RVALUE_REFS
+    U16Vec(U16Vec&& that);
+#endif
 
     // Operators.
     const U16Vec& operator =(const U16Vec& vec);
+#if HAS_RVALUE_REFS
+    const U16Vec& operator =(U16Vec&& that);
+#endif
     bool operator !=(const U16Vec& vec) const;
     bool operator ==(const U16Vec& vec) const;
     item_t operator [](size_t index) const;
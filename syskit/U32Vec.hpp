@@ -47,9 +47,15 @@ public:
     U32Vec(const U32Vec& vec);
     U32Vec(const U32Vec& vec, size_t startAt, size_t itemCount);
     U32Vec(unsigned int capacity = DefaultCap, int growBy = 0);
+#if HAS_RVALUE_REFS
+    U32Vec(U32Vec&& that);
+#endif
 
     // Operators.
     const U32Vec& operator =(const U32Vec& vec);
+#if HAS_RVALUE_REFS
+    const U32Vec& operator =(U32Vec&& that);
+#endif
     bool operator !=(const U32Vec& vec) const;
     bool operator ==(const U32Vec& vec) const;
     item_t operator [](size_t index) const;
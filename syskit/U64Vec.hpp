@@ -47,9 +47,15 @@ public:
     U64Vec(const U64Vec& vec);
     U64Vec(const U64Vec& vec, size_t startAt, size_t itemCount);
     U64Vec(unsigned int capacity = DefaultCap, int growBy = 0);
+#if HAS_RVALUE_REFS
+    U64Vec(U64Vec&& that);
+#endif
 
     // Operators.
     const U64Vec& operator =(const U64Vec& vec);
+#if HAS_RVALUE_REFS
+    const U64Vec& operator =(U64Vec&& that);
+#endif
     bool operator !=(const U64Vec& vec) const;
     bool operator ==(const U64Vec& vec) const;
     item_t operator [](size_t index) const;
@@ -23,6 +23,22 @@ UtfSeq(*seq)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Construct instance using guts from given sequence.
+//! Given sequence is left empty and can be reused.
+//!
+Utf16Seq::Utf16Seq(Utf16Seq&& seq):
+UtfSeq(seq)
+{
+    numU16s_ = seq.numU16s_;
+    seq_ = seq.seq_;
+    seq.seq_ = 0;
+    seq.renewSeq();
+}
+#endif
+
+
 //!
 //! Construct a duplicate instance of the given sequence.
 //!
@@ -117,6 +133,32 @@ const Utf16Seq& Utf16Seq::operator =(const Utf16Seq& seq)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Reset and move the sequence contents including guts from given sequence
+//! into this. Given sequence is left empty and can be reused.
+//!
+const Utf16Seq& Utf16Seq::operator =(Utf16Seq&& seq)
+{
+
+    // Prevent self assignment.
+    if (this != &seq)
+    {
+        delete[] seq_;
+        UtfSeq::operator =(seq);
+        setCapacity(seq.capacity());
+        numU16s_ = seq.numU16s_;
+        seq_ = seq.seq_;
+        seq.seq_ = 0;
+        seq.renewSeq();
+    }
+
+    // Return reference to self.
+    return *this;
+}
+#endif
+
+
 //!
 //! Return the character at given index. Behavior is unpredictable if
 //! the index is invalid (i.e., if it's greater than or equal to the
@@ -526,27 +568,45 @@ unsigned int Utf16Seq::convert8(const utf8_t* s, size_t numU8s, utf32_t defaultC
     size_t remaining = numU8s;
     const utf8_t* p8 = s;
 
-    // Iterate through each UTF8 character.
+    // Widen ASCII runs in bulk. Then iterate through a chunk of characters.
+    // The chunk grows while the bulk path keeps failing.
     // Plenty of room in existing buffer for encoding.
     utf16_t* p16 = seq_;
     Utf16 default16(defaultChar);
     Utf8 c8;
-    for (Utf16 c16; remaining > 0; p16 += c16.encode(p16))
+    for (size_t chunkSize = 16; remaining > 0;)
     {
-        size_t bytesConsumed = c8.decode(p8, remaining);
-        if (bytesConsumed > 0)
-        {
-            c16.resetWithValidChar(c8.asU32());
-        }
-        else
+        size_t n = widenAscii(p16, p8, remaining);
+        p8 += n;
+        p16 += n;
+        remaining -= n;
+        charCount += n;
+        chunkSize = (n >= 16)? 16: ((chunkSize < 1024)? (chunkSize << 1): chunkSize);
+        for (size_t i = 0; (i < chunkSize) && (remaining > 0); ++i, ++charCount)
         {
-            ++invalidCharCount;
-            c16 = default16;
-            bytesConsumed = 1;
+            if (*p8 <= Utf8::MaxAscii)
+            {
+                *p16++ = *p8++;
+                --remaining;
+                continue;
+            }
+
+            Utf16 c16;
+            size_t bytesConsumed = c8.decode(p8, remaining);
+            if (bytesConsumed > 0)
+            {
+                c16.resetWithValidChar(c8.asU32());
+            }
+            else
+            {
+                ++invalidCharCount;
+                c16 = default16;
+                bytesConsumed = 1;
+            }
+            p16 += c16.encode(p16);
+            p8 += bytesConsumed;
+            remaining -= bytesConsumed;
         }
-        p8 += bytesConsumed;
-        remaining -= bytesConsumed;
-        ++charCount;
     }
 
     // Summarize result.
@@ -603,6 +663,40 @@ unsigned int Utf16Seq::shrink(const utf32_t* s, size_t numChars, utf32_t default
 }
 
 
+//
+// Widen the leading ASCII bytes in given byte sequence (numU8s bytes starting
+// at s) into UTF16 at p16. Return the number of bytes widened. Use SSE2 to
+// widen 16 bytes at a time if supported.
+//
+size_t Utf16Seq::widenAscii(utf16_t* p16, const utf8_t* s, size_t numU8s)
+{
+    const utf8_t* p = s;
+    const utf8_t* pEnd = s + numU8s;
+
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    if (s_useSse2)
+    {
+        const __m128i ZERO = _mm_setzero_si128();
+        for (; pEnd - p >= 16; p += 16, p16 += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if (_mm_movemask_epi8(v) != 0)
+            {
+                break;
+            }
+            __m128i* q = reinterpret_cast<__m128i*>(p16);
+            _mm_storeu_si128(q, _mm_unpacklo_epi8(v, ZERO));
+            _mm_storeu_si128(q + 1, _mm_unpackhi_epi8(v, ZERO));
+        }
+    }
+#endif
+
+    for (; (p < pEnd) && (*p <= Utf8::MaxAscii); *p16++ = *p++);
+    return p - s;
+}
+
+
 //!
 //! Detach raw UTF16 sequence from instance. The return sequence is allocated
 //! from the heap and is to be freed by the caller using the delete[] operator
@@ -755,9 +849,7 @@ void Utf16Seq::reset(const utf8_t* s, size_t numU8s, size_t numChars)
     if (numU8s == numChars)
     {
         growBuf(minCap);
-        const utf8_t* p8 = s;
-        const utf8_t* p8End = p8 + numU8s;
-        for (utf16_t* p16 = seq_; p8 < p8End; *p16++ = *p8++);
+        widenAscii(seq_, s, numU8s);
         setLength16(numChars, numChars);
         return;
     }
@@ -768,14 +860,42 @@ void Utf16Seq::reset(const utf8_t* s, size_t numU8s, size_t numChars)
     const utf8_t* p8 = s;
     const utf8_t* p8End = p8 + numU8s;
 
-    // Iterate through each UTF8 character.
+    // Widen ASCII runs in bulk. Then decode a chunk of bytes directly. The
+    // chunk grows while the bulk path keeps failing. Given data is valid, so
+    // no range checks are required.
     // Plenty of room in existing buffer for encoding.
-    Utf8 c8;
     utf16_t* p16 = seq_;
-    for (Utf16 c16; p8 < p8End; p16 += c16.encode(p16))
+    for (size_t chunkSize = 16; p8 < p8End;)
     {
-        p8 += c8.decode(p8);
-        c16.resetWithValidChar(c8.asU32());
+        size_t n = widenAscii(p16, p8, p8End - p8);
+        p8 += n;
+        p16 += n;
+        chunkSize = (n >= 16)? 16: ((chunkSize < 1024)? (chunkSize << 1): chunkSize);
+        const utf8_t* pStop = (static_cast<size_t>(p8End - p8) > chunkSize)? (p8 + chunkSize): p8End;
+        for (Utf16 c16; p8 < pStop;)
+        {
+            if (*p8 <= Utf8::MaxAscii)
+            {
+                *p16++ = *p8++;
+            }
+            else if (*p8 < 0xe0U)
+            {
+                *p16++ = static_cast<utf16_t>(((p8[0] & 0x1fU) << 6) | (p8[1] & 0x3fU));
+                p8 += 2;
+            }
+            else if (*p8 < 0xf0U)
+            {
+                *p16++ = static_cast<utf16_t>(((p8[0] & 0x0fU) << 12) | ((p8[1] & 0x3fU) << 6) | (p8[2] & 0x3fU));
+                p8 += 3;
+            }
+            else
+            {
+                utf32_t value = ((p8[0] & 0x07U) << 18) | ((p8[1] & 0x3fU) << 12) | ((p8[2] & 0x3fU) << 6) | (p8[3] & 0x3fU);
+                c16.resetWithValidChar(value);
+                p16 += c16.encode(p16);
+                p8 += 4;
+            }
+        }
     }
 
     // Summarize result.
@@ -784,6 +904,16 @@ void Utf16Seq::reset(const utf8_t* s, size_t numU8s, size_t numChars)
 }
 
 
+// Make this sequence empty after its guts have been taken.
+// Give it a minimal buffer of its own so it can be reused.
+void Utf16Seq::renewSeq()
+{
+    setCapacity(0);
+    seq_ = new utf16_t[capacity()];
+    reset();
+}
+
+
 //!
 //! Shrink given array into this sequence. Given array holds numChars
 //! characters suitable for this sequence. Behavior is unpredictable
@@ -49,12 +49,18 @@ public:
     Utf16Seq(const Utf16Seq& seq);
     Utf16Seq(unsigned int capacity = DefaultCap);
     Utf16Seq(utf16_t* s, size_t numU16s, size_t numChars);
+#if HAS_RVALUE_REFS
+    Utf16Seq(Utf16Seq&& seq);
+#endif
 
     // Operators.
     bool operator !=(const Utf16Seq& seq) const;
     bool operator ==(const Utf16Seq& seq) const;
     const Utf16Seq& operator +=(const Utf16Seq& seq);
     const Utf16Seq& operator =(const Utf16Seq& seq);
+#if HAS_RVALUE_REFS
+    const Utf16Seq& operator =(Utf16Seq&& seq);
+#endif
 
     // Raw access.
     const utf16_t* raw() const;
@@ -149,10 +155,13 @@ private:
     utf16_t* seq_;
     unsigned int numU16s_;
 
+    void renewSeq();
     void setLength16(size_t, size_t);
     void setSize16(unsigned int);
     void shrinkBuf(unsigned int);
 
+    static size_t widenAscii(utf16_t*, const utf8_t*, size_t);
+
 };
 
 //! Return true if this sequence equals given sequence.
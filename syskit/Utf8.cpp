@@ -88,9 +88,9 @@ bool Utf8::isValid234(const utf8_t seq[MaxSeqLength])
             return false;
         }
         if (seq[0] == 0xe0U) return (seq[1] >= 0xa0U); //too many bytes in a 3-byte sequence?
-        if (seq[0] == 0xedU) return (seq[1] <= 0x9fU); //reserved value in a 3-byte sequence?
+        if (seq[0] == 0xedU) return ((seq[1] >= 0x80U) && (seq[1] <= 0x9fU)); //reserved value in a 3-byte sequence?
         if (seq[0] == 0xf0U) return (seq[1] >= 0x90U); //too many bytes in a 4-byte sequence?
-        if (seq[0] == 0xf4U) return (seq[1] <= 0x8fU); //value too big for a 4-byte sequence?
+        if (seq[0] == 0xf4U) return ((seq[1] >= 0x80U) && (seq[1] <= 0x8fU)); //value too big for a 4-byte sequence?
         return (seq[1] >= 0x80U);
 
     default:
@@ -144,9 +144,9 @@ bool Utf8::isValid234(const utf8_t* seq, size_t maxSeqLength)
             return false;
         }
         if (seq[0] == 0xe0U) return (seq[1] >= 0xa0U); //too many bytes in a 3-byte sequence?
-        if (seq[0] == 0xedU) return (seq[1] <= 0x9fU); //reserved value in a 3-byte sequence?
+        if (seq[0] == 0xedU) return ((seq[1] >= 0x80U) && (seq[1] <= 0x9fU)); //reserved value in a 3-byte sequence?
         if (seq[0] == 0xf0U) return (seq[1] >= 0x90U); //too many bytes in a 4-byte sequence?
-        if (seq[0] == 0xf4U) return (seq[1] <= 0x8fU); //too-big values in a 4-byte sequence?
+        if (seq[0] == 0xf4U) return ((seq[1] >= 0x80U) && (seq[1] <= 0x8fU)); //too-big values in a 4-byte sequence?
         return (seq[1] >= 0x80U);
 
     default:
@@ -257,9 +257,9 @@ unsigned int Utf8::decode234(const utf8_t* seq, size_t maxSeqLength)
         // Too many bytes in a 4-byte sequence?
         // Value too big for a 4-byte sequence?
         if (seq[0] == 0xe0U) return (seq[1] >= 0xa0U)? (c_ = value, seqLength): (0);
-        if (seq[0] == 0xedU) return (seq[1] <= 0x9fU)? (c_ = value, seqLength): (0);
+        if (seq[0] == 0xedU) return ((seq[1] >= 0x80U) && (seq[1] <= 0x9fU))? (c_ = value, seqLength): (0);
         if (seq[0] == 0xf0U) return (seq[1] >= 0x90U)? (c_ = value, seqLength): (0);
-        if (seq[0] == 0xf4U) return (seq[1] <= 0x8fU)? (c_ = value, seqLength): (0);
+        if (seq[0] == 0xf4U) return ((seq[1] >= 0x80U) && (seq[1] <= 0x8fU))? (c_ = value, seqLength): (0);
         return (seq[1] >= 0x80U)? (c_ = value, seqLength): (0);
 
     default:
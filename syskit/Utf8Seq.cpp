@@ -8,27 +8,88 @@
 #include "syskit/Utf8Seq.hpp"
 #include "syskit/sys.hpp"
 
+// Byte classes for the UTF8 validation state machine. Indexed by byte.
+// 0: ASCII, 1: 0x80-0x8f, 2: 0x90-0x9f, 3: 0xa0-0xbf, 4: 2-byte lead,
+// 5: 0xe0, 6: other 3-byte leads, 7: 0xed, 8: 0xf0, 9: 0xf1-0xf3,
+// 10: 0xf4, 11: not valid in any sequence.
+const unsigned char UTF8_CLASS[] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x00-0x0f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x10-0x1f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x20-0x2f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x30-0x3f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x40-0x4f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x50-0x5f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x60-0x6f
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  //0x70-0x7f
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  //0x80-0x8f
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  //0x90-0x9f
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,  //0xa0-0xaf
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,  //0xb0-0xbf
+    11, 11, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,  //0xc0-0xcf
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,  //0xd0-0xdf
+    5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 6, 6,  //0xe0-0xef
+    8, 9, 9, 9, 10, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11 //0xf0-0xff
+};
+
+// State transitions for the UTF8 validation state machine. Indexed by
+// state plus byte class. States are multiples of the number of byte
+// classes. 0: accept, 12: reject, 24/36/48: expecting 1/2/3 more bytes
+// in 0x80-0xbf, 60: after 0xe0, 72: after 0xed, 84: after 0xf0, 96:
+// after 0xf4. Restrictions after 0xe0, 0xed, 0xf0, and 0xf4 reject too
+// long sequences, reserved values, and values larger than MaxChar.
+const unsigned char UTF8_NEXT[] =
+{
+    0, 12, 12, 12, 24, 60, 36, 72, 84, 48, 96, 12,  //accept
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,  //reject
+    12, 0, 0, 0, 12, 12, 12, 12, 12, 12, 12, 12,  //1 more
+    12, 24, 24, 24, 12, 12, 12, 12, 12, 12, 12, 12,  //2 more
+    12, 36, 36, 36, 12, 12, 12, 12, 12, 12, 12, 12,  //3 more
+    12, 12, 12, 24, 12, 12, 12, 12, 12, 12, 12, 12,  //after 0xe0
+    12, 24, 24, 12, 12, 12, 12, 12, 12, 12, 12, 12,  //after 0xed
+    12, 12, 36, 36, 12, 12, 12, 12, 12, 12, 12, 12,  //after 0xf0
+    12, 36, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12   //after 0xf4
+};
+
+const unsigned int UTF8_ACCEPT = 0;
+const unsigned int UTF8_REJECT = 12;
+
 BEGIN_NAMESPACE1(syskit)
 
 
 //
 // Transfer resource ownership.
-// Nullify source.
+// Nullify source. A borrowed source buffer is copied instead.
 //
 Utf8Seq::Utf8Seq(Utf8Seq* seq):
 UtfSeq(*seq)
 {
-    seq_ = seq->seq_;
-    seq->seq_ = 0;
+    takeSeq(*seq);
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Construct instance using guts from given sequence. Given sequence is left
+//! empty and can be reused. A borrowed source buffer is copied instead.
+//!
+Utf8Seq::Utf8Seq(Utf8Seq&& seq):
+UtfSeq(seq)
+{
+    takeSeq(seq);
+    seq.renewSeq();
+}
+#endif
+
+
 //!
 //! Construct a duplicate instance of the given sequence.
 //!
 Utf8Seq::Utf8Seq(const Utf8Seq& seq):
 UtfSeq(seq)
 {
+    index_ = 0;
+    ownsSeq_ = true;
     seq_ = new utf8_t[Utf8Seq::capacity()];
     memcpy(seq_, seq.seq_, byteSize_);
 }
@@ -40,6 +101,8 @@ UtfSeq(seq)
 Utf8Seq::Utf8Seq(const Utf8Seq& seq, size_t startAt, size_t charCount, unsigned int capacity):
 UtfSeq(capacity, 0, 0)
 {
+    index_ = 0;
+    ownsSeq_ = true;
     seq_ = new utf8_t[Utf8Seq::capacity()];
     reset(seq, startAt, charCount);
 }
@@ -51,6 +114,8 @@ UtfSeq(capacity, 0, 0)
 Utf8Seq::Utf8Seq(const char* s, size_t length, unsigned int capacity):
 UtfSeq(capacity, 0, 0)
 {
+    index_ = 0;
+    ownsSeq_ = true;
     seq_ = new utf8_t[Utf8Seq::capacity()];
     reset(s, length);
 }
@@ -64,6 +129,8 @@ UtfSeq(capacity, 0, 0)
 Utf8Seq::Utf8Seq(unsigned int capacity):
 UtfSeq(capacity, 0, 0)
 {
+    index_ = 0;
+    ownsSeq_ = true;
     seq_ = new utf8_t[Utf8Seq::capacity()];
 }
 
@@ -76,13 +143,34 @@ UtfSeq(capacity, 0, 0)
 Utf8Seq::Utf8Seq(utf8_t* s, size_t numU8s, size_t numChars):
 UtfSeq(static_cast<unsigned int>(numU8s), numU8s, numChars)
 {
+    index_ = 0;
+    ownsSeq_ = true;
     seq_ = s;
 }
 
 
+//!
+//! Construct an empty sequence using given buffer which can hold up to capacity
+//! bytes. The buffer is borrowed, not owned. It must outlive the instance, and
+//! it is abandoned for a heap buffer when growth occurs. Used by derived classes
+//! to keep short sequences in inline storage.
+//!
+Utf8Seq::Utf8Seq(utf8_t* buf, unsigned int capacity):
+UtfSeq(capacity, 0, 0)
+{
+    index_ = 0;
+    ownsSeq_ = false;
+    seq_ = buf;
+}
+
+
 Utf8Seq::~Utf8Seq()
 {
-    delete[] seq_;
+    dropIndex();
+    if (ownsSeq_)
+    {
+        delete[] seq_;
+    }
 }
 
 
@@ -96,6 +184,7 @@ const Utf8Seq& Utf8Seq::operator +=(const Utf8& c)
     {
         byteSize_ += c.encode(seq_ + byteSize_);
         ++numChars_;
+        fitIndex();
     }
 
     return *this;
@@ -117,6 +206,7 @@ const Utf8Seq& Utf8Seq::operator +=(char c)
             seq_[byteSize_] = c;
             ++numChars_;
             ++byteSize_;
+            fitIndex();
         }
     }
 
@@ -130,6 +220,7 @@ const Utf8Seq& Utf8Seq::operator +=(char c)
             Utf8 c8(static_cast<unsigned char>(c), skipValidation);
             byteSize_ += c8.encode(seq_ + byteSize_);
             ++numChars_;
+            fitIndex();
         }
     }
 
@@ -151,6 +242,7 @@ const Utf8Seq& Utf8Seq::operator +=(const Utf8Seq& seq)
             memcpy(seq_ + byteSize_, seq.seq_, seq.byteSize_);
             numChars_ += seq.numChars_;
             byteSize_ += seq.byteSize_;
+            fitIndex();
         }
     }
 
@@ -168,11 +260,16 @@ const Utf8Seq& Utf8Seq::operator =(const Utf8Seq& seq)
         // Grow to accomodate source.
         if (seq.byteSize_ > capacity())
         {
-            delete[] seq_;
+            if (ownsSeq_)
+            {
+                delete[] seq_;
+            }
             seq_ = new utf8_t[setNextCap(seq.byteSize_)];
+            ownsSeq_ = true;
         }
 
         // Copy from given sequence.
+        dropIndex();
         UtfSeq::operator =(seq);
         memcpy(seq_, seq.seq_, byteSize_);
     }
@@ -182,14 +279,50 @@ const Utf8Seq& Utf8Seq::operator =(const Utf8Seq& seq)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Reset and move the sequence contents including guts from given sequence into
+//! this. Given sequence is now disabled and must not be used further. A borrowed
+//! source buffer is copied instead.
+//!
+const Utf8Seq& Utf8Seq::operator =(Utf8Seq&& seq)
+{
+
+    // Prevent self assignment.
+    if (this != &seq)
+    {
+        if (!seq.ownsSeq_)
+        {
+            const Utf8Seq& src = seq;
+            return operator =(src);
+        }
+
+        // Take over source buffer. Leave source empty but usable.
+        if (ownsSeq_)
+        {
+            delete[] seq_;
+        }
+        dropIndex();
+        UtfSeq::operator =(seq);
+        setCapacity(seq.capacity());
+        takeSeq(seq);
+        seq.renewSeq();
+    }
+
+    // Return reference to self.
+    return *this;
+}
+#endif
+
+
 //!
 //! Return the character at given index. Behavior is unpredictable if
 //! the index is invalid (i.e., if it's greater than or equal to the
 //! number of characters in the sequence). This method is implemented
-//! by decoding the raw sequence from its beginning/end until the desired
-//! character is seen. It can quite inefficient if some character in the
-//! sequence uses more than one byte. If most of the characters need to
-//! be iterated, use expand() for best performance.
+//! by decoding the raw sequence from the nearest known location (its
+//! beginning, its end, or an index entry) until the desired character
+//! is seen. If most of the characters need to be iterated, use expand()
+//! for best performance.
 //!
 utf32_t Utf8Seq::operator [](size_t index) const
 {
@@ -329,20 +462,9 @@ bool Utf8Seq::applyLoToHi(cb0_t cb, void* arg) const
 //!
 bool Utf8Seq::countChars(const utf8_t* s, size_t numU8s, unsigned int& numChars)
 {
-    bool ok = true;
-    const utf8_t* p = s;
-    size_t count = 0;
-    for (size_t remaining = numU8s; remaining > 0; ++count)
-    {
-        if (!Utf8::isValid(p, remaining))
-        {
-            ok = false;
-            break;
-        }
-        size_t charLength = Utf8::getSeqLength(*p);
-        p += charLength;
-        remaining -= charLength;
-    }
+    size_t count;
+    const utf8_t* p = scan(s, numU8s, count);
+    bool ok = (p == s + numU8s);
 
     numChars = static_cast<unsigned int>(count);
     return ok;
@@ -360,22 +482,12 @@ bool Utf8Seq::countChars(const utf8_t* s, size_t numU8s, unsigned int& numChars)
 //!
 bool Utf8Seq::isValid(const utf8_t* s, size_t numU8s, const utf8_t** badSeq)
 {
-    bool ok = true;
-    const utf8_t* p = s;
-    for (size_t remaining = numU8s; remaining > 0;)
+    size_t numChars;
+    const utf8_t* p = scan(s, numU8s, numChars);
+    bool ok = (p == s + numU8s);
+    if ((!ok) && (badSeq != 0))
     {
-        if (!Utf8::isValid(p, remaining))
-        {
-            ok = false;
-            if (badSeq != 0)
-            {
-                *badSeq = p;
-            }
-            break;
-        }
-        size_t charLength = Utf8::getSeqLength(*p);
-        p += charLength;
-        remaining -= charLength;
+        *badSeq = p;
     }
 
     return ok;
@@ -401,8 +513,12 @@ bool Utf8Seq::resize(unsigned int newCap)
         {
             utf8_t* raw8 = new utf8_t[newCap];
             memcpy(raw8, seq_, byteSize_);
-            delete[] seq_;
+            if (ownsSeq_)
+            {
+                delete[] seq_;
+            }
             seq_ = raw8;
+            ownsSeq_ = true;
             setCapacity(newCap);
         }
     }
@@ -431,12 +547,9 @@ bool Utf8Seq::truncate(size_t numChars)
         }
         else
         {
-            const utf8_t* p = seq_ + byteSize_;
-            do
-            {
-                for (--p; Utf8::getSeqLength(*p) == Utf8::InvalidByte0; --p);
-            } while (--numChars_ > numChars);
-            setByteSize(p - seq_);
+            const utf8_t* p = seek(numChars);
+            setLength(p - seq_, numChars);
+            fitIndex();
         }
     }
 
@@ -444,12 +557,83 @@ bool Utf8Seq::truncate(size_t numChars)
 }
 
 
+//
+// Build and return the character index. Entry 0 holds the number of subsequent
+// entries. Entry k holds the byte offset of character k*IndexStep. The index is
+// published with a release store, so readers loading it with acquire semantics
+// see its entries. If some other thread has published one first, use it and
+// discard the one built here.
+//
+const unsigned int* Utf8Seq::buildIndex() const
+{
+    unsigned int numEntries = numChars_ / IndexStep;
+    unsigned int* index = new unsigned int[indexCap(numEntries)];
+    index[0] = 0;
+    indexTail(index, numEntries);
+
+    unsigned int* cur;
+    if (!publishIfNull(&index_, index, cur))
+    {
+        delete[] index;
+        index = cur;
+    }
+
+    return index;
+}
+
+
+//
+// Scan given UTF8 byte sequence (numU8s bytes starting at s) left to right
+// until all is scanned or until some invalid data is seen. ASCII runs are
+// skipped in bulk. Multi-byte sequences are validated using a table-driven
+// state machine. Return the location where invalid data is seen, or s+numU8s
+// if the whole sequence is valid. Also return the number of valid characters
+// seen in numChars.
+//
+const utf8_t* Utf8Seq::scan(const utf8_t* s, size_t numU8s, size_t& numChars)
+{
+    size_t count = 0;
+    const utf8_t* p = s;
+    for (const utf8_t* pEnd = s + numU8s; p < pEnd;)
+    {
+
+        // ASCII run.
+        if (*p <= Utf8::MaxAscii)
+        {
+            size_t n = skipAscii(p, pEnd - p);
+            p += n;
+            count += n;
+            continue;
+        }
+
+        // Multi-byte sequence. Invalid if rejected or truncated.
+        const utf8_t* p1 = p;
+        unsigned int state = UTF8_NEXT[UTF8_ACCEPT + UTF8_CLASS[*p1++]];
+        while ((state > UTF8_REJECT) && (p1 < pEnd))
+        {
+            state = UTF8_NEXT[state + UTF8_CLASS[*p1++]];
+        }
+        if (state != UTF8_ACCEPT)
+        {
+            break;
+        }
+        p = p1;
+        ++count;
+    }
+
+    numChars = count;
+    return p;
+}
+
+
 //!
 //! Seek and return the address of the character residing at given index.
-//! Behavior is unpredictable if the index is invalid (i.e., if it's greater
-//! than or equal to the number of characters in the sequence). This method
-//! can be quite inefficient for non-ASCII data. If most of the characters
-//! need to be iterated, use expand() for best performance.
+//! Return the end of the sequence if the index equals the number of characters
+//! in the sequence. Behavior is unpredictable if the index is greater than that.
+//! For long non-ASCII data, decoding starts from the nearest index entry, so at
+//! most IndexStep/2 characters are decoded. The index is built on first use.
+//! If most of the characters need to be iterated, use expand() for best
+//! performance.
 //!
 const utf8_t* Utf8Seq::seek(size_t index) const
 {
@@ -462,20 +646,47 @@ const utf8_t* Utf8Seq::seek(size_t index) const
     }
 
     // Some decoding required if some character uses more than one byte.
+    // Start from the nearest known location: the beginning, the end, or
+    // an index entry if the sequence is long enough to be indexed.
     else if (index > 0)
     {
-        if (index <= (numChars_ >> 1))
+        size_t i = 0;
+        if (numChars_ >= MinIndexedChars)
+        {
+            const unsigned int* entry = loadAcquire(&index_);
+            if (entry == 0)
+            {
+                entry = buildIndex();
+            }
+            size_t k = index / IndexStep;
+            if (k >= entry[0])
+            {
+                k = entry[0];
+            }
+            else if ((index % IndexStep) > (IndexStep >> 1))
+            {
+                ++k;
+            }
+            if (k > 0)
+            {
+                i = k * IndexStep;
+                p += entry[k];
+            }
+        }
+
+        if ((i <= index) && ((index - i) > (numChars_ - index)))
         {
-            for (size_t i = 0; i++ < index; p += Utf8::getSeqLength(*p));
+            i = numChars_;
+            p = seq_ + byteSize_;
         }
-        else
+
+        for (; i < index; ++i)
         {
-            p += byteSize_;
-            size_t i = numChars_;
-            do
-            {
-                while (Utf8::getSeqLength(*--p) == Utf8::InvalidByte0);
-            } while (--i > index);
+            p += Utf8::getSeqLength(*p);
+        }
+        for (; i > index; --i)
+        {
+            while (Utf8::getSeqLength(*--p) == Utf8::InvalidByte0);
         }
     }
 
@@ -549,36 +760,37 @@ unsigned int Utf8Seq::convert16(const utf16_t* s, size_t numU16s, utf32_t defaul
     unsigned int minCap = static_cast<unsigned int>(numU16s)* 2 * Utf8::MaxSeqLength;
     unsigned int oldCap = growBuf(minCap);
     unsigned int invalidCharCount = 0;
-    size_t charCount = numU16s;
+    size_t charCount = 0;
     const utf16_t* p16 = s;
-    const utf16_t* p16End = p16 + charCount;
+    const utf16_t* p16End = p16 + numU16s;
 
-    // Iterate through each UTF16 character.
+    // Encode non-surrogate characters in bulk. Then
+    // encode a surrogate pair or an invalid character.
     // Plenty of room in existing buffer for encoding.
+    const bool swapped = false;
     Utf8 default8(defaultChar);
     utf8_t* p8 = seq_;
-    for (Utf8 c; p16 < p16End; p8 += c.encode(p8))
+    for (Utf8 c; p16 < p16End; p8 += c.encode(p8), ++charCount)
     {
-        if ((*p16 >= Utf16::HiHalfMin) && (*p16 <= Utf16::LoHalfMax))
+        size_t n = encodeBmp(p8, p16, p16End - p16, swapped);
+        charCount += n;
+        if ((p16 += n) == p16End)
         {
-            if ((p16 + 1 < p16End) && (*p16 <= Utf16::HiHalfMax) &&
-                (p16[1] >= Utf16::LoHalfMin) && (p16[1] <= Utf16::LoHalfMax))
-            {
-                utf32_t value = Utf16::convertSurrogate(p16);
-                c.resetWithValidChar(value);
-                --charCount;
-            }
-            else
-            {
-                c = default8;
-                ++invalidCharCount;
-            }
-            p16 += 2;
+            break;
+        }
+
+        if ((p16 + 1 < p16End) && (*p16 <= Utf16::HiHalfMax) &&
+            (p16[1] >= Utf16::LoHalfMin) && (p16[1] <= Utf16::LoHalfMax))
+        {
+            utf32_t value = Utf16::convertSurrogate(p16);
+            c.resetWithValidChar(value);
         }
         else
         {
-            c.resetWithValidChar(*p16++);
+            c = default8;
+            ++invalidCharCount;
         }
+        p16 += 2;
     }
 
     // Summarize result.
@@ -607,40 +819,38 @@ unsigned int Utf8Seq::convert61(const utf16_t* s, size_t numU16s, utf32_t defaul
     unsigned int minCap = static_cast<unsigned int>(numU16s)* 2 * Utf8::MaxSeqLength;
     unsigned int oldCap = growBuf(minCap);
     unsigned int invalidCharCount = 0;
-    size_t charCount = numU16s;
+    size_t charCount = 0;
     const utf16_t* p61 = s;
-    const utf16_t* p61End = p61 + charCount;
+    const utf16_t* p61End = p61 + numU16s;
 
-    // Iterate through each UTF16 character.
+    // Encode non-surrogate characters in bulk. Then
+    // encode a surrogate pair or an invalid character.
     // Plenty of room in existing buffer for encoding.
+    const bool swapped = true;
     Utf8 default8(defaultChar);
     utf8_t* p8 = seq_;
-    for (Utf8 c; p61 < p61End; p8 += c.encode(p8))
+    for (Utf8 c; p61 < p61End; p8 += c.encode(p8), ++charCount)
     {
-        unsigned short u16A = bswap16(*p61);
-        if ((u16A >= Utf16::HiHalfMin) && (u16A <= Utf16::LoHalfMax))
+        size_t n = encodeBmp(p8, p61, p61End - p61, swapped);
+        charCount += n;
+        if ((p61 += n) == p61End)
         {
-            if ((p61 + 1 < p61End) && (u16A <= Utf16::HiHalfMax))
-            {
-                unsigned short u16B = bswap16(p61[1]);
-                if ((u16B >= Utf16::LoHalfMin) && (u16B <= Utf16::LoHalfMax))
-                {
-                    utf32_t value = Utf16::convertSurrogate(u16A, u16B);
-                    c.resetWithValidChar(value);
-                    --charCount;
-                    p61 += 2;
-                    continue;
-                }
-            }
-            c = default8;
-            ++invalidCharCount;
-            p61 += 2;
+            break;
+        }
+
+        unsigned short u16A = bswap16(p61[0]);
+        unsigned short u16B = (p61 + 1 < p61End)? bswap16(p61[1]): 0;
+        if ((u16A <= Utf16::HiHalfMax) && (u16B >= Utf16::LoHalfMin) && (u16B <= Utf16::LoHalfMax))
+        {
+            utf32_t value = Utf16::convertSurrogate(u16A, u16B);
+            c.resetWithValidChar(value);
         }
         else
         {
-            c.resetWithValidChar(u16A);
-            ++p61;
+            c = default8;
+            ++invalidCharCount;
         }
+        p61 += 2;
     }
 
     // Summarize result.
@@ -718,6 +928,24 @@ unsigned int Utf8Seq::convert8(const utf8_t* s, size_t numU8s, utf32_t defaultCh
 }
 
 
+//
+// Return the number of entries to allocate for a character index holding
+// numEntries entries after entry 0. Sizes are powers of two, so an index
+// can be extended in place most of the time. An index whose entry 0 holds
+// n has room for at least indexCap(n) entries.
+//
+unsigned int Utf8Seq::indexCap(unsigned int numEntries)
+{
+    unsigned int cap = 1;
+    while (cap <= numEntries)
+    {
+        cap <<= 1;
+    }
+
+    return cap;
+}
+
+
 //!
 //! Shrink given array into this sequence. Given array holds numChars
 //! characters, some of which might be unsuitable for this sequence.
@@ -764,6 +992,141 @@ unsigned int Utf8Seq::shrink(const utf32_t* s, size_t numChars, utf32_t defaultC
 }
 
 
+//
+// Encode leading non-surrogate characters in given UTF16 data (numU16s shorts
+// starting at s, non-native-endian if swapped is true) into UTF8 at p8. Stop
+// at the first surrogate. Advance p8 past the encoded bytes. Return the number
+// of shorts encoded. Use SSE2 to narrow 16 ASCII characters at a time if
+// supported. Encode other characters directly, in chunks which grow while
+// the ASCII path keeps failing, so mostly non-ASCII text is not penalized.
+//
+size_t Utf8Seq::encodeBmp(utf8_t*& p8, const utf16_t* s, size_t numU16s, bool swapped)
+{
+    const utf16_t* p = s;
+    const utf16_t* pEnd = s + numU16s;
+    utf8_t* q = p8;
+
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    const __m128i NON_ASCII = _mm_set1_epi16(static_cast<short>(0xff80U));
+#endif
+
+    for (size_t chunkSize = 16;;)
+    {
+        const utf16_t* p0 = p;
+
+#if HAS_SSE2_INTRINSICS
+        if (s_useSse2)
+        {
+            for (; pEnd - p >= 16; p += 16, q += 16)
+            {
+                const __m128i* v = reinterpret_cast<const __m128i*>(p);
+                __m128i v0 = _mm_loadu_si128(v);
+                __m128i v1 = _mm_loadu_si128(v + 1);
+                if (swapped)
+                {
+                    v0 = _mm_or_si128(_mm_slli_epi16(v0, 8), _mm_srli_epi16(v0, 8));
+                    v1 = _mm_or_si128(_mm_slli_epi16(v1, 8), _mm_srli_epi16(v1, 8));
+                }
+                __m128i hi = _mm_and_si128(_mm_or_si128(v0, v1), NON_ASCII);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(hi, _mm_setzero_si128())) != 0xffff)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(q), _mm_packus_epi16(v0, v1));
+            }
+        }
+#endif
+
+        chunkSize = (p > p0)? 16: ((chunkSize < 1024)? (chunkSize << 1): chunkSize);
+        const utf16_t* pStop = (static_cast<size_t>(pEnd - p) > chunkSize)? (p + chunkSize): pEnd;
+        for (; p < pStop; ++p)
+        {
+            unsigned int u16 = swapped? bswap16(*p): *p;
+            if (u16 <= Utf8::MaxAscii)
+            {
+                *q++ = static_cast<utf8_t>(u16);
+            }
+            else if (u16 <= 0x07ffU)
+            {
+                q[0] = static_cast<utf8_t>(0xc0U | (u16 >> 6));
+                q[1] = static_cast<utf8_t>(0x80U | (u16 & 0x3fU));
+                q += 2;
+            }
+            else if ((u16 < Utf16::HiHalfMin) || (u16 > Utf16::LoHalfMax))
+            {
+                q[0] = static_cast<utf8_t>(0xe0U | (u16 >> 12));
+                q[1] = static_cast<utf8_t>(0x80U | ((u16 >> 6) & 0x3fU));
+                q[2] = static_cast<utf8_t>(0x80U | (u16 & 0x3fU));
+                q += 3;
+            }
+            else
+            {
+                p8 = q;
+                return p - s;
+            }
+        }
+
+        if (p == pEnd)
+        {
+            break;
+        }
+    }
+
+    p8 = q;
+    return p - s;
+}
+
+
+//
+// Return the number of leading ASCII bytes in given byte sequence (numU8s
+// bytes starting at s). Use SSE2 to check 64 and then 16 bytes at a time
+// if supported. Otherwise, check 8 bytes at a time.
+//
+size_t Utf8Seq::skipAscii(const utf8_t* s, size_t numU8s)
+{
+    const utf8_t* p = s;
+    const utf8_t* pEnd = s + numU8s;
+
+#if HAS_SSE2_INTRINSICS
+    static bool s_useSse2 = sse2IsSupported();
+    if (s_useSse2)
+    {
+        for (; pEnd - p >= 64; p += 64)
+        {
+            const __m128i* v = reinterpret_cast<const __m128i*>(p);
+            __m128i v01 = _mm_or_si128(_mm_loadu_si128(v), _mm_loadu_si128(v + 1));
+            __m128i v23 = _mm_or_si128(_mm_loadu_si128(v + 2), _mm_loadu_si128(v + 3));
+            if (_mm_movemask_epi8(_mm_or_si128(v01, v23)) != 0)
+            {
+                break;
+            }
+        }
+        for (; pEnd - p >= 16; p += 16)
+        {
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) != 0)
+            {
+                break;
+            }
+        }
+    }
+#endif
+
+    const unsigned long long HIGH_BITS = 0x8080808080808080ULL;
+    for (unsigned long long w; pEnd - p >= 8; p += 8)
+    {
+        memcpy(&w, p, sizeof(w));
+        if ((w & HIGH_BITS) != 0)
+        {
+            break;
+        }
+    }
+
+    for (; (p < pEnd) && (*p <= Utf8::MaxAscii); ++p);
+    return p - s;
+}
+
+
 //!
 //! Detach raw UTF8 sequence from instance. The return sequence is allocated
 //! from the heap and is to be freed by the caller using the delete[] operator
@@ -772,6 +1135,12 @@ unsigned int Utf8Seq::shrink(const utf32_t* s, size_t numChars, utf32_t defaultC
 utf8_t* Utf8Seq::detachRaw()
 {
     utf8_t* raw = seq_;
+    if (!ownsSeq_)
+    {
+        raw = new utf8_t[capacity()];
+        memcpy(raw, seq_, byteSize_);
+        ownsSeq_ = true;
+    }
     seq_ = 0;
     reset();
     setCapacity(0xffffffffUL);
@@ -838,6 +1207,7 @@ void Utf8Seq::append(const Utf8Seq& seq, size_t startAt, size_t charCount)
         {
             memcpy(seq_ + byteSize_, seq.seq_ + size0, size1);
             setLength(byteSize_ + size1, numChars_ + charCount);
+            fitIndex();
         }
     }
 }
@@ -875,6 +1245,7 @@ void Utf8Seq::append(const char* s, size_t length)
         *p8++ = *p;
     } while (++p < pEnd);
     setLength(byteSize_ + length, numChars_ + length);
+    fitIndex();
 }
 
 
@@ -891,6 +1262,7 @@ void Utf8Seq::append(const utf8_t* s, size_t numU8s, size_t numChars)
         {
             memcpy(seq_ + byteSize_, s, numU8s);
             setLength(byteSize_ + numU8s, numChars_ + numChars);
+            fitIndex();
         }
     }
 }
@@ -914,6 +1286,7 @@ void Utf8Seq::append(size_t count, char c)
         {
             memset(seq_ + byteSize_, c, count);
             setLength(byteSize_ + count, numChars_ + count);
+            fitIndex();
         }
     }
 
@@ -934,6 +1307,7 @@ void Utf8Seq::append(size_t count, char c)
                 p8[1] = a8[1];
             }
             setLength(minCap, numChars_ + count);
+            fitIndex();
         }
     }
 }
@@ -955,6 +1329,7 @@ void Utf8Seq::appendAscii8(const unsigned char* s, size_t length)
             c.resetWithValidChar(*p++);
         }
         setLength(p8 - seq_, numChars_ + length);
+        fitIndex();
     }
 }
 
@@ -1027,13 +1402,38 @@ void Utf8Seq::applyLoToHi(cb1_t cb, void* arg) const
 //!
 void Utf8Seq::attachRaw(utf8_t* s, size_t numU8s, size_t numChars)
 {
-    delete[] seq_;
+    if (ownsSeq_)
+    {
+        delete[] seq_;
+    }
+    dropIndex();
     seq_ = s;
+    ownsSeq_ = true;
     setLength(numU8s, numChars);
     setCapacity(byteSize_);
 }
 
 
+//
+// Add character index entries for characters appended at the end. Grow the
+// index if it has no room for the new entries.
+//
+void Utf8Seq::extendIndex()
+{
+    unsigned int numEntries = numChars_ / IndexStep;
+    unsigned int* index = index_;
+    if (indexCap(index[0]) <= numEntries)
+    {
+        index = new unsigned int[indexCap(numEntries)];
+        memcpy(index, index_, (index_[0] + 1) * sizeof(*index));
+        delete[] index_;
+        index_ = index;
+    }
+
+    indexTail(index, numEntries);
+}
+
+
 //!
 //! Compute the byte sizes identifying the given subsequence. Save the
 //! byte size of characters up to startAt in size0. Save the byte size
@@ -1050,22 +1450,16 @@ void Utf8Seq::getByteSizes(size_t startAt, size_t charCount, unsigned int& size0
         }
         else
         {
-            const utf8_t* p1 = seq_;
-            if (startAt <= (numChars_ >> 1))
+            const utf8_t* p1 = seek(startAt);
+            const utf8_t* p2 = p1;
+            if (charCount <= IndexStep)
             {
-                for (size_t i = 0; i++ < startAt; p1 += Utf8::getSeqLength(*p1));
+                for (size_t i = 0; i++ < charCount; p2 += Utf8::getSeqLength(*p2));
             }
             else
             {
-                p1 += byteSize_;
-                size_t i = numChars_;
-                do
-                {
-                    while (Utf8::getSeqLength(*--p1) == Utf8::InvalidByte0);
-                } while (--i > startAt);
+                p2 = seek(startAt + charCount);
             }
-            const utf8_t* p2 = p1;
-            for (size_t i = 0; i++ < charCount; p2 += Utf8::getSeqLength(*p2));
             size0 = static_cast<unsigned int>(p1 - seq_);
             size1 = static_cast<unsigned int>(p2 - p1);
         }
@@ -1079,6 +1473,27 @@ void Utf8Seq::getByteSizes(size_t startAt, size_t charCount, unsigned int& size0
 }
 
 
+//
+// Fill the character index entries after the last known one, up to
+// entry numEntries. The index must have room for these entries.
+//
+void Utf8Seq::indexTail(unsigned int* index, unsigned int numEntries) const
+{
+    unsigned int k = index[0];
+    const utf8_t* p = seq_ + ((k == 0)? 0: index[k]);
+    while (k < numEntries)
+    {
+        for (unsigned int i = 0; i < IndexStep; ++i)
+        {
+            p += Utf8::getSeqLength(*p);
+        }
+        index[++k] = static_cast<unsigned int>(p - seq_);
+    }
+
+    index[0] = numEntries;
+}
+
+
 //!
 //! Reset instance with given subsequence (charCount characters starting at startAt).
 //!
@@ -1191,11 +1606,17 @@ void Utf8Seq::reset16(const utf16_t* s, size_t numChars)
     const utf16_t* p16 = s;
     const utf16_t* p16End = p16 + numChars;
 
-    // Iterate through each UTF16 character.
+    // Encode characters in bulk. Given data is not supposed to
+    // have surrogates, but encode each as-is like other characters.
     // Plenty of room in existing buffer for encoding.
+    const bool swapped = false;
     utf8_t* p8 = seq_;
     for (Utf8 c; p16 < p16End; p8 += c.encode(p8))
     {
+        if ((p16 += encodeBmp(p8, p16, p16End - p16, swapped)) == p16End)
+        {
+            break;
+        }
         c.resetWithValidChar(*p16++);
     }
 
@@ -1227,19 +1648,19 @@ void Utf8Seq::reset16(const utf16_t* s, size_t numU16s, size_t numChars)
         unsigned int minCap = static_cast<unsigned int>(numChars)* Utf8::MaxSeqLength;
         oldCap = growBuf(minCap);
         p8 = seq_;
+        const bool swapped = false;
         size_t i = 0;
         for (Utf8 c; i < numChars; ++i, p8 += c.encode(p8))
         {
-            if ((*p16 >= Utf16::HiHalfMin) && (*p16 <= Utf16::LoHalfMax))
+            size_t n = encodeBmp(p8, p16, numChars - i, swapped); //at least one short per character
+            p16 += n;
+            if ((i += n) == numChars)
             {
-                utf32_t value = Utf16::convertSurrogate(p16);
-                c.resetWithValidChar(value);
-                p16 += 2;
-            }
-            else
-            {
-                c.resetWithValidChar(*p16++);
+                break;
             }
+            utf32_t value = Utf16::convertSurrogate(p16);
+            c.resetWithValidChar(value);
+            p16 += 2;
         }
     }
 
@@ -1252,19 +1673,19 @@ void Utf8Seq::reset16(const utf16_t* s, size_t numU16s, size_t numChars)
         oldCap = growBuf(minCap);
         p8 = seq_;
         numChars = 0;
+        const bool swapped = false;
         const utf16_t* p16End = p16 + numU16s;
         for (Utf8 c; p16 < p16End; ++numChars, p8 += c.encode(p8))
         {
-            if ((*p16 >= Utf16::HiHalfMin) && (*p16 <= Utf16::LoHalfMax))
-            {
-                utf32_t value = Utf16::convertSurrogate(p16);
-                c.resetWithValidChar(value);
-                p16 += 2;
-            }
-            else
+            size_t n = encodeBmp(p8, p16, p16End - p16, swapped);
+            numChars += n;
+            if ((p16 += n) == p16End)
             {
-                c.resetWithValidChar(*p16++);
+                break;
             }
+            utf32_t value = Utf16::convertSurrogate(p16);
+            c.resetWithValidChar(value);
+            p16 += 2;
         }
     }
 
@@ -1274,6 +1695,20 @@ void Utf8Seq::reset16(const utf16_t* s, size_t numU16s, size_t numChars)
 }
 
 
+// Make this sequence empty after its guts have been taken. A nullified
+// instance gets a minimal buffer of its own so it can be reused.
+void Utf8Seq::renewSeq()
+{
+    if (seq_ == 0)
+    {
+        setCapacity(0);
+        seq_ = new utf8_t[Utf8Seq::capacity()];
+        ownsSeq_ = true;
+    }
+    reset();
+}
+
+
 //!
 //! Shrink given array into this sequence. Given array holds numChars
 //! characters suitable for this sequence. Behavior is unpredictable
@@ -1321,6 +1756,27 @@ void Utf8Seq::shrinkBuf(unsigned int oldCap)
 }
 
 
+// Take over the buffer of given sequence and nullify it. A borrowed buffer
+// is copied instead. Sizes and capacity have already been copied.
+void Utf8Seq::takeSeq(Utf8Seq& seq)
+{
+    ownsSeq_ = true;
+    if (seq.ownsSeq_)
+    {
+        seq_ = seq.seq_;
+        seq.seq_ = 0;
+        index_ = seq.index_;
+        seq.index_ = 0;
+    }
+    else
+    {
+        index_ = 0;
+        seq_ = new utf8_t[Utf8Seq::capacity()];
+        memcpy(seq_, seq.seq_, byteSize_);
+    }
+}
+
+
 //!
 //! Construct an unattached Utf8Seq iterator.
 //!
@@ -23,7 +23,10 @@ class Utf8Seq: public UtfSeq
     //! of characters are ASCII. This class can help reduce memory usage and
     //! can also help ease interoperability. Use convertX() to convert
     //! from other UTF forms. This class uses the UTF8 definition as described
-    //! in the Utf8 class. Example:
+    //! in the Utf8 class. Access by character index in a long sequence with
+    //! multi-byte characters is helped by a sparse index of byte offsets. The
+    //! index is built on first use, and is discarded when the sequence changes.
+    //! Example:
     //!\code
     //! Utf8Seq seq;
     //! utf16_t raw[3] = {0xaaaaU, 0xbbbbU, 0xccccU};
@@ -53,6 +56,9 @@ public:
     Utf8Seq(const char* s, size_t length, unsigned int capacity = DefaultCap);
     Utf8Seq(unsigned int capacity = DefaultCap);
     Utf8Seq(utf8_t* s, size_t numU8s, size_t numChars);
+#if HAS_RVALUE_REFS
+    Utf8Seq(Utf8Seq&& seq);
+#endif
 
     // Operators.
     bool operator !=(const Utf8Seq& seq) const;
@@ -65,6 +71,9 @@ public:
     const Utf8Seq& operator +=(const Utf8Seq& seq);
     const Utf8Seq& operator +=(char c);
     const Utf8Seq& operator =(const Utf8Seq& seq);
+#if HAS_RVALUE_REFS
+    const Utf8Seq& operator =(Utf8Seq&& seq);
+#endif
 
     // Raw access.
     bool isAscii() const;
@@ -171,6 +180,8 @@ public:
     };
 
 protected:
+    Utf8Seq(utf8_t* buf, unsigned int capacity);
+
     const utf8_t* seek(size_t index) const;
     void addNull();
     void addNullIfNone();
@@ -178,12 +189,32 @@ protected:
     void rmNull();
 
 private:
+    enum
+    {
+        IndexStep = 64, //number of characters between index entries
+        MinIndexedChars = 256
+    };
+
+    bool ownsSeq_;
+    mutable unsigned int* index_;
     utf8_t* seq_;
 
+    const unsigned int* buildIndex() const;
     void appendAscii8(const unsigned char*, size_t);
+    void dropIndex();
+    void extendIndex();
+    void fitIndex();
+    void indexTail(unsigned int*, unsigned int) const;
     void reset16(const utf16_t*, size_t);
+    void renewSeq();
     void reset16(const utf16_t*, size_t, size_t);
     void shrinkBuf(unsigned int);
+    void takeSeq(Utf8Seq&);
+
+    static const utf8_t* scan(const utf8_t*, size_t, size_t&);
+    static size_t encodeBmp(utf8_t*&, const utf16_t*, size_t, bool);
+    static size_t skipAscii(const utf8_t*, size_t);
+    static unsigned int indexCap(unsigned int);
 
 };
 
@@ -303,9 +334,40 @@ inline utf8_t* Utf8Seq::detachRaw(unsigned int& byteSize)
     return detachRaw();
 }
 
+//! Discard the character index. Required when the sequence is overwritten.
+inline void Utf8Seq::dropIndex()
+{
+    if (index_ != 0)
+    {
+        delete[] index_;
+        index_ = 0;
+    }
+}
+
+//! Keep the character index consistent with the sequence after some characters
+//! have been appended or removed at the end. Index entries beyond the end are
+//! dropped, and entries for appended characters are added, so the index always
+//! covers the whole sequence.
+inline void Utf8Seq::fitIndex()
+{
+    if (index_ != 0)
+    {
+        unsigned int numEntries = numChars_ / IndexStep;
+        if (index_[0] > numEntries)
+        {
+            index_[0] = numEntries;
+        }
+        else if (index_[0] < numEntries)
+        {
+            extendIndex();
+        }
+    }
+}
+
 //! Reset instance by making it an empty sequence.
 inline void Utf8Seq::reset()
 {
+    dropIndex();
     numChars_ = 0;
     byteSize_ = 0;
 }
@@ -323,6 +385,7 @@ inline void Utf8Seq::reset(const utf16_t* s, size_t numU16s, size_t numChars)
 //! Assuming sufficient capacity, reset instance with a terminating null.
 inline void Utf8Seq::resetWithNull()
 {
+    dropIndex();
     seq_[0] = 0;
     numChars_ = 1;
     byteSize_ = 1;
@@ -333,11 +396,13 @@ inline void Utf8Seq::rmNull()
 {
     --numChars_;
     --byteSize_;
+    fitIndex();
 }
 
 //! Treat sequence as raw bytes and update the given byte. Don't do any error checking.
 inline void Utf8Seq::setU8(size_t index, unsigned char u8)
 {
+    dropIndex();
     seq_[index] = u8;
 }
 
@@ -6,11 +6,36 @@
 
 #include "syskit-pch.h"
 #include "syskit/Heap.hpp"
+#include "syskit/ThreadPool.hpp"
 #include "syskit/Vec.hpp"
 #include "syskit/macros.h"
 
 const unsigned int INVALID_CAP = 0xffffffffU;
 
+BEGIN_NAMESPACE
+
+typedef struct
+{
+    syskit::Vec::cb2_t cb;
+    void* arg;
+    syskit::ThreadPool::Reduction* reduction;
+    syskit::Vec::item_t const* item;
+} applyArg_t;
+
+// Apply callback to items in the [loIndex, hiIndex) range using one partial result.
+void applyRange(void* arg, size_t loIndex, size_t hiIndex)
+{
+    const applyArg_t* p = static_cast<const applyArg_t*>(arg);
+    void* partial = p->reduction->open();
+    for (size_t i = loIndex; i < hiIndex; ++i)
+    {
+        p->cb(p->arg, partial, p->item[i]);
+    }
+    p->reduction->close(partial);
+}
+
+END_NAMESPACE
+
 BEGIN_NAMESPACE1(syskit)
 
 
@@ -25,13 +50,31 @@ Growable(*that)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Construct instance using guts from that. That is, move vector contents from
+//! that into this. That instance is left empty and can be reused.
+//!
+Vec::Vec(Vec&& that):
+Growable(that)
+{
+    item_ = that.item_;
+    adoptItems(that);
+    numItems_ = that.numItems_;
+    that.setCapacity(0);
+    that.item_ = that.allocateItems<item_t>(that.capacity());
+    that.numItems_ = 0;
+}
+#endif
+
+
 //!
 //! Construct a duplicate instance of the given vector.
 //!
 Vec::Vec(const Vec& vec):
 Growable(vec)
 {
-    item_ = new item_t[capacity()];
+    item_ = allocateItems<item_t>(capacity());
     numItems_ = vec.numItems_;
 
     // Copy the utilized items only. Don't care about the
@@ -46,7 +89,7 @@ Growable(vec)
 Vec::Vec(const Vec& vec, size_t startAt, size_t itemCount):
 Growable(vec)
 {
-    item_ = new item_t[capacity()];
+    item_ = allocateItems<item_t>(capacity());
     numItems_ = static_cast<unsigned int>(itemCount);
 
     // Copy the utilized items only. Don't care about the
@@ -65,14 +108,31 @@ Growable(capacity, growBy)
 {
 
     // Allocate all items. Initialize each item when used.
-    item_ = new item_t[Vec::capacity()];
+    item_ = allocateItems<item_t>(Vec::capacity());
+    numItems_ = 0;
+}
+
+
+//!
+//! Construct an empty vector with initial capacity of capacity items. The
+//! initial item array is carved out of given region, so the region must
+//! outlive the vector. The vector does not grow if growBy is zero,
+//! exponentially grows by doubling if growBy is negative, and grows by
+//! growBy items otherwise. A grown vector uses the heap.
+//!
+Vec::Vec(unsigned int capacity, int growBy, Region& region):
+Growable(capacity, growBy)
+{
+
+    // Allocate all items. Initialize each item when used.
+    item_ = allocateItems<item_t>(Vec::capacity(), region);
     numItems_ = 0;
 }
 
 
 Vec::~Vec()
 {
-    delete[] item_;
+    freeItems(item_);
 }
 
 
@@ -86,9 +146,14 @@ const Vec& Vec::operator =(Vec* that)
     // No-op if operating against the same tree.
     if (this != that)
     {
-        delete[] item_;
+        freeItems(item_);
         Growable::operator =(*that);
-        item_ = that->detachRaw(numItems_);
+        item_ = that->item_;
+        adoptItems(*that);
+        numItems_ = that->numItems_;
+        that->item_ = 0;
+        that->numItems_ = 0;
+        that->setCapacity(INVALID_CAP);
     }
 
     // Return reference to self.
@@ -118,8 +183,8 @@ const Vec& Vec::operator =(const Vec& vec)
     {
         if (canGrow())
         {
-            delete[] item_;
-            item_ = new item_t[setNextCap(minCap)];
+            freeItems(item_);
+            item_ = allocateItems<item_t>(setNextCap(minCap));
         }
         else
         {
@@ -136,6 +201,33 @@ const Vec& Vec::operator =(const Vec& vec)
 }
 
 
+#if HAS_RVALUE_REFS
+//!
+//! Reset and move the vector contents including guts from that into this. That
+//! instance is left empty and can be reused.
+//!
+const Vec& Vec::operator =(Vec&& that)
+{
+
+    // No-op if operating against the same vector.
+    if (this != &that)
+    {
+        freeItems(item_);
+        Growable::operator =(that);
+        item_ = that.item_;
+        adoptItems(that);
+        numItems_ = that.numItems_;
+        that.setCapacity(0);
+        that.item_ = that.allocateItems<item_t>(that.capacity());
+        that.numItems_ = 0;
+    }
+
+    // Return reference to self.
+    return *this;
+}
+#endif
+
+
 //!
 //! Find and return the kth smallest item. Given items can be arbitrarily rearranged.
 //! Behavior is unpredictable if k is not less than the number of items. Use given
@@ -175,7 +267,7 @@ Vec::item_t Vec::findKthSmallest(item_t* item, size_t itemCount, size_t k, compa
 //!
 Vec::item_t* Vec::detachRaw()
 {
-    item_t* raw = item_;
+    item_t* raw = detachItems(item_, capacity(), numItems_);
     item_ = 0;
     numItems_ = 0;
     setCapacity(INVALID_CAP);
@@ -341,10 +433,7 @@ bool Vec::resize(unsigned int newCap)
         ok = true;
         if (newCap != capacity())
         {
-            item_t* item = new item_t[newCap];
-            memcpy(item, item_, numItems_ * sizeof(*item_));
-            delete[] item_;
-            item_ = item;
+            item_ = resizeItems(item_, newCap, numItems_);
             setCapacity(newCap);
         }
     }
@@ -611,6 +700,24 @@ unsigned int Vec::add(void* const* raw, size_t itemCount)
 }
 
 
+//!
+//! Apply callback to each item in parallel using given thread pool (the process-wide
+//! pool if zero). The vector is partitioned into index ranges. For each range, a
+//! partial result is obtained as open(arg), the callback is invoked for each item as
+//! cb(arg, partial, item), and the partial result is handed back as close(arg, partial).
+//! The close hook is serialized and can merge the partial result into a total. Either
+//! hook can be zero. The callback can be concurrently invoked and must be thread-safe
+//! with respect to arg. Return when all items have been visited.
+//!
+void Vec::applyParallel(cb2_t cb, void* arg, open_t open, close_t close, ThreadPool* pool) const
+{
+    ThreadPool& threadPool = (pool != 0)? *pool: ThreadPool::instance();
+    ThreadPool::Reduction reduction(open, close, arg);
+    applyArg_t applyArg = {cb, arg, &reduction, item_};
+    threadPool.apply(numItems_, applyRange, &applyArg);
+}
+
+
 //!
 //! Sort vector and save results in sorted. Use given comparison function.
 //!
@@ -10,6 +10,9 @@
 
 BEGIN_NAMESPACE1(syskit)
 
+class Region;
+class ThreadPool;
+
 
 #if _WIN32
 #pragma pack(push,4)
@@ -61,24 +64,36 @@ public:
         size_t numItems;
     } searchArg_t;
     typedef void* item_t;
+    typedef void(*cb2_t)(void* arg, void* partial, item_t item);
+    typedef void(*close_t)(void* arg, void* partial);
+    typedef void* (*open_t)(void* arg);
 
     // Constructors.
     Vec(Vec* that);
     Vec(const Vec& vec);
     Vec(const Vec& vec, size_t startAt, size_t itemCount);
+    Vec(unsigned int capacity, int growBy, Region& region);
     Vec(unsigned int capacity = DefaultCap, int growBy = 0);
+#if HAS_RVALUE_REFS
+    Vec(Vec&& that);
+#endif
 
     // Operators.
     bool operator !=(const Vec& vec) const;
     bool operator ==(const Vec& vec) const;
     const Vec& operator =(Vec* that);
     const Vec& operator =(const Vec& vec);
+#if HAS_RVALUE_REFS
+    const Vec& operator =(Vec&& that);
+#endif
     item_t operator [](size_t index) const;
     item_t& operator [](size_t index);
     static void operator delete(void* p, size_t size);
     static void operator delete(void* p, void* buf);
+    static void operator delete(void* p, Region& region);
     static void* operator new(size_t size);
     static void* operator new(size_t size, void* buf);
+    static void* operator new(size_t size, Region& region);
 
     // Vector operations.
     bool add(item_t item);
@@ -116,6 +131,9 @@ public:
     unsigned int numItems() const;
     void* const* raw() const;
 
+    // Iterator support.
+    void applyParallel(cb2_t cb, void* arg = 0, open_t open = 0, close_t close = 0, ThreadPool* pool = 0) const;
+
     // Sort and search.
     bool equals(const Vec& vec, diff_t diff) const;
     bool search(const void* item, compare_t compare) const;
@@ -145,6 +163,7 @@ private:
 END_NAMESPACE1
 
 #include "syskit/BufPool.hpp"
+#include "syskit/Region.hpp"
 
 BEGIN_NAMESPACE1(syskit)
 
@@ -188,6 +207,10 @@ inline void Vec::operator delete(void* /*p*/, void* /*buf*/)
 {
 }
 
+inline void Vec::operator delete(void* /*p*/, Region& /*region*/)
+{
+}
+
 inline void* Vec::operator new(size_t size)
 {
     void* buf = BufPool::allocateBuf(size);
@@ -199,6 +222,15 @@ inline void* Vec::operator new(size_t /*size*/, void* buf)
     return buf;
 }
 
+//! Allocate from given region. A region-allocated vector must be destructed
+//! explicitly (i.e., vec->~Vec()) and not via the delete operator. Its memory
+//! is reclaimed when the region is reset or destructed.
+inline void* Vec::operator new(size_t size, Region& region)
+{
+    void* buf = region.allocate(size);
+    return buf;
+}
+
 //! Peek at given index and return the residing item. Don't do any error
 //! checking. Behavior is unpredictable if given index is invalid.
 inline Vec::item_t Vec::peek(size_t index) const
@@ -0,0 +1,65 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <dlfcn.h>
+#include <execinfo.h>
+#include "syskit/BufProfile.hpp"
+#include "syskit/sys.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Capture the current call stack, excluding this method. Save at most
+//! maxFrames return addresses in eip[]. Return the number of saved frames.
+//!
+unsigned int BufProfile::captureStack(const void* eip[], unsigned int maxFrames)
+{
+    void* frame[MaxFrames + 8];
+    int n = maxFrames + 1;
+    if (n > static_cast<int>(sizeof(frame) / sizeof(frame[0])))
+    {
+        n = sizeof(frame) / sizeof(frame[0]);
+    }
+
+    n = backtrace(frame, n);
+    unsigned int numFrames = (n > 1)? (n - 1): 0;
+    for (unsigned int i = 0; i < numFrames; ++i)
+    {
+        eip[i] = frame[i + 1];
+    }
+
+    return numFrames;
+}
+
+
+//!
+//! Describe given return address as "symbol+offset (module)" if possible.
+//! Use the raw address otherwise. Save the description in desc[].
+//!
+void BufProfile::describeFrame(const void* eip, char* desc, size_t descSize)
+{
+    Dl_info info;
+    if ((dladdr(eip, &info) != 0) && (info.dli_fname != 0))
+    {
+        const char* module = strrchr(info.dli_fname, '/');
+        module = (module == 0)? info.dli_fname: module + 1;
+        if (info.dli_sname != 0)
+        {
+            size_t off = static_cast<const char*>(eip) - static_cast<const char*>(info.dli_saddr);
+            snprintf(desc, descSize, "%s+0x%zx (%s)", info.dli_sname, off, module);
+        }
+        else
+        {
+            size_t off = static_cast<const char*>(eip) - static_cast<const char*>(info.dli_fbase);
+            snprintf(desc, descSize, "%p (%s+0x%zx)", eip, module, off);
+        }
+    }
+    else
+    {
+        snprintf(desc, descSize, "%p", eip);
+    }
+}
+
+END_NAMESPACE1
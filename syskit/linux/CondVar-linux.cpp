@@ -2,11 +2,14 @@
  * Software by Thanh Phung -- thanhtphung@yahoo.com.
  * No copyrights. No warranties. No restrictions in reuse.
  */
+#include <errno.h>
 #include <time.h>
+#include "syskit/BitVec.hpp"
+#include "syskit/Process.hpp"
 #include "syskit/linux/CondVar-linux.hpp"
 #include "syskit/macros.h"
 
-const int NSECS_PER_SEC = 1000000000;
+const int MAX_SPIN_COUNT = 1000;
 const unsigned int MSECS_PER_SEC = 1000U;
 const unsigned int NSECS_PER_MSEC = 1000000U;
 
@@ -16,10 +19,12 @@ BEGIN_NAMESPACE1(syskit)
 //!
 //! Construct a condition variable and its associated mutex.
 //!
-CondVar::CondVar():
-cv_(PTHREAD_COND_INITIALIZER),
-mu_(PTHREAD_MUTEX_INITIALIZER)
+CondVar::CondVar()
 {
+    spinLimit_ = 0;
+    mu_ = Unlocked;
+    seq_ = 0;
+    numWaiters_ = 0;
 }
 
 
@@ -28,8 +33,77 @@ mu_(PTHREAD_MUTEX_INITIALIZER)
 //!
 CondVar::~CondVar()
 {
-    pthread_mutex_destroy(&mu_);
-    pthread_cond_destroy(&cv_);
+}
+
+
+//
+// Briefly spin while waiting for the associated mutex to be unlocked. The
+// spin limit tracks the number of spins recently needed and shrinks when
+// spinning fails. Don't bother spinning if there are waiters. Return true
+// if the mutex was locked.
+//
+bool CondVar::spinToLock()
+{
+    static bool s_allowSpin = (BitVec::countSetBits(Process::affinityMask()) > 1);
+    if ((!s_allowSpin) || (mu_ == LockedWithWaiters))
+    {
+        return false;
+    }
+
+    int spinLimit = spinLimit_;
+    int maxSpins = spinLimit * 2 + 10;
+    if (maxSpins > MAX_SPIN_COUNT)
+    {
+        maxSpins = MAX_SPIN_COUNT;
+    }
+
+    for (int i = 0; i < maxSpins; ++i)
+    {
+        cpuRelax();
+        if ((mu_ == Unlocked) && tryLockMutex())
+        {
+            spinLimit_ = spinLimit + (i - spinLimit) / 8;
+            return true;
+        }
+    }
+
+    spinLimit_ = spinLimit - spinLimit / 8;
+    return false;
+}
+
+
+//
+// Lock the associated mutex after a failed attempt. Spin then park.
+//
+void CondVar::lockSlow()
+{
+    if (!spinToLock())
+    {
+        relock();
+    }
+}
+
+
+//
+// Lock the associated mutex without spinning. Mark it as having
+// waiters since there's no way to tell if others are parked.
+//
+void CondVar::relock()
+{
+    while (__atomic_exchange_n(&mu_, LockedWithWaiters, __ATOMIC_ACQUIRE) != Unlocked)
+    {
+        futexWait(&mu_, LockedWithWaiters, 0);
+    }
+}
+
+
+//
+// Wake up at most numWaiters waiters. The associated mutex is locked.
+//
+void CondVar::wake(int numWaiters)
+{
+    __atomic_add_fetch(&seq_, 1, __ATOMIC_SEQ_CST);
+    futexWake(&seq_, numWaiters);
 }
 
 
@@ -43,28 +117,32 @@ CondVar::~CondVar()
 //!
 bool CondVar::wait(unsigned int timeoutInMsecs)
 {
+
+    // Note the sequence number while holding the associated mutex. A signal
+    // or broadcast after unlocking changes it, and the futex wait then fails
+    // immediately instead of missing the wake-up.
+    ++numWaiters_;
+    unsigned int seq = seq_;
+    unlockMutex();
+
     int rc;
     if (timeoutInMsecs == ETERNITY)
     {
-        rc = pthread_cond_wait(&cv_, &mu_);
+        rc = futexWait(&seq_, seq, 0);
     }
 
     else
     {
-        struct timespec now;
-        clock_gettime(CLOCK_REALTIME, &now);
-        struct timespec then;
-        then.tv_sec = now.tv_sec + (timeoutInMsecs / MSECS_PER_SEC);
-        then.tv_nsec = now.tv_nsec + ((timeoutInMsecs%MSECS_PER_SEC) * NSECS_PER_MSEC);
-        if (then.tv_nsec >= NSECS_PER_SEC)
-        {
-            ++then.tv_sec;
-            then.tv_nsec -= NSECS_PER_SEC;
-        }
-        rc = pthread_cond_timedwait(&cv_, &mu_, &then);
+        struct timespec timeout;
+        timeout.tv_sec = timeoutInMsecs / MSECS_PER_SEC;
+        timeout.tv_nsec = (timeoutInMsecs % MSECS_PER_SEC) * NSECS_PER_MSEC;
+        rc = futexWait(&seq_, seq, &timeout);
     }
 
-    return (rc == 0);
+    bool timedOut = (rc != 0) && (errno == ETIMEDOUT);
+    relock();
+    --numWaiters_;
+    return (!timedOut);
 }
 
 END_NAMESPACE1
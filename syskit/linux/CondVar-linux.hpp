@@ -5,8 +5,7 @@
 #ifndef SYSKIT_COND_VAR_LINUX_HPP
 #define SYSKIT_COND_VAR_LINUX_HPP
 
-#include <pthread.h>
-#include "syskit/macros.h"
+#include "syskit/sys.hpp"
 
 BEGIN_NAMESPACE1(syskit)
 
@@ -46,6 +45,9 @@ class CondVar
     //! s_condVar.signal();
     //! s_condVar.unlockMutex();
     //!\endcode
+    //! On Linux, both the mutex and the condition variable are implemented
+    //! directly on futexes. Lockers briefly spin before parking, and the spin
+    //! adapts to recent mutex hold times.
     //!
 {
 
@@ -111,12 +113,26 @@ public:
     };
 
 private:
-    pthread_cond_t cv_;
-    pthread_mutex_t mu_;
+    enum
+    {
+        Unlocked = 0,
+        LockedWithNoWaiters = 1,
+        LockedWithWaiters = 2
+    };
+
+    int spinLimit_;
+    unsigned int volatile mu_;
+    unsigned int volatile seq_;
+    unsigned int numWaiters_;
 
     CondVar(const CondVar&); //prohibit usage
     const CondVar& operator=(const CondVar&); //prohibit usage
 
+    bool spinToLock();
+    void lockSlow();
+    void relock();
+    void wake(int);
+
 };
 
 //! Broadcast the condition. That is, no-op if there are no waiters, or
@@ -125,7 +141,12 @@ private:
 //! Behavior is unpredictable otherwise.
 inline bool CondVar::broadcast()
 {
-    return pthread_cond_broadcast(&cv_) == 0;
+    if (numWaiters_ > 0)
+    {
+        wake(0x7fffffff);
+    }
+
+    return true;
 }
 
 //! Return true if instance was successfully constructed.
@@ -138,7 +159,12 @@ inline bool CondVar::isOk() const
 //! Return true if successful.
 inline bool CondVar::lockMutex()
 {
-    return pthread_mutex_lock(&mu_) == 0;
+    if (!tryLockMutex())
+    {
+        lockSlow();
+    }
+
+    return true;
 }
 
 //! Signal the condition. That is, no-op if there are no waiters, or
@@ -147,14 +173,20 @@ inline bool CondVar::lockMutex()
 //! Behavior is unpredictable otherwise.
 inline bool CondVar::signal()
 {
-    return pthread_cond_signal(&cv_) == 0;
+    if (numWaiters_ > 0)
+    {
+        wake(1);
+    }
+
+    return true;
 }
 
 //! Lock associated mutex. Do not wait.
 //! Return true if successful.
 inline bool CondVar::tryLockMutex()
 {
-    return pthread_mutex_trylock(&mu_) == 0;
+    unsigned int unlocked = Unlocked;
+    return __atomic_compare_exchange_n(&mu_, &unlocked, LockedWithNoWaiters, false /*weak*/, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
 }
 
 //! Unlock associated mutex.
@@ -162,7 +194,12 @@ inline bool CondVar::tryLockMutex()
 //! Unlocking an unlocked mutex is allowed and is considered successful.
 inline bool CondVar::unlockMutex()
 {
-    return pthread_mutex_unlock(&mu_) == 0;
+    if (__atomic_exchange_n(&mu_, Unlocked, __ATOMIC_RELEASE) == LockedWithWaiters)
+    {
+        futexWake(&mu_, 1);
+    }
+
+    return true;
 }
 
 //! Atomically unlock associated mutex and wait until the condition
@@ -173,7 +210,7 @@ inline bool CondVar::unlockMutex()
 //! implementations, do not assume this wait can be interrupted.
 inline bool CondVar::wait()
 {
-    return pthread_cond_wait(&cv_, &mu_) == 0;
+    return wait(ETERNITY);
 }
 
 //! Return true if instance was successfully constructed.
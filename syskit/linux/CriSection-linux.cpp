@@ -4,6 +4,8 @@
  */
 #include <pthread.h>
 #include "syskit/CriSection.hpp"
+#include "syskit/LockStat.hpp"
+#include "syskit/TickTime.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -12,6 +14,17 @@ BEGIN_NAMESPACE1(syskit)
 CriSection::CriSection()
 {
     cs_ = new pthread_mutex_t(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP);
+    stat_ = 0;
+}
+
+
+//!
+//! Construct a critical section. The spin count is not used.
+//!
+CriSection::CriSection(unsigned int /*spinCount*/)
+{
+    cs_ = new pthread_mutex_t(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP);
+    stat_ = 0;
 }
 
 
@@ -19,6 +32,7 @@ CriSection::~CriSection()
 {
     pthread_mutex_destroy(cs_);
     delete cs_;
+    delete stat_;
 }
 
 
@@ -28,7 +42,13 @@ CriSection::~CriSection()
 //!
 bool CriSection::tryLock()
 {
-    return pthread_mutex_trylock(cs_) == 0;
+    bool ok = (pthread_mutex_trylock(cs_) == 0);
+    if (ok && (stat_ != 0))
+    {
+        stat_->onLock(0 /*waitStart*/, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -37,7 +57,20 @@ bool CriSection::tryLock()
 //!
 void CriSection::lock()
 {
-    pthread_mutex_lock(cs_);
+    if (stat_ == 0)
+    {
+        pthread_mutex_lock(cs_);
+        return;
+    }
+
+    // Profiled. Note when the wait starts if contended.
+    unsigned long long waitStart = 0;
+    if (pthread_mutex_trylock(cs_) != 0)
+    {
+        waitStart = TickTime::curTime();
+        pthread_mutex_lock(cs_);
+    }
+    stat_->onLock(waitStart, 0 /*numSpins*/);
 }
 
 
@@ -46,6 +79,11 @@ void CriSection::lock()
 //!
 void CriSection::unlock()
 {
+    if (stat_ != 0)
+    {
+        stat_->onUnlock();
+    }
+
     pthread_mutex_unlock(cs_);
 }
 
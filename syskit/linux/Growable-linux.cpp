@@ -0,0 +1,98 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include <sys/mman.h>
+#include <unistd.h>
+#include "syskit/Growable.hpp"
+#include "syskit/sys.hpp"
+
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+BEGIN_NAMESPACE
+
+// Round given size up to the mapping granularity.
+size_t roundUp(size_t byteSize, bool useHugePages)
+{
+    static const size_t s_pageSize = sysconf(_SC_PAGESIZE);
+    size_t unit = useHugePages? HUGE_PAGE_SIZE: s_pageSize;
+    return (byteSize + unit - 1) / unit * unit;
+}
+
+END_NAMESPACE
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Return true if big arrays are supported on this platform.
+//!
+bool Growable::canMap()
+{
+    return true;
+}
+
+
+//!
+//! Unmap given big array of given mapped size.
+//!
+void Growable::unmapArray(void* addr, size_t mappedSize)
+{
+    munmap(addr, mappedSize);
+}
+
+
+//!
+//! Map and return a private anonymous region of at least byteSize bytes.
+//! Advise the kernel to back the region with transparent huge pages if
+//! useHugePages is true. Return zero if unsuccessful. Otherwise, also return
+//! the mapped size in byteSize.
+//!
+void* Growable::mapArray(size_t& byteSize, bool useHugePages)
+{
+    size_t size = roundUp(byteSize, useHugePages);
+    void* addr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    byteSize = size;
+#if defined(MADV_HUGEPAGE)
+    if (useHugePages)
+    {
+        madvise(addr, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return addr;
+}
+
+
+//!
+//! Resize given big array of oldSize mapped bytes to at least newByteSize bytes.
+//! The kernel grows the mapping in place if possible and moves the pages without
+//! copying otherwise. Return the resulting address. Return zero if unsuccessful.
+//! Otherwise, also return the mapped size in newByteSize.
+//!
+void* Growable::remapArray(void* addr, size_t oldSize, size_t& newByteSize, bool useHugePages)
+{
+    size_t newSize = roundUp(newByteSize, useHugePages);
+    void* newAddr = (oldSize == newSize)? addr: mremap(addr, oldSize, newSize, MREMAP_MAYMOVE);
+    if (newAddr == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    newByteSize = newSize;
+#if defined(MADV_HUGEPAGE)
+    if (useHugePages && (newSize > oldSize))
+    {
+        madvise(newAddr, newSize, MADV_HUGEPAGE);
+    }
+#endif
+
+    return newAddr;
+}
+
+END_NAMESPACE1
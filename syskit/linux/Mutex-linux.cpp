@@ -3,7 +3,9 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include <pthread.h>
+#include "syskit/LockStat.hpp"
 #include "syskit/Mutex.hpp"
+#include "syskit/TickTime.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -12,12 +14,14 @@ BEGIN_NAMESPACE1(syskit)
 Mutex::Mutex():
 mu_(PTHREAD_MUTEX_INITIALIZER)
 {
+    stat_ = 0;
 }
 
 
 Mutex::~Mutex()
 {
     pthread_mutex_destroy(&mu_);
+    delete stat_;
 }
 
 
@@ -35,7 +39,25 @@ bool Mutex::isOk() const
 //!
 bool Mutex::lock()
 {
-    return pthread_mutex_lock(&mu_) == 0;
+    if (stat_ == 0)
+    {
+        return pthread_mutex_lock(&mu_) == 0;
+    }
+
+    // Profiled. Note when the wait starts if contended.
+    unsigned long long waitStart = 0;
+    bool ok = (pthread_mutex_trylock(&mu_) == 0);
+    if (!ok)
+    {
+        waitStart = TickTime::curTime();
+        ok = (pthread_mutex_lock(&mu_) == 0);
+    }
+    if (ok)
+    {
+        stat_->onLock(waitStart, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -44,7 +66,13 @@ bool Mutex::lock()
 //!
 bool Mutex::tryLock()
 {
-    return pthread_mutex_trylock(&mu_) == 0;
+    bool ok = (pthread_mutex_trylock(&mu_) == 0);
+    if (ok && (stat_ != 0))
+    {
+        stat_->onLock(0 /*waitStart*/, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -54,6 +82,11 @@ bool Mutex::tryLock()
 //!
 bool Mutex::unlock()
 {
+    if (stat_ != 0)
+    {
+        stat_->onUnlock();
+    }
+
     return pthread_mutex_unlock(&mu_) == 0;
 }
 
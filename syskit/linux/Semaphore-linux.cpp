@@ -3,37 +3,213 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include <errno.h>
-#include <sys/types.h>
-#include <sys/ipc.h>
-#include <sys/sem.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include "syskit/BitVec.hpp"
+#include "syskit/Process.hpp"
 #include "syskit/Semaphore.hpp"
-#include "syskit/TickTime.hpp"
 #include "syskit/sys.hpp"
 
-const int INVALID_ID = -1;
+const long NSECS_PER_SEC = 1000000000L;
+const unsigned int MAX_SPIN_COUNT = 4000U;
 const unsigned int MSECS_PER_SEC = 1000U;
 const unsigned int NSECS_PER_MSEC = 1000000U;
 
+BEGIN_NAMESPACE1(syskit)
+
+// Futex-based semaphore state. The token count is also the futex word. States
+// are recycled but never freed, so a stale handle can always be detected using
+// the generation number which changes whenever a state is released.
+struct futexSem_s
+{
+    unsigned int volatile count;
+    unsigned int volatile numWaiters;
+    unsigned int volatile numMultiWaiters; //waiters wanting more than one token
+    unsigned int volatile gen;
+    int spinLimit; //adaptive, tracks the recent spins needed to acquire
+    futexSem_s* next;
+};
+
+END_NAMESPACE1
+
+using namespace syskit;
+
 BEGIN_NAMESPACE
-#if __CYGWIN__
 
-int semtimedop(int semid, struct sembuf *sops, size_t nsops, struct timespec* /*waitTime*/)
+pthread_mutex_t s_freeMu = PTHREAD_MUTEX_INITIALIZER;
+futexSem_s* s_freeList = 0;
+
+futexSem_s* allocateState(unsigned int count)
 {
-    return semop(semid, sops, nsops);
+    pthread_mutex_lock(&s_freeMu);
+    futexSem_s* futex = s_freeList;
+    if (futex != 0)
+    {
+        s_freeList = futex->next;
+    }
+    pthread_mutex_unlock(&s_freeMu);
+
+    if (futex == 0)
+    {
+        futex = new futexSem_s;
+        futex->gen = 0;
+    }
+
+    futex->count = count;
+    futex->numWaiters = 0;
+    futex->numMultiWaiters = 0;
+    futex->spinLimit = 0;
+    futex->next = 0;
+    __atomic_add_fetch(&futex->gen, 1, __ATOMIC_SEQ_CST);
+    return futex;
 }
 
-#endif
-END_NAMESPACE
+void freeState(futexSem_s* futex)
+{
+    __atomic_add_fetch(&futex->gen, 1, __ATOMIC_SEQ_CST);
+    if (futex->numWaiters > 0)
+    {
+        futexWake(&futex->count, INT_MAX);
+    }
 
-BEGIN_NAMESPACE1(syskit)
+    pthread_mutex_lock(&s_freeMu);
+    futex->next = s_freeList;
+    s_freeList = futex;
+    pthread_mutex_unlock(&s_freeMu);
+}
 
-union semun
+// Return true if given handle refers to a live semaphore.
+bool isValid(const sem_t& sem)
 {
-    int val;
-    struct semid_ds* buf;
-    unsigned short *array;
-    struct seminfo* __buf;
-};
+    return (sem.futex != 0) && (sem.futex->gen == sem.gen);
+}
+
+// Spinning is allowed only if the calling process is
+// initially bound to more than one processor.
+bool spinIsAllowed()
+{
+    static bool s_allowSpin = (BitVec::countSetBits(Process::affinityMask()) > 1);
+    return s_allowSpin;
+}
+
+// Acquire delta tokens. Do not wait. Return true if successful.
+bool takeTokens(futexSem_s* futex, unsigned int delta)
+{
+    unsigned int count = __atomic_load_n(&futex->count, __ATOMIC_RELAXED);
+    while (count >= delta)
+    {
+        if (__atomic_compare_exchange_n(&futex->count, &count, count - delta, true /*weak*/, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Briefly spin while waiting for delta tokens. The spin limit adapts to the
+// number of spins recently needed, so short-term holders are waited for
+// without parking and long-term holders do not waste cycles. Don't bother
+// spinning if there are waiters. Return true if tokens were acquired.
+bool spinForTokens(futexSem_s* futex, unsigned int delta)
+{
+    if ((futex->numWaiters > 0) || (!spinIsAllowed()))
+    {
+        return false;
+    }
+
+    int spinLimit = futex->spinLimit;
+    int maxSpins = spinLimit * 2 + 10;
+    if (maxSpins > static_cast<int>(MAX_SPIN_COUNT))
+    {
+        maxSpins = MAX_SPIN_COUNT;
+    }
+
+    for (int i = 0; i < maxSpins; ++i)
+    {
+        cpuRelax();
+        if ((futex->count >= delta) && takeTokens(futex, delta))
+        {
+            futex->spinLimit = spinLimit + (i - spinLimit) / 8;
+            return true;
+        }
+    }
+
+    futex->spinLimit = spinLimit - spinLimit / 8;
+    return false;
+}
+
+// Acquire delta tokens. Spin then park. Wait until given deadline
+// (CLOCK_MONOTONIC) if deadline is non-zero. Wait forever otherwise.
+// Return true if successful.
+bool waitForTokens(const sem_t& sem, unsigned int delta, const struct timespec* deadline)
+{
+    futexSem_s* futex = sem.futex;
+    if (takeTokens(futex, delta) || spinForTokens(futex, delta))
+    {
+        return true;
+    }
+
+    __atomic_add_fetch(&futex->numWaiters, 1, __ATOMIC_SEQ_CST);
+    if (delta > 1)
+    {
+        __atomic_add_fetch(&futex->numMultiWaiters, 1, __ATOMIC_SEQ_CST);
+    }
+
+    bool ok;
+    for (;;)
+    {
+        if (takeTokens(futex, delta))
+        {
+            ok = true;
+            break;
+        }
+        if (futex->gen != sem.gen)
+        {
+            ok = false;
+            break;
+        }
+
+        unsigned int count = __atomic_load_n(&futex->count, __ATOMIC_SEQ_CST);
+        if (count >= delta)
+        {
+            continue;
+        }
+
+        // Park until woken up or until the deadline.
+        struct timespec timeout;
+        if (deadline != 0)
+        {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            timeout.tv_sec = deadline->tv_sec - now.tv_sec;
+            timeout.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+            if (timeout.tv_nsec < 0)
+            {
+                --timeout.tv_sec;
+                timeout.tv_nsec += NSECS_PER_SEC;
+            }
+            if (timeout.tv_sec < 0)
+            {
+                ok = takeTokens(futex, delta);
+                break;
+            }
+        }
+        futexWait(&futex->count, count, (deadline != 0)? &timeout: 0);
+    }
+
+    if (delta > 1)
+    {
+        __atomic_sub_fetch(&futex->numMultiWaiters, 1, __ATOMIC_SEQ_CST);
+    }
+    __atomic_sub_fetch(&futex->numWaiters, 1, __ATOMIC_SEQ_CST);
+    return ok;
+}
+
+END_NAMESPACE
+
+BEGIN_NAMESPACE1(syskit)
 
 
 //!
@@ -45,30 +221,18 @@ union semun
 //!
 Semaphore::Semaphore(unsigned int capacity)
 {
-    sem_.index = 0;
+    sem_.futex = allocateState((capacity > MAX_CAP)? MAX_CAP: capacity);
+    sem_.gen = sem_.futex->gen;
     sem_.ok = 1;
     semIsMine_ = true;
-
-    sem_.id = semget(IPC_PRIVATE, 1, IPC_CREAT | IPC_EXCL | 0644);
-    if (sem_.id != INVALID_ID)
-    {
-        semun arg;
-        arg.val = (capacity > MAX_CAP)? MAX_CAP: capacity;
-        if (semctl(sem_.id, 0, SETVAL, arg) != 0)
-        {
-            semctl(sem_.id, sem_.index, IPC_RMID, 0 /*arg*/);
-            sem_.id = INVALID_ID;
-            sem_.ok = 0;
-        }
-    }
 }
 
 
 Semaphore::~Semaphore()
 {
-    if (semIsMine_ && (sem_.id != INVALID_ID))
+    if (semIsMine_ && isValid(sem_))
     {
-        semctl(sem_.id, sem_.index, IPC_RMID, 0 /*arg*/);
+        freeState(sem_.futex);
     }
 }
 
@@ -79,23 +243,7 @@ Semaphore::~Semaphore()
 //!
 bool Semaphore::decrementBy(unsigned int delta)
 {
-    bool ok;
-    if ((delta > 0) && (delta <= MAX_CAP))
-    {
-        struct sembuf sop;
-        sop.sem_num = sem_.index;
-        sop.sem_op = -delta;
-        sop.sem_flg = 0;
-        int rc;
-        while (((rc = semop(sem_.id, &sop, 1)) != 0) && (errno == EINTR));
-        ok = (rc == 0);
-    }
-
-    else
-    {
-        ok = false;
-    }
-
+    bool ok = (delta > 0) && (delta <= MAX_CAP) && isValid(sem_) && waitForTokens(sem_, delta, 0);
     return ok;
 }
 
@@ -108,53 +256,40 @@ bool Semaphore::decrementBy(unsigned int delta, unsigned int waitTimeInMsecs)
 {
 
     // Sanity check.
-    if ((delta == 0) || (delta > MAX_CAP))
+    if ((delta == 0) || (delta > MAX_CAP) || (!isValid(sem_)))
     {
         return false;
     }
 
     // Wait forever if necessary.
-    struct sembuf sop;
-    sop.sem_num = sem_.index;
-    sop.sem_op = -delta;
-    int rc;
+    bool ok;
     if (waitTimeInMsecs == ETERNITY)
     {
-        sop.sem_flg = 0;
-        while (((rc = semop(sem_.id, &sop, 1)) != 0) && (errno == EINTR));
+        ok = waitForTokens(sem_, delta, 0);
     }
 
     // Do not wait.
     else if (waitTimeInMsecs == 0)
     {
-        sop.sem_flg = IPC_NOWAIT;
-        rc = semop(sem_.id, &sop, 1);
+        ok = takeTokens(sem_.futex, delta);
     }
 
     // Wait at most waitTimeInMsecs msecs.
     else
     {
-        sop.sem_flg = 0;
-        struct timespec waitTime;
-        waitTime.tv_sec = waitTimeInMsecs / MSECS_PER_SEC;
-        waitTime.tv_nsec = (waitTimeInMsecs % MSECS_PER_SEC) * NSECS_PER_MSEC;
-        unsigned long long startTime = rdtsc();
-        while (((rc = semtimedop(sem_.id, &sop, 1, &waitTime)) != 0) && (errno == EINTR))
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += waitTimeInMsecs / MSECS_PER_SEC;
+        deadline.tv_nsec += (waitTimeInMsecs % MSECS_PER_SEC) * NSECS_PER_MSEC;
+        if (deadline.tv_nsec >= NSECS_PER_SEC)
         {
-            unsigned long long delta = rdtsc() - startTime;
-            unsigned int deltaInMsecs = static_cast<unsigned int>(delta * TickTime::msecsPerTick()); //close enough
-            if (deltaInMsecs >= waitTimeInMsecs)
-            {
-                break;
-            }
-            unsigned int remainingTimeInMsecs = waitTimeInMsecs - deltaInMsecs;
-            waitTime.tv_sec = remainingTimeInMsecs / MSECS_PER_SEC;
-            waitTime.tv_nsec = (remainingTimeInMsecs % MSECS_PER_SEC) * NSECS_PER_MSEC;
+            ++deadline.tv_sec;
+            deadline.tv_nsec -= NSECS_PER_SEC;
         }
+        ok = waitForTokens(sem_, delta, &deadline);
     }
 
     // Return true if successful.
-    bool ok = (rc == 0);
     return ok;
 }
 
@@ -165,16 +300,31 @@ bool Semaphore::decrementBy(unsigned int delta, unsigned int waitTimeInMsecs)
 //!
 bool Semaphore::incrementBy(unsigned int delta)
 {
+    if ((delta == 0) || (delta > MAX_CAP) || (!isValid(sem_)))
+    {
+        return false;
+    }
 
-    // Must use IPC_NOWAIT even though the operation should not block.
-    // Seems like a semop() bug. --ttp
-    struct sembuf sop;
-    sop.sem_num = sem_.index;
-    sop.sem_op = delta;
-    sop.sem_flg = IPC_NOWAIT;
+    // The token count must not exceed MAX_CAP.
+    futexSem_s* futex = sem_.futex;
+    unsigned int count = __atomic_load_n(&futex->count, __ATOMIC_RELAXED);
+    do
+    {
+        if (count + delta > MAX_CAP)
+        {
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&futex->count, &count, count + delta, true /*weak*/, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
 
-    bool ok = (semop(sem_.id, &sop, 1) == 0);
-    return ok;
+    // Wake up only as many waiters as there are new tokens unless some
+    // waiters want multiple tokens. Avoid the system call if no waiters.
+    if (__atomic_load_n(&futex->numWaiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        int numWaiters = (futex->numMultiWaiters > 0)? INT_MAX: static_cast<int>(delta);
+        futexWake(&futex->count, numWaiters);
+    }
+
+    return true;
 }
 
 
@@ -184,21 +334,7 @@ bool Semaphore::incrementBy(unsigned int delta)
 //!
 bool Semaphore::tryDecrementBy(unsigned int delta)
 {
-    bool ok;
-    if ((delta > 0) && (delta <= MAX_CAP))
-    {
-        struct sembuf sop;
-        sop.sem_num = sem_.index;
-        sop.sem_op = -delta;
-        sop.sem_flg = IPC_NOWAIT;
-        ok = (semop(sem_.id, &sop, 1) == 0);
-    }
-
-    else
-    {
-        ok = false;
-    }
-
+    bool ok = (delta > 0) && (delta <= MAX_CAP) && isValid(sem_) && takeTokens(sem_.futex, delta);
     return ok;
 }
 
@@ -210,8 +346,8 @@ bool Semaphore::tryDecrementBy(unsigned int delta)
 //!
 void Semaphore::detach()
 {
-    sem_.id = INVALID_ID;
-    sem_.index = 0;
+    sem_.futex = 0;
+    sem_.gen = 0;
     sem_.ok = 1;
     semIsMine_ = true;
 }
@@ -222,9 +358,15 @@ void Semaphore::detach()
 //!
 void Semaphore::reset(unsigned int count)
 {
-    semun arg;
-    arg.val = (count > MAX_CAP)? MAX_CAP: count;
-    semctl(sem_.id, sem_.index, SETVAL, arg);
+    if (isValid(sem_))
+    {
+        futexSem_s* futex = sem_.futex;
+        __atomic_store_n(&futex->count, (count > MAX_CAP)? MAX_CAP: count, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&futex->numWaiters, __ATOMIC_SEQ_CST) > 0)
+        {
+            futexWake(&futex->count, INT_MAX);
+        }
+    }
 }
 
 END_NAMESPACE1
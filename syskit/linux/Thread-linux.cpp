@@ -3,6 +3,7 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <time.h>
 #include "syskit/Thread.hpp"
@@ -14,6 +15,8 @@
 #define PTHREAD_ATTR0 {{0}}
 #endif
 
+const size_t MAX_CPUS = sizeof(void*) * 8; //32 for x86, 64 for x64, etc.
+
 BEGIN_NAMESPACE1(syskit)
 
 //
@@ -138,6 +141,61 @@ bool Thread::waitTilDone(void** exitCode)
 }
 
 
+//!
+//! Set the affinity mask for the thread.
+//! Return true if successful.
+//!
+bool Thread::setAffinityMask(size_t affinityMask)
+{
+#if __CYGWIN__
+    bool ok = (affinityMask != 0);
+
+#else
+    cpu_set_t threadMask;
+    CPU_ZERO(&threadMask);
+    for (size_t cpu = 0, mask = 1; cpu < MAX_CPUS; ++cpu, mask <<= 1)
+    {
+        if ((affinityMask & mask) != 0)
+        {
+            CPU_SET(cpu, &threadMask);
+        }
+    }
+
+    bool ok = (id_ != INVALID_ID) && (pthread_setaffinity_np(id_, sizeof(threadMask), &threadMask) == 0);
+#endif
+
+    return ok;
+}
+
+
+//!
+//! Return the affinity mask for the thread.
+//!
+size_t Thread::affinityMask() const
+{
+#if __CYGWIN__
+    size_t mask = 1;
+
+#else
+    size_t mask = 0;
+    cpu_set_t threadMask;
+    CPU_ZERO(&threadMask);
+    if ((id_ != INVALID_ID) && (pthread_getaffinity_np(id_, sizeof(threadMask), &threadMask) == 0))
+    {
+        for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &threadMask))
+            {
+                mask |= (static_cast<size_t>(1) << cpu);
+            }
+        }
+    }
+#endif
+
+    return mask;
+}
+
+
 //!
 //! Return the thread identifier of the caller.
 //!
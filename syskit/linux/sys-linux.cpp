@@ -3,13 +3,127 @@
  * No copyrights. No warranties. No restrictions in reuse.
  */
 #include <errno.h>
+#include <limits.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#if __CYGWIN__
+#include <pthread.h>
+#else
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include "syskit/Utf8Seq.hpp"
 #include "syskit/sys.hpp"
 
+#if __CYGWIN__
+const unsigned int NUM_PARKING_SLOTS = 64;
+const unsigned int NSECS_PER_SEC = 1000000000U;
+
+BEGIN_NAMESPACE
+
+// Cygwin lacks futexes. Emulate them using a small table of parking slots,
+// each with a mutex and a condition variable. A futex word hashes to one slot.
+typedef struct
+{
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+} parkingSlot_t;
+
+parkingSlot_t* parkingSlotOf(const void volatile* word)
+{
+    static parkingSlot_t s_slot[NUM_PARKING_SLOTS];
+    static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+    struct Init
+    {
+        static void run()
+        {
+            for (unsigned int i = 0; i < NUM_PARKING_SLOTS; ++i)
+            {
+                pthread_mutex_init(&s_slot[i].mu, 0);
+                pthread_cond_init(&s_slot[i].cv, 0);
+            }
+        }
+    };
+    pthread_once(&s_once, Init::run);
+
+    size_t k = reinterpret_cast<size_t>(word) >> 2;
+    return s_slot + ((k ^ (k >> 7)) % NUM_PARKING_SLOTS);
+}
+
+END_NAMESPACE
+#endif
+
 BEGIN_NAMESPACE1(syskit)
 
+
+//!
+//! Wait until the futex word is woken up, but only if it still contains the
+//! expected value. Wait at most timeout (relative) if timeout is non-zero. Wait
+//! forever otherwise. Return zero if woken up. Return -1 and set errno otherwise
+//! (EAGAIN if the futex word did not contain the expected value, ETIMEDOUT if
+//! timed out, EINTR if interrupted). Spurious wake-ups are possible.
+//!
+int futexWait(unsigned int volatile* word, unsigned int expected, const struct timespec* timeout)
+{
+#if __CYGWIN__
+    parkingSlot_t* slot = parkingSlotOf(word);
+    pthread_mutex_lock(&slot->mu);
+    int rc = 0;
+    if (*word != expected)
+    {
+        errno = EAGAIN;
+        rc = -1;
+    }
+    else if (timeout == 0)
+    {
+        pthread_cond_wait(&slot->cv, &slot->mu);
+    }
+    else
+    {
+        struct timespec then;
+        clock_gettime(CLOCK_REALTIME, &then);
+        then.tv_sec += timeout->tv_sec;
+        then.tv_nsec += timeout->tv_nsec;
+        if (then.tv_nsec >= static_cast<long>(NSECS_PER_SEC))
+        {
+            ++then.tv_sec;
+            then.tv_nsec -= NSECS_PER_SEC;
+        }
+        if (pthread_cond_timedwait(&slot->cv, &slot->mu, &then) != 0)
+        {
+            errno = ETIMEDOUT;
+            rc = -1;
+        }
+    }
+    pthread_mutex_unlock(&slot->mu);
+    return rc;
+#else
+    int rc = syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, timeout, 0, 0);
+    return rc;
+#endif
+}
+
+
+//!
+//! Wake up at most numWaiters threads waiting on the futex word. Return
+//! the number of woken threads, or -1 if unsuccessful.
+//!
+int futexWake(unsigned int volatile* word, int numWaiters)
+{
+#if __CYGWIN__
+    parkingSlot_t* slot = parkingSlotOf(word);
+    pthread_mutex_lock(&slot->mu);
+    pthread_cond_broadcast(&slot->cv);
+    pthread_mutex_unlock(&slot->mu);
+    return numWaiters;
+#else
+    int rc = syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, numWaiters, 0, 0, 0);
+    return rc;
+#endif
+}
+
+
 //!
 //! mkdir() variance. Return true if successful or if already existent.
 //!
@@ -13,6 +13,7 @@
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/sem.h>
+#include <time.h>
 #include <wchar.h>
 
 #ifndef LITTLE_ENDIAN
@@ -44,14 +45,60 @@ typedef pthread_mutex_t criSection_t;
 typedef pthread_mutex_t mutex_t;
 typedef unsigned int ulong32_t;
 
+struct futexSem_s;
+
 typedef struct
 {
-    long id;
-    unsigned short index;
-    unsigned short ok;
+    struct futexSem_s* futex;
+    unsigned int gen;
+    unsigned int ok;
 } sem_t;
 
 extern bool mkdir(const wchar_t*);
+extern int futexWait(unsigned int volatile* word, unsigned int expected, const struct timespec* timeout);
+extern int futexWake(unsigned int volatile* word, int numWaiters);
+
+//! Hint the processor that the calling thread is spinning.
+inline void cpuRelax()
+{
+#if __i386__ || __x86_64__
+    asm volatile("pause": : : "memory");
+#else
+    asm volatile("": : : "memory");
+#endif
+}
+
+//! Keep loads before the fence from being reordered with loads after it.
+inline void loadFence()
+{
+#if __i386__ || __x86_64__
+    asm volatile("": : : "memory"); //loads are not reordered with other loads
+#else
+    __sync_synchronize();
+#endif
+}
+
+//! Keep loads and stores before the fence from being reordered with loads and stores after it.
+inline void fullFence()
+{
+    __sync_synchronize();
+}
+
+//! Load the pointer at p with acquire semantics. Later loads and stores are
+//! not reordered before the load.
+template<typename T> inline T* loadAcquire(T* const* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+//! Store v at p with release semantics if the pointer at p is null. Earlier loads
+//! and stores are not reordered after the store. Return true if successful. Return
+//! false otherwise and the current pointer at p, loaded with acquire semantics, in cur.
+template<typename T> inline bool publishIfNull(T** p, T* v, T*& cur)
+{
+    cur = 0;
+    return __atomic_compare_exchange_n(p, &cur, v, false /*weak*/, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE);
+}
 
 inline void cpuid(int code, unsigned int info[2])
 {
@@ -71,6 +118,19 @@ inline bool popcntIsSupported()
 #endif
 }
 
+//! Return true if the SSE2 intrinsics are supported.
+inline bool sse2IsSupported()
+{
+#if GCC_VERSION >= 40800
+    return (__builtin_cpu_supports("sse2") != 0);
+#else
+    int code = 1;
+    unsigned int info[2];
+    cpuid(code, info);
+    return ((info[1] & 0x04000000UL) != 0); //CPUID_FEAT_EDX_SSE2: 1 <<26
+#endif
+}
+
 //! Emulate the x86 _BitScanForward() msvc intrinsic.
 inline unsigned char _BitScanForward(unsigned int* index, unsigned int mask)
 {
@@ -88,13 +148,13 @@ inline unsigned char _BitScanForward64(unsigned int* index, unsigned long long m
 //! Emulate the x86 _BitScanReverse() msvc intrinsic.
 inline unsigned char _BitScanReverse(unsigned int* index, unsigned int mask)
 {
-    return mask? ((*index = (64 - __builtin_clz(mask))), 1): (0);
+    return mask? ((*index = (31 - __builtin_clz(mask))), 1): (0);
 }
 
 //! Emulate the x64 _BitScanReverse64() msvc intrinsic.
 inline unsigned char _BitScanReverse64(unsigned int* index, unsigned long long mask)
 {
-    return mask? ((*index = (64 - __builtin_clzl(mask))), 1): (0);
+    return mask? ((*index = (63 - __builtin_clzll(mask))), 1): (0);
 }
 
 //! Return the number of set bits in mask using the popcnt intrinsic.
@@ -120,10 +180,14 @@ inline unsigned long long bswap64(unsigned long long u64)
 }
 
 //! Return the 64-bit time stamp counter provided by the RDTSC assembly instruction.
+//! The "=A" constraint cannot be used since it names a single 64-bit register on x86-64,
+//! which leaves only the low 32 bits and makes TickTime intervals wrap within seconds.
 inline unsigned long long volatile rdtsc()
 {
-    register unsigned long long tsc;
-    asm volatile("rdtsc": "=A"(tsc));
+    unsigned int hi;
+    unsigned int lo;
+    asm volatile("rdtsc": "=a"(lo), "=d"(hi));
+    unsigned long long tsc = (static_cast<unsigned long long>(hi) << 32) | lo;
     return tsc;
 }
 
@@ -79,6 +79,14 @@ namespace namespace0 { namespace namespace1 { struct structName; } }
 #endif
 #define END_NAMESPACE2 } }
 
+// rvalue references (move constructors and move assignment operators)
+// are supported by vc100 and later, and by c++11 compilers
+#ifndef HAS_RVALUE_REFS
+#if (defined(_MSC_VER) && (_MSC_VER >= 1600)) || (__cplusplus >= 201103L)
+#define HAS_RVALUE_REFS 1
+#endif
+#endif
+
 // stringify given argument
 // STRINGIFY(abc) --> "abc"
 #ifdef STRINGIFY
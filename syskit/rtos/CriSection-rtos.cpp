@@ -5,6 +5,7 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include "syskit/CriSection.hpp"
+#include "syskit/LockStat.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -13,16 +14,19 @@ BEGIN_NAMESPACE1(syskit)
 CriSection::CriSection()
 {
     cs_ = 0;
+    stat_ = 0;
 }
 
 
 CriSection::CriSection(unsigned int /*spinCount*/)
 {
+    stat_ = 0;
 }
 
 
 CriSection::~CriSection()
 {
+    delete stat_;
 }
 
 
@@ -41,6 +41,24 @@ typedef void* sem_t;
 
 extern bool mkdir(const wchar_t*);
 
+//! Hint the processor that the calling thread is spinning.
+inline void cpuRelax()
+{
+    asm volatile("": : : "memory");
+}
+
+//! Keep loads before the fence from being reordered with loads after it.
+inline void loadFence()
+{
+    __sync_synchronize();
+}
+
+//! Keep loads and stores before the fence from being reordered with loads and stores after it.
+inline void fullFence()
+{
+    __sync_synchronize();
+}
+
 #if 0
 // TODO
 inline void cpuid(int code, unsigned int info[2])
@@ -69,6 +87,12 @@ inline bool popcntIsSupported()
 
 #endif
 
+//! Return true if the SSE2 intrinsics are supported.
+inline bool sse2IsSupported()
+{
+    return false;
+}
+
 //! Emulate the x86 _BitScanForward() msvc intrinsic.
 inline unsigned char _BitScanForward(unsigned int* index, unsigned int mask)
 {
@@ -86,13 +110,13 @@ inline unsigned char _BitScanForward64(unsigned int* index, unsigned long long m
 //! Emulate the x86 _BitScanReverse() msvc intrinsic.
 inline unsigned char _BitScanReverse(unsigned int* index, unsigned int mask)
 {
-    return mask? ((*index = (64 - __builtin_clz(mask))), 1): (0);
+    return mask? ((*index = (31 - __builtin_clz(mask))), 1): (0);
 }
 
 //! Emulate the x64 _BitScanReverse64() msvc intrinsic.
 inline unsigned char _BitScanReverse64(unsigned int* index, unsigned long long mask)
 {
-    return mask? ((*index = (64 - __builtin_clzl(mask))), 1): (0);
+    return mask? ((*index = (63 - __builtin_clzll(mask))), 1): (0);
 }
 
 //! Return the number of set bits in mask using the popcnt intrinsic.
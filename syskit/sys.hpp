@@ -31,6 +31,13 @@
 
 #endif
 
+// SSE2 intrinsics can be compiled in. Use sse2IsSupported()
+// to find out if they are also supported at run time.
+#if _M_IX86 || _M_X64 || __SSE2__
+#include <emmintrin.h>
+#define HAS_SSE2_INTRINSICS 1
+#endif
+
 #ifdef htonl
 #undef htonl
 #endif
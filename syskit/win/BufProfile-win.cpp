@@ -0,0 +1,50 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include "syskit-pch.h"
+#include "syskit/BufProfile.hpp"
+#include "syskit/sys.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Capture the current call stack, excluding this method. Save at most
+//! maxFrames return addresses in eip[]. Return the number of saved frames.
+//!
+unsigned int BufProfile::captureStack(const void* eip[], unsigned int maxFrames)
+{
+    unsigned long framesToSkip = 1;
+    void** frame = const_cast<void**>(eip);
+    unsigned int numFrames = RtlCaptureStackBackTrace(framesToSkip, maxFrames, frame, 0);
+    return numFrames;
+}
+
+
+//!
+//! Describe given return address as "module+offset" if possible.
+//! Use the raw address otherwise. Save the description in desc[].
+//!
+void BufProfile::describeFrame(const void* eip, char* desc, size_t descSize)
+{
+    HMODULE h;
+    DWORD flags = GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT;
+    char path[MAX_PATH + 1];
+    if (GetModuleHandleExA(flags, static_cast<const char*>(eip), &h) && (GetModuleFileNameA(h, path, sizeof(path)) > 0))
+    {
+        const char* module = strrchr(path, '\\');
+        module = (module == 0)? path: module + 1;
+        size_t off = static_cast<const char*>(eip) - reinterpret_cast<const char*>(h);
+        sprintf_s(desc, descSize, "%p (%s+0x%Ix)", eip, module, off);
+    }
+    else
+    {
+        sprintf_s(desc, descSize, "%p", eip);
+    }
+}
+
+END_NAMESPACE1
@@ -7,6 +7,8 @@
 
 #include "syskit-pch.h"
 #include "syskit/CriSection.hpp"
+#include "syskit/LockStat.hpp"
+#include "syskit/TickTime.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -16,6 +18,7 @@ CriSection::CriSection()
 {
     cs_ = new _RTL_CRITICAL_SECTION;
     InitializeCriticalSection(cs_);
+    stat_ = 0;
 }
 
 
@@ -23,6 +26,7 @@ CriSection::CriSection(unsigned int spinCount)
 {
     cs_ = new _RTL_CRITICAL_SECTION;
     InitializeCriticalSectionAndSpinCount(cs_, spinCount);
+    stat_ = 0;
 }
 
 
@@ -30,6 +34,7 @@ CriSection::~CriSection()
 {
     DeleteCriticalSection(cs_);
     delete cs_;
+    delete stat_;
 }
 
 
@@ -39,7 +44,13 @@ CriSection::~CriSection()
 //!
 bool CriSection::tryLock()
 {
-    return TryEnterCriticalSection(cs_) != 0;
+    bool ok = (TryEnterCriticalSection(cs_) != 0);
+    if (ok && (stat_ != 0))
+    {
+        stat_->onLock(0 /*waitStart*/, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -48,7 +59,20 @@ bool CriSection::tryLock()
 //!
 void CriSection::lock()
 {
-    EnterCriticalSection(cs_);
+    if (stat_ == 0)
+    {
+        EnterCriticalSection(cs_);
+        return;
+    }
+
+    // Profiled. Note when the wait starts if contended.
+    unsigned long long waitStart = 0;
+    if (TryEnterCriticalSection(cs_) == 0)
+    {
+        waitStart = TickTime::curTime();
+        EnterCriticalSection(cs_);
+    }
+    stat_->onLock(waitStart, 0 /*numSpins*/);
 }
 
 
@@ -57,6 +81,11 @@ void CriSection::lock()
 //!
 void CriSection::unlock()
 {
+    if (stat_ != 0)
+    {
+        stat_->onUnlock();
+    }
+
     LeaveCriticalSection(cs_);
 }
 
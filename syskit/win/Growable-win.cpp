@@ -0,0 +1,47 @@
+/*
+ * Software by Thanh Phung -- thanhtphung@yahoo.com.
+ * No copyrights. No warranties. No restrictions in reuse.
+ */
+#include "syskit-pch.h"
+#include "syskit/Growable.hpp"
+#include "syskit/sys.hpp"
+
+BEGIN_NAMESPACE1(syskit)
+
+
+//!
+//! Return true if big arrays are supported on this platform. Windows lacks
+//! an equivalent of mremap(), so big arrays are not supported.
+//!
+bool Growable::canMap()
+{
+    return false;
+}
+
+
+//!
+//! Unmap given big array. Not supported.
+//!
+void Growable::unmapArray(void* /*addr*/, size_t /*mappedSize*/)
+{
+}
+
+
+//!
+//! Map a big array. Not supported. Return zero.
+//!
+void* Growable::mapArray(size_t& /*byteSize*/, bool /*useHugePages*/)
+{
+    return 0;
+}
+
+
+//!
+//! Resize a big array. Not supported. Return zero.
+//!
+void* Growable::remapArray(void* /*addr*/, size_t /*oldSize*/, size_t& /*newByteSize*/, bool /*useHugePages*/)
+{
+    return 0;
+}
+
+END_NAMESPACE1
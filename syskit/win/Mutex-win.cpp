@@ -6,7 +6,9 @@
 #include <windows.h>
 
 #include "syskit-pch.h"
+#include "syskit/LockStat.hpp"
 #include "syskit/Mutex.hpp"
+#include "syskit/TickTime.hpp"
 #include "syskit/macros.h"
 
 BEGIN_NAMESPACE1(syskit)
@@ -17,6 +19,7 @@ Mutex::Mutex()
 
     // A binary semaphore is used to model a non-recursive mutex.
     mu_ = CreateSemaphoreW(0, 1 /*initialCount*/, 1 /*maxCount*/, 0);
+    stat_ = 0;
 }
 
 
@@ -26,6 +29,8 @@ Mutex::~Mutex()
     {
         CloseHandle(mu_);
     }
+
+    delete stat_;
 }
 
 
@@ -43,7 +48,25 @@ bool Mutex::isOk() const
 //!
 bool Mutex::lock()
 {
-    return WaitForSingleObjectEx(mu_, ETERNITY, 1 /*bAlertable*/) == WAIT_OBJECT_0;
+    if (stat_ == 0)
+    {
+        return WaitForSingleObjectEx(mu_, ETERNITY, 1 /*bAlertable*/) == WAIT_OBJECT_0;
+    }
+
+    // Profiled. Note when the wait starts if contended.
+    unsigned long long waitStart = 0;
+    bool ok = (WaitForSingleObjectEx(mu_, 0 /*dwMilliseconds*/, 0 /*bAlertable*/) == WAIT_OBJECT_0);
+    if (!ok)
+    {
+        waitStart = TickTime::curTime();
+        ok = (WaitForSingleObjectEx(mu_, ETERNITY, 1 /*bAlertable*/) == WAIT_OBJECT_0);
+    }
+    if (ok)
+    {
+        stat_->onLock(waitStart, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -52,7 +75,13 @@ bool Mutex::lock()
 //!
 bool Mutex::tryLock()
 {
-    return WaitForSingleObjectEx(mu_, 0 /*dwMilliseconds*/, 0 /*bAlertable*/) == WAIT_OBJECT_0;
+    bool ok = (WaitForSingleObjectEx(mu_, 0 /*dwMilliseconds*/, 0 /*bAlertable*/) == WAIT_OBJECT_0);
+    if (ok && (stat_ != 0))
+    {
+        stat_->onLock(0 /*waitStart*/, 0 /*numSpins*/);
+    }
+
+    return ok;
 }
 
 
@@ -62,6 +91,11 @@ bool Mutex::tryLock()
 //!
 bool Mutex::unlock()
 {
+    if (stat_ != 0)
+    {
+        stat_->onUnlock();
+    }
+
     ReleaseSemaphore(mu_, 1 /*lReleaseCount*/, 0 /*lpPreviousCount*/);
     return true;
 }
@@ -16,9 +16,11 @@
 
 extern "C" unsigned int __popcnt(unsigned int);
 extern "C" void __cpuid(int[4], int);
+extern "C" void _ReadWriteBarrier(void);
 
 #pragma intrinsic(__cpuid)
 #pragma intrinsic(__popcnt)
+#pragma intrinsic(_ReadWriteBarrier)
 #pragma intrinsic(_byteswap_ushort)
 #pragma intrinsic(_byteswap_ulong)
 #pragma intrinsic(_byteswap_uint64)
@@ -69,6 +71,43 @@ inline bool mkdir(const wchar_t* path)
     return ok;
 }
 
+//! Hint the processor that the calling thread is spinning.
+inline void cpuRelax()
+{
+    YieldProcessor();
+}
+
+//! Keep loads before the fence from being reordered with loads after it.
+inline void loadFence()
+{
+    _ReadWriteBarrier(); //loads are not reordered with other loads on x86/x64
+}
+
+//! Keep loads and stores before the fence from being reordered with loads and stores after it.
+inline void fullFence()
+{
+    MemoryBarrier();
+}
+
+//! Load the pointer at p with acquire semantics. Later loads and stores are
+//! not reordered before the load.
+template<typename T> inline T* loadAcquire(T* const* p)
+{
+    T* v = *const_cast<T* const volatile*>(p);
+    _ReadWriteBarrier(); //loads have acquire semantics on x86/x64
+    return v;
+}
+
+//! Store v at p with release semantics if the pointer at p is null. Earlier loads
+//! and stores are not reordered after the store. Return true if successful. Return
+//! false otherwise and the current pointer at p, loaded with acquire semantics, in cur.
+template<typename T> inline bool publishIfNull(T** p, T* v, T*& cur)
+{
+    void* volatile* target = reinterpret_cast<void* volatile*>(p);
+    cur = static_cast<T*>(InterlockedCompareExchangePointer(target, v, 0));
+    return (cur == 0);
+}
+
 //! Return true if the popcnt intrinsic is supported.
 inline bool popcntIsSupported()
 {
@@ -77,6 +116,14 @@ inline bool popcntIsSupported()
     return ((info[2] & 0x00800000UL) != 0); //CPUID_FEAT_ECX_POPCNT: 1 <<23
 }
 
+//! Return true if the SSE2 intrinsics are supported.
+inline bool sse2IsSupported()
+{
+    int info[4];
+    __cpuid(info, 1 /*infoType*/);
+    return ((info[3] & 0x04000000UL) != 0); //CPUID_FEAT_EDX_SSE2: 1 <<26
+}
+
 //! Return the number of set bits in mask using the popcnt intrinsic.
 inline unsigned int popcnt(unsigned int mask)
 {